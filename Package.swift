@@ -21,7 +21,8 @@ let package = Package(
         .target(
             name: "URLMock",
             publicHeadersPath: "Headers/Public",
-            cSettings: [.headerSearchPath("Headers/Private")]
+            cSettings: [.headerSearchPath("Headers/Private")],
+            linkerSettings: [.linkedLibrary("z")]
         )
     ]
 )
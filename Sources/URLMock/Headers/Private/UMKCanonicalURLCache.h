@@ -0,0 +1,83 @@
+//
+//  UMKCanonicalURLCache.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ UMKCanonicalURLCache objects are bounded, thread-safe caches that map URL strings to canonical URLs. When the
+ cache is full, the least recently used entry is evicted to make room for a new one.
+ 
+ Every lookup is counted as either a hit or a miss so that the effectiveness of the cache can be inspected.
+ */
+@interface UMKCanonicalURLCache : NSObject
+
+/*! The maximum number of canonical URLs the cache can hold. If 0, the cache stores nothing. */
+@property (nonatomic, assign, readonly) NSUInteger capacity;
+
+/*! The number of canonical URLs currently in the cache. */
+@property (nonatomic, assign, readonly) NSUInteger count;
+
+/*! The number of lookups that found a canonical URL since the cache was created or last cleared. */
+@property (nonatomic, assign, readonly) NSUInteger hitCount;
+
+/*! The number of lookups that did not find a canonical URL since the cache was created or last cleared. */
+@property (nonatomic, assign, readonly) NSUInteger missCount;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Initializes a newly allocated cache with the specified capacity.
+ @param capacity The maximum number of canonical URLs the cache can hold.
+ @result An initialized cache.
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/*!
+ @abstract Returns the canonical URL for the specified URL string and marks it as most recently used.
+ @param URLString The URL string. May not be nil.
+ @result The cached canonical URL for the URL string, or nil if there is none.
+ */
+- (NSURL * _Nullable)canonicalURLForURLString:(NSString *)URLString;
+
+/*!
+ @abstract Stores the specified canonical URL for the specified URL string.
+ @discussion If the cache is full, its least recently used entry is evicted.
+ @param canonicalURL The canonical URL. May not be nil.
+ @param URLString The URL string. May not be nil.
+ */
+- (void)setCanonicalURL:(NSURL *)canonicalURL forURLString:(NSString *)URLString;
+
+/*!
+ @abstract Removes all canonical URLs from the cache and resets its hit and miss counts.
+ */
+- (void)removeAllCanonicalURLs;
+
+@end
+
+NS_ASSUME_NONNULL_END
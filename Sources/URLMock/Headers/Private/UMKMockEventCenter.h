@@ -0,0 +1,121 @@
+//
+//  UMKMockEventCenter.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class UMKMockRegistryEvent;
+@protocol UMKMockURLRequest;
+
+/*!
+ UMKMockEventCenters publish a mock registry's events to observers, keep counts of them, and wake up threads that are
+ waiting for a condition on those counts to be met. 
+ 
+ Waits are driven by the events themselves: waiting threads sleep on a condition variable and re-evaluate their 
+ conditions only when an event is posted or when -signal is invoked, so they neither poll nor add latency. Conditions
+ are never evaluated by the thread that posts the event, which is usually a URL loading thread. Blocking waits 
+ evaluate them on the waiting thread once it wakes up, and asynchronous waits evaluate them on their queues.
+ 
+ Event centers are thread-safe.
+ */
+@interface UMKMockEventCenter : NSObject
+
+/*! The number of responses that have finished since the center was created or last reset. */
+@property (nonatomic, assign, readonly) NSUInteger finishedResponseCount;
+
+/*!
+ @abstract Returns the number of requests the specified mock request has serviced since the center was created or 
+     last reset.
+ @param mockRequest The mock request. May not be nil.
+ @result The number of requests the mock request has serviced.
+ */
+- (NSUInteger)serviceCountForMockRequest:(id<UMKMockURLRequest>)mockRequest;
+
+/*!
+ @abstract Updates the center's counts with the specified event, sends it to the center's observers, and re-evaluates
+     the conditions of any waiters.
+ @discussion Observers are invoked synchronously on the calling thread.
+ @param event The event. May not be nil.
+ */
+- (void)postEvent:(UMKMockRegistryEvent *)event;
+
+/*!
+ @abstract Wakes up any waiters so that they re-evaluate their conditions.
+ @discussion This should be invoked when state other than the center's counts that a condition might depend on changes.
+     It doesn't evaluate any conditions itself, so it is cheap enough to invoke from URL loading threads.
+ */
+- (void)signal;
+
+/*!
+ @abstract Resets the center's counts and re-evaluates the conditions of any waiters.
+ */
+- (void)reset;
+
+/*!
+ @abstract Adds an observer block that is invoked with every event posted to the center.
+ @param block The block to invoke. May not be nil.
+ @result An opaque object that can be passed to -removeObserver: to remove the observer.
+ */
+- (id<NSObject>)addObserverUsingBlock:(void (^)(UMKMockRegistryEvent *event))block;
+
+/*!
+ @abstract Removes the specified observer.
+ @param observer An object returned by -addObserverUsingBlock:.
+ */
+- (void)removeObserver:(id<NSObject>)observer;
+
+/*!
+ @abstract Blocks the calling thread until the specified condition is met or the specified timeout elapses.
+ @discussion The condition is evaluated on the calling thread immediately and then each time the thread is woken up
+     by an event being posted or the center being signaled. It is evaluated without holding any of the center's locks.
+ @param condition The condition. May not be nil.
+ @param timeout The maximum amount of time to wait.
+ @result Whether the condition was met before the timeout elapsed.
+ */
+- (BOOL)waitForCondition:(BOOL (^)(void))condition timeout:(NSTimeInterval)timeout;
+
+/*!
+ @abstract Asynchronously invokes the specified completion handler once the specified condition is met or the 
+     specified timeout elapses.
+ @discussion The condition is evaluated on the specified queue as soon as possible and then each time an event is
+     posted or the center is signaled. Signals that arrive while an evaluation is pending are coalesced into it. The
+     condition is evaluated without holding any of the center's locks.
+ @param condition The condition. May not be nil.
+ @param timeout The maximum amount of time to wait.
+ @param queue The queue on which to evaluate the condition and invoke the completion handler. May not be nil.
+ @param completionHandler The completion handler, which is passed whether the condition was met before the timeout
+     elapsed. May not be nil.
+ */
+- (void)notifyWhenCondition:(BOOL (^)(void))condition
+                    timeout:(NSTimeInterval)timeout
+                      queue:(dispatch_queue_t)queue
+          completionHandler:(void (^)(BOOL conditionMet))completionHandler;
+
+@end
+
+NS_ASSUME_NONNULL_END
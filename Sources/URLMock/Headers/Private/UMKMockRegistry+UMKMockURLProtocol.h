@@ -0,0 +1,106 @@
+//
+//  UMKMockRegistry+UMKMockURLProtocol.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import <URLMock/UMKMockRegistry.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class UMKMockRequestIndexEntry;
+
+/*!
+ The UMKMockURLProtocol category on UMKMockRegistry declares the methods that UMKMockURLProtocol uses to match and 
+ account for the requests it receives.
+ */
+@interface UMKMockRegistry (UMKMockURLProtocol)
+
+/*!
+ @abstract Returns the first expected mock request that matches the specified URL request.
+ @param request The URL request to find a mock request for. May not be nil.
+ @result The first expected mock request that matches the specified URL request.
+ */
+- (nullable id<UMKMockURLRequest>)expectedMockRequestMatchingURLRequest:(NSURLRequest *)request;
+
+/*!
+ @abstract Matches the specified URL request and saves the match for use by the protocol instance that is created
+     for the request.
+ @discussion This is used by +canInitWithRequest: so that the protocol instance doesn't have to repeat the match.
+ @param request The URL request to find a mock request for. May not be nil.
+ @result Whether an expected mock request matched the URL request.
+ */
+- (BOOL)savePendingMatchForURLRequest:(NSURLRequest *)request;
+
+/*!
+ @abstract Moves the pending match for one URL request, if any, to another.
+ @discussion This is used when +canonicalRequestForRequest: replaces a request with a new instance.
+ @param request The URL request whose pending match should be moved. May not be nil.
+ @param canonicalRequest The URL request to which the pending match should be moved. May not be nil.
+ */
+- (void)movePendingMatchFromURLRequest:(NSURLRequest *)request toURLRequest:(NSURLRequest *)canonicalRequest;
+
+/*!
+ @abstract Returns the index entry of the expected mock request that a new protocol instance should use to respond to
+     the specified URL request.
+ @discussion When verification is enabled, mock requests are removed after servicing requests, so the match is claimed. 
+     Otherwise, if +canInitWithRequest: already matched the request and the expected mock requests have not changed
+     since, that match is used. If not, the request is matched again. The entry's statistics are those in which the 
+     mock request's response should be recorded.
+ @param request The URL request to find a mock request for. May not be nil.
+ @param outClaimed On output, whether the returned entry was claimed. May not be NULL.
+ @result The entry for the first expected mock request that matches the specified URL request.
+ */
+- (nullable UMKMockRequestIndexEntry *)expectedMockRequestEntryForProtocolWithURLRequest:(NSURLRequest *)request
+                                                                                 claimed:(BOOL *)outClaimed;
+
+/*!
+ @abstract Records that the specified request was serviced by the mock request of the specified index entry.
+ @discussion Claimed mock requests are removed from the receiver's expected mock requests. Otherwise, this doesn't 
+     take the lock that guards the receiver's expected mock requests.
+ @param request The request that was serviced. May not be nil.
+ @param entry The index entry of the mock request that serviced the request. May not be nil.
+ @param claimed Whether the entry was claimed when it was matched.
+ */
+- (void)markRequest:(NSURLRequest *)request asServicedByEntry:(UMKMockRequestIndexEntry *)entry claimed:(BOOL)claimed;
+
+/*!
+ @abstract Records that the specified request was unexpected.
+ @param request The unexpected request. May not be nil.
+ */
+- (void)addUnexpectedRequest:(NSURLRequest *)request;
+
+/*!
+ @abstract Records that the response to the specified request finished.
+ @param request The request whose response finished. May not be nil.
+ @param mockRequest The mock request that serviced the request, or nil if the request was unexpected.
+ @param error The error with which the response failed, or nil if it succeeded.
+ */
+- (void)markResponseFinishedForRequest:(NSURLRequest *)request
+                           mockRequest:(nullable id<UMKMockURLRequest>)mockRequest
+                                 error:(nullable NSError *)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
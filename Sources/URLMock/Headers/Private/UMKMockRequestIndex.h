@@ -0,0 +1,213 @@
+//
+//  UMKMockRequestIndex.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+@class UMKMockRequestStatistics;
+@protocol UMKMockURLRequest;
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ UMKMockRequestIndexEntry objects pair a mock request with the order in which it was added to a mock request index.
+ */
+@interface UMKMockRequestIndexEntry : NSObject
+
+/*! The entry's mock request. */
+@property (nonatomic, strong, readonly) id<UMKMockURLRequest> mockRequest;
+
+/*! The order in which the entry was added to its index. Entries added earlier have smaller registration indexes. */
+@property (nonatomic, assign, readonly) uint64_t registrationIndex;
+
+/*! 
+ @abstract Whether the entry has been claimed by a URL request.
+ @discussion Claimed entries never match URL requests. This property can be read from any thread.
+ */
+@property (nonatomic, assign, readonly, getter=isClaimed) BOOL claimed;
+
+/*!
+ @abstract Whether the entry has been marked as serviced.
+ @discussion Like claimed, this property can be read from any thread.
+ */
+@property (nonatomic, assign, readonly, getter=isServiced) BOOL serviced;
+
+/*!
+ @abstract The statistics in which the entry's evaluations and matches are recorded, or nil if none are recorded.
+ @discussion Statistics are recorded using atomic operations, so entries can record them from any thread.
+ */
+@property (nonatomic, strong, readonly, nullable) UMKMockRequestStatistics *statistics;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Initializes a newly allocated entry with the specified mock request and registration index.
+ @param mockRequest The entry's mock request. May not be nil.
+ @param registrationIndex The entry's registration index.
+ @result An initialized entry.
+ */
+- (instancetype)initWithMockRequest:(id<UMKMockURLRequest>)mockRequest
+                  registrationIndex:(uint64_t)registrationIndex NS_DESIGNATED_INITIALIZER;
+
+/*!
+ @abstract Atomically claims the entry.
+ @discussion Only one invocation of this method ever succeeds, even if it is invoked concurrently on several threads.
+ @result Whether the entry was claimed by this invocation.
+ */
+- (BOOL)claim;
+
+/*!
+ @abstract Atomically marks the entry as serviced.
+ @discussion Like -claim, only one invocation of this method ever succeeds, so it can be used to count each entry's 
+     servicing exactly once without a lock.
+ @result Whether the entry was marked as serviced by this invocation.
+ */
+- (BOOL)markServiced;
+
+@end
+
+
+/*!
+ UMKMockRequestIndex objects store UMKMockURLProtocol’s expected mock requests in registration order and find the
+ first one that matches a URL request.
+
+ Plain UMKMockHTTPRequest instances are additionally indexed by their uppercased HTTP method and canonical URL, so
+ they can be found without scanning every expected mock request. Likewise, the URL patterns of plain
+ UMKPatternMatchingMockRequest instances are compiled into a UMKMockRouteTrie. All other mock requests are opaque to
+ the index and are scanned in order. When several mock requests match a URL request, the one that was added first wins.
+
+ Mock request indexes are not thread-safe. Copies are immutable snapshots that may be read from any number of threads
+ at once. Rather than copying every entry, a snapshot shares a compacted copy of the index with other snapshots and 
+ stores only the entries added since that copy was made, so taking a snapshot after each mutation costs O(√n) time 
+ amortized rather than O(n). Because copying updates the original's bookkeeping, it must be serialized with mutations.
+ */
+@interface UMKMockRequestIndex : NSObject <NSCopying>
+
+/*! The index's mock requests in the order in which they were added. */
+@property (nonatomic, copy, readonly) NSArray<id<UMKMockURLRequest>> *mockRequests;
+
+/*! The number of mock requests in the index. */
+@property (nonatomic, assign, readonly) NSUInteger count;
+
+/*! 
+ @abstract A counter that changes every time mock requests are added to or removed from the index.
+ @discussion Match results computed while the index has a given generation remain valid as long as the generation 
+     is unchanged.
+ */
+@property (nonatomic, assign, readonly) uint64_t generation;
+
+/*! Whether any of the index's entries record their evaluations in statistics. */
+@property (nonatomic, assign, readonly) BOOL recordsStatistics;
+
+/*!
+ @abstract Adds the specified mock request to the end of the receiver.
+ @param mockRequest The mock request to add. May not be nil.
+ */
+- (void)addMockRequest:(id<UMKMockURLRequest>)mockRequest;
+
+/*!
+ @abstract Adds the specified mock requests to the end of the receiver in order.
+ @discussion This is equivalent to adding each mock request individually, but each exact-match bucket is only
+     rebuilt once and the receiver’s generation is only incremented once.
+ @param mockRequests The mock requests to add. May not be nil.
+ */
+- (void)addMockRequests:(NSArray<id<UMKMockURLRequest>> *)mockRequests;
+
+/*!
+ @abstract Adds the specified mock requests to the end of the receiver in order, recording their evaluations and 
+     matches in the specified statistics.
+ @param mockRequests The mock requests to add. May not be nil.
+ @param statistics The statistics for each mock request, in the same order as mockRequests, or nil if statistics 
+     should not be recorded. If non-nil, must have the same number of elements as mockRequests.
+ @result The entries that were added for the mock requests, in the same order as mockRequests.
+ */
+- (NSArray<UMKMockRequestIndexEntry *> *)addMockRequests:(NSArray<id<UMKMockURLRequest>> *)mockRequests
+                                              statistics:(nullable NSArray<UMKMockRequestStatistics *> *)statistics;
+
+/*!
+ @abstract Removes all occurrences of the specified mock request from the receiver.
+ @discussion Mock requests are compared using -isEqual:.
+ @param mockRequest The mock request to remove.
+ */
+- (void)removeMockRequest:(id<UMKMockURLRequest>)mockRequest;
+
+/*!
+ @abstract Removes all occurrences of the specified mock requests from the receiver.
+ @discussion Mock requests are compared using -isEqual: and -hash. Unlike removing each mock request individually,
+     this scans the receiver only once.
+ @param mockRequests The mock requests to remove. May not be nil.
+ */
+- (void)removeMockRequests:(NSArray<id<UMKMockURLRequest>> *)mockRequests;
+
+/*!
+ @abstract Removes all mock requests from the receiver.
+ */
+- (void)removeAllMockRequests;
+
+/*!
+ @abstract Returns the first mock request in the receiver that matches the specified URL request.
+ @discussion Evaluations are not recorded in statistics.
+ @param request The URL request. May not be nil.
+ @result The earliest added mock request that matches the URL request, or nil if none match.
+ */
+- (id<UMKMockURLRequest> _Nullable)firstMockRequestMatchingURLRequest:(NSURLRequest *)request;
+
+/*!
+ @abstract Returns the entry for the first mock request in the receiver that matches the specified URL request.
+ @discussion Lookups that only probe whether a URL request can be handled should not record statistics, so that
+     each URL request's evaluations are recorded once, by the lookup whose result is used to service it.
+ @param request The URL request. May not be nil.
+ @param recordsStatistics Whether to record each candidate's evaluation in its entry's statistics.
+ @result The entry for the earliest added mock request that matches the URL request, or nil if none match.
+ */
+- (nullable UMKMockRequestIndexEntry *)firstEntryMatchingURLRequest:(NSURLRequest *)request recordingStatistics:(BOOL)recordsStatistics;
+
+/*!
+ @abstract Returns the first mock request in the receiver that matches the specified URL request, claiming its entry
+     if the mock request should be removed after servicing the URL request.
+ @discussion Claiming ensures that a mock request that is removed after servicing a request is returned at most once,
+     even if several threads look up matching URL requests in copies of the same index at once. If another thread
+     claims a matching entry first, the next matching entry is used instead.
+ @param request The URL request. May not be nil.
+ @param outClaimed On output, whether the returned mock request's entry was claimed. May not be NULL.
+ @result The earliest added unclaimed mock request that matches the URL request, or nil if none match.
+ */
+- (id<UMKMockURLRequest> _Nullable)claimFirstMockRequestMatchingURLRequest:(NSURLRequest *)request claimed:(BOOL *)outClaimed;
+
+/*!
+ @abstract Returns the entry for the first mock request in the receiver that matches the specified URL request, 
+     claiming it if its mock request should be removed after servicing the URL request.
+ @discussion See -claimFirstMockRequestMatchingURLRequest:claimed: for details. Claiming is only done for URL requests
+     that are about to be serviced, so each candidate's evaluation is recorded in its entry's statistics.
+ @param request The URL request. May not be nil.
+ @param outClaimed On output, whether the returned entry was claimed. May not be NULL.
+ @result The entry for the earliest added unclaimed mock request that matches the URL request, or nil if none match.
+ */
+- (nullable UMKMockRequestIndexEntry *)claimFirstEntryMatchingURLRequest:(NSURLRequest *)request claimed:(BOOL *)outClaimed;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,123 @@
+//
+//  UMKMockRouteTrie.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+#import <URLMock/UMKPatternMatchingMockRequest.h>
+
+@class UMKMockRequestIndexEntry;
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ UMKMockRouteMatches are the results of looking up a URL string in a route trie.
+ */
+@interface UMKMockRouteMatch : NSObject
+
+/*! The index entry whose URL pattern matched. */
+@property (nonatomic, strong, readonly) UMKMockRequestIndexEntry *entry;
+
+/*!
+ @abstract The URL pattern parameters extracted from the URL string.
+ @discussion This is nil if the trie could only match the URL string by letting a parameter span several path 
+     segments. SOCKit patterns resolve that ambiguity differently than the trie, so such matches must be confirmed 
+     by matching the entry's mock request normally.
+ */
+@property (nonatomic, copy, readonly, nullable) NSDictionary<NSString *, NSString *> *parameters;
+
+@end
+
+
+/*!
+ UMKMockRouteTrie objects compile the URL patterns of many pattern-matching mock requests into a single trie of path 
+ segments, so that the patterns that match a URL can be found with one walk instead of testing each pattern in turn.
+
+ Each pattern is split into path segments on '/'. A segment that consists entirely of a parameter, like :id, becomes a 
+ parameter node; all other segments become literal nodes. A parameter in the last segment of a pattern matches the rest 
+ of the URL, just like a trailing SOCKit parameter. Patterns that use escape characters or that mix parameters and 
+ literal text within a segment cannot be compiled and should be matched some other way.
+
+ Route tries are not thread-safe, but a trie that is no longer mutated may be read from any number of threads at once.
+ */
+@interface UMKMockRouteTrie : NSObject <NSCopying>
+
+/*! The number of entries in the trie. */
+@property (nonatomic, assign, readonly) NSUInteger count;
+
+/*!
+ @abstract Returns whether the specified URL pattern can be compiled into a route trie.
+ @param URLPattern The URL pattern. May not be nil.
+ @result Whether the URL pattern can be compiled.
+ */
++ (BOOL)canCompileURLPattern:(NSString *)URLPattern;
+
+/*!
+ @abstract Adds the specified entry to the trie.
+ @param entry The entry to add. Its mock request must be a UMKPatternMatchingMockRequest whose URL pattern can be 
+     compiled. May not be nil.
+ */
+- (void)addEntry:(UMKMockRequestIndexEntry *)entry;
+
+/*!
+ @abstract Removes the specified entry from the trie.
+ @param entry The entry to remove. May not be nil.
+ */
+- (void)removeEntry:(UMKMockRequestIndexEntry *)entry;
+
+/*!
+ @abstract Removes all entries from the trie.
+ */
+- (void)removeAllEntries;
+
+/*!
+ @abstract Returns the entries whose URL patterns may match the specified URL string.
+ @param URLString The canonical URL string, excluding its query. May not be nil.
+ @result The matches for the URL string, sorted by their entries' registration indexes.
+ */
+- (NSArray<UMKMockRouteMatch *> *)matchesForURLString:(NSString *)URLString;
+
+@end
+
+
+/*!
+ The UMKMockRouteTrie category on UMKPatternMatchingMockRequest declares the method route tries use to finish matching 
+ a URL request after they have already matched its URL.
+ */
+@interface UMKPatternMatchingMockRequest (UMKMockRouteTrie)
+
+/*!
+ @abstract Returns whether the receiver matches the URL request of the specified context, given that its URL pattern
+     is already known to match the request's URL.
+ @param context The match context.
+ @param parameters The URL pattern parameters parsed from the request's URL.
+ @result Whether the receiver matches the context's URL request.
+ */
+- (BOOL)matchesURLRequestOfContext:(UMKRequestMatchContext *)context patternParameters:(NSDictionary<NSString *, NSString *> *)parameters;
+
+@end
+
+NS_ASSUME_NONNULL_END
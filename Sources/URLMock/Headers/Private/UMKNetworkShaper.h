@@ -0,0 +1,80 @@
+//
+//  UMKNetworkShaper.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import <Foundation/Foundation.h>
+
+@class UMKNetworkConditions, UMKVirtualClock;
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ UMKNetworkShapers decide when each part of a single response may be delivered under a set of network conditions.
+
+ A shaper samples the response's latency once, and paces the response's body with a token bucket that holds up to
+ one preferred chunk's worth of bytes and refills at the conditions' downstream rate. Because the bucket refills
+ based on the time that has actually elapsed on the response's clock, delays caused by a busy thread are made up for
+ by later chunks, and the average throughput matches the downstream rate. Shapers are not thread-safe; each belongs
+ to one response.
+ */
+@interface UMKNetworkShaper : NSObject
+
+/*! The network conditions the shaper models. */
+@property (nonatomic, strong, readonly) UMKNetworkConditions *networkConditions;
+
+/*! The clock whose time refills the shaper's token bucket. */
+@property (nonatomic, strong, readonly) UMKVirtualClock *clock;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Initializes a newly allocated shaper with the specified network conditions and clock.
+ @discussion The shaper's token bucket starts out full.
+ @param networkConditions The network conditions to model. May not be nil.
+ @param clock The clock whose time refills the token bucket. May not be nil.
+ @result An initialized shaper.
+ */
+- (instancetype)initWithNetworkConditions:(UMKNetworkConditions *)networkConditions clock:(UMKVirtualClock *)clock NS_DESIGNATED_INITIALIZER;
+
+/*!
+ @abstract Returns the time to wait before the response is sent.
+ @discussion This is the round-trip time plus a jitter sample taken from the network conditions when the shaper
+     is created. The same shaper always returns the same value.
+ @result The time to wait before the response is sent.
+ */
+- (NSTimeInterval)latency;
+
+/*!
+ @abstract Takes the specified number of bytes from the token bucket and returns how long to wait before sending them.
+ @param length The number of bytes about to be sent.
+ @result The time to wait until the bucket would have held enough tokens, or 0 if it already did.
+ */
+- (NSTimeInterval)delayBeforeSendingBytes:(NSUInteger)length;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,61 @@
+//
+//  UMKSplitMix64.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import <Foundation/Foundation.h>
+
+
+/*! The amount by which a SplitMix64 generator's state advances with each output. */
+#define UMKSplitMix64Increment 0x9E3779B97F4A7C15ULL
+
+
+/*!
+ @abstract Returns the SplitMix64 output for the specified generator state.
+ @discussion SplitMix64's state is just a counter that advances by UMKSplitMix64Increment, so the nth output of a
+     generator seeded with s is UMKSplitMix64Mix(s + n * UMKSplitMix64Increment). This lets generators hand out
+     outputs with a single atomic add and no lock.
+ @param state The generator state after it has been advanced.
+ @result A pseudorandom 64-bit value.
+ */
+static inline uint64_t UMKSplitMix64Mix(uint64_t state)
+{
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+
+/*!
+ @abstract Returns a pseudorandom number in [0, 1) derived from the specified 64-bit value.
+ @discussion Only the top 53 bits are used, which is all the precision a double has.
+ @param bits A pseudorandom 64-bit value.
+ @result A pseudorandom number in [0, 1).
+ */
+static inline double UMKUnitIntervalWithRandomBits(uint64_t bits)
+{
+    return (bits >> 11) * 0x1.0p-53;
+}
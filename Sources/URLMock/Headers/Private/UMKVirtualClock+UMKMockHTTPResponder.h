@@ -0,0 +1,59 @@
+//
+//  UMKVirtualClock+UMKMockHTTPResponder.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import <URLMock/UMKVirtualClock.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ The UMKMockHTTPResponder category on UMKVirtualClock declares the methods that responders use to tell a clock about
+ work that a scheduled block handed off to another thread.
+
+ Virtual clocks don't advance while such work is outstanding. Otherwise, a response whose next chunk is scheduled
+ from its loading thread could fall behind the clock, and its chunks would no longer be ordered correctly relative
+ to other responses.
+ */
+@interface UMKVirtualClock (UMKMockHTTPResponder)
+
+/*!
+ @abstract Records that work that may schedule more blocks has been handed off to the specified run loop.
+ @discussion Each invocation must be balanced by an invocation of -endActivityOnRunLoop: with the same run loop once
+     the work is done. Manual clocks that are advanced on the run loop's thread run the run loop until the work is done.
+ @param runLoop The run loop to which the work was handed off. May not be NULL.
+ */
+- (void)beginActivityOnRunLoop:(CFRunLoopRef)runLoop;
+
+/*!
+ @abstract Records that work previously recorded with -beginActivityOnRunLoop: is done.
+ @param runLoop The run loop to which the work was handed off. May not be NULL.
+ */
+- (void)endActivityOnRunLoop:(CFRunLoopRef)runLoop;
+
+@end
+
+NS_ASSUME_NONNULL_END
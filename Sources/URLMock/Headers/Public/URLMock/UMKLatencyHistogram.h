@@ -0,0 +1,84 @@
+//
+//  UMKLatencyHistogram.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import <Foundation/Foundation.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ UMKLatencyHistograms record the distribution of a series of durations in nanoseconds using logarithmically sized 
+ buckets, each of which is divided into 16 linearly sized sub-buckets, in the style of an HDR histogram. Durations
+ below 32 ns are recorded exactly; larger durations are recorded to within 1/16th (6.25%) of their actual value. 
+ Durations of about 18 minutes or more share the last bucket, though the maximum is always recorded exactly.
+
+ Recording a duration is lock-free and wait-free apart from updating the minimum and maximum, so histograms can be
+ updated concurrently from the URL loading system's threads without contention. The histogram's buckets are allocated
+ the first time a duration is recorded. Readers may observe a histogram that is being updated concurrently in a
+ slightly inconsistent state, e.g., with a count that does not yet include a duration that is reflected in its sum.
+ */
+@interface UMKLatencyHistogram : NSObject
+
+/*! The number of durations that have been recorded. */
+@property (nonatomic, assign, readonly) uint64_t count;
+
+/*! The sum of the durations that have been recorded, in nanoseconds. */
+@property (nonatomic, assign, readonly) uint64_t totalDuration;
+
+/*! The shortest duration that has been recorded, in nanoseconds, or 0 if no durations have been recorded. */
+@property (nonatomic, assign, readonly) uint64_t minimumDuration;
+
+/*! The longest duration that has been recorded, in nanoseconds, or 0 if no durations have been recorded. */
+@property (nonatomic, assign, readonly) uint64_t maximumDuration;
+
+/*! The mean of the durations that have been recorded, in nanoseconds, or 0 if no durations have been recorded. */
+@property (nonatomic, assign, readonly) double meanDuration;
+
+/*!
+ @abstract Records the specified duration.
+ @param duration The duration in nanoseconds.
+ */
+- (void)recordDuration:(uint64_t)duration;
+
+/*!
+ @abstract Returns the duration below which the specified percentage of recorded durations fall.
+ @discussion The result is the largest duration that is equivalent to the bucket containing the percentile, clamped
+     to the minimum and maximum recorded durations. The 0th percentile is always the minimum duration.
+ @param percentile The percentile, from 0 to 100.
+ @result The duration at the percentile in nanoseconds, or 0 if no durations have been recorded.
+ */
+- (uint64_t)durationAtPercentile:(double)percentile;
+
+/*!
+ @abstract Removes all recorded durations.
+ @discussion Durations that are recorded while the histogram is being reset may be partially lost.
+ */
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,138 @@
+//
+//  UMKLatencyModel.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import <Foundation/Foundation.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ UMKLatencyModels describe how long it takes for the first byte of a mock response to arrive. Responders with a
+ latency model sample it once per response and schedule the response to be delivered after that much time has passed.
+
+ Each model is a distribution of latencies: a fixed value, a uniform range, a lognormal distribution, or an empirical
+ distribution interpolated from a table of percentiles, such as one exported from production metrics. Samples are
+ drawn from a SplitMix64 pseudorandom generator seeded with the model's seed, so a model always produces the same
+ sequence of latencies after it is created or reset. Sampling is lock-free and thread-safe, so one model can be
+ shared among any number of responders.
+
+ To simplify its interface, UMKLatencyModel is implemented as a class cluster.
+ */
+@interface UMKLatencyModel : NSObject
+
+/*! The seed of the model's pseudorandom generator. */
+@property (nonatomic, assign, readonly) uint64_t seed;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+
+/*! @methodgroup Creating Latency Models */
+
+/*!
+ @abstract Returns a latency model that always produces the specified latency.
+ @param latency The latency. Must be non-negative.
+ @result A fixed latency model.
+ */
++ (instancetype)fixedLatencyModelWithLatency:(NSTimeInterval)latency;
+
+/*!
+ @abstract Returns a latency model whose latencies are uniformly distributed over the specified range.
+ @param minimumLatency The minimum latency. Must be non-negative.
+ @param maximumLatency The maximum latency. Must be at least the minimum latency.
+ @param seed The seed of the model's pseudorandom generator.
+ @result A uniform latency model.
+ */
++ (instancetype)uniformLatencyModelWithMinimumLatency:(NSTimeInterval)minimumLatency
+                                       maximumLatency:(NSTimeInterval)maximumLatency
+                                                 seed:(uint64_t)seed;
+
+/*!
+ @abstract Returns a latency model whose latencies are lognormally distributed.
+ @discussion Lognormal distributions are long-tailed, like most real-world latencies. The natural logarithm of the
+     latency is normally distributed with a mean of ln(medianLatency) and a standard deviation of sigma. For example,
+     with a sigma of 1, the 99th percentile latency is about 10 times the median.
+ @param medianLatency The median latency. Must be positive.
+ @param sigma The standard deviation of the latency's natural logarithm. Must be non-negative.
+ @param seed The seed of the model's pseudorandom generator.
+ @result A lognormal latency model.
+ */
++ (instancetype)lognormalLatencyModelWithMedianLatency:(NSTimeInterval)medianLatency sigma:(double)sigma seed:(uint64_t)seed;
+
+/*!
+ @abstract Returns a latency model whose latencies follow the specified percentile table.
+ @discussion Latencies between percentiles are linearly interpolated. Samples below the lowest percentile have the
+     lowest percentile's latency and samples above the highest percentile have the highest percentile's latency, so
+     tables should usually include the 0th and 100th percentiles.
+ @param percentileLatencies A dictionary mapping percentiles between 0 and 100 to the latency at that percentile.
+     Latencies must be non-negative and may not decrease as percentiles increase. May not be empty.
+ @param seed The seed of the model's pseudorandom generator.
+ @result An empirical latency model.
+ */
++ (instancetype)empiricalLatencyModelWithPercentileLatencies:(NSDictionary<NSNumber *, NSNumber *> *)percentileLatencies
+                                                        seed:(uint64_t)seed;
+
+/*!
+ @abstract Returns a latency model whose latencies follow the percentile table in the specified JSON file.
+ @discussion The file must contain a JSON object whose keys are percentiles and whose values are latencies in
+     seconds, e.g., { "p50" : 0.08, "p90" : 0.25, "p99" : 1.3, "p100" : 4.0 }. Keys may optionally be prefixed with "p".
+     The table must satisfy the same requirements as those passed to +empiricalLatencyModelWithPercentileLatencies:seed:.
+ @param fileURL The file URL of the percentile table. May not be nil.
+ @param seed The seed of the model's pseudorandom generator.
+ @param outError On return, if the file couldn't be read or doesn't contain a valid percentile table, an error
+     describing the problem.
+ @result An empirical latency model, or nil if the file couldn't be loaded.
+ */
++ (nullable instancetype)empiricalLatencyModelWithContentsOfURL:(NSURL *)fileURL
+                                                           seed:(uint64_t)seed
+                                                          error:(NSError **)outError;
+
+
+/*! @methodgroup Sampling */
+
+/*!
+ @abstract Returns the latency at the specified quantile of the receiver's distribution.
+ @discussion Subclasses must override this method.
+ @param quantile The quantile, between 0 and 1.
+ @result The latency at the specified quantile.
+ */
+- (NSTimeInterval)latencyAtQuantile:(double)quantile;
+
+/*!
+ @abstract Returns the next latency from the receiver's pseudorandom sequence.
+ @discussion This may be invoked from any thread.
+ @result A latency sampled from the receiver's distribution.
+ */
+- (NSTimeInterval)sampleLatency;
+
+/*!
+ @abstract Restarts the receiver's pseudorandom sequence from its seed.
+ */
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -34,6 +34,12 @@ NS_ASSUME_NONNULL_BEGIN
 /*! The HTTP header field for the Accepts header, i.e., "Accepts". */
 extern NSString *const kUMKMockHTTPMessageAcceptsHeaderField;
 
+/*! The HTTP header field for the Content-Encoding header, i.e., "Content-Encoding". */
+extern NSString *const kUMKMockHTTPMessageContentEncodingHeaderField;
+
+/*! The HTTP header field for the Content-Length header, i.e., "Content-Length". */
+extern NSString *const kUMKMockHTTPMessageContentLengthHeaderField;
+
 /*! The HTTP header field for the Content-Type header, i.e., "Content-Type". */
 extern NSString *const kUMKMockHTTPMessageContentTypeHeaderField;
 
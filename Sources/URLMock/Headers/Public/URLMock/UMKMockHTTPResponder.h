@@ -27,13 +27,61 @@
 #import <URLMock/UMKMockHTTPMessage.h>
 #import <URLMock/UMKMockURLProtocol.h>
 
+@class UMKLatencyModel, UMKNetworkConditions;
 
 NS_ASSUME_NONNULL_BEGIN
 
+/*!
+ @abstract Blocks that produce the successive chunks of a streaming HTTP response body.
+ @discussion A streaming responder invokes its chunk producer on the loading thread each time it needs another chunk,
+     and never invokes it again for a response once it returns nil or an empty data object. Each chunk producer is
+     only ever used by a single response, so it may keep whatever state it needs to track its progress.
+ @param maximumLength The maximum number of bytes the chunk should contain.
+ @param error On return, if the body couldn't be produced, an error describing the problem. The load fails with this
+     error after any chunks that were already produced are delivered.
+ @result The next chunk of the body, or nil if the body is complete or an error occurred.
+ */
+typedef NSData * _Nullable (^UMKMockHTTPResponderChunkProducer)(NSUInteger maximumLength, NSError * _Nullable * _Nullable error);
+
+/*!
+ @abstract Blocks that create a new chunk producer for each response a streaming responder sends.
+ @discussion The block is invoked once for each response, possibly on several threads at once.
+ @result A chunk producer that produces a response's entire body from the start.
+ */
+typedef UMKMockHTTPResponderChunkProducer _Nonnull (^UMKMockHTTPResponderChunkProducerFactory)(void);
+
+/*!
+ @abstract Blocks that create a new, unopened input stream for each response a streaming responder sends.
+ @discussion The block is invoked once for each response, possibly on several threads at once.
+ @result An unopened input stream from which a response's entire body can be read.
+ */
+typedef NSInputStream * _Nonnull (^UMKMockHTTPResponderBodyStreamFactory)(void);
+
+/*!
+ @abstract Constants that indicate how a responder encodes the bodies of its responses.
+ @constant UMKMockHTTPContentEncodingIdentity Bodies are sent as they are.
+ @constant UMKMockHTTPContentEncodingGzip Bodies are compressed in the gzip format (RFC 1952).
+ @constant UMKMockHTTPContentEncodingDeflate Bodies are compressed in the zlib format (RFC 1950), which is what HTTP
+     calls deflate.
+ */
+typedef NS_ENUM(NSInteger, UMKMockHTTPContentEncoding) {
+    UMKMockHTTPContentEncodingIdentity = 0,
+    UMKMockHTTPContentEncodingGzip,
+    UMKMockHTTPContentEncodingDeflate
+};
+
 /*!
  UMKMockHTTPResponder objects respond to mock HTTP URL requests. Instances can be created to respond with
  an NSError, an HTTP response, or even an HTTP response with its body broken into multiple chunks that are
  delivered over time.
+
+ Responding to a request doesn't modify a responder. Each response is a separate UMKMockURLResponseSession that owns
+ its own cancellation state, so one responder can be shared by any number of concurrent requests, and stopping one of
+ them doesn't affect the others. Configure a responder before it is used, though; changing its headers or body while
+ it is responding is not thread-safe.
+
+ Data responders compile their status code, headers, and body into a template the first time they respond, and reuse
+ it until their headers or body change, so each response only has to be stamped with its request's URL.
  
  To simplify its interface, UMKMockHTTPResponder is implemented as a class cluster. Subclasses effectively 
  have to reimplement everything from scratch, and the only important common interface is already defined in
@@ -112,8 +160,10 @@ NS_ASSUME_NONNULL_BEGIN
  @param body The HTTP body to respond with.
  @param hint A hint as to how many chunks the HTTP body should be broken into when responding. The
      actual number of chunks depends on the size of the body and the whims of the NSURL system. May not be 0.
+     Chunks share the body's bytes rather than copying them, so even very large bodies can be chunked cheaply.
  @param delay The amount of time the responder should wait between sending chunks of data. This
-     is only used if chunks is more than 1. Must be non-negative.
+     is only used if chunks is more than 1. Must be non-negative. The wait doesn't block the loading thread;
+     each chunk is delivered by a timer on the thread's run loop, and canceling the response cancels the timer.
  @result A newly initialized UMKMockHTTPResponder with the specified parameters.
  */
 + (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
@@ -122,6 +172,203 @@ NS_ASSUME_NONNULL_BEGIN
                                  chunkCountHint:(NSUInteger)hint
                              delayBetweenChunks:(NSTimeInterval)delay;
 
+
+/*! @methodgroup File-Backed Responders */
+
+/*!
+ @abstract Returns a new UMKMockHTTPResponder instance that responds by sending an HTTP response with the
+     specified HTTP status code and headers, and with the contents of the specified file as its body.
+ @discussion The file is not read when the responder is created. It is memory-mapped the first time the responder's
+     body is needed, so large fixtures cost nothing unless they are actually used, and the response is delivered
+     straight from the mapping. If the headers don't include a Content-Length, one is added using the file's size.
+     If the file can't be mapped when responding, the responder responds with the resulting error.
+
+     Setting the responder's body replaces the file's contents.
+ @param statusCode The HTTP status code to respond with.
+ @param headers The HTTP headers to respond with.
+ @param bodyFileURL The file URL of the HTTP body to respond with. May not be nil.
+ @result A new UMKMockHTTPResponder instance initialized with the specified parameters.
+ */
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
+                                        headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                                    bodyFileURL:(NSURL *)bodyFileURL;
+
+/*!
+ @abstract Returns a new UMKMockHTTPResponder instance that responds by sending an HTTP response with the
+     specified HTTP status code and headers, and with the contents of the specified file as its body, broken into
+     chunks.
+ @discussion See +mockHTTPResponderWithStatusCode:headers:bodyFileURL: for how the file is used. Chunks are
+     delivered straight from the file's mapping.
+ @param statusCode The HTTP status code to respond with.
+ @param headers The HTTP headers to respond with.
+ @param bodyFileURL The file URL of the HTTP body to respond with. May not be nil.
+ @param hint A hint as to how many chunks the HTTP body should be broken into when responding. May not be 0.
+ @param delay The amount of time the responder should wait between sending chunks of data. Must be non-negative.
+ @result A new UMKMockHTTPResponder instance initialized with the specified parameters.
+ */
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
+                                        headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                                    bodyFileURL:(NSURL *)bodyFileURL
+                                 chunkCountHint:(NSUInteger)hint
+                             delayBetweenChunks:(NSTimeInterval)delay;
+
+/*!
+ @abstract Returns a new UMKMockHTTPResponder instance that responds by sending an HTTP response with the
+     specified HTTP status code and headers, and with the contents of the specified precompressed file as its body.
+ @discussion Use this to serve fixtures that are already compressed, such as .gz files, exactly as they are. The
+     file's bytes are sent unmodified with a Content-Encoding header for the specified encoding, and the responder's
+     contentEncoding is set to match. Its body is the encoded contents of the file. See
+     +mockHTTPResponderWithStatusCode:headers:bodyFileURL: for how the file is used.
+
+     Setting the responder's body replaces the file's contents with an unencoded body, which is then compressed with
+     the responder's content encoding like any other.
+ @param statusCode The HTTP status code to respond with.
+ @param headers The HTTP headers to respond with.
+ @param encodedBodyFileURL The file URL of the encoded HTTP body to respond with. May not be nil.
+ @param contentEncoding The encoding with which the file's contents are compressed.
+ @param hint A hint as to how many chunks the encoded HTTP body should be broken into when responding. May not be 0.
+ @param delay The amount of time the responder should wait between sending chunks of data. Must be non-negative.
+ @result A new UMKMockHTTPResponder instance initialized with the specified parameters.
+ */
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
+                                        headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                             encodedBodyFileURL:(NSURL *)encodedBodyFileURL
+                                contentEncoding:(UMKMockHTTPContentEncoding)contentEncoding
+                                 chunkCountHint:(NSUInteger)hint
+                             delayBetweenChunks:(NSTimeInterval)delay;
+
+
+/*! @methodgroup Streaming Responders */
+
+/*!
+ @abstract Returns a new UMKMockHTTPResponder instance that responds by sending an HTTP response whose body is
+     produced chunk by chunk as it is sent.
+ @discussion Chunks are pulled from the chunk producer on demand, and the responder holds on to no more than two of
+     them at a time, so memory use stays constant no matter how large the body is. The first chunk is sent right away
+     and each subsequent chunk is sent after the specified delay. When the response is canceled, the responder stops
+     pulling chunks immediately.
+
+     Because a chunk producer can only produce its body once, the responder can only respond to a single request.
+     Every response after the first fails with an error whose domain is kUMKErrorDomain and whose code is
+     kUMKSingleUseResponderReusedErrorCode. To respond to several requests, use
+     +mockHTTPResponderWithStatusCode:headers:chunkProducerFactory:chunkLength:delayBetweenChunks: instead.
+
+     Streaming responders have no body; the receiver's body property is always nil.
+ @param statusCode The HTTP status code to respond with.
+ @param headers The HTTP headers to respond with.
+ @param chunkProducer The block that produces the HTTP body. May not be nil.
+ @param chunkLength The maximum length of each chunk. Must be positive.
+ @param delay The amount of time the responder should wait between sending chunks of data. Must be non-negative.
+ @result A new UMKMockHTTPResponder instance initialized with the specified parameters.
+ */
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
+                                        headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                                  chunkProducer:(UMKMockHTTPResponderChunkProducer)chunkProducer
+                                    chunkLength:(NSUInteger)chunkLength
+                             delayBetweenChunks:(NSTimeInterval)delay;
+
+/*!
+ @abstract Returns a new UMKMockHTTPResponder instance that responds by sending an HTTP response whose body is
+     produced chunk by chunk by a new chunk producer for each response.
+ @discussion The chunk producer factory is invoked once per response, so the responder can respond to any number of
+     requests, including concurrent ones, without their bodies interfering with one another. See
+     +mockHTTPResponderWithStatusCode:headers:chunkProducer:chunkLength:delayBetweenChunks: for more details.
+ @param statusCode The HTTP status code to respond with.
+ @param headers The HTTP headers to respond with.
+ @param chunkProducerFactory The block that creates each response's chunk producer. May not be nil.
+ @param chunkLength The maximum length of each chunk. Must be positive.
+ @param delay The amount of time the responder should wait between sending chunks of data. Must be non-negative.
+ @result A new UMKMockHTTPResponder instance initialized with the specified parameters.
+ */
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
+                                        headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                           chunkProducerFactory:(UMKMockHTTPResponderChunkProducerFactory)chunkProducerFactory
+                                    chunkLength:(NSUInteger)chunkLength
+                             delayBetweenChunks:(NSTimeInterval)delay;
+
+/*!
+ @abstract Returns a new UMKMockHTTPResponder instance that responds by sending an HTTP response whose body is
+     read from the specified input stream as it is sent.
+ @discussion The stream is opened when the first chunk is needed and read into buffers of the specified length. It
+     is closed when it is exhausted or fails, in which case the load fails with the stream's error. Because a stream
+     can only be read once, the responder can only respond to a single request. Every response after the first fails
+     with an error whose domain is kUMKErrorDomain and whose code is kUMKSingleUseResponderReusedErrorCode. To respond
+     to several requests, use +mockHTTPResponderWithStatusCode:headers:bodyStreamFactory:chunkLength:delayBetweenChunks:
+     instead. See +mockHTTPResponderWithStatusCode:headers:chunkProducer:chunkLength:delayBetweenChunks: for more
+     details.
+ @param statusCode The HTTP status code to respond with.
+ @param headers The HTTP headers to respond with.
+ @param bodyStream The stream from which to read the HTTP body. May not be nil.
+ @param chunkLength The maximum length of each chunk. Must be positive.
+ @param delay The amount of time the responder should wait between sending chunks of data. Must be non-negative.
+ @result A new UMKMockHTTPResponder instance initialized with the specified parameters.
+ */
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
+                                        headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                                     bodyStream:(NSInputStream *)bodyStream
+                                    chunkLength:(NSUInteger)chunkLength
+                             delayBetweenChunks:(NSTimeInterval)delay;
+
+/*!
+ @abstract Returns a new UMKMockHTTPResponder instance that responds by sending an HTTP response whose body is
+     read from a new input stream for each response.
+ @discussion The body stream factory is invoked once per response, so the responder can respond to any number of
+     requests, including concurrent ones. See
+     +mockHTTPResponderWithStatusCode:headers:bodyStream:chunkLength:delayBetweenChunks: for more details.
+ @param statusCode The HTTP status code to respond with.
+ @param headers The HTTP headers to respond with.
+ @param bodyStreamFactory The block that creates each response's input stream. May not be nil.
+ @param chunkLength The maximum length of each chunk. Must be positive.
+ @param delay The amount of time the responder should wait between sending chunks of data. Must be non-negative.
+ @result A new UMKMockHTTPResponder instance initialized with the specified parameters.
+ */
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
+                                        headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                              bodyStreamFactory:(UMKMockHTTPResponderBodyStreamFactory)bodyStreamFactory
+                                    chunkLength:(NSUInteger)chunkLength
+                             delayBetweenChunks:(NSTimeInterval)delay;
+
+
+/*! @methodgroup Network Conditions */
+
+/*!
+ @abstract The network conditions under which the receiver delivers its responses.
+ @discussion If nil, the network conditions of the mock registry that is servicing the request are used, if any.
+     Under network conditions, the response is sent after the conditions' latency and the body is paced at their
+     downstream rate, overriding the delay between chunks. Error responders ignore network conditions, though they
+     honor a latency model. nil by default.
+ */
+@property (nonatomic, strong, nullable) UMKNetworkConditions *networkConditions;
+
+
+/*! @methodgroup Latency */
+
+/*!
+ @abstract The model from which the receiver samples the time to the first byte of each response.
+ @discussion A latency is sampled for every request the receiver responds to. The response, or the error for error
+     responders, is delivered once that much time has passed, overriding the latency of any network conditions. The
+     wait is scheduled on the mock registry's UMKVirtualClock rather than slept, so any number of delayed responses
+     can be outstanding without tying up threads. nil by default.
+ */
+@property (nonatomic, strong, nullable) UMKLatencyModel *latencyModel;
+
+
+/*! @methodgroup Content Encoding */
+
+/*!
+ @abstract The encoding with which the receiver compresses the bodies of its responses.
+ @discussion When this isn't UMKMockHTTPContentEncodingIdentity, data responders send their non-empty bodies
+     compressed with it, add a matching Content-Encoding header, and replace any Content-Length header with the
+     compressed length. The body is compressed the first time it is needed after it or the encoding changes, and the
+     compressed bytes are reused by every response after that. Chunking and network shaping apply to the compressed
+     bytes, as they would on a real connection. The NSURL system doesn't decode bodies delivered by URL protocols, so
+     clients receive the compressed bytes and exercise their own decompression.
+
+     Precompressed bodies are sent as they are. Error and streaming responders ignore this property.
+     UMKMockHTTPContentEncodingIdentity by default.
+ */
+@property (nonatomic) UMKMockHTTPContentEncoding contentEncoding;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,384 @@
+//
+//  UMKMockRegistry.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class UMKMockRequestStatistics, UMKNetworkConditions, UMKRequestJournal, UMKVirtualClock;
+@protocol UMKMockURLRequest;
+
+/*!
+ @abstract Constants that indicate what happened to cause a mock registry event.
+ @constant UMKMockRegistryEventKindServiced A request was matched to a mock request that will service it.
+ @constant UMKMockRegistryEventKindUnexpected A request did not match any expected mock request.
+ @constant UMKMockRegistryEventKindFinishedResponse The response to a request finished, either successfully or with an
+     error.
+ */
+typedef NS_ENUM(NSInteger, UMKMockRegistryEventKind) {
+    UMKMockRegistryEventKindServiced,
+    UMKMockRegistryEventKindUnexpected,
+    UMKMockRegistryEventKindFinishedResponse
+};
+
+
+/*!
+ UMKMockRegistryEvents describe things that happen to the requests received by a mock registry. They are sent to
+ the registry's event observers.
+ */
+@interface UMKMockRegistryEvent : NSObject
+
+/*! What happened. */
+@property (nonatomic, assign, readonly) UMKMockRegistryEventKind kind;
+
+/*! The request the event is about. */
+@property (nonatomic, strong, readonly) NSURLRequest *request;
+
+/*! The mock request that is servicing the request, or nil if the request was unexpected. */
+@property (nonatomic, strong, readonly, nullable) id<UMKMockURLRequest> mockRequest;
+
+/*! For finished response events, the error with which the response failed, if any. nil otherwise. */
+@property (nonatomic, strong, readonly, nullable) NSError *error;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Initializes a newly allocated event with the specified kind, request, mock request, and error.
+ @param kind What happened.
+ @param request The request the event is about. May not be nil.
+ @param mockRequest The mock request that is servicing the request. Must be non-nil for serviced events.
+ @param error The error with which the response failed, if any.
+ @result An initialized event.
+ */
+- (instancetype)initWithKind:(UMKMockRegistryEventKind)kind
+                     request:(NSURLRequest *)request
+                 mockRequest:(nullable id<UMKMockURLRequest>)mockRequest
+                       error:(nullable NSError *)error NS_DESIGNATED_INITIALIZER;
+
+@end
+
+
+/*!
+ UMKMockRegistry objects hold a set of expected mock requests along with the accounting information needed to verify
+ that they were serviced as expected: the unexpected requests that were received, the requests that were serviced,
+ and whether verification is enabled.
+ 
+ UMKMockURLProtocol's class methods operate on the default registry. Other registries are completely independent of 
+ it and of each other, so tests that run in parallel within a single process can each use their own registry without
+ sharing expectations or verification results. Each registry has its own UMKMockURLProtocol subclass, which is bound
+ to the registry and can be added to an NSURLSessionConfiguration's protocol classes using
+ -registerWithSessionConfiguration:.
+
+ Registries are thread-safe.
+ */
+@interface UMKMockRegistry : NSObject
+
+/*!
+ @abstract Returns the default registry.
+ @discussion This is the registry used by UMKMockURLProtocol's class methods and by sessions that use 
+     UMKMockURLProtocol itself.
+ @result The default registry.
+ */
++ (UMKMockRegistry *)defaultRegistry;
+
+/*!
+ @abstract The UMKMockURLProtocol subclass that responds to requests using the receiver's expected mock requests.
+ @discussion For the default registry, this is UMKMockURLProtocol. For other registries, it is a subclass that is 
+     created the first time this property is accessed. The subclass only holds a weak reference to the registry, so
+     registries should outlive any sessions that use their protocol class.
+ */
+@property (nonatomic, readonly) Class protocolClass;
+
+/*!
+ @abstract Adds the receiver's protocol class to the front of the specified session configuration's protocol classes.
+ @discussion Sessions created with the configuration will use the receiver's expected mock requests. 
+ @param configuration The session configuration. May not be nil.
+ */
+- (void)registerWithSessionConfiguration:(NSURLSessionConfiguration *)configuration;
+
+/*!
+ @abstract Removes all expected mock requests and information about unexpected and serviced requests.
+ @discussion Due to the asynchronous nature of URL loading, care should be taken to ensure that there are no
+     connections using the receiver in progress when this method is invoked. 
+ */
+- (void)reset;
+
+
+/*! @methodgroup Getting and setting expectations */
+
+/*! The receiver's expected mock requests, in the order in which they were added. */
+@property (nonatomic, copy, readonly) NSArray<id<UMKMockURLRequest>> *expectedMockRequests;
+
+/*!
+ @abstract Adds the specified mock request to the receiver's expected mock requests.
+ @param request The mock request to expect. May not be nil.
+ */
+- (void)expectMockRequest:(id<UMKMockURLRequest>)request;
+
+/*!
+ @abstract Adds the specified mock requests to the receiver's expected mock requests in order.
+ @discussion The mock requests are added atomically: readers see either none of them or all of them.
+ @param requests The mock requests to expect. May not be nil.
+ */
+- (void)expectMockRequests:(NSArray<id<UMKMockURLRequest>> *)requests;
+
+/*!
+ @abstract Removes the specified mock request from the receiver's expected mock requests.
+ @param request The mock request to remove.
+ */
+- (void)removeExpectedMockRequest:(id<UMKMockURLRequest>)request;
+
+/*!
+ @abstract Removes the specified mock requests from the receiver's expected mock requests.
+ @discussion The mock requests are removed atomically: readers see either all of them or none of them.
+ @param requests The mock requests to remove. May not be nil.
+ */
+- (void)removeExpectedMockRequests:(NSArray<id<UMKMockURLRequest>> *)requests;
+
+
+/*! @methodgroup Verification */
+
+/*!
+ @abstract Whether verification is enabled for the receiver.
+ @discussion NO by default. See +[UMKMockURLProtocol setVerificationEnabled:] for more information on what enabling 
+     verification means.
+ */
+@property (assign, getter=isVerificationEnabled) BOOL verificationEnabled;
+
+/*!
+ @abstract The number of requests the receiver has received that did not match any expected mock request.
+ @discussion This is kept up to date as requests are received, so it can be read from any thread in constant time.
+ */
+@property (nonatomic, assign, readonly) NSUInteger unexpectedRequestCount;
+
+/*!
+ @abstract The number of the receiver's expected mock requests that have not serviced a request.
+ @discussion Mock requests are only counted as serviced while verification is enabled. Like unexpectedRequestCount,
+     this is kept up to date as requests are serviced and expectations change, so it can be read from any thread in
+     constant time.
+ */
+@property (nonatomic, assign, readonly) NSUInteger unservicedMockRequestCount;
+
+/*!
+ @abstract Verifies that the receiver's mock requests are being serviced as expected.
+ @discussion Behaves exactly like +[UMKMockURLProtocol verifyWithError:], but only considers the receiver's mock 
+     requests and the requests it has received. Verification only checks the receiver's unexpectedRequestCount and
+     unservicedMockRequestCount, so it takes constant time when it succeeds. Errors are only created when it fails.
+ @param outError If an error occurs, upon return contains an NSError object that describes the problem.
+ @throws NSInternalInconsistencyException if verification is not enabled.
+ @result Whether verification succeeded.
+ */
+- (BOOL)verifyWithError:(NSError * _Nullable * _Nullable)outError;
+
+/*! 
+ @abstract The unexpected requests the receiver has received since it was last reset. 
+ @discussion This includes every unexpected request unless retainedRequestLimit has been lowered, in which case it 
+     only includes the most recent ones. It is always empty if retainsRequests is NO.
+ */
+@property (nonatomic, copy, readonly) NSArray<NSURLRequest *> *unexpectedRequests;
+
+/*! 
+ @abstract The requests the receiver has serviced since it was last reset. 
+ @discussion The keys in this dictionary are the actual requests that were serviced; the values are the mock
+     requests that serviced them. This includes every serviced request unless retainedRequestLimit has been lowered, 
+     in which case it only includes the most recent ones. It is always empty if retainsRequests is NO.
+ */
+@property (nonatomic, copy, readonly) NSDictionary<NSURLRequest *, id<UMKMockURLRequest>> *servicedRequests;
+
+/*!
+ @abstract Whether the receiver retains the requests it services and the unexpected requests it receives.
+ @discussion YES by default. Retained requests are kept along with their bodies until the receiver is reset or, if 
+     retainedRequestLimit has been lowered, until that many newer requests of the same kind have been retained. Tests that only need request histories 
+     may want to set this to NO and rely on the receiver's journal instead. Verification does not depend on retained 
+     requests. When not every unexpected request was retained, verification errors include the journal's records of
+     unexpected requests instead.
+ */
+@property (assign) BOOL retainsRequests;
+
+/*!
+ @abstract The maximum number of serviced requests and the maximum number of unexpected requests that the receiver 
+     retains.
+ @discussion NSUIntegerMax by default, so every request is retained until the receiver is reset. Lower it to bound the 
+     memory used by long-running tests; the receiver's journal and counts are unaffected. Once the limit is reached, 
+     the oldest retained request of the same kind is released whenever a new one is retained.
+ */
+@property (assign) NSUInteger retainedRequestLimit;
+
+/*!
+ @abstract The receiver's request journal.
+ @discussion The receiver adds a record to its journal for every request it services while verification is enabled
+     and every unexpected request it receives, regardless of whether it retains the requests themselves. Because 
+     requests are only intercepted without a matching mock request while verification is enabled, unexpected requests 
+     are normally only received then. By default, this is a journal with a capacity of 1024 records and a byte budget
+     of 1 MB. Set it to a journal with different limits to change how many records are retained. The journal is 
+     cleared when the receiver is reset.
+ */
+@property (strong) UMKRequestJournal *journal;
+
+
+/*! @methodgroup Statistics */
+
+/*!
+ @abstract Whether the receiver collects statistics for the mock requests it is asked to expect.
+ @discussion NO by default. This only affects mock requests that are expected while it is YES; statistics for mock 
+     requests that were expected earlier continue to be collected, and mock requests expected while it is NO never 
+     have statistics. Collecting statistics adds two clock reads and a few atomic operations each time a mock request
+     is evaluated as a candidate for a URL request, but never takes a lock.
+ */
+@property (assign, getter=isStatisticsEnabled) BOOL statisticsEnabled;
+
+/*!
+ @abstract Returns the statistics the receiver has collected for the specified mock request.
+ @param mockRequest The mock request. May not be nil.
+ @result The mock request's statistics, or nil if the receiver has not collected statistics for it since it was 
+     last reset.
+ */
+- (nullable UMKMockRequestStatistics *)statisticsForMockRequest:(id<UMKMockURLRequest>)mockRequest;
+
+/*!
+ @abstract The statistics the receiver has collected since it was last reset, in the order in which their mock 
+     requests were first expected.
+ @discussion Statistics are kept for mock requests that are no longer expected until the receiver is reset.
+ */
+@property (nonatomic, copy, readonly) NSArray<UMKMockRequestStatistics *> *mockRequestStatistics;
+
+
+/*! @methodgroup Network conditions */
+
+/*!
+ @abstract The network conditions under which responses to the receiver's requests are delivered.
+ @discussion Responders with their own network conditions use those instead. Changes only affect responses that start
+     after the change. Network conditions are not cleared when the receiver is reset. nil by default.
+ */
+@property (strong, nullable) UMKNetworkConditions *networkConditions;
+
+
+/*! @methodgroup Timing */
+
+/*!
+ @abstract The clock that times the delays of responses to the receiver's requests.
+ @discussion If nil, +[UMKVirtualClock defaultClock] is used. Use a manual or as-fast-as-possible clock to deliver
+     delayed responses without waiting for the delays in real time. Changes only affect responses that start after the
+     change. The clock is not cleared when the receiver is reset. nil by default.
+ */
+@property (strong, nullable) UMKVirtualClock *clock;
+
+
+/*! @methodgroup Observing events */
+
+/*!
+ @abstract Adds a block that is invoked with each of the receiver's events.
+ @discussion Serviced and unexpected events are published when the protocol instance for a request is created; 
+     finished response events are published once the response has been completely delivered or has failed. Events
+     are published regardless of whether verification is enabled. Observer blocks are invoked synchronously on the 
+     URL loading system's threads, so they should return quickly.
+ @param block The block to invoke. May not be nil.
+ @result An opaque object that can be passed to -removeEventObserver: to remove the observer.
+ */
+- (id<NSObject>)addEventObserverUsingBlock:(void (^)(UMKMockRegistryEvent *event))block;
+
+/*!
+ @abstract Removes the specified event observer.
+ @param observer An object returned by -addEventObserverUsingBlock:.
+ */
+- (void)removeEventObserver:(id<NSObject>)observer;
+
+/*!
+ @abstract Returns the number of requests the specified mock request has serviced since the receiver was last reset.
+ @param mockRequest The mock request. May not be nil.
+ @result The number of requests the mock request has serviced.
+ */
+- (NSUInteger)serviceCountForMockRequest:(id<UMKMockURLRequest>)mockRequest;
+
+/*! The number of responses that have finished since the receiver was last reset. */
+@property (nonatomic, assign, readonly) NSUInteger finishedResponseCount;
+
+
+/*! @methodgroup Waiting for events */
+
+/*!
+ @abstract Blocks the calling thread until the specified mock request has serviced at least the specified number of
+     requests or the timeout elapses.
+ @discussion Waiting threads sleep until the receiver publishes an event, so waiting does not consume CPU time or 
+     poll. Because responses are delivered on the URL loading system's threads, this method should not be invoked 
+     on a thread whose run loop must run for requests to be made, e.g., the thread on which an NSURLConnection was 
+     scheduled. Use -waitForMockRequest:serviceCount:timeout:completionHandler: in that case.
+ @param mockRequest The mock request. May not be nil.
+ @param serviceCount The number of requests the mock request must service.
+ @param timeout The maximum amount of time to wait.
+ @result Whether the mock request serviced the specified number of requests before the timeout elapsed.
+ */
+- (BOOL)waitForMockRequest:(id<UMKMockURLRequest>)mockRequest serviceCount:(NSUInteger)serviceCount timeout:(NSTimeInterval)timeout;
+
+/*!
+ @abstract Invokes the specified completion handler once the specified mock request has serviced at least the
+     specified number of requests or the timeout elapses.
+ @discussion The completion handler is invoked on a global concurrent queue.
+ @param mockRequest The mock request. May not be nil.
+ @param serviceCount The number of requests the mock request must service.
+ @param timeout The maximum amount of time to wait.
+ @param completionHandler The completion handler, which is passed whether the mock request serviced the specified 
+     number of requests before the timeout elapsed. May not be nil.
+ */
+- (void)waitForMockRequest:(id<UMKMockURLRequest>)mockRequest
+              serviceCount:(NSUInteger)serviceCount
+                   timeout:(NSTimeInterval)timeout
+         completionHandler:(void (^)(BOOL serviced))completionHandler;
+
+/*!
+ @abstract Blocks the calling thread until every expected mock request has serviced a request or the timeout elapses.
+ @discussion Mock requests that are removed after servicing a request no longer count as expected. See 
+     -waitForMockRequest:serviceCount:timeout: for restrictions on the threads from which this may be invoked.
+ @param timeout The maximum amount of time to wait.
+ @result Whether every expected mock request serviced a request before the timeout elapsed.
+ */
+- (BOOL)waitForExpectedMockRequestsToBeServicedWithTimeout:(NSTimeInterval)timeout;
+
+/*!
+ @abstract Invokes the specified completion handler once every expected mock request has serviced a request or the 
+     timeout elapses.
+ @discussion The completion handler is invoked on a global concurrent queue.
+ @param timeout The maximum amount of time to wait.
+ @param completionHandler The completion handler, which is passed whether every expected mock request serviced a
+     request before the timeout elapsed. May not be nil.
+ */
+- (void)waitForExpectedMockRequestsToBeServicedWithTimeout:(NSTimeInterval)timeout completionHandler:(void (^)(BOOL serviced))completionHandler;
+
+/*!
+ @abstract Blocks the calling thread until at least the specified number of responses have finished since the
+     receiver was last reset or the timeout elapses.
+ @discussion See -waitForMockRequest:serviceCount:timeout: for restrictions on the threads from which this may be 
+     invoked.
+ @param finishedResponseCount The number of responses that must finish.
+ @param timeout The maximum amount of time to wait.
+ @result Whether the specified number of responses finished before the timeout elapsed.
+ */
+- (BOOL)waitForFinishedResponseCount:(NSUInteger)finishedResponseCount timeout:(NSTimeInterval)timeout;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,99 @@
+//
+//  UMKMockRequestStatistics.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import <Foundation/Foundation.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class UMKLatencyHistogram;
+@protocol UMKMockURLRequest;
+
+/*!
+ UMKMockRequestStatistics record how a mock registry uses one of its expected mock requests: how often the mock 
+ request was evaluated as a candidate for a URL request and how long that took, how often it matched, and how long 
+ its responder took to deliver its responses. They are useful for finding the mock requests and matching blocks that
+ slow down a large test suite.
+
+ Registries only collect statistics for mock requests that are expected while their statisticsEnabled property is YES.
+ Every occurrence of a mock request in a registry shares the same statistics. Statistics are updated using atomic
+ operations only, so collecting them never takes a lock on the request path.
+ */
+@interface UMKMockRequestStatistics : NSObject
+
+/*! The mock request that the statistics are about. */
+@property (nonatomic, strong, readonly) id<UMKMockURLRequest> mockRequest;
+
+/*!
+ @abstract The number of times the mock request matched a URL request that was then serviced.
+ @discussion Lookups that only probe whether a URL request can be handled, like +canInitWithRequest:, are not
+     counted, so this doesn't depend on how often the URL loading system probes or on whether verification is enabled.
+ */
+@property (nonatomic, assign, readonly) NSUInteger matchCount;
+
+/*!
+ @abstract The number of times the mock request was evaluated as a candidate for a URL request that was then serviced.
+ @discussion This includes evaluations that did not result in a match. Mock requests that the registry's index rules
+     out without invoking -matchesURLRequest: are not evaluated. As with matchCount, probes are not counted.
+ */
+@property (nonatomic, assign, readonly) NSUInteger evaluationCount;
+
+/*! The time spent evaluating whether the mock request matched URL requests, one duration per evaluation. */
+@property (nonatomic, strong, readonly) UMKLatencyHistogram *matchingTimeHistogram;
+
+/*!
+ @abstract The time from when the mock request's responder started responding until it delivered its response.
+ @discussion This is measured to the first response, data, or error the responder delivered to the URL loading system.
+ */
+@property (nonatomic, strong, readonly) UMKLatencyHistogram *timeToFirstByteHistogram;
+
+/*! The time from when the mock request's responder started responding until it finished responding or failed. */
+@property (nonatomic, strong, readonly) UMKLatencyHistogram *responseDurationHistogram;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Initializes newly allocated statistics for the specified mock request.
+ @param mockRequest The mock request. May not be nil.
+ @result Initialized statistics with no recorded activity.
+ */
+- (instancetype)initWithMockRequest:(id<UMKMockURLRequest>)mockRequest NS_DESIGNATED_INITIALIZER;
+
+/*!
+ @abstract Records that the mock request was evaluated as a candidate for a URL request.
+ @param duration How long the evaluation took, in nanoseconds.
+ */
+- (void)recordEvaluationWithDuration:(uint64_t)duration;
+
+/*!
+ @abstract Records that the mock request matched a URL request.
+ */
+- (void)recordMatch;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,105 @@
+//
+//  UMKMockSequenceResponder.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import <URLMock/UMKMockURLProtocol.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @abstract Constants that indicate how a sequence responder responds once every response in its sequence is used.
+ @constant UMKMockSequenceResponderExhaustionBehaviorStop Further requests fail with an error whose domain is
+     kUMKErrorDomain and whose code is kUMKMockSequenceExhaustedErrorCode.
+ @constant UMKMockSequenceResponderExhaustionBehaviorRepeatLast Further requests are responded to by the last
+     responder in the sequence.
+ @constant UMKMockSequenceResponderExhaustionBehaviorWrapAround The sequence starts over from the first responder.
+ */
+typedef NS_ENUM(NSInteger, UMKMockSequenceResponderExhaustionBehavior) {
+    UMKMockSequenceResponderExhaustionBehaviorStop = 0,
+    UMKMockSequenceResponderExhaustionBehaviorRepeatLast,
+    UMKMockSequenceResponderExhaustionBehaviorWrapAround
+};
+
+
+/*!
+ UMKMockSequenceResponders respond to successive requests with successive responders from a sequence, which makes
+ them useful for testing polling and retry logic. For example, a sequence of two responders that respond with a 503
+ followed by one that responds with a 200 simulates a service that recovers on the third attempt.
+
+ Each request claims the next position in the sequence by atomically incrementing a cursor, so a sequence responder
+ can be shared by any number of concurrent requests without locking, and no two requests ever claim the same
+ position. The order in which concurrent requests claim positions is the order in which they start loading.
+
+ The same responder may appear in a sequence more than once. Responders in the sequence should be able to respond to
+ several requests at once if the sequence responder may be used concurrently; UMKMockHTTPResponders can.
+ */
+@interface UMKMockSequenceResponder : NSObject <UMKMockURLResponder>
+
+/*! The responders in the instance's sequence, in the order in which they respond. */
+@property (nonatomic, copy, readonly) NSArray<id<UMKMockURLResponder>> *responders;
+
+/*! How the instance responds once its sequence is exhausted. */
+@property (nonatomic, assign, readonly) UMKMockSequenceResponderExhaustionBehavior exhaustionBehavior;
+
+/*! The number of requests to which the instance has responded since it was created or last reset. */
+@property (nonatomic, assign, readonly) NSUInteger responseCount;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Returns a new sequence responder with the specified responders that stops once they are exhausted.
+ @param responders The responders in the sequence. May not be nil or empty.
+ @result A new sequence responder with the specified responders.
+ */
++ (instancetype)sequenceResponderWithResponders:(NSArray<id<UMKMockURLResponder>> *)responders;
+
+/*!
+ @abstract Initializes a newly allocated sequence responder with the specified responders and exhaustion behavior.
+ @param responders The responders in the sequence. May not be nil or empty.
+ @param exhaustionBehavior How the instance responds once the sequence is exhausted.
+ @result An initialized sequence responder.
+ */
+- (instancetype)initWithResponders:(NSArray<id<UMKMockURLResponder>> *)responders
+                exhaustionBehavior:(UMKMockSequenceResponderExhaustionBehavior)exhaustionBehavior NS_DESIGNATED_INITIALIZER;
+
+/*!
+ @abstract Returns the responder that will respond to the request at the specified position in the sequence.
+ @param index The zero-based position of the request, counting from when the receiver was created or last reset.
+ @result The responder for the request at the specified position, or nil if the request will fail because the
+     sequence is exhausted.
+ */
+- (nullable id<UMKMockURLResponder>)responderForResponseAtIndex:(NSUInteger)index;
+
+/*!
+ @abstract Restarts the receiver's sequence from the first responder.
+ @discussion Responses already in progress are not affected.
+ */
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
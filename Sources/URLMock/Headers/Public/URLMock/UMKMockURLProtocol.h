@@ -35,6 +35,15 @@ extern NSString *const kUMKErrorDomain;
 /*! The key used in NSError userInfo dictionaries whose value is an array of unexpected requests. */
 extern NSString *const kUMKUnexpectedRequestsKey;
 
+/*! The key used in NSError userInfo dictionaries whose value is an NSNumber containing the number of unexpected requests. */
+extern NSString *const kUMKUnexpectedRequestCountKey;
+
+/*! 
+ The key used in NSError userInfo dictionaries whose value is an array of UMKRequestJournalRecords for unexpected 
+ requests. This is used when not every unexpected request was retained.
+ */
+extern NSString *const kUMKUnexpectedRequestRecordsKey;
+
 /*! The key used in NSError userInfo dictionaries whose value is an array of unserviced mock requests. */
 extern NSString *const kUMKUnservicedMockRequestsKey;
 
@@ -45,14 +54,25 @@ typedef NS_ENUM(NSInteger, UMKErrorCode) {
 
     /*! Indicates an error due to an unserviced mock request. */
     kUMKUnservicedMockRequestErrorCode = 1002,
+
+    /*! Indicates an error due to a request made after a sequence responder's responses were exhausted. */
+    kUMKMockSequenceExhaustedErrorCode = 1003,
+
+    /*! Indicates an error due to a single-use streaming responder being asked to respond more than once. */
+    kUMKSingleUseResponderReusedErrorCode = 1004,
 };
 
 
-@protocol UMKMockURLRequest, UMKMockURLResponder;
+@class UMKMockRegistry, UMKMockRequestStatistics, UMKNetworkConditions, UMKRequestMatchContext;
+@protocol UMKMockURLRequest, UMKMockURLResponder, UMKRequestJournalSink;
 
 /*!
  UMKMockURLProtocol is the primary class in the URLMock framework. It has methods for enabling and disabling
  mock responses, adding and removing expected mock requests, and configuring the behavior of the framework.
+
+ The class methods for working with expectations and verification operate on the protocol's mock registry. For
+ UMKMockURLProtocol itself, that is the default registry. Each UMKMockRegistry has its own subclass of 
+ UMKMockURLProtocol, whose class methods operate on that registry instead.
  */
 @interface UMKMockURLProtocol : NSURLProtocol
 
@@ -66,6 +86,14 @@ typedef NS_ENUM(NSInteger, UMKErrorCode) {
  */
 + (void)disable;
 
+/*!
+ @abstract Returns the mock registry whose expected mock requests the protocol uses.
+ @discussion For UMKMockURLProtocol, this is +[UMKMockRegistry defaultRegistry]. Subclasses created by mock registries
+     return the registry that created them, or nil if that registry has been deallocated.
+ @result The protocol's mock registry.
+ */
++ (nullable UMKMockRegistry *)mockRegistry;
+
 /*!
  @abstract Removes all expected mock requests and information about unexpected and serviced requests.
  @discussion Due to the asynchronous nature of URL loading, care should be taken to ensure that there are no
@@ -90,6 +118,14 @@ typedef NS_ENUM(NSInteger, UMKErrorCode) {
  */
 + (void)expectMockRequest:(id<UMKMockURLRequest>)request;
 
+/*!
+ @abstract Adds the specified mock requests to the protocol's set of expected mock requests in order.
+ @discussion This is equivalent to invoking +expectMockRequest: with each mock request, but is much faster when
+     registering large numbers of mock requests, as the expected mock requests are only updated once.
+ @param requests The mock requests to expect. May not be nil.
+ */
++ (void)expectMockRequests:(NSArray<id<UMKMockURLRequest>> *)requests;
+
 /*!
  @abstract Removes the specified mock request from the protocol's set of expected mock requests.
  @discussion This is how mock requests are unregistered from the mock protocol.
@@ -97,6 +133,14 @@ typedef NS_ENUM(NSInteger, UMKErrorCode) {
  */
 + (void)removeExpectedMockRequest:(id<UMKMockURLRequest>)request;
 
+/*!
+ @abstract Removes the specified mock requests from the protocol's set of expected mock requests.
+ @discussion This is equivalent to invoking +removeExpectedMockRequest: with each mock request, but the expected
+     mock requests are only scanned and updated once.
+ @param requests The mock requests to remove. May not be nil.
+ */
++ (void)removeExpectedMockRequests:(NSArray<id<UMKMockURLRequest>> *)requests;
+
 
 /*! @methodgroup Verification */
 
@@ -127,8 +171,10 @@ typedef NS_ENUM(NSInteger, UMKErrorCode) {
      Invoking it otherwise will raise an exception.
  @param outError If an error occurs, upon return contains an NSError object that describes the problem.
      If verification fails because unexpected requests were received, those requests are accessible in the error
-     object's userInfo dictionary via the kUMKUnexpectedRequestsKey key. If there were any unserviced mock 
-     requests, they are accessible via the kUMKUnservicedMockRequestsKey key.
+     object's userInfo dictionary via the kUMKUnexpectedRequestsKey key, and their exact number via the 
+     kUMKUnexpectedRequestCountKey key. If not every unexpected request was retained, the journal records for the 
+     unexpected requests are accessible via the kUMKUnexpectedRequestRecordsKey key. If there were any unserviced 
+     mock requests, they are accessible via the kUMKUnservicedMockRequestsKey key.
  @throws NSInternalInconsistencyException if verification is not enabled.
  @result Whether verification succeeded.
  */
@@ -148,6 +194,73 @@ typedef NS_ENUM(NSInteger, UMKErrorCode) {
  */
 + (NSDictionary<NSURLRequest *, id<UMKMockURLRequest>> *)servicedRequests;
 
+/*!
+ @abstract Returns the sink of the default registry's request journal.
+ @result The sink of the default registry's request journal.
+ */
++ (nullable id<UMKRequestJournalSink>)requestJournalSink;
+
+/*!
+ @abstract Sets the sink of the default registry's request journal.
+ @discussion While verification is enabled, the sink is sent a record of every request that is serviced and every
+     unexpected request that is received, even after the journal has evicted those records. To keep a complete request
+     history on disk without holding it in memory, use a UMKNDJSONRequestJournalSink. The sink belongs to the journal,
+     so replacing the default registry's journal also replaces its sink.
+ @param sink The sink. If nil, records are not sent anywhere.
+ */
++ (void)setRequestJournalSink:(nullable id<UMKRequestJournalSink>)sink;
+
+
+/*! @methodgroup Statistics */
+
+/*!
+ @abstract Returns whether statistics are collected for mock requests when they are expected.
+ @discussion Set to NO by default. See -[UMKMockRegistry statisticsEnabled] for more information.
+ @result Whether statistics are collected.
+ */
++ (BOOL)isStatisticsEnabled;
+
+/*!
+ @abstract Enables or disables statistics collection for mock requests that are subsequently expected.
+ @discussion When enabled, each expected mock request records how often it was evaluated and matched, how long its 
+     matching took, and how long its responses took to start and finish in latency histograms. This can be used to 
+     find the mock requests and matching blocks that dominate a test suite's run time.
+ @param enabled Whether to enable statistics collection or not.
+ */
++ (void)setStatisticsEnabled:(BOOL)enabled;
+
+/*!
+ @abstract Returns the statistics collected for the specified mock request since the last reset.
+ @param mockRequest The mock request. May not be nil.
+ @result The mock request's statistics, or nil if none have been collected.
+ */
++ (nullable UMKMockRequestStatistics *)statisticsForMockRequest:(id<UMKMockURLRequest>)mockRequest;
+
+/*!
+ @abstract Returns all the statistics collected since the last reset, in the order in which their mock requests were
+     first expected.
+ @result The statistics collected since the last reset.
+ */
++ (NSArray<UMKMockRequestStatistics *> *)mockRequestStatistics;
+
+
+/*! @methodgroup Network conditions */
+
+/*!
+ @abstract Returns the network conditions under which responses are delivered by default.
+ @result The default registry's network conditions.
+ */
++ (nullable UMKNetworkConditions *)networkConditions;
+
+/*!
+ @abstract Sets the network conditions under which responses are delivered by default.
+ @discussion Responses are sent after the conditions' latency and their bodies are paced at the conditions' downstream
+     rate, so that a client's throughput and buffering can be measured under profiles such as
+     +[UMKNetworkConditions networkConditions3G]. Responders with their own network conditions use those instead.
+ @param networkConditions The network conditions. If nil, responses are delivered as quickly as their responders allow.
+ */
++ (void)setNetworkConditions:(nullable UMKNetworkConditions *)networkConditions;
+
 
 /*! @methodgroup Getting canonical URLs */
 
@@ -158,6 +271,40 @@ typedef NS_ENUM(NSInteger, UMKErrorCode) {
  */
 + (NSURL * _Nullable)canonicalURLForURL:(NSURL * _Nullable)URL;
 
+/*!
+ @abstract Returns the maximum number of canonical URLs that the protocol caches.
+ @discussion Canonicalizing a URL with a query requires parsing and re-encoding the query, so the results of
+     +canonicalURLForURL: are kept in a least-recently-used cache. The default capacity is 512.
+ @result The maximum number of canonical URLs that the protocol caches.
+ */
++ (NSUInteger)canonicalURLCacheCapacity;
+
+/*!
+ @abstract Sets the maximum number of canonical URLs that the protocol caches.
+ @discussion Setting the capacity empties the cache and resets its hit and miss counts.
+ @param capacity The maximum number of canonical URLs to cache. If 0, canonical URLs are not cached.
+ */
++ (void)setCanonicalURLCacheCapacity:(NSUInteger)capacity;
+
+/*!
+ @abstract Returns the number of times +canonicalURLForURL: found its result in the canonical URL cache.
+ @discussion URLs without queries are never cached and are not counted.
+ @result The number of canonical URL cache hits since the cache was last emptied.
+ */
++ (NSUInteger)canonicalURLCacheHitCount;
+
+/*!
+ @abstract Returns the number of times +canonicalURLForURL: did not find its result in the canonical URL cache.
+ @discussion URLs without queries are never cached and are not counted.
+ @result The number of canonical URL cache misses since the cache was last emptied.
+ */
++ (NSUInteger)canonicalURLCacheMissCount;
+
+/*!
+ @abstract Empties the canonical URL cache and resets its hit and miss counts.
+ */
++ (void)removeAllCachedCanonicalURLs;
+
 @end
 
 
@@ -186,6 +333,20 @@ typedef NS_ENUM(NSInteger, UMKErrorCode) {
 
 @optional
 
+/*!
+ @abstract Returns whether the receiver matches the specified URL request using the specified match context.
+ @discussion UMKMockURLProtocol sends this message instead of -matchesURLRequest: to instances of
+     UMKMockHTTPRequest, UMKPatternMatchingMockRequest, and their subclasses, unless a subclass overrides
+     -matchesURLRequest: but not this method. All other mock requests, including proxies and mock objects, are sent
+     -matchesURLRequest:. The same context is shared by every mock request that is matched against a given URL request, so mock requests
+     should get values like the request’s canonical URL and body from the context rather than computing them 
+     themselves. Implementations must return the same result as -matchesURLRequest: would for the same request.
+ @param request The URL request. May not be nil.
+ @param context The match context for the URL request. May not be nil.
+ @result Whether the receiver matches the specified URL request.
+ */
+- (BOOL)matchesURLRequest:(NSURLRequest *)request context:(UMKRequestMatchContext *)context;
+
 /*!
  @abstract Returns whether the receiver should be removed from UMKMockURLProtocol’s set of
      expected mock requests after servicing the specified request.
@@ -200,6 +361,33 @@ typedef NS_ENUM(NSInteger, UMKErrorCode) {
 @end
 
 
+#pragma mark -
+
+/*!
+ The UMKMockURLResponseSession protocol declares messages that a single response to a mock request must respond to.
+ Sessions hold all of the state of a response that is in progress, including whether it has been canceled, so that
+ the responder that created them can serve any number of concurrent requests without being modified.
+ */
+@protocol UMKMockURLResponseSession <NSObject>
+
+/*!
+ @abstract Starts the response.
+ @discussion The receiver should respond to this message by sending the client methods in the NSURLProtocolClient
+     protocol, either immediately or later on the run loop of the thread that sent it. This is sent at most once, on
+     the thread that is loading the request.
+ */
+- (void)start;
+
+/*!
+ @abstract Cancels the response.
+ @discussion After this returns, the receiver should send no further client methods. This may be sent from any
+     thread, and does nothing if the response has already finished or been canceled.
+ */
+- (void)cancel;
+
+@end
+
+
 #pragma mark -
 
 /*!
@@ -224,6 +412,35 @@ typedef NS_ENUM(NSInteger, UMKErrorCode) {
  */
 - (void)cancelResponse;
 
+@optional
+
+/*!
+ @abstract Cancels the receiver's response to the specified protocol object, leaving any other responses alone.
+ @discussion Responders that may respond on behalf of several protocol objects at once should implement this so that
+     one request being stopped doesn't cancel the others. When a protocol object stops loading, it sends this
+     message if its responder implements it, and -cancelResponse otherwise.
+ @param protocol The URL protocol whose response should be canceled. May not be nil.
+ */
+- (void)cancelResponseToProtocol:(NSURLProtocol *)protocol;
+
+/*!
+ @abstract Returns a new response session that responds to the specified mock request on behalf of the specified
+     protocol object.
+ @discussion Responders that implement this can be shared freely between concurrent requests. When a protocol object
+     starts loading, it sends this message if its responder implements it and starts the resulting session, rather
+     than sending -respondToMockRequest:client:protocol:. When it stops loading, it cancels its session instead of
+     sending the responder any cancellation messages, so stopping one request never affects any other.
+
+     The responder should not retain the session. Creating a session must not modify the responder.
+ @param request The mock request. May not be nil.
+ @param client The protocol client. May not be nil.
+ @param protocol The URL protocol. May not be nil.
+ @result A new response session that has not been started.
+ */
+- (id<UMKMockURLResponseSession>)responseSessionForMockRequest:(id<UMKMockURLRequest>)request
+                                                        client:(id<NSURLProtocolClient>)client
+                                                      protocol:(NSURLProtocol *)protocol;
+
 @end
 
 NS_ASSUME_NONNULL_END
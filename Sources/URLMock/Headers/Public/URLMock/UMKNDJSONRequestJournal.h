@@ -0,0 +1,136 @@
+//
+//  UMKNDJSONRequestJournal.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import <URLMock/UMKRequestJournal.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ UMKNDJSONRequestJournalSinks are request journal sinks that append each record they receive to a file as a line of
+ newline-delimited JSON (NDJSON). Each line is the record’s JSON object, as returned by -[UMKRequestJournalRecord
+ JSONObject].
+ 
+ Sinks never block the threads that add records on disk I/O. Serialized records are buffered in memory and written 
+ to the file in batches on a background queue, either when the buffer reaches the sink’s batch size or when the
+ sink’s flush interval has elapsed since the first unwritten record was received, whichever comes first.
+ 
+ Sinks are thread-safe.
+ */
+@interface UMKNDJSONRequestJournalSink : NSObject <UMKRequestJournalSink>
+
+/*! The URL of the file to which records are appended. */
+@property (nonatomic, copy, readonly) NSURL *fileURL;
+
+/*! The number of buffered bytes after which records are written to the file without waiting for the flush interval. */
+@property (nonatomic, assign, readonly) NSUInteger batchByteCount;
+
+/*! The maximum amount of time a record is buffered before it is written to the file. */
+@property (nonatomic, assign, readonly) NSTimeInterval flushInterval;
+
+/*! The number of records that have been written to the file. */
+@property (nonatomic, assign, readonly) NSUInteger writtenRecordCount;
+
+/*! The error that occurred the last time the sink failed to write to its file, or nil if no write has failed. */
+@property (nonatomic, strong, readonly, nullable) NSError *lastError;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Initializes a newly allocated sink that appends to the specified file with a batch size of 64 KB and a 
+     flush interval of 1 second.
+ @param fileURL The URL of the file to append to. The file is created if it does not exist. May not be nil.
+ @param outError If the file cannot be opened, upon return contains an NSError object that describes the problem.
+ @result An initialized sink, or nil if the file could not be opened.
+ */
+- (nullable instancetype)initWithFileURL:(NSURL *)fileURL error:(NSError * _Nullable * _Nullable)outError;
+
+/*!
+ @abstract Initializes a newly allocated sink that appends to the specified file with the specified batch size and
+     flush interval.
+ @param fileURL The URL of the file to append to. The file is created if it does not exist. May not be nil.
+ @param batchByteCount The number of buffered bytes after which records are written without waiting for the flush 
+     interval.
+ @param flushInterval The maximum amount of time a record is buffered before it is written to the file.
+ @param outError If the file cannot be opened, upon return contains an NSError object that describes the problem.
+ @result An initialized sink, or nil if the file could not be opened.
+ */
+- (nullable instancetype)initWithFileURL:(NSURL *)fileURL
+                          batchByteCount:(NSUInteger)batchByteCount
+                           flushInterval:(NSTimeInterval)flushInterval
+                                   error:(NSError * _Nullable * _Nullable)outError NS_DESIGNATED_INITIALIZER;
+
+/*!
+ @abstract Writes all buffered records to the file, blocking until they have been written.
+ @discussion This is intended to be invoked after a run completes, before its journal file is read.
+ */
+- (void)flush;
+
+/*!
+ @abstract Writes all buffered records to the file and closes it.
+ @discussion Records received after the sink is closed are discarded. Sinks close their files when they are 
+     deallocated, so this only needs to be invoked to close the file earlier.
+ */
+- (void)close;
+
+@end
+
+
+/*!
+ UMKNDJSONRequestJournalReaders read request journal records from files written by UMKNDJSONRequestJournalSinks.
+ Files are streamed rather than read into memory, so arbitrarily large journals can be analyzed.
+ */
+@interface UMKNDJSONRequestJournalReader : NSObject
+
+/*! The URL of the file from which records are read. */
+@property (nonatomic, copy, readonly) NSURL *fileURL;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Initializes a newly allocated reader that reads records from the specified file.
+ @param fileURL The URL of the file to read. May not be nil.
+ @result An initialized reader.
+ */
+- (instancetype)initWithFileURL:(NSURL *)fileURL NS_DESIGNATED_INITIALIZER;
+
+/*!
+ @abstract Invokes the specified block with each record in the receiver's file, in the order in which they were 
+     written.
+ @discussion Records are the JSON objects described in -[UMKRequestJournalRecord JSONObject]. Blank lines are 
+     skipped. A final line that is not terminated by a newline is parsed like any other, so a record that was only 
+     partially written results in an error rather than being dropped silently.
+ @param block The block to invoke with each record. Setting *stop to YES stops the enumeration. May not be nil.
+ @param outError If the file cannot be read or contains a malformed record, upon return contains an NSError object 
+     that describes the problem.
+ @result Whether the file was read without error. Records that precede an error are still passed to the block.
+ */
+- (BOOL)enumerateRecordsUsingBlock:(void (^)(NSDictionary<NSString *, id> *record, BOOL *stop))block
+                             error:(NSError * _Nullable * _Nullable)outError;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,134 @@
+//
+//  UMKNetworkConditions.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import <Foundation/Foundation.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ UMKNetworkConditions describe the link over which mock responses are delivered: how fast data flows downstream,
+ how long it takes for the first byte of a response to arrive, and how much that latency varies.
+
+ When a responder has network conditions, either its own or its mock registry's, it waits for the round-trip time
+ plus a sample of the jitter before sending its response, and paces its body's chunks with a token bucket that
+ refills at the downstream rate. Chunk sizes are reduced as needed so that throughput is smooth rather than bursty.
+ Jitter samples come from a pseudorandom generator seeded with the conditions' jitter seed, so the same conditions
+ always produce the same sequence of latencies.
+
+ Apart from their jitter generator, which any thread can advance without locking, network conditions are immutable
+ and can be shared among any number of responders and registries.
+ */
+@interface UMKNetworkConditions : NSObject <NSCopying>
+
+/*! The number of bytes per second that can be delivered downstream, or 0 if bandwidth is unlimited. */
+@property (nonatomic, assign, readonly) NSUInteger downstreamBytesPerSecond;
+
+/*! The base time between when a request is sent and when the first byte of its response arrives. */
+@property (nonatomic, assign, readonly) NSTimeInterval roundTripTime;
+
+/*! The maximum additional latency added to the round-trip time. Each response adds a value between 0 and this. */
+@property (nonatomic, assign, readonly) NSTimeInterval jitter;
+
+/*! The seed for the pseudorandom generator from which jitter is sampled. */
+@property (nonatomic, assign, readonly) uint64_t jitterSeed;
+
+/*!
+ @abstract The length of the chunks that bodies are broken into when they are delivered under these conditions.
+ @discussion This is about 20 ms worth of data at the downstream rate, but no less than 1 KB and no more than 64 KB.
+     It is NSUIntegerMax if bandwidth is unlimited.
+ */
+@property (nonatomic, assign, readonly) NSUInteger preferredChunkLength;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Initializes newly allocated network conditions with the specified parameters and a jitter seed of 0.
+ @param bytesPerSecond The number of bytes per second that can be delivered downstream, or 0 for unlimited bandwidth.
+ @param roundTripTime The base time to the first byte of a response. Must be non-negative.
+ @param jitter The maximum additional latency. Must be non-negative.
+ @result Initialized network conditions.
+ */
+- (instancetype)initWithDownstreamBytesPerSecond:(NSUInteger)bytesPerSecond
+                                   roundTripTime:(NSTimeInterval)roundTripTime
+                                          jitter:(NSTimeInterval)jitter;
+
+/*!
+ @abstract Initializes newly allocated network conditions with the specified parameters.
+ @param bytesPerSecond The number of bytes per second that can be delivered downstream, or 0 for unlimited bandwidth.
+ @param roundTripTime The base time to the first byte of a response. Must be non-negative.
+ @param jitter The maximum additional latency. Must be non-negative.
+ @param jitterSeed The seed for the pseudorandom generator from which jitter is sampled.
+ @result Initialized network conditions.
+ */
+- (instancetype)initWithDownstreamBytesPerSecond:(NSUInteger)bytesPerSecond
+                                   roundTripTime:(NSTimeInterval)roundTripTime
+                                          jitter:(NSTimeInterval)jitter
+                                      jitterSeed:(uint64_t)jitterSeed NS_DESIGNATED_INITIALIZER;
+
+
+/*! @methodgroup Profiles */
+
+/*!
+ @abstract Returns network conditions typical of a 3G cellular link.
+ @discussion 750 kbit/s downstream, a 100 ms round-trip time, and 20 ms of jitter.
+ @result Network conditions typical of a 3G link.
+ */
++ (instancetype)networkConditions3G;
+
+/*!
+ @abstract Returns network conditions typical of an LTE cellular link.
+ @discussion 12 Mbit/s downstream, a 50 ms round-trip time, and 10 ms of jitter.
+ @result Network conditions typical of an LTE link.
+ */
++ (instancetype)networkConditionsLTE;
+
+/*!
+ @abstract Returns network conditions typical of a Wi-Fi link.
+ @discussion 30 Mbit/s downstream, a 10 ms round-trip time, and 2 ms of jitter.
+ @result Network conditions typical of a Wi-Fi link.
+ */
++ (instancetype)networkConditionsWiFi;
+
+
+/*! @methodgroup Jitter */
+
+/*!
+ @abstract Returns the next jitter sample from the receiver's pseudorandom sequence.
+ @discussion Each response delivered under the receiver takes one sample. This may be invoked from any thread.
+ @result A jitter sample between 0 and the receiver's jitter.
+ */
+- (NSTimeInterval)sampleJitter;
+
+/*!
+ @abstract Restarts the receiver's jitter sequence from its jitter seed.
+ */
+- (void)resetJitter;
+
+@end
+
+NS_ASSUME_NONNULL_END
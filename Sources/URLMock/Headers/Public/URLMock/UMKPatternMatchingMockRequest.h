@@ -120,6 +120,17 @@ typedef _Nonnull id<UMKMockURLResponder>(^UMKParameterizedResponderGenerationBlo
  */
 - (instancetype)initWithURLPattern:(NSString *)URLPattern NS_DESIGNATED_INITIALIZER;
 
+/*!
+ @abstract Returns whether the receiver matches the specified URL request using the specified match context.
+ @discussion This behaves identically to -matchesURLRequest:, but gets the URL request’s uppercase HTTP method and
+     canonical URL from the context. If a subclass overrides -matchesURLRequest: but not this method, this method
+     invokes the subclass’s implementation of -matchesURLRequest:.
+ @param request The URL request.
+ @param context The match context for the URL request.
+ @result Whether the receiver matches the specified URL request.
+ */
+- (BOOL)matchesURLRequest:(NSURLRequest *)request context:(UMKRequestMatchContext *)context;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,214 @@
+//
+//  UMKRequestJournal.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class UMKRequestJournal, UMKRequestJournalRecord;
+@protocol UMKMockURLRequest;
+
+/*!
+ @abstract Constants that indicate why a request was recorded in a request journal.
+ @constant UMKRequestJournalRecordKindServiced The request was serviced by a mock request.
+ @constant UMKRequestJournalRecordKindUnexpected The request did not match any expected mock request.
+ */
+typedef NS_ENUM(NSInteger, UMKRequestJournalRecordKind) {
+    UMKRequestJournalRecordKindServiced,
+    UMKRequestJournalRecordKindUnexpected
+};
+
+
+/*!
+ UMKRequestJournalRecords are compact, immutable summaries of requests received by a mock registry. Rather than
+ retaining the request itself, a record holds its method and canonical URL along with digests of its headers and 
+ body, so that records stay small no matter how large the requests they describe are.
+ */
+@interface UMKRequestJournalRecord : NSObject
+
+/*! Why the request was recorded. */
+@property (nonatomic, assign, readonly) UMKRequestJournalRecordKind kind;
+
+/*! The request's HTTP method, in uppercase. */
+@property (nonatomic, copy, readonly) NSString *HTTPMethod;
+
+/*! The request's canonical URL, as returned by +[UMKMockURLProtocol canonicalURLForURL:]. */
+@property (nonatomic, strong, readonly, nullable) NSURL *canonicalURL;
+
+/*! 
+ @abstract A 64-bit FNV-1a digest of the request's header fields.
+ @discussion Header field names are compared case-insensitively, so requests with the same header fields have the 
+     same digest regardless of the case or order of their field names.
+ */
+@property (nonatomic, assign, readonly) uint64_t headerDigest;
+
+/*! The length of the request's HTTP body in bytes, or NSNotFound if the request's body is provided as a stream. */
+@property (nonatomic, assign, readonly) NSUInteger bodyLength;
+
+/*! A 64-bit FNV-1a hash of the request's HTTP body. This is 0 if the request's body is provided as a stream. */
+@property (nonatomic, assign, readonly) uint64_t bodyHash;
+
+/*! The mock request that serviced the request, or nil if the request was unexpected. */
+@property (nonatomic, strong, readonly, nullable) id<UMKMockURLRequest> mockRequest;
+
+/*! When the request was recorded, in seconds since the reference date. */
+@property (nonatomic, assign, readonly) NSTimeInterval timestamp;
+
+/*! 
+ @abstract The approximate number of bytes used by the record.
+ @discussion This is used by request journals to enforce their byte budgets.
+ */
+@property (nonatomic, assign, readonly) NSUInteger byteCount;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Initializes a newly allocated record that summarizes the specified request.
+ @discussion The request's body is only hashed if it is available as data. Body streams are never read, as doing so 
+     would make the body unavailable to the request's responder.
+ @param request The request to summarize. May not be nil.
+ @param kind Why the request is being recorded.
+ @param mockRequest The mock request that serviced the request, or nil if the request was unexpected.
+ @result An initialized record.
+ */
+- (instancetype)initWithURLRequest:(NSURLRequest *)request
+                              kind:(UMKRequestJournalRecordKind)kind
+                       mockRequest:(nullable id<UMKMockURLRequest>)mockRequest NS_DESIGNATED_INITIALIZER;
+
+/*!
+ @abstract Returns a JSON object that represents the record.
+ @discussion The object is a dictionary with the following keys:
+     <ul>
+       <li>"kind": "serviced" or "unexpected"</li>
+       <li>"method": The request's HTTP method</li>
+       <li>"url": The absolute string of the request's canonical URL, or null if it has none</li>
+       <li>"headerDigest": The header digest as a 16-digit hexadecimal string</li>
+       <li>"bodyLength": The body length, or null if the body was provided as a stream</li>
+       <li>"bodyHash": The body hash as a 16-digit hexadecimal string</li>
+       <li>"mockRequest": A string that identifies the mock request that serviced the request, or null if none did. 
+           The string contains the mock request's class and address, so it is only unique within a process.</li>
+       <li>"timestamp": The timestamp, in seconds since the Unix epoch</li>
+     </ul>
+     64-bit digests are represented as strings because many JSON parsers can’t represent them exactly as numbers.
+ @result A JSON object that represents the record.
+ */
+- (NSDictionary<NSString *, id> *)JSONObject;
+
+@end
+
+
+/*!
+ The UMKRequestJournalSink protocol declares a method that allows an object to receive every record added to a 
+ request journal, including records that the journal itself does not retain. Sinks can be used to persist a complete 
+ request history without keeping it in memory.
+ */
+@protocol UMKRequestJournalSink <NSObject>
+
+/*!
+ @abstract Tells the sink that the specified record was added to the specified journal.
+ @discussion This method is invoked on the thread that added the record, which is typically one of the URL loading 
+     system’s threads. Implementations should return quickly and must be thread-safe.
+ @param journal The journal to which the record was added.
+ @param record The record that was added.
+ */
+- (void)requestJournal:(UMKRequestJournal *)journal didAddRecord:(UMKRequestJournalRecord *)record;
+
+@end
+
+
+/*!
+ UMKRequestJournals are bounded, thread-safe logs of the requests received by a mock registry. A journal retains 
+ at most a fixed number of records and tries to keep their total size within a byte budget. When adding a record
+ would exceed either limit, the oldest records are evicted to make room for it.
+ 
+ Journals keep exact counts of every record ever added to them, even after those records have been evicted, so they
+ can be used to account for requests over long runs without growing without bound.
+ */
+@interface UMKRequestJournal : NSObject
+
+/*! The maximum number of records the journal retains. If 0, the journal only keeps counts. */
+@property (nonatomic, assign, readonly) NSUInteger capacity;
+
+/*! 
+ @abstract The maximum total size in bytes of the records the journal retains. 
+ @discussion The most recently added record is always retained, even if it alone exceeds the byte budget.
+ */
+@property (nonatomic, assign, readonly) NSUInteger byteBudget;
+
+/*! The records currently retained by the journal, from oldest to newest. */
+@property (nonatomic, copy, readonly) NSArray<UMKRequestJournalRecord *> *records;
+
+/*! The approximate total size in bytes of the records currently retained by the journal. */
+@property (nonatomic, assign, readonly) NSUInteger byteCount;
+
+/*! The number of records added to the journal since it was created or last cleared, including evicted ones. */
+@property (nonatomic, assign, readonly) NSUInteger totalRecordCount;
+
+/*! The number of serviced request records added to the journal since it was created or last cleared. */
+@property (nonatomic, assign, readonly) NSUInteger servicedRecordCount;
+
+/*! The number of unexpected request records added to the journal since it was created or last cleared. */
+@property (nonatomic, assign, readonly) NSUInteger unexpectedRecordCount;
+
+/*! The number of records evicted from the journal since it was created or last cleared. */
+@property (nonatomic, assign, readonly) NSUInteger evictedRecordCount;
+
+/*! 
+ @abstract The journal's sink, which is sent every record added to the journal. 
+ @discussion nil by default. The journal retains its sink.
+ */
+@property (strong, nullable) id<UMKRequestJournalSink> sink;
+
+/*!
+ @abstract Initializes a newly allocated journal with a capacity of 1024 records and a byte budget of 1 MB.
+ @result An initialized journal.
+ */
+- (instancetype)init;
+
+/*!
+ @abstract Initializes a newly allocated journal with the specified capacity and byte budget.
+ @param capacity The maximum number of records the journal retains.
+ @param byteBudget The maximum total size in bytes of the records the journal retains.
+ @result An initialized journal.
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity byteBudget:(NSUInteger)byteBudget NS_DESIGNATED_INITIALIZER;
+
+/*!
+ @abstract Adds the specified record to the journal, evicting the oldest records if necessary.
+ @discussion If the journal has a sink, the record is also sent to it.
+ @param record The record to add. May not be nil.
+ */
+- (void)addRecord:(UMKRequestJournalRecord *)record;
+
+/*!
+ @abstract Removes all records from the journal and resets its counts.
+ */
+- (void)removeAllRecords;
+
+@end
+
+NS_ASSUME_NONNULL_END
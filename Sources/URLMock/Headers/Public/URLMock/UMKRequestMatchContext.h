@@ -0,0 +1,91 @@
+//
+//  UMKRequestMatchContext.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import <Foundation/Foundation.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ UMKRequestMatchContext objects hold data derived from a URL request that mock requests commonly need when
+ determining whether they match it. Each value is computed the first time it is accessed and is then reused, so
+ that a URL request’s canonical URL is only computed once and its body is only read and parsed once, no matter how
+ many mock requests are matched against it.
+
+ UMKMockURLProtocol creates one context for each URL request it matches and passes it to every mock request that
+ implements -matchesURLRequest:context:. Match contexts are not thread-safe and should not be retained beyond the
+ matching pass for which they were created.
+ */
+@interface UMKRequestMatchContext : NSObject
+
+/*! The URL request from which the context's values are derived. */
+@property (nonatomic, strong, readonly) NSURLRequest *request;
+
+/*! The canonical version of the request's URL, as returned by +[UMKMockURLProtocol canonicalURLForURL:]. */
+@property (nonatomic, strong, readonly, nullable) NSURL *canonicalURL;
+
+/*! The absolute string of the request's canonical URL up to, but not including, its query string. */
+@property (nonatomic, copy, readonly, nullable) NSString *canonicalURLStringExcludingQuery;
+
+/*! The request's HTTP method in uppercase. */
+@property (nonatomic, copy, readonly, nullable) NSString *uppercaseHTTPMethod;
+
+/*! The request's HTTP header fields. */
+@property (nonatomic, copy, readonly, nullable) NSDictionary<NSString *, NSString *> *HTTPHeaderFields;
+
+/*! 
+ @abstract The request's body data. 
+ @discussion If the request has a body stream, it is read the first time this property is accessed.
+ */
+@property (nonatomic, copy, readonly, nullable) NSData *HTTPBodyData;
+
+/*! The object that results from parsing the request's body as JSON, or nil if the body is not valid JSON. */
+@property (nonatomic, strong, readonly, nullable) id JSONObjectFromHTTPBody;
+
+/*! The parameters that result from parsing the request's body as a UTF-8 WWW form URL encoded string. */
+@property (nonatomic, copy, readonly, nullable) NSDictionary<NSString *, id> *parametersFromURLEncodedHTTPBody;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Initializes a newly allocated match context for the specified URL request.
+ @discussion This is the class’s designated initializer. No values are computed until they are first accessed.
+ @param request The URL request. May not be nil.
+ @result An initialized match context.
+ */
+- (instancetype)initWithURLRequest:(NSURLRequest *)request NS_DESIGNATED_INITIALIZER;
+
+/*!
+ @abstract Returns the value of the specified header field of the request.
+ @discussion Header field names are compared case-insensitively.
+ @param field The header field name. May not be nil.
+ @result The value of the header field, or nil if the request has no value for it.
+ */
+- (NSString * _Nullable)valueForHTTPHeaderField:(NSString *)field;
+
+@end
+
+NS_ASSUME_NONNULL_END
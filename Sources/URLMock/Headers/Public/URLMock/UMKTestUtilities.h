@@ -234,7 +234,8 @@ extern NSError *UMKRandomError(void);
 /*!
  @abstract Waits no longer than the specified timeout interval for the given condition block to evaluate to YES.
  @discussion This method primarily exists as a helper for testing asynchronous operations. In this case, the condition
-     block should return YES when the operation has completed.
+     block should return YES when the operation has completed. Conditions are evaluated by polling. To wait for mock
+     registry events, like a mock request servicing a request, prefer UMKMockRegistry’s event-driven wait methods.
  @param timeoutInterval The time interval to wait for the condition block to return true. May not be negative.
  @param condition A block that returns true when a given condition has been fulfilled.
  @result YES if the condition block returned YES before the timeout; NO otherwise.
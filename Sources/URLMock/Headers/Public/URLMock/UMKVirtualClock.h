@@ -0,0 +1,133 @@
+//
+//  UMKVirtualClock.h
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import <Foundation/Foundation.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @abstract Constants that indicate how a clock's time advances.
+ @constant UMKVirtualClockModeRealTime Time advances with the system's uptime, and scheduled blocks run once their
+     delay has actually passed.
+ @constant UMKVirtualClockModeManual Time only advances when -advanceByTimeInterval: is invoked.
+ @constant UMKVirtualClockModeAsFastAsPossible Time jumps to the next scheduled block as soon as the work started by
+     the previous one has settled, so delays take no real time at all. Blocks scheduled from other threads are
+     relative to whatever time the clock has reached when they are scheduled.
+ */
+typedef NS_ENUM(NSInteger, UMKVirtualClockMode) {
+    UMKVirtualClockModeRealTime,
+    UMKVirtualClockModeManual,
+    UMKVirtualClockModeAsFastAsPossible
+};
+
+
+/*!
+ UMKVirtualClocks time every delay that mock responders impose: the latency before a response, the delay between
+ chunks, and the pacing of network conditions. By default, responders use a real-time clock, so delays take as long
+ as they say. Tests that would rather not wait can use a manual clock, which only advances when told to, or a clock
+ that advances as fast as possible. Either way, scheduled blocks run in the order their times imply, and blocks
+ scheduled for the same time run in the order they were scheduled.
+
+ Mock registries use their own clock if they have one and the default clock otherwise.
+ */
+@interface UMKVirtualClock : NSObject
+
+/*! How the clock's time advances. */
+@property (nonatomic, assign, readonly) UMKVirtualClockMode mode;
+
+/*! The number of seconds that have passed on the clock since it was created. */
+@property (nonatomic, assign, readonly) NSTimeInterval currentTime;
+
+/*! The number of scheduled blocks that have not yet run or been canceled. */
+@property (nonatomic, assign, readonly) NSUInteger scheduledBlockCount;
+
+/*!
+ @abstract Returns the clock that mock responders use when their registry doesn't have one.
+ @result The default clock. This is a real-time clock unless it has been replaced.
+ */
++ (UMKVirtualClock *)defaultClock;
+
+/*!
+ @abstract Sets the clock that mock responders use when their registry doesn't have one.
+ @discussion Changes only affect responses that start after the change.
+ @param clock The new default clock. If nil, the default clock is reset to a real-time clock.
+ */
++ (void)setDefaultClock:(nullable UMKVirtualClock *)clock;
+
+/*!
+ @abstract Initializes a newly allocated real-time clock.
+ @result An initialized real-time clock.
+ */
+- (instancetype)init;
+
+/*!
+ @abstract Initializes a newly allocated clock with the specified mode.
+ @param mode How the clock's time should advance.
+ @result An initialized clock whose current time is 0.
+ */
+- (instancetype)initWithMode:(UMKVirtualClockMode)mode NS_DESIGNATED_INITIALIZER;
+
+
+/*! @methodgroup Scheduling Blocks */
+
+/*!
+ @abstract Schedules the specified block to run once the specified amount of time has passed on the receiver.
+ @discussion The block runs on an unspecified thread: a private serial queue for real-time and as-fast-as-possible
+     clocks, and the thread that advances the clock for manual clocks. Blocks should be brief and hand any real work
+     off to wherever it needs to happen.
+ @param block The block to run. May not be nil.
+ @param delay How long to wait before running the block. Must be non-negative.
+ @result An opaque token that can be passed to -cancelScheduledBlock: to cancel the block.
+ */
+- (id)scheduleBlock:(dispatch_block_t)block afterDelay:(NSTimeInterval)delay;
+
+/*!
+ @abstract Cancels the scheduled block with the specified token.
+ @discussion Does nothing if the block has already run or been canceled.
+ @param token The token returned when the block was scheduled. May not be nil.
+ */
+- (void)cancelScheduledBlock:(id)token;
+
+
+/*! @methodgroup Advancing Manual Clocks */
+
+/*!
+ @abstract Advances a manual clock by the specified amount of time, running every block that comes due in order.
+ @discussion Each block runs with the clock's current time set to the block's scheduled time, and the clock waits
+     for the work each block hands off to settle before moving on. If that work was handed off to the current thread's 
+     run loop, the run loop is run until it's done; work handed off to other threads' run loops is left to those 
+     threads. Blocks that are scheduled along the way also run if they come due. If handed-off work doesn't finish 
+     within 10 seconds, for example because the thread whose run loop it was handed off to isn't running it, an 
+     assertion fails and the clock stops advancing. This must only be invoked on manual clocks.
+ @param interval The amount of time by which to advance the clock. Must be non-negative.
+ */
+- (void)advanceByTimeInterval:(NSTimeInterval)interval;
+
+@end
+
+NS_ASSUME_NONNULL_END
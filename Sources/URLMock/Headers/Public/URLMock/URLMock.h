@@ -28,10 +28,19 @@
 
 #import <URLMock/UMKMockURLProtocol.h>
 #import <URLMock/UMKMockURLProtocol+UMKHTTPConvenienceMethods.h>
+#import <URLMock/UMKMockRegistry.h>
+#import <URLMock/UMKRequestJournal.h>
+#import <URLMock/UMKNDJSONRequestJournal.h>
+#import <URLMock/UMKMockRequestStatistics.h>
+#import <URLMock/UMKRequestMatchContext.h>
 
 #import <URLMock/UMKMockHTTPMessage.h>
 #import <URLMock/UMKMockHTTPRequest.h>
 #import <URLMock/UMKMockHTTPResponder.h>
+#import <URLMock/UMKMockSequenceResponder.h>
+#import <URLMock/UMKNetworkConditions.h>
+#import <URLMock/UMKLatencyModel.h>
+#import <URLMock/UMKVirtualClock.h>
 
 #import <URLMock/UMKPatternMatchingMockRequest.h>
 
@@ -40,6 +49,7 @@
 #import <URLMock/NSURL+UMKQueryParameters.h>
 #import <URLMock/NSURLRequest+UMKHTTPConvenienceMethods.h>
 
+#import <URLMock/UMKLatencyHistogram.h>
 #import <URLMock/UMKMessageCountingProxy.h>
 #import <URLMock/UMKErrorUtilities.h>
 #import <URLMock/UMKTestUtilities.h>
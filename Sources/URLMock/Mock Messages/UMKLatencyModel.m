@@ -0,0 +1,479 @@
+//
+//  UMKLatencyModel.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import <URLMock/UMKLatencyModel.h>
+
+#import <URLMock/NSException+UMKSubclassResponsibility.h>
+
+#import "UMKSplitMix64.h"
+
+#import <stdatomic.h>
+#import <xlocale.h>
+
+
+#pragma mark Normal Distribution
+
+/*!
+ @abstract Returns the value below which the specified fraction of a standard normal distribution lies.
+ @discussion This uses Peter Acklam's rational approximation of the inverse normal CDF, which has a relative error of
+     less than 1.15e-9 everywhere.
+ @param p The fraction, between 0 and 1.
+ @result The standard normal quantile for p, or ±infinity if p is 0 or 1.
+ */
+static double UMKStandardNormalQuantile(double p)
+{
+    static const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+    static const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                6.680131188771972e+01, -1.328068155288572e+01 };
+    static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+    static const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                3.754408661907416e+00 };
+    static const double pLow = 0.02425;
+
+    if (p <= 0.0) {
+        return -INFINITY;
+    } else if (p >= 1.0) {
+        return INFINITY;
+    } else if (p < pLow) {
+        double q = sqrt(-2.0 * log(p));
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    } else if (p > 1.0 - pLow) {
+        double q = sqrt(-2.0 * log1p(-p));
+        return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+
+    double q = p - 0.5;
+    double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+}
+
+
+#pragma mark - Private Subclass Interfaces
+
+@interface UMKLatencyModel ()
+
+/*!
+ @abstract Initializes a newly allocated latency model with the specified seed.
+ @param seed The seed of the model's pseudorandom generator.
+ @result An initialized latency model.
+ */
+- (instancetype)initWithSeed:(uint64_t)seed NS_DESIGNATED_INITIALIZER;
+
++ (NSNumber *)percentileWithKey:(id)key;
++ (BOOL)percentileLatenciesAreValid:(NSDictionary<NSNumber *, NSNumber *> *)percentileLatencies;
+
+@end
+
+
+/*!
+ UMKFixedLatencyModels always produce the same latency.
+ */
+@interface UMKFixedLatencyModel : UMKLatencyModel
+
+/*! The latency the instance produces. */
+@property (nonatomic, assign, readonly) NSTimeInterval latency;
+
+- (instancetype)initWithLatency:(NSTimeInterval)latency;
+
+@end
+
+
+/*!
+ UMKUniformLatencyModels produce latencies that are uniformly distributed over a range.
+ */
+@interface UMKUniformLatencyModel : UMKLatencyModel
+
+/*! The minimum latency the instance produces. */
+@property (nonatomic, assign, readonly) NSTimeInterval minimumLatency;
+
+/*! The maximum latency the instance produces. */
+@property (nonatomic, assign, readonly) NSTimeInterval maximumLatency;
+
+- (instancetype)initWithMinimumLatency:(NSTimeInterval)minimumLatency maximumLatency:(NSTimeInterval)maximumLatency seed:(uint64_t)seed;
+
+@end
+
+
+/*!
+ UMKLognormalLatencyModels produce lognormally distributed latencies.
+ */
+@interface UMKLognormalLatencyModel : UMKLatencyModel
+
+/*! The median latency the instance produces. */
+@property (nonatomic, assign, readonly) NSTimeInterval medianLatency;
+
+/*! The standard deviation of the natural logarithm of the latencies the instance produces. */
+@property (nonatomic, assign, readonly) double sigma;
+
+- (instancetype)initWithMedianLatency:(NSTimeInterval)medianLatency sigma:(double)sigma seed:(uint64_t)seed;
+
+@end
+
+
+/*!
+ UMKEmpiricalLatencyModels produce latencies interpolated from a percentile table.
+ */
+@interface UMKEmpiricalLatencyModel : UMKLatencyModel
+
+/*! The instance's percentile table. */
+@property (nonatomic, copy, readonly) NSDictionary<NSNumber *, NSNumber *> *percentileLatencies;
+
+- (instancetype)initWithPercentileLatencies:(NSDictionary<NSNumber *, NSNumber *> *)percentileLatencies seed:(uint64_t)seed;
+
+@end
+
+
+#pragma mark - Base Class Implementation
+
+@implementation UMKLatencyModel {
+    /*! The state of the model's SplitMix64 generator. */
+    _Atomic(uint64_t) _state;
+}
+
++ (instancetype)fixedLatencyModelWithLatency:(NSTimeInterval)latency
+{
+    NSParameterAssert(latency >= 0.0);
+    return [[UMKFixedLatencyModel alloc] initWithLatency:latency];
+}
+
+
++ (instancetype)uniformLatencyModelWithMinimumLatency:(NSTimeInterval)minimumLatency
+                                       maximumLatency:(NSTimeInterval)maximumLatency
+                                                 seed:(uint64_t)seed
+{
+    NSParameterAssert(minimumLatency >= 0.0);
+    NSParameterAssert(maximumLatency >= minimumLatency);
+    return [[UMKUniformLatencyModel alloc] initWithMinimumLatency:minimumLatency maximumLatency:maximumLatency seed:seed];
+}
+
+
++ (instancetype)lognormalLatencyModelWithMedianLatency:(NSTimeInterval)medianLatency sigma:(double)sigma seed:(uint64_t)seed
+{
+    NSParameterAssert(medianLatency > 0.0);
+    NSParameterAssert(sigma >= 0.0);
+    return [[UMKLognormalLatencyModel alloc] initWithMedianLatency:medianLatency sigma:sigma seed:seed];
+}
+
+
++ (instancetype)empiricalLatencyModelWithPercentileLatencies:(NSDictionary<NSNumber *, NSNumber *> *)percentileLatencies
+                                                        seed:(uint64_t)seed
+{
+    NSParameterAssert(percentileLatencies.count > 0);
+    return [[UMKEmpiricalLatencyModel alloc] initWithPercentileLatencies:percentileLatencies seed:seed];
+}
+
+
++ (instancetype)empiricalLatencyModelWithContentsOfURL:(NSURL *)fileURL seed:(uint64_t)seed error:(NSError **)outError
+{
+    NSParameterAssert(fileURL.isFileURL);
+
+    NSError *error = nil;
+    NSData *data = [NSData dataWithContentsOfURL:fileURL options:0 error:&error];
+    id table = data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:&error] : nil;
+
+    __block BOOL valid = [table isKindOfClass:[NSDictionary class]];
+    NSMutableDictionary<NSNumber *, NSNumber *> *percentileLatencies = [[NSMutableDictionary alloc] init];
+    if (valid) {
+        [table enumerateKeysAndObjectsUsingBlock:^(id key, id value, BOOL *stop) {
+            NSNumber *percentile = [self percentileWithKey:key];
+            if (!percentile || percentileLatencies[percentile] || ![value isKindOfClass:[NSNumber class]]) {
+                valid = NO;
+                *stop = YES;
+                return;
+            }
+
+            percentileLatencies[percentile] = value;
+        }];
+    }
+
+    if (!valid || ![self percentileLatenciesAreValid:percentileLatencies]) {
+        if (outError) {
+            *outError = error ?: [NSError errorWithDomain:NSCocoaErrorDomain code:NSPropertyListReadCorruptError
+                                                 userInfo:@{ NSURLErrorKey : fileURL }];
+        }
+
+        return nil;
+    }
+
+    return [self empiricalLatencyModelWithPercentileLatencies:percentileLatencies seed:seed];
+}
+
+
+/*!
+ @abstract Returns the percentile for the specified key of a JSON percentile table.
+ @param key The key, e.g., @"p99" or @"99.9".
+ @result The percentile, or nil if the key isn't a percentile between 0 and 100.
+ */
++ (NSNumber *)percentileWithKey:(id)key
+{
+    if (![key isKindOfClass:[NSString class]]) {
+        return nil;
+    }
+
+    // Percentiles are plain decimal numbers, so parse them without regard to the current locale
+    const char *string = [key UTF8String];
+    if (string[0] == 'p' || string[0] == 'P') {
+        string++;
+    }
+
+    char *end = NULL;
+    double percentile = strtod_l(string, &end, NULL);
+    if (end == string || *end != '\0' || !(percentile >= 0.0 && percentile <= 100.0)) {
+        return nil;
+    }
+
+    return @(percentile);
+}
+
+
+/*!
+ @abstract Returns whether the specified percentile table is non-empty and its latencies don't decrease as its
+     percentiles increase.
+ @param percentileLatencies The percentile table.
+ @result Whether the percentile table can be used by an empirical latency model.
+ */
++ (BOOL)percentileLatenciesAreValid:(NSDictionary<NSNumber *, NSNumber *> *)percentileLatencies
+{
+    if (percentileLatencies.count == 0) {
+        return NO;
+    }
+
+    double previousLatency = 0.0;
+    for (NSNumber *percentile in [percentileLatencies.allKeys sortedArrayUsingSelector:@selector(compare:)]) {
+        double latency = percentileLatencies[percentile].doubleValue;
+        if (percentile.doubleValue < 0.0 || percentile.doubleValue > 100.0 || latency < previousLatency) {
+            return NO;
+        }
+
+        previousLatency = latency;
+    }
+
+    return YES;
+}
+
+
+- (instancetype)initWithSeed:(uint64_t)seed
+{
+    self = [super init];
+    if (self) {
+        _seed = seed;
+        atomic_init(&_state, seed);
+    }
+
+    return self;
+}
+
+
+- (NSTimeInterval)latencyAtQuantile:(double)quantile
+{
+    @throw [NSException umk_subclassResponsibilityExceptionWithReceiver:self selector:_cmd];
+}
+
+
+- (NSTimeInterval)sampleLatency
+{
+    uint64_t state = atomic_fetch_add_explicit(&_state, UMKSplitMix64Increment, memory_order_relaxed) + UMKSplitMix64Increment;
+    return [self latencyAtQuantile:UMKUnitIntervalWithRandomBits(UMKSplitMix64Mix(state))];
+}
+
+
+- (void)reset
+{
+    atomic_store_explicit(&_state, self.seed, memory_order_relaxed);
+}
+
+@end
+
+
+#pragma mark - Private Subclass Implementations
+
+@implementation UMKFixedLatencyModel
+
+- (instancetype)initWithLatency:(NSTimeInterval)latency
+{
+    self = [super initWithSeed:0];
+    if (self) {
+        _latency = latency;
+    }
+
+    return self;
+}
+
+
+- (NSTimeInterval)latencyAtQuantile:(double)quantile
+{
+    return self.latency;
+}
+
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<UMKLatencyModel: %p> latency: %.4f", self, self.latency];
+}
+
+@end
+
+
+@implementation UMKUniformLatencyModel
+
+- (instancetype)initWithMinimumLatency:(NSTimeInterval)minimumLatency maximumLatency:(NSTimeInterval)maximumLatency seed:(uint64_t)seed
+{
+    self = [super initWithSeed:seed];
+    if (self) {
+        _minimumLatency = minimumLatency;
+        _maximumLatency = maximumLatency;
+    }
+
+    return self;
+}
+
+
+- (NSTimeInterval)latencyAtQuantile:(double)quantile
+{
+    return self.minimumLatency + (self.maximumLatency - self.minimumLatency) * quantile;
+}
+
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<UMKLatencyModel: %p> minimumLatency: %.4f; maximumLatency: %.4f; seed: %llu",
+                self, self.minimumLatency, self.maximumLatency, self.seed];
+}
+
+@end
+
+
+@implementation UMKLognormalLatencyModel
+
+- (instancetype)initWithMedianLatency:(NSTimeInterval)medianLatency sigma:(double)sigma seed:(uint64_t)seed
+{
+    self = [super initWithSeed:seed];
+    if (self) {
+        _medianLatency = medianLatency;
+        _sigma = sigma;
+    }
+
+    return self;
+}
+
+
+- (NSTimeInterval)latencyAtQuantile:(double)quantile
+{
+    if (self.sigma == 0.0) {
+        return self.medianLatency;
+    }
+
+    return self.medianLatency * exp(self.sigma * UMKStandardNormalQuantile(quantile));
+}
+
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<UMKLatencyModel: %p> medianLatency: %.4f; sigma: %.4f; seed: %llu",
+                self, self.medianLatency, self.sigma, self.seed];
+}
+
+@end
+
+
+@implementation UMKEmpiricalLatencyModel {
+    /*! The number of entries in the percentile table. */
+    NSUInteger _count;
+
+    /*! The table's quantiles in ascending order. These are the table's percentiles divided by 100. */
+    double *_quantiles;
+
+    /*! The latency at each quantile in _quantiles. */
+    double *_latencies;
+}
+
+- (instancetype)initWithPercentileLatencies:(NSDictionary<NSNumber *, NSNumber *> *)percentileLatencies seed:(uint64_t)seed
+{
+    NSParameterAssert([[self class] percentileLatenciesAreValid:percentileLatencies]);
+
+    self = [super initWithSeed:seed];
+    if (self) {
+        _percentileLatencies = [percentileLatencies copy];
+
+        // Keep the table in C arrays so that sampling doesn't need to sort or box anything
+        NSArray<NSNumber *> *percentiles = [_percentileLatencies.allKeys sortedArrayUsingSelector:@selector(compare:)];
+        _count = percentiles.count;
+        _quantiles = calloc(_count, sizeof(double));
+        _latencies = calloc(_count, sizeof(double));
+        for (NSUInteger i = 0; i < _count; ++i) {
+            _quantiles[i] = percentiles[i].doubleValue / 100.0;
+            _latencies[i] = _percentileLatencies[percentiles[i]].doubleValue;
+        }
+    }
+
+    return self;
+}
+
+
+- (void)dealloc
+{
+    free(_quantiles);
+    free(_latencies);
+}
+
+
+- (NSTimeInterval)latencyAtQuantile:(double)quantile
+{
+    if (quantile <= _quantiles[0]) {
+        return _latencies[0];
+    } else if (quantile >= _quantiles[_count - 1]) {
+        return _latencies[_count - 1];
+    }
+
+    // Find the first quantile in the table above the one we want. There is one, and it isn't the first.
+    NSUInteger low = 1;
+    NSUInteger high = _count - 1;
+    while (low < high) {
+        NSUInteger middle = low + (high - low) / 2;
+        if (_quantiles[middle] > quantile) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+
+    double fraction = (quantile - _quantiles[low - 1]) / (_quantiles[low] - _quantiles[low - 1]);
+    return _latencies[low - 1] + (_latencies[low] - _latencies[low - 1]) * fraction;
+}
+
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<UMKLatencyModel: %p> percentileLatencies: %@; seed: %llu", self, self.percentileLatencies, self.seed];
+}
+
+@end
@@ -34,6 +34,8 @@
 #pragma mark Constants
 
 NSString *const kUMKMockHTTPMessageAcceptsHeaderField = @"Accepts";
+NSString *const kUMKMockHTTPMessageContentEncodingHeaderField = @"Content-Encoding";
+NSString *const kUMKMockHTTPMessageContentLengthHeaderField = @"Content-Length";
 NSString *const kUMKMockHTTPMessageContentTypeHeaderField = @"Content-Type";
 NSString *const kUMKMockHTTPMessageCookieHeaderField = @"Cookie";
 NSString *const kUMKMockHTTPMessageSetCookieHeaderField = @"Set-Cookie";
@@ -26,8 +26,7 @@
 
 #import <URLMock/UMKMockHTTPRequest.h>
 
-#import <URLMock/NSDictionary+UMKURLEncoding.h>
-#import <URLMock/NSURLRequest+UMKHTTPConvenienceMethods.h>
+#import <URLMock/UMKRequestMatchContext.h>
 
 
 #pragma mark Constants
@@ -67,14 +66,29 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, strong, readonly) NSURL *canonicalURL;
 
 /*!
- @abstract Returns whether the receiver's body matches that of the specified URL request.
+ @abstract Returns whether the receiver matches the URL request of the specified match context.
+ @discussion This is the implementation of both -matchesURLRequest: and -matchesURLRequest:context:.
+ @param context The match context.
+ @result Whether the receiver matches the context's URL request.
+ */
+- (BOOL)matchesURLRequestOfContext:(UMKRequestMatchContext *)context;
+
+/*!
+ @abstract Returns whether the receiver's headers are equal to those of the URL request of the specified match context.
+ @param context The match context.
+ @result Whether the receiver's headers are equal to those of the context's URL request.
+ */
+- (BOOL)headersMatchHeadersOfContext:(UMKRequestMatchContext *)context;
+
+/*!
+ @abstract Returns whether the receiver's body matches that of the URL request of the specified match context.
  @discussion If the URL request's content-type contains "application/json" or "application/x-www-form-urlencoded",
      this method will interpret the bodies of both the receiver and the URL request as JSON or URL-encoded parameters
      and compare them that way. Otherwise, the bodies' bytes are compared.
- @param request The URL request.
- @result Whether the receiver's body matches that of the specified URL request.
+ @param context The match context.
+ @result Whether the receiver's body matches that of the context's URL request.
  */
-- (BOOL)bodyMatchesBodyOfURLRequest:(NSURLRequest *)request;
+- (BOOL)bodyMatchesBodyOfContext:(UMKRequestMatchContext *)context;
 
 @end
 
@@ -196,10 +210,18 @@ NS_ASSUME_NONNULL_END
 
 - (BOOL)matchesURLRequest:(NSURLRequest *)request
 {
-    return [self.canonicalURL isEqual:[UMKMockURLProtocol canonicalURLForURL:request.URL]] &&
-           (request.HTTPMethod && [self.HTTPMethod caseInsensitiveCompare:request.HTTPMethod] == NSOrderedSame) &&
-           (self.checksHeadersWhenMatching ? [self headersAreEqualToHeadersOfRequest:request] : YES) &&
-           (self.checksBodyWhenMatching ? [self bodyMatchesBodyOfURLRequest:request] : YES);
+    return [self matchesURLRequestOfContext:[[UMKRequestMatchContext alloc] initWithURLRequest:request]];
+}
+
+
+- (BOOL)matchesURLRequest:(NSURLRequest *)request context:(UMKRequestMatchContext *)context
+{
+    // If a subclass has its own idea of what matching means, respect it
+    if ([self methodForSelector:@selector(matchesURLRequest:)] != [UMKMockHTTPRequest instanceMethodForSelector:@selector(matchesURLRequest:)]) {
+        return [self matchesURLRequest:request];
+    }
+
+    return [self matchesURLRequestOfContext:context];
 }
 
 
@@ -211,9 +233,35 @@ NS_ASSUME_NONNULL_END
 
 #pragma mark - Private Methods
 
-- (BOOL)bodyMatchesBodyOfURLRequest:(NSURLRequest *)request
+- (BOOL)matchesURLRequestOfContext:(UMKRequestMatchContext *)context
+{
+    return [self.canonicalURL isEqual:context.canonicalURL] &&
+           (context.uppercaseHTTPMethod && [self.HTTPMethod caseInsensitiveCompare:context.uppercaseHTTPMethod] == NSOrderedSame) &&
+           (self.checksHeadersWhenMatching ? [self headersMatchHeadersOfContext:context] : YES) &&
+           (self.checksBodyWhenMatching ? [self bodyMatchesBodyOfContext:context] : YES);
+}
+
+
+- (BOOL)headersMatchHeadersOfContext:(UMKRequestMatchContext *)context
+{
+    NSDictionary<NSString *, NSString *> *headers = self.headers;
+    if (headers.count != context.HTTPHeaderFields.count) {
+        return NO;
+    }
+
+    for (NSString *field in headers) {
+        if (![[context valueForHTTPHeaderField:field] isEqualToString:headers[field]]) {
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+
+- (BOOL)bodyMatchesBodyOfContext:(UMKRequestMatchContext *)context
 {
-    NSData *body = [request umk_HTTPBodyData];
+    NSData *body = context.HTTPBodyData;
 
     // If one of these is nil and the other isn't, they don't match. Otherwise, if one is nil,
     // they're both nil, so they do match.
@@ -225,14 +273,12 @@ NS_ASSUME_NONNULL_END
     
     // If the content type is either JSON or WWW Form URL Encoded, do a content-type-specific equality check.
     // This is because we know JSON and form parameters are equivalent even if their orders are not.
-    NSString *contentType = [request valueForHTTPHeaderField:kUMKMockHTTPMessageContentTypeHeaderField];
+    NSString *contentType = [context valueForHTTPHeaderField:kUMKMockHTTPMessageContentTypeHeaderField];
     if (contentType) {
         if ([contentType rangeOfString:kUMKMockHTTPMessageJSONContentTypeHeaderValue].location != NSNotFound) {
-            return [[self JSONObjectFromBody] isEqual:[NSJSONSerialization JSONObjectWithData:body options:0 error:NULL]];
+            return [[self JSONObjectFromBody] isEqual:context.JSONObjectFromHTTPBody];
         } else if ([contentType rangeOfString:kUMKMockHTTPMessageWWWFormURLEncodedContentTypeHeaderValue].location != NSNotFound) {
-            NSString *requestBodyString = [[NSString alloc] initWithData:body encoding:NSUTF8StringEncoding];
-            NSDictionary<NSString *, id> *bodyParameters = [NSDictionary umk_dictionaryWithURLEncodedParameterString:requestBodyString];
-            return [[self parametersFromURLEncodedBody] isEqualToDictionary:bodyParameters];
+            return [[self parametersFromURLEncodedBody] isEqualToDictionary:context.parametersFromURLEncodedHTTPBody];
         }
     }
     
@@ -27,6 +27,17 @@
 #import <URLMock/UMKMockHTTPResponder.h>
 
 #import <URLMock/NSException+UMKSubclassResponsibility.h>
+#import <URLMock/UMKLatencyModel.h>
+#import <URLMock/UMKMockRegistry.h>
+#import <URLMock/UMKNetworkConditions.h>
+#import <URLMock/UMKVirtualClock.h>
+
+#import "UMKNetworkShaper.h"
+#import "UMKVirtualClock+UMKMockHTTPResponder.h"
+
+#import <os/lock.h>
+#import <stdatomic.h>
+#import <zlib.h>
 
 
 #pragma mark Constants
@@ -41,12 +52,191 @@ static const NSTimeInterval kUMKMinimumDelayBetweenChunks = 0.0001;
 static NSString *const kUMKHTTP11VersionString = @"HTTP/1.1";
 
 
+#pragma mark - Dispatch Data
+
+/*!
+ @abstract Returns a dispatch data object whose contents are the bytes of the specified data object.
+ @discussion The bytes are not copied. Each of the data object's byte ranges becomes a region of the dispatch data
+     object, and each region keeps the data object alive until it is no longer referenced. Because dispatch data
+     objects are also NSData objects, subranges of the result can be handed to protocol clients directly.
+ @param data The data object. May not be nil.
+ @result A dispatch data object that shares the data object's bytes.
+ */
+static dispatch_data_t UMKDispatchDataWithData(NSData *data)
+{
+    if ([data conformsToProtocol:@protocol(OS_dispatch_data)]) {
+        return (dispatch_data_t)data;
+    }
+
+    __block dispatch_data_t dispatchData = dispatch_data_empty;
+    [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        dispatch_data_t region = dispatch_data_create(bytes, byteRange.length, NULL, ^{
+            (void)data;
+        });
+
+        dispatchData = dispatch_data_create_concat(dispatchData, region);
+    }];
+
+    return dispatchData;
+}
+
+
+#pragma mark - Stream Chunk Producers
+
+/*!
+ @abstract Returns a chunk producer that reads chunks from the specified input stream.
+ @discussion The stream is opened the first time the producer is invoked and closed when it is exhausted or fails.
+ @param stream The input stream. May not be nil.
+ @result A chunk producer that reads from the stream.
+ */
+static UMKMockHTTPResponderChunkProducer UMKChunkProducerWithInputStream(NSInputStream *stream)
+{
+    return ^NSData *(NSUInteger maximumLength, NSError **error) {
+        if (stream.streamStatus == NSStreamStatusNotOpen) {
+            [stream open];
+        }
+
+        NSMutableData *chunk = [[NSMutableData alloc] initWithLength:maximumLength];
+        NSInteger length = [stream read:chunk.mutableBytes maxLength:maximumLength];
+        if (length <= 0) {
+            if (length < 0 && error) {
+                *error = stream.streamError;
+            }
+
+            [stream close];
+            return nil;
+        }
+
+        chunk.length = (NSUInteger)length;
+        return chunk;
+    };
+}
+
+
+/*!
+ @abstract Returns the specified data compressed with the specified content encoding.
+ @param data The data to compress. May not be nil.
+ @param contentEncoding The encoding with which to compress the data. May not be UMKMockHTTPContentEncodingIdentity.
+ @result The compressed data, or nil if zlib could not allocate the memory it needed.
+ */
+static NSData *UMKDataByEncodingData(NSData *data, UMKMockHTTPContentEncoding contentEncoding)
+{
+    // Adding 16 to the window bits makes zlib write a gzip header and trailer instead of zlib ones
+    int windowBits = contentEncoding == UMKMockHTTPContentEncodingGzip ? MAX_WBITS + 16 : MAX_WBITS;
+    z_stream stream = { 0 };
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return nil;
+    }
+
+    // The bound is for the whole input, so the output never has to grow
+    NSMutableData *encodedData = [[NSMutableData alloc] initWithLength:deflateBound(&stream, data.length)];
+    stream.next_in = (Bytef *)data.bytes;
+    stream.next_out = encodedData.mutableBytes;
+    NSUInteger inputLength = data.length;
+    NSUInteger outputLength = encodedData.length;
+
+    int status = Z_OK;
+    while (status == Z_OK) {
+        // zlib's lengths are 32 bits, so feed it at most 4 GB at a time
+        if (stream.avail_in == 0) {
+            stream.avail_in = (uInt)MIN(inputLength, UINT_MAX);
+            inputLength -= stream.avail_in;
+        }
+
+        if (stream.avail_out == 0) {
+            stream.avail_out = (uInt)MIN(outputLength, UINT_MAX);
+            outputLength -= stream.avail_out;
+        }
+
+        status = deflate(&stream, inputLength == 0 ? Z_FINISH : Z_NO_FLUSH);
+    }
+
+    encodedData.length = stream.total_out;
+    deflateEnd(&stream);
+    return status == Z_STREAM_END ? encodedData : nil;
+}
+
+
+/*!
+ @abstract Returns the specified headers updated for a body encoded with the specified content encoding.
+ @discussion Any Content-Encoding header is replaced with one for the encoding, and any Content-Length header is
+     replaced with the encoded body's length. Header fields are matched case-insensitively.
+ @param headers The headers of the response. May not be nil.
+ @param contentEncoding The encoding of the body. May not be UMKMockHTTPContentEncodingIdentity.
+ @param encodedBodyLength The length of the encoded body.
+ @result The updated headers.
+ */
+static NSDictionary<NSString *, NSString *> *UMKHeadersWithContentEncoding(NSDictionary<NSString *, NSString *> *headers,
+                                                                           UMKMockHTTPContentEncoding contentEncoding,
+                                                                           NSUInteger encodedBodyLength)
+{
+    NSMutableDictionary<NSString *, NSString *> *encodedHeaders = [headers mutableCopy];
+    BOOL hasContentLength = NO;
+    for (NSString *field in headers) {
+        if ([field caseInsensitiveCompare:kUMKMockHTTPMessageContentLengthHeaderField] == NSOrderedSame) {
+            hasContentLength = YES;
+            [encodedHeaders removeObjectForKey:field];
+        } else if ([field caseInsensitiveCompare:kUMKMockHTTPMessageContentEncodingHeaderField] == NSOrderedSame) {
+            [encodedHeaders removeObjectForKey:field];
+        }
+    }
+
+    encodedHeaders[kUMKMockHTTPMessageContentEncodingHeaderField] = contentEncoding == UMKMockHTTPContentEncodingGzip ? @"gzip" : @"deflate";
+    if (hasContentLength) {
+        encodedHeaders[kUMKMockHTTPMessageContentLengthHeaderField] = [NSString stringWithFormat:@"%lu", (unsigned long)encodedBodyLength];
+    }
+
+    return encodedHeaders;
+}
+
+
 #pragma mark -
 
+@class UMKMockHTTPChunkedBodyDelivery;
+
 @interface UMKMockHTTPResponder ()
 
-/*! Whether the responder is currently responding to a request. */
-@property (nonatomic, getter = isResponding) BOOL responding;
+/*!
+ @abstract Adds the specified delivery to the receiver's active deliveries and starts it.
+ @discussion Active deliveries are canceled when the receiver's response is canceled, and removed when they complete.
+     Only deliveries started by -respondToMockRequest:client:protocol: are tracked; sessions that are created for and
+     owned by protocol objects never touch the receiver once they are created.
+ @param delivery The delivery to start. May not be nil.
+ */
+- (void)startDelivery:(UMKMockHTTPChunkedBodyDelivery *)delivery;
+
+/*!
+ @abstract Removes the specified delivery from the receiver's active deliveries.
+ @param delivery The delivery to remove.
+ */
+- (void)removeActiveDelivery:(UMKMockHTTPChunkedBodyDelivery *)delivery;
+
+/*!
+ @abstract Returns the network conditions under which the receiver should respond on behalf of the specified protocol.
+ @discussion These are the receiver's network conditions if it has any, and otherwise those of the mock registry of
+     the protocol's class.
+ @param protocol The protocol on whose behalf the receiver is responding.
+ @result The network conditions under which to respond, or nil if responses should not be shaped.
+ */
+- (UMKNetworkConditions *)networkConditionsForProtocol:(NSURLProtocol *)protocol;
+
+/*!
+ @abstract Returns the clock that times the receiver's responses on behalf of the specified protocol.
+ @discussion This is the clock of the mock registry of the protocol's class if it has one, and otherwise the default
+     clock.
+ @param protocol The protocol on whose behalf the receiver is responding.
+ @result The clock that times the response.
+ */
+- (UMKVirtualClock *)clockForProtocol:(NSURLProtocol *)protocol;
+
+/*!
+ @abstract Returns how long the receiver should wait before sending a response.
+ @discussion If the receiver has a latency model, this is a new sample from it, overriding the network shaper's
+     latency. Otherwise it is the shaper's latency, or 0 if there is no shaper.
+ @param networkShaper The shaper that will pace the response, or nil if the response isn't shaped.
+ @result How long to wait before sending the response.
+ */
+- (NSTimeInterval)timeToFirstByteWithNetworkShaper:(UMKNetworkShaper *)networkShaper;
 
 @end
 
@@ -78,6 +268,52 @@ NS_ASSUME_NONNULL_BEGIN
 @end
 
 
+/*!
+ UMKMockHTTPResponseTemplates hold everything about a response responder's response that doesn't depend on the
+ request, so that it is computed once rather than for every response. Templates are immutable, except that each
+ remembers the last response it stamped so that a mock that is hit repeatedly with the same URL can reuse it.
+ */
+@interface UMKMockHTTPResponseTemplate : NSObject
+
+/*! The HTTP status code of the template's responses. */
+@property (readonly, nonatomic) NSInteger statusCode;
+
+/*! The HTTP headers of the template's responses. */
+@property (readonly, copy, nonatomic) NSDictionary<NSString *, NSString *> *headers;
+
+/*! The body of the template's responses. */
+@property (readonly, strong, nonatomic, nullable) NSData *body;
+
+/*! The number of chunks the body is broken into when network conditions don't require more. */
+@property (readonly, nonatomic) NSUInteger chunkCount;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Initializes a newly allocated template with the specified parameters.
+ @param statusCode The HTTP status code of the template's responses.
+ @param headers The HTTP headers of the template's responses. May not be nil.
+ @param body The body of the template's responses.
+ @param chunkCount The number of chunks the body is broken into. Must be positive.
+ @result An initialized template.
+ */
+- (instancetype)initWithStatusCode:(NSInteger)statusCode
+                           headers:(NSDictionary<NSString *, NSString *> *)headers
+                              body:(nullable NSData *)body
+                        chunkCount:(NSUInteger)chunkCount NS_DESIGNATED_INITIALIZER;
+
+/*!
+ @abstract Returns an HTTP response with the template's status code and headers for the specified URL.
+ @discussion If the URL is the same as the one the receiver last stamped, the same response is returned. This may be
+     invoked from any thread.
+ @param URL The URL of the response. May not be nil.
+ @result An HTTP response for the specified URL.
+ */
+- (NSHTTPURLResponse *)responseWithURL:(NSURL *)URL;
+
+@end
+
+
 /*!
  UMKMockHTTPResponseResponder instances respond to mock HTTP requests with an HTTP response.
  */
@@ -92,6 +328,12 @@ NS_ASSUME_NONNULL_BEGIN
 /*! The delay in seconds that the instance waits between sending chunks. */
 @property (readonly, nonatomic) NSTimeInterval delayBetweenChunks;
 
+/*! The file URL of the instance's body, or nil if its body isn't file-backed. This is cleared when the body is set. */
+@property (readonly, nonatomic, nullable) NSURL *bodyFileURL;
+
+/*! Whether the instance's body is already encoded with its content encoding. This is cleared when the body is set. */
+@property (readonly, nonatomic) BOOL bodyIsEncoded;
+
 - (instancetype)init NS_UNAVAILABLE;
 
 /*!
@@ -112,187 +354,1354 @@ NS_ASSUME_NONNULL_BEGIN
                     chunkCountHint:(NSUInteger)hint
                 delayBetweenChunks:(NSTimeInterval)delay NS_DESIGNATED_INITIALIZER;
 
+/*!
+ @abstract Initializes a newly-created UMKMockHTTPResponseResponder instance whose body is the contents of the specified
+     file.
+ @discussion The file is not read until the instance's body is needed. If the headers don't include a Content-Length,
+     one is added using the file's size.
+ @param statusCode The HTTP status code to respond with.
+ @param headers The HTTP headers to respond with.
+ @param bodyFileURL The file URL of the HTTP body to respond with. May not be nil.
+ @param hint A hint as to how many chunks the HTTP body should be broken into when responding. May not be 0.
+ @param delay The amount of time the responder should wait between sending chunks of data. Must be non-negative.
+ @result A newly initialized UMKMockHTTPResponseResponder with the specified parameters.
+ */
+- (instancetype)initWithStatusCode:(NSInteger)statusCode
+                           headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                       bodyFileURL:(NSURL *)bodyFileURL
+                    chunkCountHint:(NSUInteger)hint
+                delayBetweenChunks:(NSTimeInterval)delay;
+
+/*!
+ @abstract Initializes a newly-created UMKMockHTTPResponseResponder instance whose body is the contents of the specified
+     file, which is already encoded with the specified content encoding.
+ @discussion The file's contents are sent as they are, with a Content-Encoding header for the encoding.
+ @param statusCode The HTTP status code to respond with.
+ @param headers The HTTP headers to respond with.
+ @param encodedBodyFileURL The file URL of the encoded HTTP body to respond with. May not be nil.
+ @param contentEncoding The encoding with which the file's contents are compressed.
+ @param hint A hint as to how many chunks the HTTP body should be broken into when responding. May not be 0.
+ @param delay The amount of time the responder should wait between sending chunks of data. Must be non-negative.
+ @result A newly initialized UMKMockHTTPResponseResponder with the specified parameters.
+ */
+- (instancetype)initWithStatusCode:(NSInteger)statusCode
+                           headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                encodedBodyFileURL:(NSURL *)encodedBodyFileURL
+                   contentEncoding:(UMKMockHTTPContentEncoding)contentEncoding
+                    chunkCountHint:(NSUInteger)hint
+                delayBetweenChunks:(NSTimeInterval)delay;
+
+/*!
+ @abstract Returns the instance's response template, compiling it if necessary.
+ @discussion The template is compiled on first use and reused until the instance's headers or body change. If the
+     instance's body is file-backed, compiling the template maps the file.
+ @param outError On return, if the body file could not be mapped, an error describing the problem.
+ @result The instance's response template, or nil if the body file could not be mapped.
+ */
+- (nullable UMKMockHTTPResponseTemplate *)responseTemplateReturningError:(NSError **)outError;
+
+/*!
+ @abstract Discards the instance's response template so that it is recompiled the next time it is used.
+ */
+- (void)invalidateResponseTemplate;
+
 @end
 
-NS_ASSUME_NONNULL_END
 
+/*!
+ UMKMockHTTPChunkedBodyDeliveries deliver an HTTP response and its body to a protocol client in chunks, without
+ blocking the thread that started the response. Every response an HTTP responder sends is a delivery, and deliveries
+ hold all of the response's state, so a single responder can serve any number of concurrent requests.
+
+ Chunks are pulled from a chunk producer one at a time, so only the chunk being delivered and the one after it are
+ ever held by the delivery. The response and first chunk are delivered once the delivery's latency has passed.
+ Without a network shaper, each subsequent chunk is delivered after a fixed delay; with one, each chunk waits until
+ the shaper's token bucket can pay for it.
+
+ Delays are timed by blocks scheduled on the delivery's clock, which hand control back to the run loop of the thread
+ that started the delivery. The URL loading system expects its client methods to be invoked on that thread, and the
+ thread remains free to service other work while the delivery waits.
+ */
+@interface UMKMockHTTPChunkedBodyDelivery : NSObject <UMKMockURLResponseSession>
 
-#pragma mark - Base Class Implementation
+/*! The protocol on whose behalf the body is being delivered. */
+@property (nonatomic, strong, readonly) NSURLProtocol *protocol;
 
-@implementation UMKMockHTTPResponder
+/*!
+ A block that is invoked on the delivery's thread after the client has been told that loading finished or failed. It
+ is not invoked if the delivery is canceled. This must be set before the delivery is started.
+ */
+@property (nonatomic, copy, nullable) void (^completionHandler)(UMKMockHTTPChunkedBodyDelivery *delivery);
 
-+ (instancetype)mockHTTPResponderWithError:(NSError *)error
-{
-    NSParameterAssert(error);
-    return [[UMKMockHTTPErrorResponder alloc] initWithError:error];
-}
+- (instancetype)init NS_UNAVAILABLE;
 
+/*!
+ @abstract Initializes a newly allocated delivery that delivers the chunks produced by the specified block.
+ @param response The response to deliver before the body, or nil if it was already delivered.
+ @param latency How long to wait after the delivery is started before delivering the response. Must be non-negative.
+ @param chunkProducer The block that produces the body's chunks. It is invoked on the delivery's thread. The body is
+     complete when it returns nil or an empty data object; if it also returns an error, the load fails with that
+     error. May not be nil.
+ @param chunkLength The maximum chunk length to request from the chunk producer. Must be positive.
+ @param delay The delay between chunks when there is no network shaper. Must be positive.
+ @param networkShaper The shaper that paces the delivery, or nil to use a fixed delay between chunks.
+ @param clock The clock that times the delivery. May not be nil.
+ @param client The protocol client to which the chunks are delivered. May not be nil.
+ @param protocol The protocol on whose behalf the body is delivered. May not be nil.
+ @result An initialized delivery.
+ */
+- (instancetype)initWithResponse:(nullable NSURLResponse *)response
+                         latency:(NSTimeInterval)latency
+                   chunkProducer:(UMKMockHTTPResponderChunkProducer)chunkProducer
+                     chunkLength:(NSUInteger)chunkLength
+              delayBetweenChunks:(NSTimeInterval)delay
+                   networkShaper:(nullable UMKNetworkShaper *)networkShaper
+                           clock:(UMKVirtualClock *)clock
+                          client:(id<NSURLProtocolClient>)client
+                        protocol:(NSURLProtocol *)protocol NS_DESIGNATED_INITIALIZER;
 
-+ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
-{
-    return [self mockHTTPResponderWithStatusCode:statusCode headers:nil body:nil chunkCountHint:1 delayBetweenChunks:0.0];
-}
+/*!
+ @abstract Initializes a newly allocated delivery that breaks the specified body into the specified number of chunks.
+ @discussion Because the body's length may not be evenly divisible by the number of chunks, every chunk but the last
+     has the same length, and the last chunk contains whatever is left.
+ @param response The response to deliver before the body, or nil if it was already delivered.
+ @param latency How long to wait after the delivery is started before delivering the response. Must be non-negative.
+ @param body The body to deliver. Its bytes are shared with the delivered chunks, not copied. If nil or empty, only
+     the response is delivered.
+ @param chunkCount The number of chunks into which to break the body. Must be at least 1 and, if the body is not
+     empty, no more than the body's length. A single chunk is the body itself.
+ @param delay The delay between chunks when there is no network shaper. Must be positive.
+ @param networkShaper The shaper that paces the delivery, or nil to use a fixed delay between chunks.
+ @param clock The clock that times the delivery. May not be nil.
+ @param client The protocol client to which the chunks are delivered. May not be nil.
+ @param protocol The protocol on whose behalf the body is delivered. May not be nil.
+ @result An initialized delivery.
+ */
+- (instancetype)initWithResponse:(nullable NSURLResponse *)response
+                         latency:(NSTimeInterval)latency
+                            body:(nullable NSData *)body
+                      chunkCount:(NSUInteger)chunkCount
+              delayBetweenChunks:(NSTimeInterval)delay
+                   networkShaper:(nullable UMKNetworkShaper *)networkShaper
+                           clock:(UMKVirtualClock *)clock
+                          client:(id<NSURLProtocolClient>)client
+                        protocol:(NSURLProtocol *)protocol;
 
+/*!
+ @abstract Initializes a newly allocated delivery that fails with the specified error without delivering a response.
+ @param error The error to fail with. May not be nil.
+ @param latency How long to wait after the delivery is started before failing. Must be non-negative.
+ @param clock The clock that times the delivery. May not be nil.
+ @param client The protocol client to which the error is delivered. May not be nil.
+ @param protocol The protocol on whose behalf the error is delivered. May not be nil.
+ @result An initialized delivery.
+ */
+- (instancetype)initWithError:(NSError *)error
+                      latency:(NSTimeInterval)latency
+                        clock:(UMKVirtualClock *)clock
+                       client:(id<NSURLProtocolClient>)client
+                     protocol:(NSURLProtocol *)protocol;
 
-+ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
-{
-    return [self mockHTTPResponderWithStatusCode:statusCode headers:headers body:nil chunkCountHint:1 delayBetweenChunks:0.0];
-}
+/*!
+ @abstract Delivers the response and first chunk, or schedules them if the latency or network shaper requires a
+     wait, and schedules the rest.
+ @discussion This must be invoked on the thread that started loading the response. Everything is delivered on that
+     thread using its run loop.
+ */
+- (void)start;
 
+/*!
+ @abstract Cancels the delivery.
+ @discussion No further chunks are pulled or delivered after this returns, and the delivery's scheduled block is
+     canceled immediately. This may be invoked from any thread.
+ */
+- (void)cancel;
 
-+ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode body:(NSData *)body
-{
-    return [self mockHTTPResponderWithStatusCode:statusCode headers:nil body:body chunkCountHint:1 delayBetweenChunks:0.0];
-}
+@end
 
 
-+ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers body:(NSData *)body
-{
-    return [self mockHTTPResponderWithStatusCode:statusCode headers:headers body:body chunkCountHint:1 delayBetweenChunks:0.0];
-}
+/*!
+ UMKMockHTTPStreamingResponder instances respond to mock HTTP requests with an HTTP response whose body is pulled
+ from a chunk producer as it is delivered, so that bodies of any size can be sent in constant memory. Each response
+ gets its own chunk producer from the instance's chunk producer factory. Instances created with a single chunk
+ producer instead hand it to their first response and fail every later one.
+ */
+@interface UMKMockHTTPStreamingResponder : UMKMockHTTPResponseResponder
 
+/*! The block that creates each response's chunk producer, or nil if the instance is single-use. */
+@property (readonly, copy, nonatomic, nullable) UMKMockHTTPResponderChunkProducerFactory chunkProducerFactory;
 
-+ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
-                                        headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
-                                           body:(NSData *)body
-                                 chunkCountHint:(NSUInteger)chunkCountHint
-                             delayBetweenChunks:(NSTimeInterval)delay
-{
-    NSParameterAssert(chunkCountHint != 0);
-    NSParameterAssert(delay >= 0.0);
-    return [[UMKMockHTTPResponseResponder alloc] initWithStatusCode:statusCode
-                                                            headers:headers
-                                                               body:body
-                                                     chunkCountHint:chunkCountHint
-                                                 delayBetweenChunks:delay];
-}
+/*! The block that produces the body of the instance's only response, or nil if the instance isn't single-use. */
+@property (readonly, copy, nonatomic, nullable) UMKMockHTTPResponderChunkProducer chunkProducer;
 
+/*! The maximum length of each chunk that the instance requests from its chunk producers. */
+@property (readonly, nonatomic) NSUInteger chunkLength;
 
-- (void)respondToMockRequest:(id<UMKMockURLRequest>)request client:(id<NSURLProtocolClient>)client protocol:(NSURLProtocol *)protocol
-{
-    @throw [NSException umk_subclassResponsibilityExceptionWithReceiver:self selector:_cmd];
-}
+/*!
+ @abstract Initializes a newly-created UMKMockHTTPStreamingResponder instance with the specified parameters.
+ @param statusCode The HTTP status code to respond with.
+ @param headers The HTTP headers to respond with.
+ @param chunkProducerFactory The block that creates each response's chunk producer. This is only nil when invoked by
+     the single-use initializer.
+ @param chunkLength The maximum length of each chunk. Must be positive.
+ @param delay The amount of time the responder should wait between sending chunks of data. Must be non-negative.
+ @result A newly initialized UMKMockHTTPStreamingResponder with the specified parameters.
+ */
+- (instancetype)initWithStatusCode:(NSInteger)statusCode
+                           headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+              chunkProducerFactory:(nullable UMKMockHTTPResponderChunkProducerFactory)chunkProducerFactory
+                       chunkLength:(NSUInteger)chunkLength
+                delayBetweenChunks:(NSTimeInterval)delay NS_DESIGNATED_INITIALIZER;
 
+/*!
+ @abstract Initializes a newly-created single-use UMKMockHTTPStreamingResponder instance with the specified
+     parameters.
+ @param statusCode The HTTP status code to respond with.
+ @param headers The HTTP headers to respond with.
+ @param chunkProducer The block that produces the HTTP body of the instance's only response. May not be nil.
+ @param chunkLength The maximum length of each chunk. Must be positive.
+ @param delay The amount of time the responder should wait between sending chunks of data. Must be non-negative.
+ @result A newly initialized UMKMockHTTPStreamingResponder with the specified parameters.
+ */
+- (instancetype)initWithStatusCode:(NSInteger)statusCode
+                           headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                     chunkProducer:(UMKMockHTTPResponderChunkProducer)chunkProducer
+                       chunkLength:(NSUInteger)chunkLength
+                delayBetweenChunks:(NSTimeInterval)delay;
 
-- (void)cancelResponse
-{
-    self.responding = NO;
-}
+- (instancetype)initWithStatusCode:(NSInteger)statusCode
+                           headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                              body:(NSData * _Nullable)body
+                    chunkCountHint:(NSUInteger)hint
+                delayBetweenChunks:(NSTimeInterval)delay NS_UNAVAILABLE;
 
 @end
 
+NS_ASSUME_NONNULL_END
 
-#pragma mark - Private Subclass Implementations
 
-@implementation UMKMockHTTPErrorResponder
+#pragma mark - UMKMockHTTPChunkedBodyDelivery
 
-- (instancetype)initWithError:(NSError *)error
+@implementation UMKMockHTTPChunkedBodyDelivery {
+    /*! The response to deliver before the first chunk, or nil once it has been delivered. */
+    NSURLResponse *_response;
+
+    /*! The block that produces the body's chunks. This is released as soon as the delivery is done. */
+    UMKMockHTTPResponderChunkProducer _chunkProducer;
+
+    /*! How long to wait after starting before delivering the response. */
+    NSTimeInterval _latency;
+
+    /*! The maximum chunk length to request from the chunk producer. */
+    NSUInteger _chunkLength;
+
+    /*! The delay between chunks when there is no network shaper. */
+    NSTimeInterval _delay;
+
+    /*! The shaper that paces the delivery, if any. Only accessed on the delivery's thread. */
+    UMKNetworkShaper *_networkShaper;
+
+    /*! The clock that times the delivery. */
+    UMKVirtualClock *_clock;
+
+    /*! The protocol client. */
+    id<NSURLProtocolClient> _client;
+
+    /*! The run loop of the thread that started the delivery, retained. */
+    CFRunLoopRef _runLoop;
+
+    /*! The run loop modes in which chunks are delivered. */
+    NSArray<NSString *> *_runLoopModes;
+
+    /*! Protects _scheduledBlockToken. */
+    os_unfair_lock _scheduledBlockLock;
+
+    /*! The token for the clock block that schedules the next chunk, or nil if none is scheduled. */
+    id _scheduledBlockToken;
+
+    /*! The next chunk to deliver, or nil if there are no more. Only accessed on the delivery's thread. */
+    NSData *_nextChunk;
+
+    /*! The error the chunk producer returned when it stopped, if any. Only accessed on the delivery's thread. */
+    NSError *_chunkProducerError;
+
+    /*! Whether the delivery has finished or been canceled. Once set, no more chunks are pulled or delivered. */
+    _Atomic(bool) _done;
+}
+
+- (instancetype)initWithResponse:(NSURLResponse *)response
+                         latency:(NSTimeInterval)latency
+                   chunkProducer:(UMKMockHTTPResponderChunkProducer)chunkProducer
+                     chunkLength:(NSUInteger)chunkLength
+              delayBetweenChunks:(NSTimeInterval)delay
+                   networkShaper:(UMKNetworkShaper *)networkShaper
+                           clock:(UMKVirtualClock *)clock
+                          client:(id<NSURLProtocolClient>)client
+                        protocol:(NSURLProtocol *)protocol
 {
+    NSParameterAssert(latency >= 0.0);
+    NSParameterAssert(chunkProducer);
+    NSParameterAssert(chunkLength > 0);
+    NSParameterAssert(delay > 0.0);
+    NSParameterAssert(clock);
+    NSParameterAssert(client);
+    NSParameterAssert(protocol);
+
     self = [super init];
     if (self) {
-        _error = error;
+        _response = response;
+        _latency = latency;
+        _chunkProducer = [chunkProducer copy];
+        _chunkLength = chunkLength;
+        _delay = delay;
+        _networkShaper = networkShaper;
+        _clock = clock;
+        _client = client;
+        _protocol = protocol;
+        _scheduledBlockLock = OS_UNFAIR_LOCK_INIT;
+        atomic_init(&_done, false);
     }
-    
+
     return self;
 }
 
 
-- (void)respondToMockRequest:(id<UMKMockURLRequest>)request client:(id<NSURLProtocolClient>)client protocol:(NSURLProtocol *)protocol
+- (instancetype)initWithResponse:(NSURLResponse *)response
+                         latency:(NSTimeInterval)latency
+                            body:(NSData *)body
+                      chunkCount:(NSUInteger)chunkCount
+              delayBetweenChunks:(NSTimeInterval)delay
+                   networkShaper:(UMKNetworkShaper *)networkShaper
+                           clock:(UMKVirtualClock *)clock
+                          client:(id<NSURLProtocolClient>)client
+                        protocol:(NSURLProtocol *)protocol
 {
-    self.responding = YES;
-    [client URLProtocol:protocol didFailWithError:self.error];
-    self.responding = NO;
-}
+    NSUInteger bodyLength = body.length;
+    NSParameterAssert(chunkCount > 0 && chunkCount <= MAX(bodyLength, 1));
+
+    // Most responses are a single chunk, which can just be the body itself
+    if (chunkCount == 1) {
+        __block NSData *remainingBody = body;
+        return [self initWithResponse:response
+                              latency:latency
+                        chunkProducer:^NSData *(NSUInteger maximumLength, NSError **error) {
+                            NSData *chunk = remainingBody;
+                            remainingBody = nil;
+                            return chunk;
+                        }
+                          chunkLength:MAX(bodyLength, 1)
+                   delayBetweenChunks:delay
+                        networkShaper:networkShaper
+                                clock:clock
+                               client:client
+                             protocol:protocol];
+    }
 
+    // Chunks are subranges of the dispatch data, so they share the body's bytes rather than copying them
+    dispatch_data_t dispatchBody = bodyLength > 0 ? UMKDispatchDataWithData(body) : dispatch_data_empty;
+    NSUInteger bytesPerChunk = MAX(bodyLength / chunkCount, 1);
+    __block NSUInteger index = 0;
 
-- (NSString *)description
-{
-    return [NSString stringWithFormat:@"<UMKMockHTTPResponder: %p> error: %@", self, self.error];
+    UMKMockHTTPResponderChunkProducer chunkProducer = ^NSData *(NSUInteger maximumLength, NSError **error) {
+        if (index == chunkCount || bodyLength == 0) {
+            return nil;
+        }
+
+        NSUInteger location = index * bytesPerChunk;
+        NSUInteger length = ++index == chunkCount ? bodyLength - location : bytesPerChunk;
+        return (NSData *)dispatch_data_create_subrange(dispatchBody, location, length);
+    };
+
+    return [self initWithResponse:response
+                          latency:latency
+                    chunkProducer:chunkProducer
+                      chunkLength:bytesPerChunk
+               delayBetweenChunks:delay
+                    networkShaper:networkShaper
+                            clock:clock
+                           client:client
+                         protocol:protocol];
 }
 
-@end
 
+- (instancetype)initWithError:(NSError *)error
+                      latency:(NSTimeInterval)latency
+                        clock:(UMKVirtualClock *)clock
+                       client:(id<NSURLProtocolClient>)client
+                     protocol:(NSURLProtocol *)protocol
+{
+    NSParameterAssert(error);
 
-@implementation UMKMockHTTPResponseResponder
+    // With no response and a body that fails immediately, the error is all that's delivered
+    return [self initWithResponse:nil
+                          latency:latency
+                    chunkProducer:^NSData *(NSUInteger maximumLength, NSError **outError) {
+                        if (outError) {
+                            *outError = error;
+                        }
+
+                        return nil;
+                    }
+                      chunkLength:1
+               delayBetweenChunks:kUMKMinimumDelayBetweenChunks
+                    networkShaper:nil
+                            clock:clock
+                           client:client
+                         protocol:protocol];
+}
 
-- (instancetype)initWithStatusCode:(NSInteger)statusCode
-                           headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
-                              body:(NSData *)body
-                    chunkCountHint:(NSUInteger)hint
-                delayBetweenChunks:(NSTimeInterval)delay
-{
-    NSParameterAssert(hint > 0);
-    NSParameterAssert(delay >= 0.0);
 
-    self = [super init];
-    if (self) {
-        self.body = body;
-        self.headers = headers;
-        _statusCode = statusCode;
-        _chunkCountHint = hint;
-        _delayBetweenChunks = delay;
+- (void)dealloc
+{
+    if (_runLoop) {
+        CFRelease(_runLoop);
     }
-    
-    return self;
 }
 
 
-- (void)respondToMockRequest:(id<UMKMockURLRequest>)request client:(id<NSURLProtocolClient>)client protocol:(NSURLProtocol *)protocol
+- (void)start
 {
-    self.responding = YES;
+    _runLoop = (CFRunLoopRef)CFRetain(CFRunLoopGetCurrent());
 
-    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:protocol.request.URL
-                                                              statusCode:self.statusCode
-                                                             HTTPVersion:kUMKHTTP11VersionString
-                                                            headerFields:self.headers];
+    // Deliver in the mode the thread is running in as well as the default mode, like -performSelector:onThread:... would
+    NSString *currentMode = CFBridgingRelease(CFRunLoopCopyCurrentMode(_runLoop));
+    _runLoopModes = currentMode && ![currentMode isEqualToString:NSDefaultRunLoopMode] ? @[ NSDefaultRunLoopMode, currentMode ]
+                                                                                       : @[ NSDefaultRunLoopMode ];
 
-    // Stop if we were canceled in another thread.
-    if (!self.responding) {
+    if (atomic_load(&_done)) {
         return;
     }
 
-    [client URLProtocol:protocol didReceiveResponse:response cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+    [self pullNextChunk];
 
-    if (self.body) {
-        // Don't break the data into more chunks than there are bytes. If the body length is below the minimum, just use one chunk.
-        NSUInteger chunkCount = self.body.length >= kUMKMinimumBodyLengthToChunk ? MIN(self.body.length, self.chunkCountHint) : 1;
-
-        // If we have more than one chunk, delay at least the minimum amount. Otherwise don't delay
-        NSTimeInterval delay = chunkCount > 1 ? MAX(kUMKMinimumDelayBetweenChunks, self.delayBetweenChunks) : 0.0;
+    NSTimeInterval delay = _latency + (_networkShaper ? [self delayBeforeNextChunk] : 0.0);
+    if (delay > 0.0) {
+        [self scheduleNextChunkAfterDelay:delay];
+    } else {
+        [self deliverNextChunk];
+    }
+}
 
-        // Because body.length may not be evenly divisible by chunkCount, we write all but the last chunk out in
-        // bytesPerChunk-sized chunks. On the last chunk, we just write whatever's left.
-        NSUInteger bytesPerChunk = self.body.length / chunkCount;
-        
-        for (NSUInteger i = 0; i < chunkCount - 1 && self.responding; ++i) {
-            [client URLProtocol:protocol didLoadData:[self.body subdataWithRange:NSMakeRange(i * bytesPerChunk, bytesPerChunk)]];
 
-            if (delay > 0.0) {
-                [NSThread sleepForTimeInterval:delay];
-            }
-        }
+- (void)cancel
+{
+    atomic_store(&_done, true);
+    [self cancelScheduledBlock];
+}
 
-        if (!self.responding) {
-            return;
-        }
 
-        NSUInteger startingLocation = (chunkCount - 1) * bytesPerChunk;
-        [client URLProtocol:protocol didLoadData:[self.body subdataWithRange:NSMakeRange(startingLocation, self.body.length - startingLocation)]];
+/*!
+ @abstract Cancels the receiver's scheduled block, if it has one.
+ */
+- (void)cancelScheduledBlock
+{
+    os_unfair_lock_lock(&_scheduledBlockLock);
+    id token = _scheduledBlockToken;
+    _scheduledBlockToken = nil;
+    os_unfair_lock_unlock(&_scheduledBlockLock);
+
+    if (token) {
+        [_clock cancelScheduledBlock:token];
     }
-    
-    if (!self.responding) {
+}
+
+
+/*!
+ @abstract Schedules the next chunk to be delivered after the specified delay on the receiver's clock.
+ @discussion The scheduled block retains the receiver until it runs or is canceled.
+ @param delay The delay after which the next chunk should be delivered.
+ */
+- (void)scheduleNextChunkAfterDelay:(NSTimeInterval)delay
+{
+    id token = [_clock scheduleBlock:^{
+        [self scheduleNextChunk];
+    } afterDelay:delay];
+
+    os_unfair_lock_lock(&_scheduledBlockLock);
+    BOOL done = atomic_load(&_done);
+    if (!done) {
+        _scheduledBlockToken = token;
+    }
+    os_unfair_lock_unlock(&_scheduledBlockLock);
+
+    // If we were canceled while scheduling, cancel won't have seen the token
+    if (done) {
+        [_clock cancelScheduledBlock:token];
+    }
+}
+
+
+/*!
+ @abstract Returns how long to wait before delivering the receiver's next chunk.
+ @discussion With a network shaper, this takes the chunk's bytes from the shaper's token bucket, so it must only be
+     invoked once per chunk.
+ @result How long to wait before delivering the receiver's next chunk.
+ */
+- (NSTimeInterval)delayBeforeNextChunk
+{
+    if (_networkShaper) {
+        return _nextChunk ? [_networkShaper delayBeforeSendingBytes:_nextChunk.length] : 0.0;
+    }
+
+    return _delay;
+}
+
+
+/*!
+ @abstract Schedules the next chunk for delivery on the receiver's run loop.
+ @discussion This is invoked by the receiver's clock when the chunk's delay has passed. The next chunk is only
+     scheduled on the clock once the previous chunk has been delivered, so chunks are always delivered in order. The
+     clock is told that work is outstanding until the chunk is delivered, so that virtual clocks don't advance
+     before the next chunk has been scheduled.
+ */
+- (void)scheduleNextChunk
+{
+    if (atomic_load(&_done)) {
+        return;
+    }
+
+    UMKVirtualClock *clock = _clock;
+    [clock beginActivityOnRunLoop:_runLoop];
+    CFRunLoopPerformBlock(_runLoop, (__bridge CFArrayRef)_runLoopModes, ^{
+        [self deliverNextChunk];
+        [clock endActivityOnRunLoop:self->_runLoop];
+    });
+
+    CFRunLoopWakeUp(_runLoop);
+}
+
+
+/*!
+ @abstract Pulls the next chunk from the receiver's chunk producer.
+ @discussion This is invoked on the delivery's thread. When the chunk producer stops producing chunks, it is
+     released along with anything it has captured.
+ */
+- (void)pullNextChunk
+{
+    NSError *error = nil;
+    NSData *chunk = _chunkProducer(_chunkLength, &error);
+    if (chunk.length > 0) {
+        _nextChunk = chunk;
+        return;
+    }
+
+    _nextChunk = nil;
+    _chunkProducerError = error;
+    _chunkProducer = nil;
+}
+
+
+/*!
+ @abstract Delivers the receiver's next chunk to its client, finishing or failing the load if it was the last.
+ @discussion This is invoked on the delivery's thread. If the response hasn't been delivered yet, it is delivered
+     first. The chunk after the one being delivered is pulled right away so that the load can finish as soon as the
+     last chunk is delivered, rather than a delay later.
+ */
+- (void)deliverNextChunk
+{
+    if (atomic_load(&_done)) {
+        _chunkProducer = nil;
         return;
     }
 
-    [client URLProtocolDidFinishLoading:protocol];
-    self.responding = NO;
+    if (_response) {
+        [_client URLProtocol:_protocol didReceiveResponse:_response cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+        _response = nil;
+    }
+
+    NSData *chunk = _nextChunk;
+    if (chunk && !atomic_load(&_done)) {
+        [_client URLProtocol:_protocol didLoadData:chunk];
+        if (_chunkProducer && !atomic_load(&_done)) {
+            [self pullNextChunk];
+        } else {
+            _nextChunk = nil;
+        }
+    }
+
+    if (_nextChunk) {
+        [self scheduleNextChunkAfterDelay:[self delayBeforeNextChunk]];
+        return;
+    } else if (atomic_exchange(&_done, true)) {
+        return;
+    }
+
+    [self cancelScheduledBlock];
+    if (_chunkProducerError) {
+        [_client URLProtocol:_protocol didFailWithError:_chunkProducerError];
+    } else {
+        [_client URLProtocolDidFinishLoading:_protocol];
+    }
+
+    if (_completionHandler) {
+        _completionHandler(self);
+    }
+}
+
+@end
+
+
+#pragma mark - UMKMockHTTPResponseTemplate
+
+@implementation UMKMockHTTPResponseTemplate {
+    /*! Protects _lastResponse. */
+    os_unfair_lock _lastResponseLock;
+
+    /*! The response the template stamped most recently. */
+    NSHTTPURLResponse *_lastResponse;
+}
+
+- (instancetype)initWithStatusCode:(NSInteger)statusCode
+                           headers:(NSDictionary<NSString *, NSString *> *)headers
+                              body:(NSData *)body
+                        chunkCount:(NSUInteger)chunkCount
+{
+    NSParameterAssert(headers);
+    NSParameterAssert(chunkCount > 0);
+
+    self = [super init];
+    if (self) {
+        _statusCode = statusCode;
+        _headers = [headers copy];
+        _body = body;
+        _chunkCount = chunkCount;
+        _lastResponseLock = OS_UNFAIR_LOCK_INIT;
+    }
+
+    return self;
+}
+
+
+- (NSHTTPURLResponse *)responseWithURL:(NSURL *)URL
+{
+    os_unfair_lock_lock(&_lastResponseLock);
+    NSHTTPURLResponse *response = _lastResponse;
+    os_unfair_lock_unlock(&_lastResponseLock);
+
+    NSURL *responseURL = response.URL;
+    if (responseURL == URL || [responseURL isEqual:URL]) {
+        return response;
+    }
+
+    response = [[NSHTTPURLResponse alloc] initWithURL:URL statusCode:_statusCode HTTPVersion:kUMKHTTP11VersionString headerFields:_headers];
+
+    os_unfair_lock_lock(&_lastResponseLock);
+    _lastResponse = response;
+    os_unfair_lock_unlock(&_lastResponseLock);
+
+    return response;
+}
+
+@end
+
+
+#pragma mark - Base Class Implementation
+
+@implementation UMKMockHTTPResponder {
+    /*! Protects _activeDeliveries. */
+    os_unfair_lock _activeDeliveriesLock;
+
+    /*! The chunked body deliveries that are in progress. */
+    NSMutableArray<UMKMockHTTPChunkedBodyDelivery *> *_activeDeliveries;
+}
+
++ (instancetype)mockHTTPResponderWithError:(NSError *)error
+{
+    NSParameterAssert(error);
+    return [[UMKMockHTTPErrorResponder alloc] initWithError:error];
+}
+
+
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
+{
+    return [self mockHTTPResponderWithStatusCode:statusCode headers:nil body:nil chunkCountHint:1 delayBetweenChunks:0.0];
+}
+
+
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+{
+    return [self mockHTTPResponderWithStatusCode:statusCode headers:headers body:nil chunkCountHint:1 delayBetweenChunks:0.0];
+}
+
+
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode body:(NSData *)body
+{
+    return [self mockHTTPResponderWithStatusCode:statusCode headers:nil body:body chunkCountHint:1 delayBetweenChunks:0.0];
+}
+
+
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers body:(NSData *)body
+{
+    return [self mockHTTPResponderWithStatusCode:statusCode headers:headers body:body chunkCountHint:1 delayBetweenChunks:0.0];
+}
+
+
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
+                                        headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                                           body:(NSData *)body
+                                 chunkCountHint:(NSUInteger)chunkCountHint
+                             delayBetweenChunks:(NSTimeInterval)delay
+{
+    NSParameterAssert(chunkCountHint != 0);
+    NSParameterAssert(delay >= 0.0);
+    return [[UMKMockHTTPResponseResponder alloc] initWithStatusCode:statusCode
+                                                            headers:headers
+                                                               body:body
+                                                     chunkCountHint:chunkCountHint
+                                                 delayBetweenChunks:delay];
+}
+
+
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
+                                        headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                                  chunkProducer:(UMKMockHTTPResponderChunkProducer)chunkProducer
+                                    chunkLength:(NSUInteger)chunkLength
+                             delayBetweenChunks:(NSTimeInterval)delay
+{
+    NSParameterAssert(chunkProducer);
+    NSParameterAssert(chunkLength != 0);
+    NSParameterAssert(delay >= 0.0);
+    return [[UMKMockHTTPStreamingResponder alloc] initWithStatusCode:statusCode
+                                                             headers:headers
+                                                       chunkProducer:chunkProducer
+                                                         chunkLength:chunkLength
+                                                  delayBetweenChunks:delay];
+}
+
+
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
+                                        headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                           chunkProducerFactory:(UMKMockHTTPResponderChunkProducerFactory)chunkProducerFactory
+                                    chunkLength:(NSUInteger)chunkLength
+                             delayBetweenChunks:(NSTimeInterval)delay
+{
+    NSParameterAssert(chunkProducerFactory);
+    NSParameterAssert(chunkLength != 0);
+    NSParameterAssert(delay >= 0.0);
+    return [[UMKMockHTTPStreamingResponder alloc] initWithStatusCode:statusCode
+                                                             headers:headers
+                                                chunkProducerFactory:chunkProducerFactory
+                                                         chunkLength:chunkLength
+                                                  delayBetweenChunks:delay];
+}
+
+
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
+                                        headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                                     bodyStream:(NSInputStream *)bodyStream
+                                    chunkLength:(NSUInteger)chunkLength
+                             delayBetweenChunks:(NSTimeInterval)delay
+{
+    NSParameterAssert(bodyStream);
+    return [self mockHTTPResponderWithStatusCode:statusCode
+                                         headers:headers
+                                   chunkProducer:UMKChunkProducerWithInputStream(bodyStream)
+                                     chunkLength:chunkLength
+                              delayBetweenChunks:delay];
+}
+
+
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
+                                        headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                              bodyStreamFactory:(UMKMockHTTPResponderBodyStreamFactory)bodyStreamFactory
+                                    chunkLength:(NSUInteger)chunkLength
+                             delayBetweenChunks:(NSTimeInterval)delay
+{
+    NSParameterAssert(bodyStreamFactory);
+    return [self mockHTTPResponderWithStatusCode:statusCode
+                                         headers:headers
+                            chunkProducerFactory:^UMKMockHTTPResponderChunkProducer{
+                                return UMKChunkProducerWithInputStream(bodyStreamFactory());
+                            }
+                                     chunkLength:chunkLength
+                              delayBetweenChunks:delay];
+}
+
+
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
+                                        headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                                    bodyFileURL:(NSURL *)bodyFileURL
+{
+    return [self mockHTTPResponderWithStatusCode:statusCode headers:headers bodyFileURL:bodyFileURL chunkCountHint:1 delayBetweenChunks:0.0];
+}
+
+
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
+                                        headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                                    bodyFileURL:(NSURL *)bodyFileURL
+                                 chunkCountHint:(NSUInteger)chunkCountHint
+                             delayBetweenChunks:(NSTimeInterval)delay
+{
+    NSParameterAssert(bodyFileURL.isFileURL);
+    NSParameterAssert(chunkCountHint != 0);
+    NSParameterAssert(delay >= 0.0);
+    return [[UMKMockHTTPResponseResponder alloc] initWithStatusCode:statusCode
+                                                            headers:headers
+                                                        bodyFileURL:bodyFileURL
+                                                     chunkCountHint:chunkCountHint
+                                                 delayBetweenChunks:delay];
+}
+
+
++ (instancetype)mockHTTPResponderWithStatusCode:(NSInteger)statusCode
+                                        headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                             encodedBodyFileURL:(NSURL *)encodedBodyFileURL
+                                contentEncoding:(UMKMockHTTPContentEncoding)contentEncoding
+                                 chunkCountHint:(NSUInteger)chunkCountHint
+                             delayBetweenChunks:(NSTimeInterval)delay
+{
+    NSParameterAssert(encodedBodyFileURL.isFileURL);
+    NSParameterAssert(chunkCountHint != 0);
+    NSParameterAssert(delay >= 0.0);
+    return [[UMKMockHTTPResponseResponder alloc] initWithStatusCode:statusCode
+                                                            headers:headers
+                                                 encodedBodyFileURL:encodedBodyFileURL
+                                                    contentEncoding:contentEncoding
+                                                     chunkCountHint:chunkCountHint
+                                                 delayBetweenChunks:delay];
+}
+
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        _activeDeliveriesLock = OS_UNFAIR_LOCK_INIT;
+        _activeDeliveries = [[NSMutableArray alloc] init];
+    }
+
+    return self;
+}
+
+
+- (id<UMKMockURLResponseSession>)responseSessionForMockRequest:(id<UMKMockURLRequest>)request
+                                                        client:(id<NSURLProtocolClient>)client
+                                                      protocol:(NSURLProtocol *)protocol
+{
+    @throw [NSException umk_subclassResponsibilityExceptionWithReceiver:self selector:_cmd];
+}
+
+
+- (void)respondToMockRequest:(id<UMKMockURLRequest>)request client:(id<NSURLProtocolClient>)client protocol:(NSURLProtocol *)protocol
+{
+    // When we're asked to respond directly, we own the session, so track it until it's done or canceled
+    UMKMockHTTPChunkedBodyDelivery *delivery = (UMKMockHTTPChunkedBodyDelivery *)[self responseSessionForMockRequest:request
+                                                                                                              client:client
+                                                                                                            protocol:protocol];
+    __weak UMKMockHTTPResponder *weakSelf = self;
+    delivery.completionHandler = ^(UMKMockHTTPChunkedBodyDelivery *completedDelivery) {
+        [weakSelf removeActiveDelivery:completedDelivery];
+    };
+
+    [self startDelivery:delivery];
+}
+
+
+- (void)cancelResponse
+{
+    os_unfair_lock_lock(&_activeDeliveriesLock);
+    NSArray<UMKMockHTTPChunkedBodyDelivery *> *deliveries = [_activeDeliveries copy];
+    [_activeDeliveries removeAllObjects];
+    os_unfair_lock_unlock(&_activeDeliveriesLock);
+
+    [deliveries makeObjectsPerformSelector:@selector(cancel)];
+}
+
+
+- (void)cancelResponseToProtocol:(NSURLProtocol *)protocol
+{
+    NSMutableArray<UMKMockHTTPChunkedBodyDelivery *> *canceledDeliveries = [[NSMutableArray alloc] init];
+
+    os_unfair_lock_lock(&_activeDeliveriesLock);
+    for (UMKMockHTTPChunkedBodyDelivery *delivery in _activeDeliveries) {
+        if (delivery.protocol == protocol) {
+            [canceledDeliveries addObject:delivery];
+        }
+    }
+
+    [_activeDeliveries removeObjectsInArray:canceledDeliveries];
+    os_unfair_lock_unlock(&_activeDeliveriesLock);
+
+    [canceledDeliveries makeObjectsPerformSelector:@selector(cancel)];
+}
+
+
+- (void)startDelivery:(UMKMockHTTPChunkedBodyDelivery *)delivery
+{
+    os_unfair_lock_lock(&_activeDeliveriesLock);
+    [_activeDeliveries addObject:delivery];
+    os_unfair_lock_unlock(&_activeDeliveriesLock);
+
+    [delivery start];
+}
+
+
+- (void)removeActiveDelivery:(UMKMockHTTPChunkedBodyDelivery *)delivery
+{
+    os_unfair_lock_lock(&_activeDeliveriesLock);
+    [_activeDeliveries removeObjectIdenticalTo:delivery];
+    os_unfair_lock_unlock(&_activeDeliveriesLock);
+}
+
+
+- (UMKNetworkConditions *)networkConditionsForProtocol:(NSURLProtocol *)protocol
+{
+    UMKNetworkConditions *networkConditions = self.networkConditions;
+    if (networkConditions || ![protocol isKindOfClass:[UMKMockURLProtocol class]]) {
+        return networkConditions;
+    }
+
+    return [[protocol class] mockRegistry].networkConditions;
+}
+
+
+- (UMKVirtualClock *)clockForProtocol:(NSURLProtocol *)protocol
+{
+    UMKVirtualClock *clock = [protocol isKindOfClass:[UMKMockURLProtocol class]] ? [[protocol class] mockRegistry].clock : nil;
+    return clock ?: [UMKVirtualClock defaultClock];
+}
+
+
+- (NSTimeInterval)timeToFirstByteWithNetworkShaper:(UMKNetworkShaper *)networkShaper
+{
+    UMKLatencyModel *latencyModel = self.latencyModel;
+    return latencyModel ? [latencyModel sampleLatency] : networkShaper.latency;
+}
+
+@end
+
+
+#pragma mark - Private Subclass Implementations
+
+@implementation UMKMockHTTPErrorResponder
+
+- (instancetype)initWithError:(NSError *)error
+{
+    self = [super init];
+    if (self) {
+        _error = error;
+    }
+    
+    return self;
+}
+
+
+- (id<UMKMockURLResponseSession>)responseSessionForMockRequest:(id<UMKMockURLRequest>)request
+                                                        client:(id<NSURLProtocolClient>)client
+                                                      protocol:(NSURLProtocol *)protocol
+{
+    return [[UMKMockHTTPChunkedBodyDelivery alloc] initWithError:self.error
+                                                         latency:[self timeToFirstByteWithNetworkShaper:nil]
+                                                           clock:[self clockForProtocol:protocol]
+                                                          client:client
+                                                        protocol:protocol];
 }
 
 
 - (NSString *)description
 {
+    return [NSString stringWithFormat:@"<UMKMockHTTPResponder: %p> error: %@", self, self.error];
+}
+
+@end
+
+
+@implementation UMKMockHTTPResponseResponder {
+    /*! Protects _mappedBody. */
+    os_unfair_lock _mappedBodyLock;
+
+    /*! The mapped contents of the body file, or nil if it hasn't been mapped yet. */
+    NSData *_mappedBody;
+
+    /*! Protects _responseTemplate and the encoded body. This is held while the template is compiled. */
+    os_unfair_lock _responseTemplateLock;
+
+    /*! The compiled response template, or nil if it hasn't been compiled since the instance last changed. */
+    UMKMockHTTPResponseTemplate *_responseTemplate;
+
+    /*! The body compressed with _encodedBodyContentEncoding, or nil if it hasn't been compressed since it was set. */
+    NSData *_encodedBody;
+
+    /*! The content encoding with which _encodedBody was compressed. */
+    UMKMockHTTPContentEncoding _encodedBodyContentEncoding;
+}
+
+- (instancetype)initWithStatusCode:(NSInteger)statusCode
+                           headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                              body:(NSData *)body
+                    chunkCountHint:(NSUInteger)hint
+                delayBetweenChunks:(NSTimeInterval)delay
+{
+    NSParameterAssert(hint > 0);
+    NSParameterAssert(delay >= 0.0);
+
+    self = [super init];
+    if (self) {
+        self.body = body;
+        self.headers = headers;
+        _statusCode = statusCode;
+        _chunkCountHint = hint;
+        _delayBetweenChunks = delay;
+        _mappedBodyLock = OS_UNFAIR_LOCK_INIT;
+        _responseTemplateLock = OS_UNFAIR_LOCK_INIT;
+    }
+    
+    return self;
+}
+
+
+- (instancetype)initWithStatusCode:(NSInteger)statusCode
+                           headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                       bodyFileURL:(NSURL *)bodyFileURL
+                    chunkCountHint:(NSUInteger)hint
+                delayBetweenChunks:(NSTimeInterval)delay
+{
+    NSParameterAssert(bodyFileURL.isFileURL);
+
+    self = [self initWithStatusCode:statusCode headers:headers body:nil chunkCountHint:hint delayBetweenChunks:delay];
+    if (self) {
+        _bodyFileURL = [bodyFileURL copy];
+
+        // Getting the file's size only requires a stat, so we can do this without reading the file
+        NSNumber *fileSize = nil;
+        if (![self valueForHeaderField:kUMKMockHTTPMessageContentLengthHeaderField] &&
+            [bodyFileURL getResourceValue:&fileSize forKey:NSURLFileSizeKey error:NULL] && fileSize) {
+            [self setValue:fileSize.stringValue forHeaderField:kUMKMockHTTPMessageContentLengthHeaderField];
+        }
+    }
+
+    return self;
+}
+
+
+- (instancetype)initWithStatusCode:(NSInteger)statusCode
+                           headers:(NSDictionary<NSString *, NSString *> * _Nullable)headers
+                encodedBodyFileURL:(NSURL *)encodedBodyFileURL
+                   contentEncoding:(UMKMockHTTPContentEncoding)contentEncoding
+                    chunkCountHint:(NSUInteger)hint
+                delayBetweenChunks:(NSTimeInterval)delay
+{
+    self = [self initWithStatusCode:statusCode headers:headers bodyFileURL:encodedBodyFileURL chunkCountHint:hint delayBetweenChunks:delay];
+    if (self) {
+        _bodyIsEncoded = YES;
+        self.contentEncoding = contentEncoding;
+    }
+
+    return self;
+}
+
+
+#pragma mark - Body
+
+- (NSData *)body
+{
+    return self.bodyFileURL ? [self mappedBodyReturningError:NULL] : [super body];
+}
+
+
+- (void)setBody:(NSData *)body
+{
+    _bodyFileURL = nil;
+    _bodyIsEncoded = NO;
+
+    os_unfair_lock_lock(&_mappedBodyLock);
+    _mappedBody = nil;
+    os_unfair_lock_unlock(&_mappedBodyLock);
+
+    [super setBody:body];
+
+    os_unfair_lock_lock(&_responseTemplateLock);
+    _responseTemplate = nil;
+    _encodedBody = nil;
+    os_unfair_lock_unlock(&_responseTemplateLock);
+}
+
+
+/*!
+ @abstract Returns the mapped contents of the receiver's body file, mapping it if necessary.
+ @discussion The file is mapped at most once; subsequent invocations return the same data object.
+ @param outError On return, if the file could not be mapped, an error describing the problem.
+ @result The mapped contents of the receiver's body file, or nil if it could not be mapped.
+ */
+- (NSData *)mappedBodyReturningError:(NSError **)outError
+{
+    os_unfair_lock_lock(&_mappedBodyLock);
+    NSData *mappedBody = _mappedBody;
+    NSError *error = nil;
+    if (!mappedBody) {
+        mappedBody = [NSData dataWithContentsOfURL:self.bodyFileURL options:NSDataReadingMappedIfSafe error:&error];
+        _mappedBody = mappedBody;
+    }
+    os_unfair_lock_unlock(&_mappedBodyLock);
+
+    if (!mappedBody && outError) {
+        *outError = error;
+    }
+
+    return mappedBody;
+}
+
+
+#pragma mark - Headers
+
+- (void)setHeaders:(NSDictionary<NSString *, NSString *> *)headers
+{
+    [super setHeaders:headers];
+    [self invalidateResponseTemplate];
+}
+
+
+- (void)setValue:(NSString *)value forHeaderField:(NSString *)field
+{
+    [super setValue:value forHeaderField:field];
+    [self invalidateResponseTemplate];
+}
+
+
+- (void)removeValueForHeaderField:(NSString *)field
+{
+    [super removeValueForHeaderField:field];
+    [self invalidateResponseTemplate];
+}
+
+
+#pragma mark - Content Encoding
+
+- (void)setContentEncoding:(UMKMockHTTPContentEncoding)contentEncoding
+{
+    [super setContentEncoding:contentEncoding];
+    [self invalidateResponseTemplate];
+}
+
+
+#pragma mark - Response Template
+
+- (UMKMockHTTPResponseTemplate *)responseTemplateReturningError:(NSError **)outError
+{
+    // Compile while holding the lock so that a template compiled from headers or a body that changed in the meantime
+    // can't be stored after the change invalidated it
+    os_unfair_lock_lock(&_responseTemplateLock);
+    UMKMockHTTPResponseTemplate *responseTemplate = _responseTemplate;
+    if (!responseTemplate) {
+        responseTemplate = [self compileResponseTemplateReturningError:outError];
+        _responseTemplate = responseTemplate;
+    }
+    os_unfair_lock_unlock(&_responseTemplateLock);
+
+    return responseTemplate;
+}
+
+
+/*!
+ @abstract Compiles a new response template from the receiver's status code, headers, body, and content encoding.
+ @discussion This must only be invoked while holding _responseTemplateLock. If the body needs to be compressed, the
+     compressed bytes are cached so that changes to the headers alone don't compress it again.
+ @param outError On return, if the template could not be compiled, an error describing the problem.
+ @result A new response template, or nil if the body file could not be mapped or the body could not be compressed.
+ */
+- (UMKMockHTTPResponseTemplate *)compileResponseTemplateReturningError:(NSError **)outError
+{
+    // Map the body file before sending any response so that we can fail if it can't be read
+    NSData *body = self.bodyFileURL ? [self mappedBodyReturningError:outError] : self.body;
+    if (!body && self.bodyFileURL) {
+        return nil;
+    }
+
+    NSDictionary<NSString *, NSString *> *headers = self.headers;
+    UMKMockHTTPContentEncoding contentEncoding = self.contentEncoding;
+    if (contentEncoding != UMKMockHTTPContentEncodingIdentity && body.length > 0) {
+        if (!self.bodyIsEncoded) {
+            if (!_encodedBody || _encodedBodyContentEncoding != contentEncoding) {
+                _encodedBody = UMKDataByEncodingData(body, contentEncoding);
+                _encodedBodyContentEncoding = contentEncoding;
+            }
+
+            body = _encodedBody;
+            if (!body) {
+                if (outError) {
+                    *outError = [NSError errorWithDomain:NSPOSIXErrorDomain code:ENOMEM userInfo:nil];
+                }
+
+                return nil;
+            }
+        }
+
+        headers = UMKHeadersWithContentEncoding(headers, contentEncoding, body.length);
+    }
+
+    // Don't break the data into more chunks than there are bytes. If the body length is below the minimum, just use one chunk.
+    NSUInteger chunkCount = body.length >= kUMKMinimumBodyLengthToChunk ? MIN(body.length, self.chunkCountHint) : 1;
+    return [[UMKMockHTTPResponseTemplate alloc] initWithStatusCode:self.statusCode headers:headers body:body chunkCount:chunkCount];
+}
+
+
+- (void)invalidateResponseTemplate
+{
+    os_unfair_lock_lock(&_responseTemplateLock);
+    _responseTemplate = nil;
+    os_unfair_lock_unlock(&_responseTemplateLock);
+}
+
+
+#pragma mark - Responding
+
+- (id<UMKMockURLResponseSession>)responseSessionForMockRequest:(id<UMKMockURLRequest>)request
+                                                        client:(id<NSURLProtocolClient>)client
+                                                      protocol:(NSURLProtocol *)protocol
+{
+    UMKVirtualClock *clock = [self clockForProtocol:protocol];
+
+    NSError *error = nil;
+    UMKMockHTTPResponseTemplate *responseTemplate = [self responseTemplateReturningError:&error];
+    if (!responseTemplate) {
+        return [[UMKMockHTTPChunkedBodyDelivery alloc] initWithError:error latency:0.0 clock:clock client:client protocol:protocol];
+    }
+
+    // Only the URL is stamped per request; everything else was compiled into the template
+    NSHTTPURLResponse *response = [responseTemplate responseWithURL:protocol.request.URL];
+    NSData *body = responseTemplate.body;
+    NSUInteger chunkCount = responseTemplate.chunkCount;
+
+    // Under network conditions, use chunks small enough for the link to deliver smoothly
+    UMKNetworkConditions *networkConditions = [self networkConditionsForProtocol:protocol];
+    if (networkConditions && body.length > networkConditions.preferredChunkLength) {
+        NSUInteger preferredChunkLength = networkConditions.preferredChunkLength;
+        chunkCount = MAX(chunkCount, (body.length + preferredChunkLength - 1) / preferredChunkLength);
+    }
+
+    // Unshaped single-chunk responses with no latency are delivered as soon as the session starts. Everything else is
+    // scheduled on the clock rather than sleeping so that the loading thread isn't tied up.
+    UMKNetworkShaper *networkShaper = networkConditions ? [[UMKNetworkShaper alloc] initWithNetworkConditions:networkConditions clock:clock] : nil;
+    return [[UMKMockHTTPChunkedBodyDelivery alloc] initWithResponse:response
+                                                            latency:[self timeToFirstByteWithNetworkShaper:networkShaper]
+                                                               body:body
+                                                         chunkCount:chunkCount
+                                                 delayBetweenChunks:MAX(kUMKMinimumDelayBetweenChunks, self.delayBetweenChunks)
+                                                      networkShaper:networkShaper
+                                                              clock:clock
+                                                             client:client
+                                                           protocol:protocol];
+}
+
+
+- (NSString *)description
+{
+    // Don't map the body file just to describe ourselves
+    if (self.bodyFileURL) {
+        return [NSString stringWithFormat:@"<UMKMockHTTPResponder: %p> statusCode: %ld; headers = %@; bodyFileURL: %@; chunkCountHint: %lu, delayBetweenChunks: %.4f",
+                    self, (unsigned long)self.statusCode, self.headers, self.bodyFileURL, (unsigned long)self.chunkCountHint, self.delayBetweenChunks];
+    }
+
     return [NSString stringWithFormat:@"<UMKMockHTTPResponder: %p> statusCode: %ld; headers = %@; body: %p; chunkCountHint: %lu, delayBetweenChunks: %.4f",
                 self, (unsigned long)self.statusCode, self.headers, self.body, (unsigned long)self.chunkCountHint, self.delayBetweenChunks];
 }
 
 @end
+
+
+#pragma mark - UMKMockHTTPStreamingResponder
+
+@implementation UMKMockHTTPStreamingResponder {
+    /*! Whether a single-use instance's chunk producer has been handed to a response. */
+    _Atomic(bool) _chunkProducerClaimed;
+}
+
+- (instancetype)initWithStatusCode:(NSInteger)statusCode
+                           headers:(NSDictionary<NSString *, NSString *> *)headers
+              chunkProducerFactory:(UMKMockHTTPResponderChunkProducerFactory)chunkProducerFactory
+                       chunkLength:(NSUInteger)chunkLength
+                delayBetweenChunks:(NSTimeInterval)delay
+{
+    NSParameterAssert(chunkLength > 0);
+
+    self = [super initWithStatusCode:statusCode headers:headers body:nil chunkCountHint:1 delayBetweenChunks:delay];
+    if (self) {
+        _chunkProducerFactory = [chunkProducerFactory copy];
+        _chunkLength = chunkLength;
+        atomic_init(&_chunkProducerClaimed, false);
+    }
+
+    return self;
+}
+
+
+- (instancetype)initWithStatusCode:(NSInteger)statusCode
+                           headers:(NSDictionary<NSString *, NSString *> *)headers
+                     chunkProducer:(UMKMockHTTPResponderChunkProducer)chunkProducer
+                       chunkLength:(NSUInteger)chunkLength
+                delayBetweenChunks:(NSTimeInterval)delay
+{
+    NSParameterAssert(chunkProducer);
+
+    self = [self initWithStatusCode:statusCode headers:headers chunkProducerFactory:nil chunkLength:chunkLength delayBetweenChunks:delay];
+    if (self) {
+        _chunkProducer = [chunkProducer copy];
+    }
+
+    return self;
+}
+
+
+/*!
+ @abstract Returns the chunk producer for a new response.
+ @discussion This may be invoked from any thread. Single-use instances return their chunk producer the first time
+     this is invoked and nil every time after that.
+ @result A chunk producer that produces the response's entire body, or nil if the instance is single-use and has
+     already responded.
+ */
+- (UMKMockHTTPResponderChunkProducer)chunkProducerForNewResponse
+{
+    UMKMockHTTPResponderChunkProducerFactory chunkProducerFactory = self.chunkProducerFactory;
+    if (chunkProducerFactory) {
+        return chunkProducerFactory();
+    }
+
+    bool expected = false;
+    return atomic_compare_exchange_strong(&_chunkProducerClaimed, &expected, true) ? self.chunkProducer : nil;
+}
+
+
+- (id<UMKMockURLResponseSession>)responseSessionForMockRequest:(id<UMKMockURLRequest>)request
+                                                        client:(id<NSURLProtocolClient>)client
+                                                      protocol:(NSURLProtocol *)protocol
+{
+    // Streaming responders have no body, so compiling the template can't fail
+    NSHTTPURLResponse *response = [[self responseTemplateReturningError:NULL] responseWithURL:protocol.request.URL];
+
+    // Under network conditions, use chunks small enough for the link to deliver smoothly
+    UMKNetworkConditions *networkConditions = [self networkConditionsForProtocol:protocol];
+    UMKVirtualClock *clock = [self clockForProtocol:protocol];
+    UMKNetworkShaper *networkShaper = networkConditions ? [[UMKNetworkShaper alloc] initWithNetworkConditions:networkConditions clock:clock] : nil;
+    NSUInteger chunkLength = networkConditions ? MIN(self.chunkLength, networkConditions.preferredChunkLength) : self.chunkLength;
+
+    // Sharing a chunk producer between responses would truncate or interleave their bodies, so fail instead
+    UMKMockHTTPResponderChunkProducer chunkProducer = [self chunkProducerForNewResponse];
+    if (!chunkProducer) {
+        NSError *error = [NSError errorWithDomain:kUMKErrorDomain code:kUMKSingleUseResponderReusedErrorCode userInfo:nil];
+        return [[UMKMockHTTPChunkedBodyDelivery alloc] initWithError:error
+                                                             latency:[self timeToFirstByteWithNetworkShaper:networkShaper]
+                                                               clock:clock
+                                                              client:client
+                                                            protocol:protocol];
+    }
+
+    return [[UMKMockHTTPChunkedBodyDelivery alloc] initWithResponse:response
+                                                            latency:[self timeToFirstByteWithNetworkShaper:networkShaper]
+                                                      chunkProducer:chunkProducer
+                                                        chunkLength:chunkLength
+                                                 delayBetweenChunks:MAX(kUMKMinimumDelayBetweenChunks, self.delayBetweenChunks)
+                                                      networkShaper:networkShaper
+                                                              clock:clock
+                                                             client:client
+                                                           protocol:protocol];
+}
+
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<UMKMockHTTPResponder: %p> statusCode: %ld; headers = %@; chunkProducerFactory: %p; chunkProducer: %p; chunkLength: %lu, delayBetweenChunks: %.4f",
+                self, (unsigned long)self.statusCode, self.headers, self.chunkProducerFactory, self.chunkProducer,
+                (unsigned long)self.chunkLength, self.delayBetweenChunks];
+}
+
+@end
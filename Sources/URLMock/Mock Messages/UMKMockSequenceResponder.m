@@ -0,0 +1,269 @@
+//
+//  UMKMockSequenceResponder.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import <URLMock/UMKMockSequenceResponder.h>
+
+#import <URLMock/UMKMockHTTPResponder.h>
+
+#import <stdatomic.h>
+
+
+#pragma mark Functions
+
+/*!
+ @abstract Cancels the specified responder's response to the specified protocol.
+ @discussion If the responder can't cancel individual responses, all of its responses are canceled, which is what
+     UMKMockURLProtocol would do.
+ @param responder The responder whose response should be canceled.
+ @param protocol The protocol whose response should be canceled.
+ */
+static void UMKCancelResponseToProtocol(id<UMKMockURLResponder> responder, NSURLProtocol *protocol)
+{
+    if ([responder respondsToSelector:@selector(cancelResponseToProtocol:)]) {
+        [responder cancelResponseToProtocol:protocol];
+    } else {
+        [responder cancelResponse];
+    }
+}
+
+
+#pragma mark - UMKMockURLResponderSession
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ UMKMockURLResponderSessions adapt responders that don't create response sessions, so that a sequence responder can
+ always return a session for the responder whose turn it is.
+ */
+@interface UMKMockURLResponderSession : NSObject <UMKMockURLResponseSession>
+
+/*! The responder that responds when the session starts. */
+@property (nonatomic, strong, readonly) id<UMKMockURLResponder> responder;
+
+/*! The mock request to respond to. */
+@property (nonatomic, strong, readonly) id<UMKMockURLRequest> mockRequest;
+
+/*! The protocol client to respond to. */
+@property (nonatomic, strong, readonly) id<NSURLProtocolClient> client;
+
+/*! The protocol on whose behalf the responder responds. */
+@property (nonatomic, strong, readonly) NSURLProtocol *protocol;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Initializes a newly allocated session that responds using the specified responder.
+ @param responder The responder. May not be nil.
+ @param mockRequest The mock request. May not be nil.
+ @param client The protocol client. May not be nil.
+ @param protocol The URL protocol. May not be nil.
+ @result An initialized session.
+ */
+- (instancetype)initWithResponder:(id<UMKMockURLResponder>)responder
+                      mockRequest:(id<UMKMockURLRequest>)mockRequest
+                           client:(id<NSURLProtocolClient>)client
+                         protocol:(NSURLProtocol *)protocol NS_DESIGNATED_INITIALIZER;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+
+@implementation UMKMockURLResponderSession
+
+- (instancetype)initWithResponder:(id<UMKMockURLResponder>)responder
+                      mockRequest:(id<UMKMockURLRequest>)mockRequest
+                           client:(id<NSURLProtocolClient>)client
+                         protocol:(NSURLProtocol *)protocol
+{
+    NSParameterAssert(responder);
+    NSParameterAssert(client);
+    NSParameterAssert(protocol);
+
+    self = [super init];
+    if (self) {
+        _responder = responder;
+        _mockRequest = mockRequest;
+        _client = client;
+        _protocol = protocol;
+    }
+
+    return self;
+}
+
+
+- (void)start
+{
+    [self.responder respondToMockRequest:self.mockRequest client:self.client protocol:self.protocol];
+}
+
+
+- (void)cancel
+{
+    UMKCancelResponseToProtocol(self.responder, self.protocol);
+}
+
+@end
+
+
+#pragma mark - UMKMockSequenceResponder
+
+@implementation UMKMockSequenceResponder {
+    /*! The number of positions in the sequence claimed so far. Each request claims one with an atomic increment. */
+    _Atomic(NSUInteger) _cursor;
+
+    /*! The distinct responders in the sequence, which are forwarded cancellation messages. */
+    NSArray<id<UMKMockURLResponder>> *_distinctResponders;
+
+    /*! The responder that fails requests made after the sequence is exhausted. */
+    UMKMockHTTPResponder *_exhaustedResponder;
+}
+
++ (instancetype)sequenceResponderWithResponders:(NSArray<id<UMKMockURLResponder>> *)responders
+{
+    return [[self alloc] initWithResponders:responders exhaustionBehavior:UMKMockSequenceResponderExhaustionBehaviorStop];
+}
+
+
+- (instancetype)initWithResponders:(NSArray<id<UMKMockURLResponder>> *)responders
+                exhaustionBehavior:(UMKMockSequenceResponderExhaustionBehavior)exhaustionBehavior
+{
+    NSParameterAssert(responders.count > 0);
+
+    self = [super init];
+    if (self) {
+        _responders = [responders copy];
+        _exhaustionBehavior = exhaustionBehavior;
+        atomic_init(&_cursor, 0);
+
+        // Responders that appear more than once only need to be told to cancel once. Responders may not implement
+        // -isEqual: meaningfully, so compare them by identity.
+        NSHashTable<id<UMKMockURLResponder>> *distinctResponders = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+        for (id<UMKMockURLResponder> responder in _responders) {
+            [distinctResponders addObject:responder];
+        }
+
+        _distinctResponders = distinctResponders.allObjects;
+
+        NSError *exhaustedError = [NSError errorWithDomain:kUMKErrorDomain code:kUMKMockSequenceExhaustedErrorCode userInfo:nil];
+        _exhaustedResponder = [UMKMockHTTPResponder mockHTTPResponderWithError:exhaustedError];
+    }
+
+    return self;
+}
+
+
+- (NSUInteger)responseCount
+{
+    return atomic_load_explicit(&_cursor, memory_order_relaxed);
+}
+
+
+- (id<UMKMockURLResponder>)responderForResponseAtIndex:(NSUInteger)index
+{
+    NSUInteger count = _responders.count;
+    if (index < count) {
+        return _responders[index];
+    }
+
+    switch (_exhaustionBehavior) {
+        case UMKMockSequenceResponderExhaustionBehaviorStop:
+            break;
+        case UMKMockSequenceResponderExhaustionBehaviorRepeatLast:
+            return _responders[count - 1];
+        case UMKMockSequenceResponderExhaustionBehaviorWrapAround:
+            return _responders[index % count];
+    }
+
+    return nil;
+}
+
+
+- (void)reset
+{
+    atomic_store_explicit(&_cursor, 0, memory_order_relaxed);
+}
+
+
+/*!
+ @abstract Claims the next position in the receiver's sequence and returns the responder for it.
+ @discussion This may be invoked from any thread. Concurrent invocations always claim different positions.
+ @result The responder for the claimed position, or a responder that fails with an error if the sequence is exhausted.
+ */
+- (id<UMKMockURLResponder>)claimNextResponder
+{
+    // Nothing else is published through the cursor, so relaxed ordering suffices
+    NSUInteger index = atomic_fetch_add_explicit(&_cursor, 1, memory_order_relaxed);
+    return [self responderForResponseAtIndex:index] ?: _exhaustedResponder;
+}
+
+
+#pragma mark - UMKMockURLResponder
+
+- (id<UMKMockURLResponseSession>)responseSessionForMockRequest:(id<UMKMockURLRequest>)request
+                                                        client:(id<NSURLProtocolClient>)client
+                                                      protocol:(NSURLProtocol *)protocol
+{
+    id<UMKMockURLResponder> responder = [self claimNextResponder];
+    if ([responder respondsToSelector:@selector(responseSessionForMockRequest:client:protocol:)]) {
+        return [responder responseSessionForMockRequest:request client:client protocol:protocol];
+    }
+
+    return [[UMKMockURLResponderSession alloc] initWithResponder:responder mockRequest:request client:client protocol:protocol];
+}
+
+
+- (void)respondToMockRequest:(id<UMKMockURLRequest>)request client:(id<NSURLProtocolClient>)client protocol:(NSURLProtocol *)protocol
+{
+    [[self claimNextResponder] respondToMockRequest:request client:client protocol:protocol];
+}
+
+
+- (void)cancelResponse
+{
+    [_distinctResponders makeObjectsPerformSelector:@selector(cancelResponse)];
+    [_exhaustedResponder cancelResponse];
+}
+
+
+- (void)cancelResponseToProtocol:(NSURLProtocol *)protocol
+{
+    for (id<UMKMockURLResponder> responder in _distinctResponders) {
+        UMKCancelResponseToProtocol(responder, protocol);
+    }
+
+    UMKCancelResponseToProtocol(_exhaustedResponder, protocol);
+}
+
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<UMKMockSequenceResponder: %p> responders: %@; exhaustionBehavior: %ld; responseCount: %lu",
+                self, self.responders, (long)self.exhaustionBehavior, (unsigned long)self.responseCount];
+}
+
+@end
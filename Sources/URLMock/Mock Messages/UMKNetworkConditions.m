@@ -0,0 +1,157 @@
+//
+//  UMKNetworkConditions.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import <URLMock/UMKNetworkConditions.h>
+
+#import "UMKSplitMix64.h"
+
+#import <stdatomic.h>
+
+
+#pragma mark Constants
+
+/*! The amount of time the preferred chunk length takes to deliver at the downstream rate. */
+static const NSTimeInterval kUMKNetworkConditionsPreferredChunkDuration = 0.02;
+
+/*! The smallest preferred chunk length. */
+static const NSUInteger kUMKNetworkConditionsMinimumPreferredChunkLength = 1024;
+
+/*! The largest preferred chunk length. */
+static const NSUInteger kUMKNetworkConditionsMaximumPreferredChunkLength = 64 * 1024;
+
+
+#pragma mark -
+
+@implementation UMKNetworkConditions {
+    /*! The state of the conditions' SplitMix64 jitter generator. */
+    _Atomic(uint64_t) _jitterState;
+}
+
+- (instancetype)initWithDownstreamBytesPerSecond:(NSUInteger)bytesPerSecond
+                                   roundTripTime:(NSTimeInterval)roundTripTime
+                                          jitter:(NSTimeInterval)jitter
+{
+    return [self initWithDownstreamBytesPerSecond:bytesPerSecond roundTripTime:roundTripTime jitter:jitter jitterSeed:0];
+}
+
+
+- (instancetype)initWithDownstreamBytesPerSecond:(NSUInteger)bytesPerSecond
+                                   roundTripTime:(NSTimeInterval)roundTripTime
+                                          jitter:(NSTimeInterval)jitter
+                                      jitterSeed:(uint64_t)jitterSeed
+{
+    NSParameterAssert(roundTripTime >= 0.0);
+    NSParameterAssert(jitter >= 0.0);
+
+    self = [super init];
+    if (self) {
+        _downstreamBytesPerSecond = bytesPerSecond;
+        _roundTripTime = roundTripTime;
+        _jitter = jitter;
+        _jitterSeed = jitterSeed;
+        atomic_init(&_jitterState, jitterSeed);
+    }
+
+    return self;
+}
+
+
++ (instancetype)networkConditions3G
+{
+    return [[self alloc] initWithDownstreamBytesPerSecond:750 * 1000 / 8 roundTripTime:0.1 jitter:0.02];
+}
+
+
++ (instancetype)networkConditionsLTE
+{
+    return [[self alloc] initWithDownstreamBytesPerSecond:12 * 1000 * 1000 / 8 roundTripTime:0.05 jitter:0.01];
+}
+
+
++ (instancetype)networkConditionsWiFi
+{
+    return [[self alloc] initWithDownstreamBytesPerSecond:30 * 1000 * 1000 / 8 roundTripTime:0.01 jitter:0.002];
+}
+
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    return self;
+}
+
+
+- (NSUInteger)preferredChunkLength
+{
+    if (self.downstreamBytesPerSecond == 0) {
+        return NSUIntegerMax;
+    }
+
+    NSUInteger length = (NSUInteger)(self.downstreamBytesPerSecond * kUMKNetworkConditionsPreferredChunkDuration);
+    return MIN(MAX(length, kUMKNetworkConditionsMinimumPreferredChunkLength), kUMKNetworkConditionsMaximumPreferredChunkLength);
+}
+
+
+- (NSTimeInterval)sampleJitter
+{
+    uint64_t state = atomic_fetch_add_explicit(&_jitterState, UMKSplitMix64Increment, memory_order_relaxed) + UMKSplitMix64Increment;
+    return self.jitter * UMKUnitIntervalWithRandomBits(UMKSplitMix64Mix(state));
+}
+
+
+- (void)resetJitter
+{
+    atomic_store_explicit(&_jitterState, self.jitterSeed, memory_order_relaxed);
+}
+
+
+- (BOOL)isEqual:(id)object
+{
+    if (self == object) {
+        return YES;
+    } else if (![object isKindOfClass:[UMKNetworkConditions class]]) {
+        return NO;
+    }
+
+    UMKNetworkConditions *conditions = object;
+    return self.downstreamBytesPerSecond == conditions.downstreamBytesPerSecond && self.roundTripTime == conditions.roundTripTime &&
+        self.jitter == conditions.jitter && self.jitterSeed == conditions.jitterSeed;
+}
+
+
+- (NSUInteger)hash
+{
+    return self.downstreamBytesPerSecond ^ (NSUInteger)(self.roundTripTime * 1e6) ^ (NSUInteger)self.jitterSeed;
+}
+
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p> downstreamBytesPerSecond: %lu; roundTripTime: %.4f; jitter: %.4f; jitterSeed: %llu",
+                self.class, self, (unsigned long)self.downstreamBytesPerSecond, self.roundTripTime, self.jitter, self.jitterSeed];
+}
+
+@end
@@ -0,0 +1,85 @@
+//
+//  UMKNetworkShaper.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import "UMKNetworkShaper.h"
+
+#import <URLMock/UMKNetworkConditions.h>
+#import <URLMock/UMKVirtualClock.h>
+
+
+@implementation UMKNetworkShaper {
+    /*! The response's latency, sampled when the shaper is created. */
+    NSTimeInterval _latency;
+
+    /*! The number of bytes that can be sent without waiting. This goes negative while bytes are owed. */
+    double _tokens;
+
+    /*! The time at which _tokens was last brought up to date on the shaper's clock. */
+    NSTimeInterval _lastRefillTime;
+}
+
+- (instancetype)initWithNetworkConditions:(UMKNetworkConditions *)networkConditions clock:(UMKVirtualClock *)clock
+{
+    NSParameterAssert(networkConditions);
+    NSParameterAssert(clock);
+
+    self = [super init];
+    if (self) {
+        _networkConditions = networkConditions;
+        _clock = clock;
+        _tokens = networkConditions.preferredChunkLength;
+        _lastRefillTime = clock.currentTime;
+        _latency = networkConditions.roundTripTime + [networkConditions sampleJitter];
+    }
+
+    return self;
+}
+
+
+- (NSTimeInterval)latency
+{
+    return _latency;
+}
+
+
+- (NSTimeInterval)delayBeforeSendingBytes:(NSUInteger)length
+{
+    double bytesPerSecond = self.networkConditions.downstreamBytesPerSecond;
+    if (bytesPerSecond == 0) {
+        return 0.0;
+    }
+
+    NSTimeInterval now = self.clock.currentTime;
+    double capacity = self.networkConditions.preferredChunkLength;
+    _tokens = MIN(capacity, _tokens + (now - _lastRefillTime) * bytesPerSecond);
+    _lastRefillTime = now;
+
+    _tokens -= length;
+    return _tokens < 0 ? -_tokens / bytesPerSecond : 0.0;
+}
+
+@end
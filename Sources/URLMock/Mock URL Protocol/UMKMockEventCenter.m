@@ -0,0 +1,359 @@
+//
+//  UMKMockEventCenter.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import "UMKMockEventCenter.h"
+
+#import <URLMock/UMKMockRegistry.h>
+
+#import <os/lock.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+#pragma mark UMKMockEventObserver
+
+/*! UMKMockEventObservers pair an observer block with the token returned to the code that added it. */
+@interface UMKMockEventObserver : NSObject
+
+/*! The block to invoke with each event. */
+@property (nonatomic, copy, readonly) void (^block)(UMKMockRegistryEvent *event);
+
+- (instancetype)initWithBlock:(void (^)(UMKMockRegistryEvent *event))block;
+
+@end
+
+
+#pragma mark - UMKMockEventWaiter
+
+/*! UMKMockEventWaiters record the condition and completion handler of an asynchronous wait. */
+@interface UMKMockEventWaiter : NSObject
+
+/*! The condition being waited for. */
+@property (nonatomic, copy, readonly) BOOL (^condition)(void);
+
+/*! The queue on which to invoke the completion handler. */
+@property (nonatomic, strong, readonly) dispatch_queue_t queue;
+
+/*! The completion handler. */
+@property (nonatomic, copy, readonly) void (^completionHandler)(BOOL conditionMet);
+
+/*! Whether an evaluation of the condition has been dispatched to the queue but hasn't started. Only accessed with the
+    center's condition lock held. */
+@property (nonatomic, assign, getter=isEvaluationScheduled) BOOL evaluationScheduled;
+
+- (instancetype)initWithCondition:(BOOL (^)(void))condition queue:(dispatch_queue_t)queue completionHandler:(void (^)(BOOL conditionMet))completionHandler;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+
+#pragma mark -
+
+@implementation UMKMockEventObserver
+
+- (instancetype)initWithBlock:(void (^)(UMKMockRegistryEvent *event))block
+{
+    self = [super init];
+    if (self) {
+        _block = [block copy];
+    }
+
+    return self;
+}
+
+@end
+
+
+#pragma mark -
+
+@implementation UMKMockEventWaiter
+
+- (instancetype)initWithCondition:(BOOL (^)(void))condition queue:(dispatch_queue_t)queue completionHandler:(void (^)(BOOL conditionMet))completionHandler
+{
+    self = [super init];
+    if (self) {
+        _condition = [condition copy];
+        _queue = queue;
+        _completionHandler = [completionHandler copy];
+    }
+
+    return self;
+}
+
+@end
+
+
+#pragma mark -
+
+@implementation UMKMockEventCenter {
+    /*! Protects the center's counts and observers. */
+    os_unfair_lock _lock;
+
+    /*! The number of requests each mock request has serviced. Keys are weakly held and compared by identity. */
+    NSMapTable<id<UMKMockURLRequest>, NSNumber *> *_serviceCounts;
+
+    /*! Backs the finishedResponseCount property. */
+    NSUInteger _finishedResponseCount;
+
+    /*! The center's observers. This array is replaced rather than mutated so that it can be enumerated without the lock. */
+    NSArray<UMKMockEventObserver *> *_observers;
+
+    /*! The condition variable on which blocking waits sleep. Its lock also protects _signalCount and _waiters. */
+    NSCondition *_condition;
+
+    /*! The number of times the center has been signaled. Blocking waits use this to detect signals they haven't seen. */
+    uint64_t _signalCount;
+
+    /*! The center's pending asynchronous waits. */
+    NSMutableArray<UMKMockEventWaiter *> *_waiters;
+}
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _serviceCounts = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsWeakMemory | NSPointerFunctionsObjectPointerPersonality
+                                               valueOptions:NSPointerFunctionsStrongMemory];
+        _observers = @[];
+        _condition = [[NSCondition alloc] init];
+        _waiters = [[NSMutableArray alloc] init];
+    }
+
+    return self;
+}
+
+
+#pragma mark - Counts
+
+- (NSUInteger)finishedResponseCount
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger finishedResponseCount = _finishedResponseCount;
+    os_unfair_lock_unlock(&_lock);
+    return finishedResponseCount;
+}
+
+
+- (NSUInteger)serviceCountForMockRequest:(id<UMKMockURLRequest>)mockRequest
+{
+    NSParameterAssert(mockRequest);
+
+    os_unfair_lock_lock(&_lock);
+    NSUInteger serviceCount = [[_serviceCounts objectForKey:mockRequest] unsignedIntegerValue];
+    os_unfair_lock_unlock(&_lock);
+    return serviceCount;
+}
+
+
+- (void)reset
+{
+    os_unfair_lock_lock(&_lock);
+    [_serviceCounts removeAllObjects];
+    _finishedResponseCount = 0;
+    os_unfair_lock_unlock(&_lock);
+
+    [self signal];
+}
+
+
+#pragma mark - Events
+
+- (void)postEvent:(UMKMockRegistryEvent *)event
+{
+    NSParameterAssert(event);
+
+    // Counts must be updated before waiters are signaled so that no waiter can miss the change
+    os_unfair_lock_lock(&_lock);
+    if (event.kind == UMKMockRegistryEventKindServiced) {
+        NSUInteger serviceCount = [[_serviceCounts objectForKey:event.mockRequest] unsignedIntegerValue];
+        [_serviceCounts setObject:@(serviceCount + 1) forKey:event.mockRequest];
+    } else if (event.kind == UMKMockRegistryEventKindFinishedResponse) {
+        _finishedResponseCount++;
+    }
+
+    NSArray<UMKMockEventObserver *> *observers = _observers;
+    os_unfair_lock_unlock(&_lock);
+
+    for (UMKMockEventObserver *observer in observers) {
+        observer.block(event);
+    }
+
+    [self signal];
+}
+
+
+- (void)signal
+{
+    NSMutableArray<UMKMockEventWaiter *> *waitersToEvaluate = nil;
+
+    [_condition lock];
+    ++_signalCount;
+    [_condition broadcast];
+    for (UMKMockEventWaiter *waiter in _waiters) {
+        if (!waiter.isEvaluationScheduled) {
+            waiter.evaluationScheduled = YES;
+            waitersToEvaluate = waitersToEvaluate ?: [[NSMutableArray alloc] init];
+            [waitersToEvaluate addObject:waiter];
+        }
+    }
+    [_condition unlock];
+
+    for (UMKMockEventWaiter *waiter in waitersToEvaluate) {
+        dispatch_async(waiter.queue, ^{
+            [self evaluateWaiter:waiter];
+        });
+    }
+}
+
+
+#pragma mark - Observers
+
+- (id<NSObject>)addObserverUsingBlock:(void (^)(UMKMockRegistryEvent *event))block
+{
+    NSParameterAssert(block);
+
+    UMKMockEventObserver *observer = [[UMKMockEventObserver alloc] initWithBlock:block];
+    os_unfair_lock_lock(&_lock);
+    _observers = [_observers arrayByAddingObject:observer];
+    os_unfair_lock_unlock(&_lock);
+
+    return observer;
+}
+
+
+- (void)removeObserver:(id<NSObject>)observer
+{
+    if (!observer) {
+        return;
+    }
+
+    os_unfair_lock_lock(&_lock);
+    NSMutableArray<UMKMockEventObserver *> *observers = [_observers mutableCopy];
+    [observers removeObjectIdenticalTo:observer];
+    _observers = [observers copy];
+    os_unfair_lock_unlock(&_lock);
+}
+
+
+#pragma mark - Waiting
+
+- (BOOL)waitForCondition:(BOOL (^)(void))condition timeout:(NSTimeInterval)timeout
+{
+    NSParameterAssert(condition);
+
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:timeout];
+    while (YES) {
+        // Reading the signal count before evaluating the condition means that if an event is posted while we evaluate
+        // it, the count will have changed by the time we would sleep, so we evaluate it again instead of missing it
+        [_condition lock];
+        uint64_t signalCount = _signalCount;
+        [_condition unlock];
+
+        if (condition()) {
+            return YES;
+        }
+
+        [_condition lock];
+        BOOL signaled = YES;
+        while (_signalCount == signalCount && (signaled = [_condition waitUntilDate:deadline]));
+        [_condition unlock];
+
+        if (!signaled) {
+            return condition();
+        }
+    }
+}
+
+
+- (void)notifyWhenCondition:(BOOL (^)(void))condition
+                    timeout:(NSTimeInterval)timeout
+                      queue:(dispatch_queue_t)queue
+          completionHandler:(void (^)(BOOL conditionMet))completionHandler
+{
+    NSParameterAssert(condition);
+    NSParameterAssert(queue);
+    NSParameterAssert(completionHandler);
+
+    UMKMockEventWaiter *waiter = [[UMKMockEventWaiter alloc] initWithCondition:condition queue:queue completionHandler:completionHandler];
+    waiter.evaluationScheduled = YES;
+
+    [_condition lock];
+    [_waiters addObject:waiter];
+    [_condition unlock];
+
+    dispatch_async(queue, ^{
+        [self evaluateWaiter:waiter];
+    });
+
+    // If the waiter is still pending when the timeout elapses, it gives up
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC)), queue, ^{
+        [self->_condition lock];
+        NSUInteger index = [self->_waiters indexOfObjectIdenticalTo:waiter];
+        if (index != NSNotFound) {
+            [self->_waiters removeObjectAtIndex:index];
+        }
+        [self->_condition unlock];
+
+        if (index != NSNotFound) {
+            completionHandler(NO);
+        }
+    });
+}
+
+
+/*!
+ @abstract Evaluates the condition of the specified asynchronous waiter and, if it is met, completes the wait.
+ @discussion This is invoked on the waiter's queue. Signals that arrive while the condition is being evaluated schedule
+     another evaluation, so none are missed.
+ @param waiter The waiter.
+ */
+- (void)evaluateWaiter:(UMKMockEventWaiter *)waiter
+{
+    [_condition lock];
+    waiter.evaluationScheduled = NO;
+    BOOL pending = [_waiters indexOfObjectIdenticalTo:waiter] != NSNotFound;
+    [_condition unlock];
+
+    if (!pending || !waiter.condition()) {
+        return;
+    }
+
+    // The wait may have timed out while the condition was being evaluated
+    [_condition lock];
+    NSUInteger index = [_waiters indexOfObjectIdenticalTo:waiter];
+    if (index != NSNotFound) {
+        [_waiters removeObjectAtIndex:index];
+    }
+    [_condition unlock];
+
+    if (index != NSNotFound) {
+        waiter.completionHandler(YES);
+    }
+}
+
+@end
@@ -0,0 +1,1184 @@
+//
+//  UMKMockRegistry.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import <URLMock/UMKMockRegistry.h>
+
+#import <URLMock/UMKErrorUtilities.h>
+#import <URLMock/UMKMockRequestStatistics.h>
+#import <URLMock/UMKMockURLProtocol.h>
+#import <URLMock/UMKRequestJournal.h>
+
+#import "UMKMockEventCenter.h"
+#import "UMKMockRegistry+UMKMockURLProtocol.h"
+#import "UMKMockRequestIndex.h"
+
+#import <objc/runtime.h>
+#import <os/lock.h>
+#import <stdatomic.h>
+
+
+#pragma mark UMKMockRegistryEvent
+
+@implementation UMKMockRegistryEvent
+
+- (instancetype)initWithKind:(UMKMockRegistryEventKind)kind
+                     request:(NSURLRequest *)request
+                 mockRequest:(id<UMKMockURLRequest>)mockRequest
+                       error:(NSError *)error
+{
+    NSParameterAssert(request);
+    NSParameterAssert(kind != UMKMockRegistryEventKindServiced || mockRequest);
+
+    self = [super init];
+    if (self) {
+        _kind = kind;
+        _request = request;
+        _mockRequest = mockRequest;
+        _error = error;
+    }
+
+    return self;
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+#pragma mark - UMKMockRequestMatch
+
+/*!
+ UMKMockRequestMatches record the result of matching a URL request against a registry's expected mock requests. They
+ allow the match performed in +canInitWithRequest: to be reused when the protocol instance for the request is created.
+ */
+@interface UMKMockRequestMatch : NSObject
+
+/*! The index entry of the mock request that matched. */
+@property (nonatomic, strong, readonly) UMKMockRequestIndexEntry *entry;
+
+/*! The mock request that matched. */
+@property (nonatomic, strong, readonly) id<UMKMockURLRequest> mockRequest;
+
+/*! The statistics of the mock request's index entry, if any. */
+@property (nonatomic, strong, readonly, nullable) UMKMockRequestStatistics *statistics;
+
+/*! The generation of the expected mock requests index when the match was performed. */
+@property (nonatomic, assign, readonly) uint64_t generation;
+
+/*!
+ @abstract Whether the match can be reused by the protocol instance for the URL request.
+ @discussion Matches can't be reused while statistics are being recorded, since the lookup that found them didn't
+     record its evaluations.
+ */
+@property (nonatomic, assign, readonly, getter=isReusable) BOOL reusable;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ @abstract Initializes a newly allocated match with the mock request and statistics of the specified index entry and
+     the generation of the specified index.
+ @param entry The index entry whose mock request matched. May not be nil.
+ @param expectedMockRequests The expected mock requests index in which the match was performed. May not be nil.
+ @result An initialized match.
+ */
+- (instancetype)initWithEntry:(UMKMockRequestIndexEntry *)entry
+         expectedMockRequests:(UMKMockRequestIndex *)expectedMockRequests NS_DESIGNATED_INITIALIZER;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+
+#pragma mark -
+
+@implementation UMKMockRequestMatch
+
+- (instancetype)initWithEntry:(UMKMockRequestIndexEntry *)entry expectedMockRequests:(UMKMockRequestIndex *)expectedMockRequests
+{
+    NSParameterAssert(entry);
+    NSParameterAssert(expectedMockRequests);
+
+    self = [super init];
+    if (self) {
+        _entry = entry;
+        _mockRequest = entry.mockRequest;
+        _statistics = entry.statistics;
+        _generation = expectedMockRequests.generation;
+        _reusable = !expectedMockRequests.recordsStatistics;
+    }
+
+    return self;
+}
+
+@end
+
+
+#pragma mark - UMKMockRegistry
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface UMKMockRegistry ()
+
+/*! The receiver's protocol class, or Nil if it has not been created yet. */
+@property (nonatomic, nullable) Class generatedProtocolClass;
+
+/*! 
+ @abstract The receiver's expected mock requests. 
+ @discussion The index keeps mock requests in the order in which they were added and allows plain UMKMockHTTPRequests
+     to be found without scanning every expected mock request. This variable should only be accessed inside a block
+     passed to -writeExpectedMockRequestsUsingBlock:. Readers should use -readExpectedMockRequestsUsingBlock:, which
+     provides an immutable snapshot of the index instead.
+ */
+@property (nonatomic, strong, readonly) UMKMockRequestIndex *expectedMockRequestIndex;
+
+/*! 
+ @abstract The generation of the receiver's expected mock requests.
+ @discussion This can be read from any thread without blocking.
+ */
+@property (nonatomic, assign, readonly) uint64_t expectedMockRequestsGeneration;
+
+/*! The isolation queue for reading/writing unexpected requests. */
+@property (nonatomic, copy, readonly) dispatch_queue_t unexpectedRequestsIsolationQueue;
+
+/*! 
+ @abstract The receiver's unexpected requests.
+ @discussion This variable should only be read and written on its isolation queue. Reads should be done using dispatch_sync;
+     writes should be done using dispatch_barrier_async.
+*/
+@property (nonatomic, strong, readonly) NSMutableArray<NSURLRequest *> *mutableUnexpectedRequests;
+
+/*! The isolation queue for reading/writing serviced requests. */
+@property (nonatomic, copy, readonly) dispatch_queue_t servicedRequestsIsolationQueue;
+
+/*!
+ @abstract The receiver's serviced requests. Keys are NSURLRequests; values are UMKMockURLRequests.
+ @discussion This variable should only be read and written on its isolation queue. Reads should be done using dispatch_sync;
+     writes should be done using dispatch_barrier_async.
+ */
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSURLRequest *, id<UMKMockURLRequest>> *mutableServicedRequests;
+
+/*!
+ @abstract The keys of mutableServicedRequests in the order they were added.
+ @discussion This variable should only be read and written on the serviced requests isolation queue.
+ */
+@property (nonatomic, strong, readonly) NSMutableArray<NSURLRequest *> *servicedRequestOrder;
+
+/*! The isolation queue for reading/writing pending matches. */
+@property (nonatomic, copy, readonly) dispatch_queue_t pendingMatchesIsolationQueue;
+
+/*!
+ @abstract Matches performed by +canInitWithRequest: that have not yet been used by a protocol instance. Keys are
+     weakly-held NSURLRequests compared by identity; values are UMKMockRequestMatches.
+ @discussion This variable should only be read and written on its isolation queue. Reads should be done using dispatch_sync;
+     writes should be done using dispatch_barrier_async or, when the written value must be returned, dispatch_barrier_sync.
+ */
+@property (nonatomic, strong, readonly) NSMapTable<NSURLRequest *, UMKMockRequestMatch *> *pendingMatches;
+
+/*! The receiver's event center, which publishes its events and wakes up threads that are waiting for them. */
+@property (nonatomic, strong, readonly) UMKMockEventCenter *eventCenter;
+
+/*!
+ @abstract Initializes a newly allocated registry with the specified protocol class.
+ @param protocolClass The registry's protocol class, or Nil if it should be generated when needed.
+ @result An initialized registry.
+ */
+- (instancetype)initWithProtocolClass:(nullable Class)protocolClass NS_DESIGNATED_INITIALIZER;
+
+/*!
+ @abstract Invokes the specified block with a snapshot of the receiver's expected mock requests.
+ @discussion Snapshots are immutable, so any number of readers may use them at once. Readers take no locks unless the
+     expected mock requests have changed since the last snapshot was taken, in which case the first reader to notice
+     creates a new snapshot, or unless they are the last reader that could be using a retired snapshot, in which case
+     they release it. The snapshot should not be used after the block returns.
+ @param block The block to invoke. May not be nil.
+ */
+- (void)readExpectedMockRequestsUsingBlock:(void (^)(UMKMockRequestIndex *snapshot))block;
+
+/*!
+ @abstract Invokes the specified block with the receiver's expected mock requests so that it may modify them.
+ @discussion Writers are serialized, and their changes are visible to all readers that start after the block returns.
+ @param block The block to invoke. May not be nil.
+ */
+- (void)writeExpectedMockRequestsUsingBlock:(void (^)(UMKMockRequestIndex *expectedMockRequests))block;
+
+/*!
+ @abstract Returns the number of snapshots of the receiver's expected mock requests that have been replaced but not yet
+     released because readers may still be using them.
+ @result The number of retired snapshots.
+ */
+- (NSUInteger)retiredExpectedMockRequestsSnapshotCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+
+#pragma mark -
+
+@implementation UMKMockRegistry {
+    /*! Serializes writers of the expected mock requests and snapshot creation. */
+    os_unfair_lock _expectedMockRequestsLock;
+
+    /*! 
+     The current snapshot of the expected mock requests, retained, or NULL if the expected mock requests have changed
+     since the last snapshot was taken.
+     */
+    _Atomic(void *) _expectedMockRequestsSnapshot;
+
+    /*!
+     The number of readers of the expected mock requests that started in each reader phase. Readers count themselves in
+     the phase that is current when they start, so once the phase changes, the count for the previous phase only falls.
+     */
+    _Atomic(NSUInteger) _expectedMockRequestsReaderCounts[2];
+
+    /*! The current reader phase, either 0 or 1. Only written while holding the lock. */
+    _Atomic(NSUInteger) _expectedMockRequestsReaderPhase;
+
+    /*! Backs the expectedMockRequestsGeneration property. */
+    _Atomic(uint64_t) _expectedMockRequestsGeneration;
+
+    /*! 
+     Snapshots that have been replaced during the current reader phase, and so may be in use by readers in either phase. 
+     Only accessed while holding the lock.
+     */
+    NSMutableArray<UMKMockRequestIndex *> *_retiredExpectedMockRequestsSnapshots;
+
+    /*!
+     Snapshots that were replaced before the current reader phase began, and so may only be in use by readers in the
+     previous phase. Only accessed while holding the lock.
+     */
+    NSMutableArray<UMKMockRequestIndex *> *_expiringExpectedMockRequestsSnapshots;
+
+    /*! The total number of retired and expiring snapshots. Only written while holding the lock. */
+    _Atomic(NSUInteger) _retiredExpectedMockRequestsSnapshotCount;
+
+    /*!
+     The tracking entry of each distinct mock request in the expected mock requests index. A mock request's tracking 
+     entry is its first entry, and marking it as serviced is what counts the mock request as serviced. Every other entry
+     is marked as serviced when it is added, so servicing it is never counted. Only accessed while holding the lock.
+     */
+    NSMapTable<id<UMKMockURLRequest>, UMKMockRequestIndexEntry *> *_trackingEntriesByMockRequest;
+
+    /*! 
+     The mock requests that serviced a request while verification was enabled and whose tracking entries have since 
+     been removed. Only accessed while holding the lock.
+     */
+    NSMutableSet<id<UMKMockURLRequest>> *_servicedMockRequests;
+
+    /*! Backs the unexpectedRequestCount property. */
+    _Atomic(NSUInteger) _unexpectedRequestCount;
+
+    /*! 
+     Backs the unservicedMockRequestCount property. This is the number of tracking entries that have not been marked as
+     serviced. It is incremented while holding the lock when a tracking entry is added and decremented by whichever
+     thread successfully marks a tracking entry as serviced, so servicing requests doesn't need the lock.
+     */
+    _Atomic(NSUInteger) _unservicedMockRequestCount;
+
+    /*! 
+     Protects _statisticsByMockRequest and _mockRequestStatistics, so that querying statistics doesn't contend with 
+     writers of the expected mock requests. Writers that hold the expected mock requests lock may take this lock, but
+     not the other way around.
+     */
+    os_unfair_lock _statisticsLock;
+
+    /*! The statistics for each mock request, keyed by identity. Only accessed while holding the statistics lock. */
+    NSMapTable<id<UMKMockURLRequest>, UMKMockRequestStatistics *> *_statisticsByMockRequest;
+
+    /*! 
+     The statistics in _statisticsByMockRequest in the order they were created. Only accessed while holding the
+     statistics lock.
+     */
+    NSMutableArray<UMKMockRequestStatistics *> *_mockRequestStatistics;
+}
+
++ (UMKMockRegistry *)defaultRegistry
+{
+    static UMKMockRegistry *defaultRegistry = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        defaultRegistry = [[self alloc] initWithProtocolClass:[UMKMockURLProtocol class]];
+    });
+
+    return defaultRegistry;
+}
+
+
+- (instancetype)init
+{
+    return [self initWithProtocolClass:Nil];
+}
+
+
+- (instancetype)initWithProtocolClass:(Class)protocolClass
+{
+    self = [super init];
+    if (self) {
+        _generatedProtocolClass = protocolClass;
+        _retainsRequests = YES;
+        _retainedRequestLimit = NSUIntegerMax;
+        _journal = [[UMKRequestJournal alloc] init];
+        _eventCenter = [[UMKMockEventCenter alloc] init];
+
+        _mutableUnexpectedRequests = [[NSMutableArray alloc] init];
+        NSString *label = [NSString stringWithFormat:@"%@.isolation.unexpectedRequests", self.class];
+        _unexpectedRequestsIsolationQueue = dispatch_queue_create([label UTF8String], 0);
+        
+        _expectedMockRequestIndex = [[UMKMockRequestIndex alloc] init];
+        _expectedMockRequestsLock = OS_UNFAIR_LOCK_INIT;
+        atomic_init(&_expectedMockRequestsSnapshot, NULL);
+        atomic_init(&_expectedMockRequestsReaderCounts[0], 0);
+        atomic_init(&_expectedMockRequestsReaderCounts[1], 0);
+        atomic_init(&_expectedMockRequestsReaderPhase, 0);
+        atomic_init(&_expectedMockRequestsGeneration, 0);
+        _retiredExpectedMockRequestsSnapshots = [[NSMutableArray alloc] init];
+        _expiringExpectedMockRequestsSnapshots = [[NSMutableArray alloc] init];
+        atomic_init(&_retiredExpectedMockRequestsSnapshotCount, 0);
+
+        _trackingEntriesByMockRequest = [NSMapTable strongToStrongObjectsMapTable];
+        _servicedMockRequests = [[NSMutableSet alloc] init];
+        atomic_init(&_unexpectedRequestCount, 0);
+        atomic_init(&_unservicedMockRequestCount, 0);
+        _statisticsLock = OS_UNFAIR_LOCK_INIT;
+        _statisticsByMockRequest = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                                          valueOptions:NSPointerFunctionsStrongMemory];
+        _mockRequestStatistics = [[NSMutableArray alloc] init];
+        
+        _mutableServicedRequests = [[NSMutableDictionary alloc] init];
+        _servicedRequestOrder = [[NSMutableArray alloc] init];
+        label = [NSString stringWithFormat:@"%@.isolation.servicedRequests", self.class];
+        _servicedRequestsIsolationQueue = dispatch_queue_create([label UTF8String], 0);
+
+        _pendingMatches = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsWeakMemory | NSPointerFunctionsObjectPointerPersonality
+                                                valueOptions:NSPointerFunctionsStrongMemory];
+        label = [NSString stringWithFormat:@"%@.isolation.pendingMatches", self.class];
+        _pendingMatchesIsolationQueue = dispatch_queue_create([label UTF8String], 0);
+    }
+
+    return self;
+}
+
+
+- (void)dealloc
+{
+    void *snapshot = atomic_exchange(&_expectedMockRequestsSnapshot, NULL);
+    if (snapshot) {
+        CFRelease(snapshot);
+    }
+}
+
+
+- (NSString *)debugDescription
+{
+    return [NSString stringWithFormat:@"<%@: %p> verificationEnabled: %@, unexpectedRequests: %@; "
+                                      @"expectedMockRequests: %@, servicedRequests: %@", self.class, self,
+                                                                                         self.verificationEnabled ? @"YES" : @"NO",
+                                                                                         self.unexpectedRequests.debugDescription,
+                                                                                         self.expectedMockRequests.debugDescription,
+                                                                                         self.servicedRequests.debugDescription];
+}
+
+
+#pragma mark - Protocol Class
+
+- (Class)protocolClass
+{
+    @synchronized (self) {
+        if (!self.generatedProtocolClass) {
+            self.generatedProtocolClass = [self createProtocolClass];
+        }
+
+        return self.generatedProtocolClass;
+    }
+}
+
+
+/*!
+ @abstract Creates and registers a new UMKMockURLProtocol subclass whose +mockRegistry method returns the receiver.
+ @result The new protocol class.
+ */
+- (Class)createProtocolClass
+{
+    Class superclass = [UMKMockURLProtocol class];
+    NSString *className = [NSString stringWithFormat:@"%@_%@", NSStringFromClass(superclass),
+                                                     [[NSUUID UUID].UUIDString stringByReplacingOccurrencesOfString:@"-" withString:@""]];
+
+    Class protocolClass = objc_allocateClassPair(superclass, className.UTF8String, 0);
+    NSAssert(protocolClass, @"Could not create protocol class %@", className);
+
+    // The class can't be destroyed while sessions might be using it, so it only holds a weak reference to the receiver
+    __weak UMKMockRegistry *weakSelf = self;
+    Method mockRegistryMethod = class_getClassMethod(superclass, @selector(mockRegistry));
+    class_addMethod(object_getClass(protocolClass), @selector(mockRegistry), imp_implementationWithBlock(^UMKMockRegistry *(id _self) {
+        return weakSelf;
+    }), method_getTypeEncoding(mockRegistryMethod));
+
+    objc_registerClassPair(protocolClass);
+    return protocolClass;
+}
+
+
+- (void)registerWithSessionConfiguration:(NSURLSessionConfiguration *)configuration
+{
+    NSParameterAssert(configuration);
+
+    Class protocolClass = self.protocolClass;
+    NSMutableArray<Class> *protocolClasses = [configuration.protocolClasses mutableCopy] ?: [[NSMutableArray alloc] init];
+    [protocolClasses removeObject:protocolClass];
+    [protocolClasses insertObject:protocolClass atIndex:0];
+    configuration.protocolClasses = protocolClasses;
+}
+
+
+#pragma mark - Accounting
+
+- (void)reset
+{
+    [self writeExpectedMockRequestsUsingBlock:^(UMKMockRequestIndex *expectedMockRequests) {
+        [expectedMockRequests removeAllMockRequests];
+
+        // Requests matched against older snapshots may still mark tracking entries as serviced, so rather than zeroing
+        // the count out from under them, mark the entries ourselves and only uncount the ones we marked
+        for (UMKMockRequestIndexEntry *entry in self->_trackingEntriesByMockRequest.objectEnumerator) {
+            if ([entry markServiced]) {
+                atomic_fetch_sub(&self->_unservicedMockRequestCount, 1);
+            }
+        }
+
+        [self->_trackingEntriesByMockRequest removeAllObjects];
+        [self->_servicedMockRequests removeAllObjects];
+
+        os_unfair_lock_lock(&self->_statisticsLock);
+        [self->_statisticsByMockRequest removeAllObjects];
+        [self->_mockRequestStatistics removeAllObjects];
+        os_unfair_lock_unlock(&self->_statisticsLock);
+    }];
+    
+    // Unexpected requests received after this point are recorded after the barrier, so they are counted correctly
+    atomic_store(&_unexpectedRequestCount, 0);
+    dispatch_barrier_async(self.unexpectedRequestsIsolationQueue, ^{
+        [self.mutableUnexpectedRequests removeAllObjects];
+    });
+    
+    dispatch_barrier_async(self.servicedRequestsIsolationQueue, ^{
+        [self.mutableServicedRequests removeAllObjects];
+        [self.servicedRequestOrder removeAllObjects];
+    });
+
+    dispatch_barrier_async(self.pendingMatchesIsolationQueue, ^{
+        [self.pendingMatches removeAllObjects];
+    });
+
+    [self.journal removeAllRecords];
+    [self.eventCenter reset];
+}
+
+
+#pragma mark - Expected Mock Requests
+
+- (uint64_t)expectedMockRequestsGeneration
+{
+    return atomic_load(&_expectedMockRequestsGeneration);
+}
+
+
+- (void)readExpectedMockRequestsUsingBlock:(void (^)(UMKMockRequestIndex *snapshot))block
+{
+    NSParameterAssert(block);
+
+    // Registering as a reader before loading the snapshot guarantees that writers won't release it while we use it
+    NSUInteger phase = atomic_load(&_expectedMockRequestsReaderPhase);
+    atomic_fetch_add(&_expectedMockRequestsReaderCounts[phase], 1);
+
+    void *snapshot = atomic_load(&_expectedMockRequestsSnapshot);
+    if (!snapshot) {
+        os_unfair_lock_lock(&_expectedMockRequestsLock);
+        snapshot = atomic_load(&_expectedMockRequestsSnapshot);
+        if (!snapshot) {
+            snapshot = (void *)CFBridgingRetain([self.expectedMockRequestIndex copy]);
+            atomic_store(&_expectedMockRequestsSnapshot, snapshot);
+        }
+
+        os_unfair_lock_unlock(&_expectedMockRequestsLock);
+    }
+
+    block((__bridge UMKMockRequestIndex *)snapshot);
+
+    // If we were the last reader in our phase, retired snapshots may no longer be in use
+    if (atomic_fetch_sub(&_expectedMockRequestsReaderCounts[phase], 1) == 1 &&
+        atomic_load(&_retiredExpectedMockRequestsSnapshotCount) > 0) {
+        os_unfair_lock_lock(&_expectedMockRequestsLock);
+        [self releaseUnusedRetiredExpectedMockRequestsSnapshots];
+        os_unfair_lock_unlock(&_expectedMockRequestsLock);
+    }
+}
+
+
+- (void)writeExpectedMockRequestsUsingBlock:(void (^)(UMKMockRequestIndex *expectedMockRequests))block
+{
+    NSParameterAssert(block);
+
+    os_unfair_lock_lock(&_expectedMockRequestsLock);
+    uint64_t generation = self.expectedMockRequestIndex.generation;
+    block(self.expectedMockRequestIndex);
+
+    // Snapshots are only invalidated when the expected mock requests actually change. The next reader takes a new one.
+    if (self.expectedMockRequestIndex.generation != generation) {
+        atomic_store(&_expectedMockRequestsGeneration, self.expectedMockRequestIndex.generation);
+        void *snapshot = atomic_exchange(&_expectedMockRequestsSnapshot, NULL);
+        if (snapshot) {
+            [_retiredExpectedMockRequestsSnapshots addObject:CFBridgingRelease(snapshot)];
+            atomic_fetch_add(&_retiredExpectedMockRequestsSnapshotCount, 1);
+        }
+
+        [self releaseUnusedRetiredExpectedMockRequestsSnapshots];
+    }
+
+    os_unfair_lock_unlock(&_expectedMockRequestsLock);
+}
+
+
+/*!
+ @abstract Releases the receiver's retired snapshots that no reader can be using and advances the reader phase if
+     possible.
+ @discussion A reader that loads the snapshot pointer after a snapshot is retired can never see it. When the reader phase 
+     changes, the snapshots retired during the old phase begin expiring: only readers that started in the old phase can be
+     using them, and since new readers start in the new phase, the old phase's reader count eventually reaches zero, at 
+     which point the expiring snapshots are released. The phase only changes once the new phase's count from its previous
+     use has reached zero and no snapshots are expiring, so a steady stream of overlapping readers can't keep retired 
+     snapshots alive indefinitely. This method must be invoked while holding the expected mock requests lock.
+ */
+- (void)releaseUnusedRetiredExpectedMockRequestsSnapshots
+{
+    NSUInteger phase = atomic_load(&_expectedMockRequestsReaderPhase);
+    NSUInteger previousPhase = phase ^ 1;
+    if (_expiringExpectedMockRequestsSnapshots.count > 0) {
+        if (atomic_load(&_expectedMockRequestsReaderCounts[previousPhase]) > 0) {
+            return;
+        }
+
+        atomic_fetch_sub(&_retiredExpectedMockRequestsSnapshotCount, _expiringExpectedMockRequestsSnapshots.count);
+        [_expiringExpectedMockRequestsSnapshots removeAllObjects];
+    }
+
+    if (_retiredExpectedMockRequestsSnapshots.count == 0 || atomic_load(&_expectedMockRequestsReaderCounts[previousPhase]) > 0) {
+        return;
+    }
+
+    NSMutableArray<UMKMockRequestIndex *> *expiringSnapshots = _retiredExpectedMockRequestsSnapshots;
+    _retiredExpectedMockRequestsSnapshots = _expiringExpectedMockRequestsSnapshots;
+    _expiringExpectedMockRequestsSnapshots = expiringSnapshots;
+    atomic_store(&_expectedMockRequestsReaderPhase, previousPhase);
+
+    // If no readers started in the old phase, the snapshots can be released right away
+    if (atomic_load(&_expectedMockRequestsReaderCounts[phase]) == 0) {
+        atomic_fetch_sub(&_retiredExpectedMockRequestsSnapshotCount, _expiringExpectedMockRequestsSnapshots.count);
+        [_expiringExpectedMockRequestsSnapshots removeAllObjects];
+    }
+}
+
+
+- (NSUInteger)retiredExpectedMockRequestsSnapshotCount
+{
+    return atomic_load(&_retiredExpectedMockRequestsSnapshotCount);
+}
+
+
+- (NSArray<id<UMKMockURLRequest>> *)expectedMockRequests
+{
+    __block NSArray<id<UMKMockURLRequest>> *expectedMockRequests = nil;
+    [self readExpectedMockRequestsUsingBlock:^(UMKMockRequestIndex *snapshot) {
+        expectedMockRequests = snapshot.mockRequests;
+    }];
+    
+    return expectedMockRequests;
+}
+
+
+- (void)expectMockRequest:(id<UMKMockURLRequest>)request
+{
+    NSParameterAssert(request);
+    [self expectMockRequests:@[ request ]];
+}
+
+
+- (void)expectMockRequests:(NSArray<id<UMKMockURLRequest>> *)requests
+{
+    NSParameterAssert(requests);
+
+    BOOL statisticsEnabled = self.isStatisticsEnabled;
+    [self writeExpectedMockRequestsUsingBlock:^(UMKMockRequestIndex *expectedMockRequests) {
+        NSArray<UMKMockRequestIndexEntry *> *entries =
+            [expectedMockRequests addMockRequests:requests
+                                       statistics:statisticsEnabled ? [self statisticsForExpectedMockRequests:requests] : nil];
+
+        // Mock requests that are already expected or have already serviced a request aren't counted again
+        for (UMKMockRequestIndexEntry *entry in entries) {
+            if (![self->_trackingEntriesByMockRequest objectForKey:entry.mockRequest] &&
+                ![self->_servicedMockRequests containsObject:entry.mockRequest]) {
+                [self->_trackingEntriesByMockRequest setObject:entry forKey:entry.mockRequest];
+                atomic_fetch_add(&self->_unservicedMockRequestCount, 1);
+            } else {
+                [entry markServiced];
+            }
+        }
+    }];
+}
+
+
+- (void)removeExpectedMockRequest:(id<UMKMockURLRequest>)request
+{
+    if (request) {
+        [self removeExpectedMockRequests:@[ request ]];
+    }
+}
+
+
+- (void)removeExpectedMockRequests:(NSArray<id<UMKMockURLRequest>> *)requests
+{
+    NSParameterAssert(requests);
+
+    [self writeExpectedMockRequestsUsingBlock:^(UMKMockRequestIndex *expectedMockRequests) {
+        [self removeExpectedMockRequests:requests fromIndex:expectedMockRequests];
+    }];
+
+    // Removing mock requests can satisfy a wait for the expected mock requests to be serviced
+    [self.eventCenter signal];
+}
+
+
+/*!
+ @abstract Removes the specified mock requests from the specified expected mock requests index, updating the 
+     receiver's unserviced mock request count.
+ @discussion This method must be invoked inside a block passed to -writeExpectedMockRequestsUsingBlock:.
+ @param requests The mock requests to remove. May not be nil.
+ @param expectedMockRequests The receiver's expected mock requests index. May not be nil.
+ */
+- (void)removeExpectedMockRequests:(NSArray<id<UMKMockURLRequest>> *)requests fromIndex:(UMKMockRequestIndex *)expectedMockRequests
+{
+    [expectedMockRequests removeMockRequests:requests];
+
+    // The index removes every occurrence of each mock request, so none of them are expected anymore. Marking a removed
+    // tracking entry ensures that a request matched against an older snapshot can't uncount it a second time.
+    for (id<UMKMockURLRequest> request in requests) {
+        UMKMockRequestIndexEntry *entry = [_trackingEntriesByMockRequest objectForKey:request];
+        if (!entry) {
+            continue;
+        }
+
+        [_trackingEntriesByMockRequest removeObjectForKey:request];
+        if ([entry markServiced]) {
+            atomic_fetch_sub(&_unservicedMockRequestCount, 1);
+        } else {
+            [_servicedMockRequests addObject:request];
+        }
+    }
+}
+
+
+/*!
+ @abstract Returns the statistics for each of the specified mock requests, creating them as needed.
+ @discussion This method must be invoked inside a block passed to -writeExpectedMockRequestsUsingBlock:.
+ @param requests The mock requests. May not be nil.
+ @result The statistics for each mock request, in the same order as the mock requests.
+ */
+- (NSArray<UMKMockRequestStatistics *> *)statisticsForExpectedMockRequests:(NSArray<id<UMKMockURLRequest>> *)requests
+{
+    NSMutableArray<UMKMockRequestStatistics *> *statistics = [[NSMutableArray alloc] initWithCapacity:requests.count];
+    os_unfair_lock_lock(&_statisticsLock);
+    for (id<UMKMockURLRequest> request in requests) {
+        UMKMockRequestStatistics *requestStatistics = [_statisticsByMockRequest objectForKey:request];
+        if (!requestStatistics) {
+            requestStatistics = [[UMKMockRequestStatistics alloc] initWithMockRequest:request];
+            [_statisticsByMockRequest setObject:requestStatistics forKey:request];
+            [_mockRequestStatistics addObject:requestStatistics];
+        }
+
+        [statistics addObject:requestStatistics];
+    }
+
+    os_unfair_lock_unlock(&_statisticsLock);
+    return statistics;
+}
+
+
+#pragma mark - Statistics
+
+- (UMKMockRequestStatistics *)statisticsForMockRequest:(id<UMKMockURLRequest>)mockRequest
+{
+    NSParameterAssert(mockRequest);
+
+    os_unfair_lock_lock(&_statisticsLock);
+    UMKMockRequestStatistics *statistics = [_statisticsByMockRequest objectForKey:mockRequest];
+    os_unfair_lock_unlock(&_statisticsLock);
+    return statistics;
+}
+
+
+- (NSArray<UMKMockRequestStatistics *> *)mockRequestStatistics
+{
+    os_unfair_lock_lock(&_statisticsLock);
+    NSArray<UMKMockRequestStatistics *> *mockRequestStatistics = [_mockRequestStatistics copy];
+    os_unfair_lock_unlock(&_statisticsLock);
+    return mockRequestStatistics;
+}
+
+
+#pragma mark - Verification
+
+- (NSArray<NSURLRequest *> *)unexpectedRequests
+{
+    __block NSArray<NSURLRequest *> *unexpectedRequests = nil;
+    dispatch_sync(self.unexpectedRequestsIsolationQueue, ^{
+        unexpectedRequests = [self.mutableUnexpectedRequests copy];
+    });
+    
+    return unexpectedRequests;
+}
+
+
+- (NSDictionary<NSURLRequest *, id<UMKMockURLRequest>> *)servicedRequests
+{
+    __block NSDictionary<NSURLRequest *, id<UMKMockURLRequest>> *servicedRequests = nil;
+    dispatch_sync(self.servicedRequestsIsolationQueue, ^{
+        servicedRequests = [self.mutableServicedRequests copy];
+    });
+    
+    return servicedRequests;
+}
+
+
+- (NSUInteger)unexpectedRequestCount
+{
+    return atomic_load(&_unexpectedRequestCount);
+}
+
+
+- (NSUInteger)unservicedMockRequestCount
+{
+    return atomic_load(&_unservicedMockRequestCount);
+}
+
+
+/*!
+ @abstract Returns the receiver's expected mock requests that have not serviced a request, in the order in which they
+     were added.
+ @result The receiver's unserviced mock requests.
+ */
+- (NSArray<id<UMKMockURLRequest>> *)unservicedMockRequests
+{
+    // The tracking entries are only accessed while holding the lock, so take it to get a consistent view of them and
+    // the expected mock requests. This is only done when verification fails.
+    NSMutableArray<id<UMKMockURLRequest>> *unservicedMockRequests = [[NSMutableArray alloc] init];
+    [self writeExpectedMockRequestsUsingBlock:^(UMKMockRequestIndex *expectedMockRequests) {
+        NSMutableSet<id<UMKMockURLRequest>> *seenMockRequests = [[NSMutableSet alloc] init];
+        for (id<UMKMockURLRequest> mockRequest in expectedMockRequests.mockRequests) {
+            UMKMockRequestIndexEntry *entry = [self->_trackingEntriesByMockRequest objectForKey:mockRequest];
+            if (entry && !entry.isServiced && ![seenMockRequests containsObject:mockRequest]) {
+                [seenMockRequests addObject:mockRequest];
+                [unservicedMockRequests addObject:mockRequest];
+            }
+        }
+    }];
+
+    return unservicedMockRequests;
+}
+
+
+- (BOOL)verifyWithError:(NSError **)outError
+{
+    if (!self.isVerificationEnabled) {
+        @throw [NSException exceptionWithName:NSInternalInconsistencyException
+                                       reason:UMKExceptionString(self, _cmd, @"Verification is not enabled.")
+                                     userInfo:nil];
+    }
+
+    // The counters are kept up to date as requests are serviced, so passing verification doesn't need to look at
+    // the requests themselves
+    NSUInteger unexpectedRequestCount = self.unexpectedRequestCount;
+    BOOL receivedUnexpectedRequest = unexpectedRequestCount > 0;
+    BOOL hasUnservicedMockRequests = self.unservicedMockRequestCount > 0;
+
+    BOOL passed = !(receivedUnexpectedRequest || hasUnservicedMockRequests);
+    if (passed || !outError) {
+        return passed;
+    }
+    
+    NSArray<id<UMKMockURLRequest>> *unservicedMockRequests = hasUnservicedMockRequests ? [self unservicedMockRequests] : nil;
+    
+    NSUInteger code = 0;
+    NSMutableDictionary *userInfo = [[NSMutableDictionary alloc] initWithCapacity:4];
+    
+    // We want to prioritize unexpected requests over unserviced requests.
+    // Unserviced requests will be returned whether that's the error code we use or not
+    if (receivedUnexpectedRequest) {
+        code = kUMKUnexpectedRequestErrorCode;
+        userInfo[NSLocalizedDescriptionKey] = NSLocalizedString(@"Received one or more unexpected requests", @"Unexpected request error description");
+        userInfo[kUMKUnexpectedRequestCountKey] = @(unexpectedRequestCount);
+
+        // The retained requests are incomplete if retaining is disabled or limited, so fall back on the journal
+        NSArray<NSURLRequest *> *unexpectedRequests = self.unexpectedRequests;
+        userInfo[kUMKUnexpectedRequestsKey] = unexpectedRequests;
+        if (unexpectedRequests.count < unexpectedRequestCount) {
+            NSPredicate *predicate = [NSPredicate predicateWithBlock:^BOOL(UMKRequestJournalRecord *record, NSDictionary *bindings) {
+                return record.kind == UMKRequestJournalRecordKindUnexpected;
+            }];
+
+            userInfo[kUMKUnexpectedRequestRecordsKey] = [self.journal.records filteredArrayUsingPredicate:predicate];
+        }
+    } else {
+        code = kUMKUnservicedMockRequestErrorCode;
+        userInfo[NSLocalizedDescriptionKey] = NSLocalizedString(@"One or more mock requests were not serviced", @"Unserviced mock request error description");
+    }
+    
+    if (unservicedMockRequests.count > 0) {
+        userInfo[kUMKUnservicedMockRequestsKey] = unservicedMockRequests;
+    }
+    
+    *outError = [NSError errorWithDomain:kUMKErrorDomain code:code userInfo:userInfo];
+    return NO;
+}
+
+
+#pragma mark - Events
+
+- (id<NSObject>)addEventObserverUsingBlock:(void (^)(UMKMockRegistryEvent *event))block
+{
+    return [self.eventCenter addObserverUsingBlock:block];
+}
+
+
+- (void)removeEventObserver:(id<NSObject>)observer
+{
+    [self.eventCenter removeObserver:observer];
+}
+
+
+- (NSUInteger)serviceCountForMockRequest:(id<UMKMockURLRequest>)mockRequest
+{
+    return [self.eventCenter serviceCountForMockRequest:mockRequest];
+}
+
+
+- (NSUInteger)finishedResponseCount
+{
+    return self.eventCenter.finishedResponseCount;
+}
+
+
+#pragma mark - Waiting
+
+- (BOOL)waitForMockRequest:(id<UMKMockURLRequest>)mockRequest serviceCount:(NSUInteger)serviceCount timeout:(NSTimeInterval)timeout
+{
+    NSParameterAssert(mockRequest);
+
+    UMKMockEventCenter *eventCenter = self.eventCenter;
+    return [eventCenter waitForCondition:^BOOL{
+        return [eventCenter serviceCountForMockRequest:mockRequest] >= serviceCount;
+    } timeout:timeout];
+}
+
+
+- (void)waitForMockRequest:(id<UMKMockURLRequest>)mockRequest
+              serviceCount:(NSUInteger)serviceCount
+                   timeout:(NSTimeInterval)timeout
+         completionHandler:(void (^)(BOOL serviced))completionHandler
+{
+    NSParameterAssert(mockRequest);
+
+    UMKMockEventCenter *eventCenter = self.eventCenter;
+    [eventCenter notifyWhenCondition:^BOOL{
+        return [eventCenter serviceCountForMockRequest:mockRequest] >= serviceCount;
+    } timeout:timeout queue:dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0) completionHandler:completionHandler];
+}
+
+
+/*!
+ @abstract Returns whether every one of the receiver's expected mock requests has serviced a request.
+ @result Whether every expected mock request has serviced a request.
+ */
+- (BOOL)expectedMockRequestsServiced
+{
+    for (id<UMKMockURLRequest> mockRequest in self.expectedMockRequests) {
+        if ([self.eventCenter serviceCountForMockRequest:mockRequest] == 0) {
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+
+- (BOOL)waitForExpectedMockRequestsToBeServicedWithTimeout:(NSTimeInterval)timeout
+{
+    __weak UMKMockRegistry *weakSelf = self;
+    return [self.eventCenter waitForCondition:^BOOL{
+        return [weakSelf expectedMockRequestsServiced];
+    } timeout:timeout];
+}
+
+
+- (void)waitForExpectedMockRequestsToBeServicedWithTimeout:(NSTimeInterval)timeout completionHandler:(void (^)(BOOL serviced))completionHandler
+{
+    // The event center holds pending waiters, so don't let them retain the receiver
+    __weak UMKMockRegistry *weakSelf = self;
+    [self.eventCenter notifyWhenCondition:^BOOL{
+        return [weakSelf expectedMockRequestsServiced];
+    } timeout:timeout queue:dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0) completionHandler:completionHandler];
+}
+
+
+- (BOOL)waitForFinishedResponseCount:(NSUInteger)finishedResponseCount timeout:(NSTimeInterval)timeout
+{
+    UMKMockEventCenter *eventCenter = self.eventCenter;
+    return [eventCenter waitForCondition:^BOOL{
+        return eventCenter.finishedResponseCount >= finishedResponseCount;
+    } timeout:timeout];
+}
+
+@end
+
+
+#pragma mark -
+
+@implementation UMKMockRegistry (UMKMockURLProtocol)
+
+#pragma mark Matching
+
+/*!
+ @abstract Returns a match for the first expected mock request that matches the specified URL request.
+ @discussion The match records the generation of the expected mock requests at the time it was performed.
+ @param request The URL request to find a mock request for. May not be nil.
+ @param recordsStatistics Whether to record each candidate's evaluation in its statistics. This should only be YES
+     for lookups whose result is used to service the URL request.
+ @result A match for the first expected mock request that matches the specified URL request, or nil if there is no match.
+ */
+- (UMKMockRequestMatch *)expectedMockRequestMatchForURLRequest:(NSURLRequest *)request recordingStatistics:(BOOL)recordsStatistics
+{
+    NSParameterAssert(request);
+
+    __block UMKMockRequestMatch *match = nil;
+    [self readExpectedMockRequestsUsingBlock:^(UMKMockRequestIndex *expectedMockRequests) {
+        UMKMockRequestIndexEntry *entry = [expectedMockRequests firstEntryMatchingURLRequest:request recordingStatistics:recordsStatistics];
+        if (entry) {
+            match = [[UMKMockRequestMatch alloc] initWithEntry:entry expectedMockRequests:expectedMockRequests];
+        }
+    }];
+
+    return match;
+}
+
+
+- (id<UMKMockURLRequest>)expectedMockRequestMatchingURLRequest:(NSURLRequest *)request
+{
+    return [self expectedMockRequestMatchForURLRequest:request recordingStatistics:NO].mockRequest;
+}
+
+
+/*!
+ @abstract Returns a match for the first expected mock request that matches the specified URL request, claiming the
+     mock request if it should be removed after servicing the request.
+ @discussion Claiming is atomic, so a mock request that is removed after servicing a request is never returned for
+     two URL requests, even if they are matched concurrently. Claimed mock requests should be removed as soon as possible.
+ @param request The URL request to find a mock request for. May not be nil.
+ @param outClaimed On output, whether the matching mock request was claimed. May not be NULL.
+ @result A match for the first unclaimed expected mock request that matches the specified URL request, or nil if there
+     is no match.
+ */
+- (UMKMockRequestMatch *)claimExpectedMockRequestMatchForURLRequest:(NSURLRequest *)request claimed:(BOOL *)outClaimed
+{
+    NSParameterAssert(request);
+
+    __block UMKMockRequestMatch *match = nil;
+    [self readExpectedMockRequestsUsingBlock:^(UMKMockRequestIndex *expectedMockRequests) {
+        UMKMockRequestIndexEntry *entry = [expectedMockRequests claimFirstEntryMatchingURLRequest:request claimed:outClaimed];
+        if (entry) {
+            match = [[UMKMockRequestMatch alloc] initWithEntry:entry expectedMockRequests:expectedMockRequests];
+        }
+    }];
+
+    return match;
+}
+
+
+- (UMKMockRequestIndexEntry *)expectedMockRequestEntryForProtocolWithURLRequest:(NSURLRequest *)request claimed:(BOOL *)outClaimed
+{
+    NSParameterAssert(request);
+    NSParameterAssert(outClaimed);
+
+    *outClaimed = NO;
+    UMKMockRequestMatch *match = [self removePendingMatchForURLRequest:request];
+    if (self.isVerificationEnabled) {
+        match = [self claimExpectedMockRequestMatchForURLRequest:request claimed:outClaimed];
+    } else if (!match || !match.isReusable || match.generation != self.expectedMockRequestsGeneration) {
+        match = [self expectedMockRequestMatchForURLRequest:request recordingStatistics:YES];
+    }
+
+    // This is the only lookup whose result services the request, so it's the only one whose match counts
+    [match.statistics recordMatch];
+    return match.entry;
+}
+
+
+#pragma mark - Pending Matches
+
+- (BOOL)savePendingMatchForURLRequest:(NSURLRequest *)request
+{
+    UMKMockRequestMatch *match = [self expectedMockRequestMatchForURLRequest:request recordingStatistics:NO];
+    if (!match) {
+        return NO;
+    }
+
+    dispatch_barrier_async(self.pendingMatchesIsolationQueue, ^{
+        [self.pendingMatches setObject:match forKey:request];
+    });
+
+    return YES;
+}
+
+
+- (void)movePendingMatchFromURLRequest:(NSURLRequest *)request toURLRequest:(NSURLRequest *)canonicalRequest
+{
+    dispatch_barrier_async(self.pendingMatchesIsolationQueue, ^{
+        UMKMockRequestMatch *match = [self.pendingMatches objectForKey:request];
+        if (match) {
+            [self.pendingMatches removeObjectForKey:request];
+            [self.pendingMatches setObject:match forKey:canonicalRequest];
+        }
+    });
+}
+
+
+/*!
+ @abstract Removes and returns the pending match for the specified URL request.
+ @param request The URL request. May not be nil.
+ @result The pending match for the URL request, or nil if there is none.
+ */
+- (UMKMockRequestMatch *)removePendingMatchForURLRequest:(NSURLRequest *)request
+{
+    __block UMKMockRequestMatch *match = nil;
+    dispatch_barrier_sync(self.pendingMatchesIsolationQueue, ^{
+        match = [self.pendingMatches objectForKey:request];
+        if (match) {
+            [self.pendingMatches removeObjectForKey:request];
+        }
+    });
+
+    return match;
+}
+
+
+#pragma mark - Accounting
+
+- (void)markRequest:(NSURLRequest *)request asServicedByEntry:(UMKMockRequestIndexEntry *)entry claimed:(BOOL)claimed
+{
+    NSParameterAssert(entry);
+
+    id<UMKMockURLRequest> mockRequest = entry.mockRequest;
+    BOOL verificationEnabled = self.isVerificationEnabled;
+    if (verificationEnabled) {
+        if (self.retainsRequests) {
+            NSUInteger limit = self.retainedRequestLimit;
+            dispatch_barrier_async(self.servicedRequestsIsolationQueue, ^{
+                if (!self.mutableServicedRequests[request]) {
+                    [self.servicedRequestOrder addObject:request];
+                }
+
+                self.mutableServicedRequests[request] = mockRequest;
+                while (self.servicedRequestOrder.count > limit) {
+                    [self.mutableServicedRequests removeObjectForKey:self.servicedRequestOrder.firstObject];
+                    [self.servicedRequestOrder removeObjectAtIndex:0];
+                }
+            });
+        }
+
+        // Only tracking entries that haven't been marked yet can be marked, so each mock request is uncounted once
+        if ([entry markServiced]) {
+            atomic_fetch_sub(&_unservicedMockRequestCount, 1);
+        }
+
+        [self.journal addRecord:[[UMKRequestJournalRecord alloc] initWithURLRequest:request
+                                                                               kind:UMKRequestJournalRecordKindServiced
+                                                                        mockRequest:mockRequest]];
+    }
+
+    // Mock requests are only claimed if they should be removed after servicing the request. Claimed mock requests
+    // can never match again, so remove them even if verification was disabled in the meantime. The entry has already
+    // been marked as serviced, so removing it records its mock request as serviced.
+    if (claimed) {
+        [self writeExpectedMockRequestsUsingBlock:^(UMKMockRequestIndex *expectedMockRequests) {
+            [self removeExpectedMockRequests:@[ mockRequest ] fromIndex:expectedMockRequests];
+        }];
+    }
+
+    // Post the event last so that waiters see the expected mock requests without the claimed mock request
+    [self postEventWithKind:UMKMockRegistryEventKindServiced request:request mockRequest:mockRequest error:nil];
+}
+
+
+- (void)addUnexpectedRequest:(NSURLRequest *)request
+{
+    // Count the request right away so that verification sees it even before the request itself is recorded
+    atomic_fetch_add(&_unexpectedRequestCount, 1);
+    if (self.retainsRequests) {
+        NSUInteger limit = self.retainedRequestLimit;
+        dispatch_barrier_async(self.unexpectedRequestsIsolationQueue, ^{
+            [self.mutableUnexpectedRequests addObject:request];
+            if (self.mutableUnexpectedRequests.count > limit) {
+                [self.mutableUnexpectedRequests removeObjectsInRange:NSMakeRange(0, self.mutableUnexpectedRequests.count - limit)];
+            }
+        });
+    }
+
+    [self.journal addRecord:[[UMKRequestJournalRecord alloc] initWithURLRequest:request
+                                                                           kind:UMKRequestJournalRecordKindUnexpected
+                                                                    mockRequest:nil]];
+    [self postEventWithKind:UMKMockRegistryEventKindUnexpected request:request mockRequest:nil error:nil];
+}
+
+
+- (void)markResponseFinishedForRequest:(NSURLRequest *)request mockRequest:(id<UMKMockURLRequest>)mockRequest error:(NSError *)error
+{
+    [self postEventWithKind:UMKMockRegistryEventKindFinishedResponse request:request mockRequest:mockRequest error:error];
+}
+
+
+/*!
+ @abstract Creates an event with the specified properties and posts it to the receiver's event center.
+ @param kind The kind of event.
+ @param request The request the event is about. May not be nil.
+ @param mockRequest The mock request that is servicing the request.
+ @param error The error with which the response failed, if any.
+ */
+- (void)postEventWithKind:(UMKMockRegistryEventKind)kind
+                  request:(NSURLRequest *)request
+              mockRequest:(id<UMKMockURLRequest>)mockRequest
+                    error:(NSError *)error
+{
+    [self.eventCenter postEvent:[[UMKMockRegistryEvent alloc] initWithKind:kind request:request mockRequest:mockRequest error:error]];
+}
+
+@end
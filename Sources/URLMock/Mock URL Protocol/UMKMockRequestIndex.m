@@ -0,0 +1,755 @@
+//
+//  UMKMockRequestIndex.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import "UMKMockRequestIndex.h"
+
+#import <URLMock/UMKMockHTTPRequest.h>
+#import <URLMock/UMKMockRequestStatistics.h>
+#import <URLMock/UMKMockURLProtocol.h>
+#import <URLMock/UMKPatternMatchingMockRequest.h>
+#import <URLMock/UMKRequestMatchContext.h>
+
+#import "UMKMockRouteTrie.h"
+
+#import <math.h>
+#import <objc/runtime.h>
+#import <stdatomic.h>
+#import <time.h>
+
+
+#pragma mark Index Keys
+
+/*!
+ @abstract Returns the exact-match index key for the specified uppercase HTTP method and canonical URL.
+ @param uppercaseHTTPMethod The uppercase HTTP method. May not be nil.
+ @param canonicalURL The canonical URL. May not be nil.
+ @result The index key for the method and URL.
+ */
+static NSString *UMKMockRequestIndexKey(NSString *uppercaseHTTPMethod, NSURL *canonicalURL)
+{
+    return [NSString stringWithFormat:@"%@ %@", uppercaseHTTPMethod, canonicalURL.absoluteString];
+}
+
+
+#pragma mark - Compaction
+
+/*!
+ @abstract The smallest number of mutations after which an index's compacted copy is discarded.
+ @discussion Below this, snapshots are cheap enough to layer that compacting more often would only add work.
+ */
+static const NSUInteger kUMKMockRequestIndexMinimumCompactionThreshold = 64;
+
+
+#pragma mark - Match Contexts
+
+/*!
+ @abstract Returns whether the specified mock request should be sent -matchesURLRequest:context: instead of
+     -matchesURLRequest:.
+ @discussion Only instances of UMKMockHTTPRequest, UMKPatternMatchingMockRequest, and their subclasses are sent the
+     context variant, and only if they don’t override -matchesURLRequest: without also overriding the context variant.
+     Proxies and mock objects often claim to respond to every optional protocol message, so asking them whether they
+     respond to -matchesURLRequest:context: would cause mocks that only stub -matchesURLRequest: to stop matching. We
+     check the class using the runtime so that they are never sent unexpected messages.
+ @param mockRequest The mock request.
+ @result Whether the mock request should be sent -matchesURLRequest:context:.
+ */
+static BOOL UMKMockRequestUsesMatchContext(id<UMKMockURLRequest> mockRequest)
+{
+    SEL matchSelector = @selector(matchesURLRequest:);
+    SEL contextMatchSelector = @selector(matchesURLRequest:context:);
+
+    Class mockRequestClass = object_getClass(mockRequest);
+    for (Class class = mockRequestClass; class; class = class_getSuperclass(class)) {
+        if (class == [UMKMockHTTPRequest class] || class == [UMKPatternMatchingMockRequest class]) {
+            return (class_getMethodImplementation(mockRequestClass, matchSelector) == class_getMethodImplementation(class, matchSelector) ||
+                    class_getMethodImplementation(mockRequestClass, contextMatchSelector) != class_getMethodImplementation(class, contextMatchSelector));
+        }
+    }
+
+    return NO;
+}
+
+
+#pragma mark -
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface UMKMockRequestIndexEntry ()
+
+/*! The key under which the entry is stored in an index’s exact-match table, or nil if the entry isn't stored there. */
+@property (nonatomic, copy, readonly, nullable) NSString *indexKey;
+
+/*! Whether the entry is stored in an index's route trie. */
+@property (nonatomic, assign, readonly, getter=isRouted) BOOL routed;
+
+/*! Whether the entry's mock request is sent -matchesURLRequest:context: instead of -matchesURLRequest:. */
+@property (nonatomic, assign, readonly) BOOL usesMatchContext;
+
+/*! Whether the entry's mock request responds to -shouldRemoveAfterServicingRequest:. */
+@property (nonatomic, assign, readonly) BOOL respondsToShouldRemove;
+
+/*! The entry's statistics. Redeclared as readwrite. */
+@property (nonatomic, strong, readwrite, nullable) UMKMockRequestStatistics *statistics;
+
+/*!
+ @abstract Returns whether the entry's mock request matches the URL request of the specified match context.
+ @param context The match context.
+ @param recordsStatistics Whether to record the evaluation in the entry's statistics.
+ @result Whether the entry's mock request matches the context's URL request.
+ */
+- (BOOL)matchesURLRequestOfContext:(UMKRequestMatchContext *)context recordingStatistics:(BOOL)recordsStatistics;
+
+/*!
+ @abstract Returns whether the entry's plain UMKPatternMatchingMockRequest matches the URL request of the specified
+     match context, given the parameters its route matched with.
+ @param context The match context.
+ @param parameters The parameters that the entry's route matched with. May not be nil.
+ @param recordsStatistics Whether to record the evaluation in the entry's statistics.
+ @result Whether the entry's mock request matches the context's URL request.
+ */
+- (BOOL)matchesURLRequestOfContext:(UMKRequestMatchContext *)context
+                 patternParameters:(NSDictionary<NSString *, NSString *> *)parameters
+               recordingStatistics:(BOOL)recordsStatistics;
+
+/*!
+ @abstract Returns whether the entry's mock request should be removed after servicing the specified URL request.
+ @discussion Mock requests that don't implement -shouldRemoveAfterServicingRequest: are always removed.
+ @param request The URL request.
+ @result Whether the entry's mock request should be removed after servicing the URL request.
+ */
+- (BOOL)shouldRemoveAfterServicingRequest:(NSURLRequest *)request;
+
+@end
+
+
+@interface UMKMockRequestIndex ()
+
+/*! All of the index’s entries in registration order. */
+@property (nonatomic, strong, readonly) NSMutableArray<UMKMockRequestIndexEntry *> *entries;
+
+/*!
+ @abstract Entries for plain UMKMockHTTPRequests, keyed by uppercased HTTP method and canonical URL. Each array is in
+     registration order.
+ @discussion The arrays are immutable and replaced whenever they change so that copies of the index can share them.
+ */
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSString *, NSArray<UMKMockRequestIndexEntry *> *> *indexedEntries;
+
+/*! Entries for plain UMKPatternMatchingMockRequests whose URL patterns can be compiled. */
+@property (nonatomic, strong) UMKMockRouteTrie *routeTrie;
+
+/*! Entries for all other mock requests in registration order. */
+@property (nonatomic, strong, readonly) NSMutableArray<UMKMockRequestIndexEntry *> *unindexedEntries;
+
+/*! The registration index that will be assigned to the next entry. */
+@property (nonatomic, assign) uint64_t nextRegistrationIndex;
+
+/*! The index's generation. Redeclared as readwrite. */
+@property (nonatomic, assign, readwrite) uint64_t generation;
+
+/*! The number of the index's entries that have statistics. */
+@property (nonatomic, assign) NSUInteger statisticsEntryCount;
+
+/*! Whether the index is a snapshot, i.e., a copy of another index. Snapshots cannot be mutated. */
+@property (nonatomic, assign, getter=isSnapshot) BOOL snapshot;
+
+/*!
+ @abstract For snapshots, the compacted index whose entries precede the snapshot's own; nil otherwise.
+ @discussion Every entry in the base index was added before every entry in the receiver.
+ */
+@property (nonatomic, strong, nullable) UMKMockRequestIndex *baseIndex;
+
+/*! For snapshots, the entries of the base index that were removed before the snapshot was taken; nil otherwise. */
+@property (nonatomic, copy, nullable) NSSet<UMKMockRequestIndexEntry *> *excludedBaseEntries;
+
+/*!
+ @abstract A complete copy of the index that snapshots share, or nil if none has been made since the index was last
+     compacted.
+ @discussion The compacted copy is never mutated. It is discarded once the index has been mutated so many times since
+     it was made that layering snapshots on top of it would cost more than making a new one.
+ */
+@property (nonatomic, strong, nullable) UMKMockRequestIndex *compactedCopy;
+
+/*! The entries that were added since the compacted copy was made and have not been removed since. */
+@property (nonatomic, strong, readonly) NSMutableArray<UMKMockRequestIndexEntry *> *entriesAddedSinceCompaction;
+
+/*! The compacted copy's entries that have been removed since it was made. */
+@property (nonatomic, strong, readonly) NSMutableSet<UMKMockRequestIndexEntry *> *entriesRemovedSinceCompaction;
+
+/*!
+ @abstract Adds the specified entries to the end of the receiver in order.
+ @discussion The entries' registration indexes must be greater than those of every entry already in the receiver.
+ @param entries The entries to add. May not be nil.
+ */
+- (void)addEntries:(NSArray<UMKMockRequestIndexEntry *> *)entries;
+
+/*!
+ @abstract Returns a complete snapshot of the receiver that shares none of its mutable storage.
+ @param zone The zone in which to allocate the copy.
+ @result A copy of the receiver.
+ */
+- (UMKMockRequestIndex *)compactedCopyWithZone:(nullable NSZone *)zone;
+
+/*!
+ @abstract Discards the receiver's compacted copy if the receiver has been mutated too many times since it was made.
+ */
+- (void)discardCompactedCopyIfStale;
+
+/*!
+ @abstract Returns the first unclaimed entry stored in the receiver's own tables whose mock request matches the URL
+     request of the specified context, skipping the specified entries.
+ @param context The match context.
+ @param excludedEntries Entries to skip without evaluating them. May be nil.
+ @param recordsStatistics Whether to record each candidate's evaluation in its statistics.
+ @result The earliest added unclaimed entry that matches, or nil if none match.
+ */
+- (nullable UMKMockRequestIndexEntry *)firstEntryMatchingContext:(UMKRequestMatchContext *)context
+                                                excludingEntries:(nullable NSSet<UMKMockRequestIndexEntry *> *)excludedEntries
+                                             recordingStatistics:(BOOL)recordsStatistics;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+
+#pragma mark -
+
+@implementation UMKMockRequestIndexEntry {
+    /*! Backs the claimed property. */
+    _Atomic(bool) _claimed;
+
+    /*! Backs the serviced property. */
+    _Atomic(bool) _serviced;
+}
+
+- (instancetype)initWithMockRequest:(id<UMKMockURLRequest>)mockRequest registrationIndex:(uint64_t)registrationIndex
+{
+    NSParameterAssert(mockRequest);
+
+    self = [super init];
+    if (self) {
+        _mockRequest = mockRequest;
+        _registrationIndex = registrationIndex;
+        _usesMatchContext = UMKMockRequestUsesMatchContext(mockRequest);
+        _respondsToShouldRemove = [mockRequest respondsToSelector:@selector(shouldRemoveAfterServicingRequest:)];
+        atomic_init(&_claimed, false);
+        atomic_init(&_serviced, false);
+
+        // Subclasses of UMKMockHTTPRequest and UMKPatternMatchingMockRequest may override -matchesURLRequest:, so only
+        // index instances of the classes themselves. We check the class using the runtime so that proxies and mock
+        // objects are never sent unexpected messages.
+        Class mockRequestClass = object_getClass(mockRequest);
+        if (mockRequestClass == [UMKMockHTTPRequest class]) {
+            UMKMockHTTPRequest *HTTPRequest = (UMKMockHTTPRequest *)mockRequest;
+            _indexKey = [UMKMockRequestIndexKey(HTTPRequest.HTTPMethod.uppercaseString,
+                                                [UMKMockURLProtocol canonicalURLForURL:HTTPRequest.URL]) copy];
+        } else if (mockRequestClass == [UMKPatternMatchingMockRequest class] &&
+                   [UMKMockRouteTrie canCompileURLPattern:((UMKPatternMatchingMockRequest *)mockRequest).URLPattern]) {
+            _routed = YES;
+        }
+    }
+
+    return self;
+}
+
+
+- (BOOL)isClaimed
+{
+    return atomic_load(&_claimed);
+}
+
+
+- (BOOL)claim
+{
+    bool expected = false;
+    return atomic_compare_exchange_strong(&_claimed, &expected, true);
+}
+
+
+- (BOOL)isServiced
+{
+    return atomic_load(&_serviced);
+}
+
+
+- (BOOL)markServiced
+{
+    bool expected = false;
+    return atomic_compare_exchange_strong(&_serviced, &expected, true);
+}
+
+
+- (BOOL)shouldRemoveAfterServicingRequest:(NSURLRequest *)request
+{
+    return !self.respondsToShouldRemove || [self.mockRequest shouldRemoveAfterServicingRequest:request];
+}
+
+
+- (BOOL)matchesURLRequestOfContext:(UMKRequestMatchContext *)context recordingStatistics:(BOOL)recordsStatistics
+{
+    if (self.isClaimed) {
+        return NO;
+    }
+
+    UMKMockRequestStatistics *statistics = recordsStatistics ? self.statistics : nil;
+    uint64_t startTime = statistics ? clock_gettime_nsec_np(CLOCK_UPTIME_RAW) : 0;
+    BOOL matches = (self.usesMatchContext ? [self.mockRequest matchesURLRequest:context.request context:context]
+                                          : [self.mockRequest matchesURLRequest:context.request]);
+    if (statistics) {
+        [statistics recordEvaluationWithDuration:clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - startTime];
+    }
+
+    return matches;
+}
+
+
+- (BOOL)matchesURLRequestOfContext:(UMKRequestMatchContext *)context
+                 patternParameters:(NSDictionary<NSString *, NSString *> *)parameters
+               recordingStatistics:(BOOL)recordsStatistics
+{
+    if (self.isClaimed) {
+        return NO;
+    }
+
+    UMKMockRequestStatistics *statistics = recordsStatistics ? self.statistics : nil;
+    uint64_t startTime = statistics ? clock_gettime_nsec_np(CLOCK_UPTIME_RAW) : 0;
+    BOOL matches = [(UMKPatternMatchingMockRequest *)self.mockRequest matchesURLRequestOfContext:context patternParameters:parameters];
+    if (statistics) {
+        [statistics recordEvaluationWithDuration:clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - startTime];
+    }
+
+    return matches;
+}
+
+@end
+
+
+#pragma mark -
+
+@implementation UMKMockRequestIndex
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        _entries = [[NSMutableArray alloc] init];
+        _indexedEntries = [[NSMutableDictionary alloc] init];
+        _routeTrie = [[UMKMockRouteTrie alloc] init];
+        _unindexedEntries = [[NSMutableArray alloc] init];
+        _entriesAddedSinceCompaction = [[NSMutableArray alloc] init];
+        _entriesRemovedSinceCompaction = [[NSMutableSet alloc] init];
+    }
+
+    return self;
+}
+
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    // Copying every entry would make each snapshot cost O(n), so snapshots instead layer the entries added since the
+    // last compaction on top of a shared compacted copy, skipping the ones removed since. Compacting again once the
+    // mutations outnumber the square root of the count bounds both the cost of each snapshot and the amortized cost of
+    // compacting to O(√n).
+    if (self.isSnapshot) {
+        return self;
+    }
+
+    if (!self.compactedCopy) {
+        self.compactedCopy = [self compactedCopyWithZone:zone];
+        [self.entriesAddedSinceCompaction removeAllObjects];
+        [self.entriesRemovedSinceCompaction removeAllObjects];
+    }
+
+    if (self.compactedCopy.generation == self.generation) {
+        return self.compactedCopy;
+    }
+
+    UMKMockRequestIndex *snapshot = [[self.class allocWithZone:zone] init];
+    snapshot.snapshot = YES;
+    snapshot.baseIndex = self.compactedCopy;
+    snapshot.excludedBaseEntries = self.entriesRemovedSinceCompaction;
+    [snapshot addEntries:self.entriesAddedSinceCompaction];
+    snapshot.nextRegistrationIndex = self.nextRegistrationIndex;
+    snapshot.generation = self.generation;
+    snapshot.statisticsEntryCount = self.statisticsEntryCount;
+    return snapshot;
+}
+
+
+- (UMKMockRequestIndex *)compactedCopyWithZone:(NSZone *)zone
+{
+    UMKMockRequestIndex *copy = [[self.class allocWithZone:zone] init];
+    copy.snapshot = YES;
+    [copy.entries addObjectsFromArray:self.entries];
+    [copy.indexedEntries addEntriesFromDictionary:self.indexedEntries];
+    [copy.unindexedEntries addObjectsFromArray:self.unindexedEntries];
+    copy.routeTrie = [self.routeTrie copy];
+    copy.nextRegistrationIndex = self.nextRegistrationIndex;
+    copy.generation = self.generation;
+    copy.statisticsEntryCount = self.statisticsEntryCount;
+    return copy;
+}
+
+
+- (void)discardCompactedCopyIfStale
+{
+    if (!self.compactedCopy) {
+        return;
+    }
+
+    NSUInteger mutationCount = self.entriesAddedSinceCompaction.count + self.entriesRemovedSinceCompaction.count;
+    if (mutationCount > MAX(kUMKMockRequestIndexMinimumCompactionThreshold, (NSUInteger)sqrt(self.entries.count))) {
+        self.compactedCopy = nil;
+        [self.entriesAddedSinceCompaction removeAllObjects];
+        [self.entriesRemovedSinceCompaction removeAllObjects];
+    }
+}
+
+
+- (NSArray<id<UMKMockURLRequest>> *)mockRequests
+{
+    NSMutableArray<id<UMKMockURLRequest>> *mockRequests = [[NSMutableArray alloc] initWithCapacity:self.count];
+    for (UMKMockRequestIndexEntry *entry in self.baseIndex.entries) {
+        if (![self.excludedBaseEntries containsObject:entry]) {
+            [mockRequests addObject:entry.mockRequest];
+        }
+    }
+
+    for (UMKMockRequestIndexEntry *entry in self.entries) {
+        [mockRequests addObject:entry.mockRequest];
+    }
+
+    return mockRequests;
+}
+
+
+- (NSUInteger)count
+{
+    return self.baseIndex.count - self.excludedBaseEntries.count + self.entries.count;
+}
+
+
+- (BOOL)recordsStatistics
+{
+    return self.statisticsEntryCount > 0;
+}
+
+
+- (NSString *)debugDescription
+{
+    return self.mockRequests.debugDescription;
+}
+
+
+#pragma mark - Adding and Removing Mock Requests
+
+- (void)addMockRequest:(id<UMKMockURLRequest>)mockRequest
+{
+    NSParameterAssert(mockRequest);
+    [self addMockRequests:@[ mockRequest ]];
+}
+
+
+- (void)addMockRequests:(NSArray<id<UMKMockURLRequest>> *)mockRequests
+{
+    [self addMockRequests:mockRequests statistics:nil];
+}
+
+
+- (NSArray<UMKMockRequestIndexEntry *> *)addMockRequests:(NSArray<id<UMKMockURLRequest>> *)mockRequests
+                                              statistics:(NSArray<UMKMockRequestStatistics *> *)statistics
+{
+    NSParameterAssert(mockRequests);
+    NSParameterAssert(!statistics || statistics.count == mockRequests.count);
+    NSAssert(!self.isSnapshot, @"Snapshots cannot be mutated");
+    if (mockRequests.count == 0) {
+        return @[];
+    }
+
+    NSMutableArray<UMKMockRequestIndexEntry *> *entries = [[NSMutableArray alloc] initWithCapacity:mockRequests.count];
+    [mockRequests enumerateObjectsUsingBlock:^(id<UMKMockURLRequest> mockRequest, NSUInteger i, BOOL *stop) {
+        UMKMockRequestIndexEntry *entry = [[UMKMockRequestIndexEntry alloc] initWithMockRequest:mockRequest
+                                                                              registrationIndex:self.nextRegistrationIndex++];
+        entry.statistics = statistics[i];
+        [entries addObject:entry];
+    }];
+
+    [self addEntries:entries];
+    if (self.compactedCopy) {
+        [self.entriesAddedSinceCompaction addObjectsFromArray:entries];
+    }
+
+    self.generation++;
+    [self discardCompactedCopyIfStale];
+    return entries;
+}
+
+
+- (void)addEntries:(NSArray<UMKMockRequestIndexEntry *> *)entries
+{
+    // Buckets are immutable so that snapshots can share them. Collect each bucket's new entries first so that
+    // every bucket is only copied once, no matter how many entries are added to it.
+    NSMutableDictionary<NSString *, NSMutableArray<UMKMockRequestIndexEntry *> *> *addedIndexedEntries = [[NSMutableDictionary alloc] init];
+    for (UMKMockRequestIndexEntry *entry in entries) {
+        if (entry.statistics) {
+            self.statisticsEntryCount++;
+        }
+
+        [self.entries addObject:entry];
+        if (entry.indexKey) {
+            NSMutableArray<UMKMockRequestIndexEntry *> *addedEntries = addedIndexedEntries[entry.indexKey];
+            if (!addedEntries) {
+                addedEntries = [[NSMutableArray alloc] init];
+                addedIndexedEntries[entry.indexKey] = addedEntries;
+            }
+
+            [addedEntries addObject:entry];
+        } else if (entry.isRouted) {
+            [self.routeTrie addEntry:entry];
+        } else {
+            [self.unindexedEntries addObject:entry];
+        }
+    }
+
+    [addedIndexedEntries enumerateKeysAndObjectsUsingBlock:^(NSString *indexKey, NSMutableArray<UMKMockRequestIndexEntry *> *addedEntries, BOOL *stop) {
+        NSArray<UMKMockRequestIndexEntry *> *bucket = self.indexedEntries[indexKey];
+        self.indexedEntries[indexKey] = bucket ? [bucket arrayByAddingObjectsFromArray:addedEntries] : [addedEntries copy];
+    }];
+}
+
+
+- (void)removeMockRequest:(id<UMKMockURLRequest>)mockRequest
+{
+    if (!mockRequest) {
+        return;
+    }
+
+    [self removeMockRequests:@[ mockRequest ]];
+}
+
+
+- (void)removeMockRequests:(NSArray<id<UMKMockURLRequest>> *)mockRequests
+{
+    NSParameterAssert(mockRequests);
+    NSAssert(!self.isSnapshot, @"Snapshots cannot be mutated");
+    if (mockRequests.count == 0 || self.entries.count == 0) {
+        return;
+    }
+
+    NSSet<id<UMKMockURLRequest>> *removedMockRequests = [NSSet setWithArray:mockRequests];
+    NSIndexSet *indexes = [self.entries indexesOfObjectsPassingTest:^BOOL(UMKMockRequestIndexEntry *entry, NSUInteger idx, BOOL *stop) {
+        return [removedMockRequests containsObject:entry.mockRequest];
+    }];
+
+    if (indexes.count == 0) {
+        return;
+    }
+
+    NSArray<UMKMockRequestIndexEntry *> *removedEntries = [self.entries objectsAtIndexes:indexes];
+    NSMutableSet<NSString *> *affectedIndexKeys = [[NSMutableSet alloc] init];
+    BOOL removedUnindexedEntries = NO;
+    for (UMKMockRequestIndexEntry *entry in removedEntries) {
+        if (entry.statistics) {
+            self.statisticsEntryCount--;
+        }
+
+        if (entry.isRouted) {
+            [self.routeTrie removeEntry:entry];
+        } else if (entry.indexKey) {
+            [affectedIndexKeys addObject:entry.indexKey];
+        } else {
+            removedUnindexedEntries = YES;
+        }
+    }
+
+    // Entries use identity equality, so a hash set of them lets each affected list be filtered in a single pass
+    NSSet<UMKMockRequestIndexEntry *> *removedEntrySet = [NSSet setWithArray:removedEntries];
+    NSPredicate *isNotRemoved = [NSPredicate predicateWithBlock:^BOOL(UMKMockRequestIndexEntry *entry, NSDictionary *bindings) {
+        return ![removedEntrySet containsObject:entry];
+    }];
+
+    for (NSString *indexKey in affectedIndexKeys) {
+        NSArray<UMKMockRequestIndexEntry *> *bucket = [self.indexedEntries[indexKey] filteredArrayUsingPredicate:isNotRemoved];
+        self.indexedEntries[indexKey] = bucket.count > 0 ? bucket : nil;
+    }
+
+    if (removedUnindexedEntries) {
+        [self.unindexedEntries filterUsingPredicate:isNotRemoved];
+    }
+
+    // Entries that were added since the compacted copy was made are simply left out of later snapshots. The rest have
+    // to be excluded from the compacted copy.
+    if (self.compactedCopy) {
+        uint64_t compactedRegistrationIndex = self.compactedCopy.nextRegistrationIndex;
+        for (UMKMockRequestIndexEntry *entry in removedEntries) {
+            if (entry.registrationIndex < compactedRegistrationIndex) {
+                [self.entriesRemovedSinceCompaction addObject:entry];
+            }
+        }
+
+        [self.entriesAddedSinceCompaction filterUsingPredicate:isNotRemoved];
+    }
+
+    [self.entries removeObjectsAtIndexes:indexes];
+    self.generation++;
+    [self discardCompactedCopyIfStale];
+}
+
+
+- (void)removeAllMockRequests
+{
+    NSAssert(!self.isSnapshot, @"Snapshots cannot be mutated");
+    [self.entries removeAllObjects];
+    [self.indexedEntries removeAllObjects];
+    [self.routeTrie removeAllEntries];
+    [self.unindexedEntries removeAllObjects];
+    self.statisticsEntryCount = 0;
+    self.compactedCopy = nil;
+    [self.entriesAddedSinceCompaction removeAllObjects];
+    [self.entriesRemovedSinceCompaction removeAllObjects];
+    self.generation++;
+}
+
+
+#pragma mark - Matching
+
+- (id<UMKMockURLRequest>)firstMockRequestMatchingURLRequest:(NSURLRequest *)request
+{
+    return [self firstEntryMatchingURLRequest:request recordingStatistics:NO].mockRequest;
+}
+
+
+- (UMKMockRequestIndexEntry *)firstEntryMatchingURLRequest:(NSURLRequest *)request recordingStatistics:(BOOL)recordsStatistics
+{
+    NSParameterAssert(request);
+    return [self firstEntryMatchingContext:[[UMKRequestMatchContext alloc] initWithURLRequest:request] recordingStatistics:recordsStatistics];
+}
+
+
+- (id<UMKMockURLRequest>)claimFirstMockRequestMatchingURLRequest:(NSURLRequest *)request claimed:(BOOL *)outClaimed
+{
+    return [self claimFirstEntryMatchingURLRequest:request claimed:outClaimed].mockRequest;
+}
+
+
+- (UMKMockRequestIndexEntry *)claimFirstEntryMatchingURLRequest:(NSURLRequest *)request claimed:(BOOL *)outClaimed
+{
+    NSParameterAssert(request);
+    NSParameterAssert(outClaimed);
+
+    // Claimed entries stop matching, so if another thread claims our match first, the next search finds the one after it
+    UMKRequestMatchContext *context = [[UMKRequestMatchContext alloc] initWithURLRequest:request];
+    UMKMockRequestIndexEntry *entry = nil;
+    while ((entry = [self firstEntryMatchingContext:context recordingStatistics:YES])) {
+        if (![entry shouldRemoveAfterServicingRequest:request]) {
+            *outClaimed = NO;
+            return entry;
+        } else if ([entry claim]) {
+            *outClaimed = YES;
+            return entry;
+        }
+    }
+
+    *outClaimed = NO;
+    return nil;
+}
+
+
+/*!
+ @abstract Returns the first unclaimed entry in the receiver whose mock request matches the URL request of the specified context.
+ @discussion Every candidate shares the context so that the request's canonical URL and body are only computed once.
+ @param context The match context.
+ @param recordsStatistics Whether to record each candidate's evaluation in its statistics.
+ @result The earliest added unclaimed entry that matches, or nil if none match.
+ */
+- (UMKMockRequestIndexEntry *)firstEntryMatchingContext:(UMKRequestMatchContext *)context recordingStatistics:(BOOL)recordsStatistics
+{
+    // Every entry in a snapshot's base index was added before the snapshot's own entries, so a match there always wins
+    UMKMockRequestIndexEntry *baseMatch = [self.baseIndex firstEntryMatchingContext:context
+                                                                   excludingEntries:self.excludedBaseEntries
+                                                                recordingStatistics:recordsStatistics];
+    return baseMatch ?: [self firstEntryMatchingContext:context excludingEntries:nil recordingStatistics:recordsStatistics];
+}
+
+
+- (UMKMockRequestIndexEntry *)firstEntryMatchingContext:(UMKRequestMatchContext *)context
+                                       excludingEntries:(NSSet<UMKMockRequestIndexEntry *> *)excludedEntries
+                                    recordingStatistics:(BOOL)recordsStatistics
+{
+    // Find the first indexed candidate that matches. Candidates with the same method and URL can still differ
+    // in their headers and bodies, so each one still has to be checked.
+    UMKMockRequestIndexEntry *bestMatch = nil;
+    if (self.indexedEntries.count > 0 && context.uppercaseHTTPMethod && context.canonicalURL) {
+        for (UMKMockRequestIndexEntry *entry in self.indexedEntries[UMKMockRequestIndexKey(context.uppercaseHTTPMethod, context.canonicalURL)]) {
+            if ([excludedEntries containsObject:entry]) {
+                continue;
+            }
+
+            if ([entry matchesURLRequestOfContext:context recordingStatistics:recordsStatistics]) {
+                bestMatch = entry;
+                break;
+            }
+        }
+    }
+
+    // Routed candidates that were added before the best match so far take precedence over it. Matches whose parameters
+    // are known only need their methods and matching blocks checked; the rest are matched normally.
+    NSString *URLString = self.routeTrie.count > 0 ? context.canonicalURLStringExcludingQuery : nil;
+    if (URLString) {
+        for (UMKMockRouteMatch *routeMatch in [self.routeTrie matchesForURLString:URLString]) {
+            UMKMockRequestIndexEntry *entry = routeMatch.entry;
+            if (bestMatch && entry.registrationIndex > bestMatch.registrationIndex) {
+                break;
+            } else if ([excludedEntries containsObject:entry]) {
+                continue;
+            }
+
+            if (routeMatch.parameters ? [entry matchesURLRequestOfContext:context
+                                                        patternParameters:routeMatch.parameters
+                                                      recordingStatistics:recordsStatistics]
+                                      : [entry matchesURLRequestOfContext:context recordingStatistics:recordsStatistics]) {
+                bestMatch = entry;
+                break;
+            }
+        }
+    }
+
+    // The same goes for opaque mock requests
+    for (UMKMockRequestIndexEntry *entry in self.unindexedEntries) {
+        if (bestMatch && entry.registrationIndex > bestMatch.registrationIndex) {
+            break;
+        } else if ([excludedEntries containsObject:entry]) {
+            continue;
+        }
+
+        if ([entry matchesURLRequestOfContext:context recordingStatistics:recordsStatistics]) {
+            return entry;
+        }
+    }
+
+    return bestMatch;
+}
+
+@end
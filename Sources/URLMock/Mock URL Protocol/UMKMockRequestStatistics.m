@@ -0,0 +1,94 @@
+//
+//  UMKMockRequestStatistics.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import <URLMock/UMKMockRequestStatistics.h>
+
+#import <URLMock/UMKLatencyHistogram.h>
+
+#import <stdatomic.h>
+
+
+@implementation UMKMockRequestStatistics {
+    /*! Backs the matchCount property. */
+    _Atomic(NSUInteger) _matchCount;
+
+    /*! Backs the evaluationCount property. */
+    _Atomic(NSUInteger) _evaluationCount;
+}
+
+- (instancetype)initWithMockRequest:(id<UMKMockURLRequest>)mockRequest
+{
+    NSParameterAssert(mockRequest);
+
+    self = [super init];
+    if (self) {
+        _mockRequest = mockRequest;
+        atomic_init(&_matchCount, 0);
+        atomic_init(&_evaluationCount, 0);
+        _matchingTimeHistogram = [[UMKLatencyHistogram alloc] init];
+        _timeToFirstByteHistogram = [[UMKLatencyHistogram alloc] init];
+        _responseDurationHistogram = [[UMKLatencyHistogram alloc] init];
+    }
+
+    return self;
+}
+
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p> mockRequest=%@, matches=%lu, evaluations=%lu, matchingTime=%@, "
+                                      @"timeToFirstByte=%@, responseDuration=%@",
+            self.class, self, self.mockRequest, (unsigned long)self.matchCount, (unsigned long)self.evaluationCount,
+            self.matchingTimeHistogram, self.timeToFirstByteHistogram, self.responseDurationHistogram];
+}
+
+
+- (NSUInteger)matchCount
+{
+    return atomic_load_explicit(&_matchCount, memory_order_relaxed);
+}
+
+
+- (NSUInteger)evaluationCount
+{
+    return atomic_load_explicit(&_evaluationCount, memory_order_relaxed);
+}
+
+
+- (void)recordEvaluationWithDuration:(uint64_t)duration
+{
+    atomic_fetch_add_explicit(&_evaluationCount, 1, memory_order_relaxed);
+    [self.matchingTimeHistogram recordDuration:duration];
+}
+
+
+- (void)recordMatch
+{
+    atomic_fetch_add_explicit(&_matchCount, 1, memory_order_relaxed);
+}
+
+@end
@@ -0,0 +1,526 @@
+//
+//  UMKMockRouteTrie.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import "UMKMockRouteTrie.h"
+
+#import "UMKMockRequestIndex.h"
+
+
+#pragma mark Pattern Segments
+
+/*!
+ @abstract Returns the set of characters that may appear in a URL pattern parameter name.
+ @discussion This is the same set of characters that SOCKit uses.
+ */
+static NSCharacterSet *UMKRouteParameterCharacterSet(void)
+{
+    static NSCharacterSet *parameterCharacterSet = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSMutableCharacterSet *characterSet = [NSMutableCharacterSet alphanumericCharacterSet];
+        [characterSet addCharactersInString:@".@_"];
+        parameterCharacterSet = [characterSet copy];
+    });
+
+    return parameterCharacterSet;
+}
+
+
+/*!
+ @abstract Returns the name of the parameter that makes up the specified URL pattern segment.
+ @param segment The URL pattern segment.
+ @result The parameter name, or nil if the segment does not consist entirely of a parameter.
+ */
+static NSString *UMKRouteParameterNameForSegment(NSString *segment)
+{
+    if (segment.length < 2 || [segment characterAtIndex:0] != ':') {
+        return nil;
+    }
+
+    NSString *name = [segment substringFromIndex:1];
+    return [name rangeOfCharacterFromSet:UMKRouteParameterCharacterSet().invertedSet].location == NSNotFound ? name : nil;
+}
+
+
+/*!
+ @abstract Returns whether the specified URL pattern segment contains only literal text.
+ @discussion A colon only begins a parameter if it is followed by a parameter character, so segments like "http:" are 
+     literal. Segments with backslashes are never treated as literal, because backslashes escape characters in SOCKit 
+     patterns.
+ @param segment The URL pattern segment.
+ @result Whether the segment is literal.
+ */
+static BOOL UMKRouteSegmentIsLiteral(NSString *segment)
+{
+    NSCharacterSet *parameterCharacterSet = UMKRouteParameterCharacterSet();
+    NSUInteger length = segment.length;
+    for (NSUInteger i = 0; i < length; ++i) {
+        unichar character = [segment characterAtIndex:i];
+        if (character == '\\') {
+            return NO;
+        } else if (character == ':' && i + 1 < length) {
+            // Be conservative with non-ASCII characters, which may be parts of surrogate pairs
+            unichar nextCharacter = [segment characterAtIndex:i + 1];
+            if (nextCharacter >= 0x80 || [parameterCharacterSet characterIsMember:nextCharacter]) {
+                return NO;
+            }
+        }
+    }
+
+    return YES;
+}
+
+
+#pragma mark - Private Classes
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ UMKMockRouteTrieRoutes store an index entry along with its compiled URL pattern.
+ */
+@interface UMKMockRouteTrieRoute : NSObject
+
+/*! The route's index entry. */
+@property (nonatomic, strong, readonly) UMKMockRequestIndexEntry *entry;
+
+/*! The path segments of the entry's URL pattern. */
+@property (nonatomic, copy, readonly) NSArray<NSString *> *segments;
+
+/*! The names of the parameters in the entry's URL pattern, in the order in which they appear. */
+@property (nonatomic, copy, readonly) NSArray<NSString *> *parameterNames;
+
+- (instancetype)initWithEntry:(UMKMockRequestIndexEntry *)entry segments:(NSArray<NSString *> *)segments;
+
+/*!
+ @abstract Returns a dictionary that maps the route's parameter names to the specified values.
+ @param values The parameter values in the order in which their parameters appear in the route's URL pattern.
+ @result The parameter dictionary.
+ */
+- (NSDictionary<NSString *, NSString *> *)parametersWithValues:(NSArray<NSString *> *)values;
+
+@end
+
+
+/*!
+ UMKMockRouteTrieNodes are the nodes of a route trie. Each node corresponds to a sequence of URL pattern segments.
+ */
+@interface UMKMockRouteTrieNode : NSObject <NSCopying>
+
+/*! The node's children for literal segments, keyed by segment. */
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSString *, UMKMockRouteTrieNode *> *literalChildren;
+
+/*! The node's child for parameter segments. */
+@property (nonatomic, strong, nullable) UMKMockRouteTrieNode *parameterChild;
+
+/*! The routes whose URL patterns end at the node, in registration order. */
+@property (nonatomic, strong, readonly) NSMutableArray<UMKMockRouteTrieRoute *> *routes;
+
+/*! Whether the node has no routes and no children. */
+@property (nonatomic, assign, readonly, getter=isEmpty) BOOL empty;
+
+@end
+
+
+@interface UMKMockRouteMatch ()
+
+/*! Redeclared as readwrite. */
+@property (nonatomic, copy, readwrite, nullable) NSDictionary<NSString *, NSString *> *parameters;
+
+- (instancetype)initWithEntry:(UMKMockRequestIndexEntry *)entry parameters:(nullable NSDictionary<NSString *, NSString *> *)parameters;
+
+@end
+
+
+@interface UMKMockRouteTrie ()
+
+/*! The trie's root node. */
+@property (nonatomic, strong) UMKMockRouteTrieNode *root;
+
+/*! The trie's routes, keyed by their entries. */
+@property (nonatomic, strong) NSMapTable<UMKMockRequestIndexEntry *, UMKMockRouteTrieRoute *> *routesByEntry;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+
+#pragma mark -
+
+@implementation UMKMockRouteTrieRoute
+
+- (instancetype)initWithEntry:(UMKMockRequestIndexEntry *)entry segments:(NSArray<NSString *> *)segments
+{
+    self = [super init];
+    if (self) {
+        _entry = entry;
+        _segments = [segments copy];
+
+        NSMutableArray<NSString *> *parameterNames = [[NSMutableArray alloc] init];
+        for (NSString *segment in segments) {
+            NSString *parameterName = UMKRouteParameterNameForSegment(segment);
+            if (parameterName) {
+                [parameterNames addObject:parameterName];
+            }
+        }
+
+        _parameterNames = [parameterNames copy];
+    }
+
+    return self;
+}
+
+
+- (NSDictionary<NSString *, NSString *> *)parametersWithValues:(NSArray<NSString *> *)values
+{
+    NSMutableDictionary<NSString *, NSString *> *parameters = [[NSMutableDictionary alloc] initWithCapacity:values.count];
+    [values enumerateObjectsUsingBlock:^(NSString *value, NSUInteger i, BOOL *stop) {
+        parameters[self.parameterNames[i]] = value;
+    }];
+
+    return parameters;
+}
+
+@end
+
+
+#pragma mark -
+
+@implementation UMKMockRouteTrieNode
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        _literalChildren = [[NSMutableDictionary alloc] init];
+        _routes = [[NSMutableArray alloc] init];
+    }
+
+    return self;
+}
+
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    // Routes are immutable, so only the nodes need to be copied
+    UMKMockRouteTrieNode *copy = [[self.class allocWithZone:zone] init];
+    [self.literalChildren enumerateKeysAndObjectsUsingBlock:^(NSString *segment, UMKMockRouteTrieNode *child, BOOL *stop) {
+        copy.literalChildren[segment] = [child copy];
+    }];
+
+    copy.parameterChild = [self.parameterChild copy];
+    [copy.routes addObjectsFromArray:self.routes];
+    return copy;
+}
+
+
+- (BOOL)isEmpty
+{
+    return self.routes.count == 0 && self.literalChildren.count == 0 && !self.parameterChild;
+}
+
+@end
+
+
+#pragma mark -
+
+@implementation UMKMockRouteMatch
+
+- (instancetype)initWithEntry:(UMKMockRequestIndexEntry *)entry parameters:(NSDictionary<NSString *, NSString *> *)parameters
+{
+    self = [super init];
+    if (self) {
+        _entry = entry;
+        _parameters = [parameters copy];
+    }
+
+    return self;
+}
+
+@end
+
+
+#pragma mark -
+
+@implementation UMKMockRouteTrie
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        _root = [[UMKMockRouteTrieNode alloc] init];
+        _routesByEntry = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                               valueOptions:NSPointerFunctionsStrongMemory];
+    }
+
+    return self;
+}
+
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    UMKMockRouteTrie *copy = [[self.class allocWithZone:zone] init];
+    copy.root = [self.root copy];
+    copy.routesByEntry = [self.routesByEntry copy];
+    return copy;
+}
+
+
+- (NSUInteger)count
+{
+    return self.routesByEntry.count;
+}
+
+
++ (BOOL)canCompileURLPattern:(NSString *)URLPattern
+{
+    if (URLPattern.length == 0) {
+        return NO;
+    }
+
+    for (NSString *segment in [URLPattern componentsSeparatedByString:@"/"]) {
+        if (!UMKRouteParameterNameForSegment(segment) && !UMKRouteSegmentIsLiteral(segment)) {
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+
+#pragma mark - Adding and Removing Entries
+
+- (void)addEntry:(UMKMockRequestIndexEntry *)entry
+{
+    NSParameterAssert(entry);
+
+    NSString *URLPattern = [(UMKPatternMatchingMockRequest *)entry.mockRequest URLPattern];
+    NSAssert([self.class canCompileURLPattern:URLPattern], @"Cannot compile URL pattern %@", URLPattern);
+
+    UMKMockRouteTrieRoute *route = [[UMKMockRouteTrieRoute alloc] initWithEntry:entry segments:[URLPattern componentsSeparatedByString:@"/"]];
+
+    UMKMockRouteTrieNode *node = self.root;
+    for (NSString *segment in route.segments) {
+        UMKMockRouteTrieNode *child = nil;
+        if (UMKRouteParameterNameForSegment(segment)) {
+            child = node.parameterChild;
+            if (!child) {
+                child = [[UMKMockRouteTrieNode alloc] init];
+                node.parameterChild = child;
+            }
+        } else {
+            child = node.literalChildren[segment];
+            if (!child) {
+                child = [[UMKMockRouteTrieNode alloc] init];
+                node.literalChildren[segment] = child;
+            }
+        }
+
+        node = child;
+    }
+
+    [node.routes addObject:route];
+    [self.routesByEntry setObject:route forKey:entry];
+}
+
+
+- (void)removeEntry:(UMKMockRequestIndexEntry *)entry
+{
+    NSParameterAssert(entry);
+
+    UMKMockRouteTrieRoute *route = [self.routesByEntry objectForKey:entry];
+    if (!route) {
+        return;
+    }
+
+    [self removeRoute:route fromNode:self.root segmentIndex:0];
+    [self.routesByEntry removeObjectForKey:entry];
+}
+
+
+/*!
+ @abstract Removes the specified route from the subtrie rooted at the specified node, pruning nodes that become empty.
+ @param route The route to remove.
+ @param node The root of the subtrie.
+ @param segmentIndex The index of the route segment that corresponds to the node's children.
+ */
+- (void)removeRoute:(UMKMockRouteTrieRoute *)route fromNode:(UMKMockRouteTrieNode *)node segmentIndex:(NSUInteger)segmentIndex
+{
+    if (segmentIndex == route.segments.count) {
+        [node.routes removeObjectIdenticalTo:route];
+        return;
+    }
+
+    NSString *segment = route.segments[segmentIndex];
+    if (UMKRouteParameterNameForSegment(segment)) {
+        [self removeRoute:route fromNode:node.parameterChild segmentIndex:segmentIndex + 1];
+        if (node.parameterChild.isEmpty) {
+            node.parameterChild = nil;
+        }
+    } else {
+        UMKMockRouteTrieNode *child = node.literalChildren[segment];
+        [self removeRoute:route fromNode:child segmentIndex:segmentIndex + 1];
+        if (child.isEmpty) {
+            [node.literalChildren removeObjectForKey:segment];
+        }
+    }
+}
+
+
+- (void)removeAllEntries
+{
+    self.root = [[UMKMockRouteTrieNode alloc] init];
+    [self.routesByEntry removeAllObjects];
+}
+
+
+#pragma mark - Matching
+
+- (NSArray<UMKMockRouteMatch *> *)matchesForURLString:(NSString *)URLString
+{
+    NSParameterAssert(URLString);
+
+    NSMapTable<UMKMockRouteTrieRoute *, UMKMockRouteMatch *> *matches = [NSMapTable strongToStrongObjectsMapTable];
+    [self collectMatchesFromNode:self.root
+                        segments:[URLString componentsSeparatedByString:@"/"]
+                    segmentIndex:0
+                 parameterValues:[[NSMutableArray alloc] init]
+                           exact:YES
+                       intoTable:matches];
+
+    NSMutableArray<UMKMockRouteMatch *> *sortedMatches = [[NSMutableArray alloc] initWithCapacity:matches.count];
+    for (UMKMockRouteTrieRoute *route in matches) {
+        [sortedMatches addObject:[matches objectForKey:route]];
+    }
+
+    [sortedMatches sortUsingComparator:^NSComparisonResult(UMKMockRouteMatch *match1, UMKMockRouteMatch *match2) {
+        uint64_t index1 = match1.entry.registrationIndex;
+        uint64_t index2 = match2.entry.registrationIndex;
+        return index1 < index2 ? NSOrderedAscending : (index1 > index2 ? NSOrderedDescending : NSOrderedSame);
+    }];
+
+    return sortedMatches;
+}
+
+
+/*!
+ @abstract Adds matches for the routes in the subtrie rooted at the specified node to the specified table.
+ @discussion Non-trailing parameters first try to match a single segment, which is exactly how SOCKit matches them. 
+     They then try to match successively more segments. Matches found that way are recorded without parameters so that
+     they are confirmed using SOCKit.
+ @param node The root of the subtrie.
+ @param segments The URL string's path segments.
+ @param segmentIndex The index of the first URL segment that has not yet been matched.
+ @param parameterValues The values of the parameters matched so far.
+ @param exact Whether every parameter matched so far matched exactly one segment.
+ @param matches The table to which matches should be added, keyed by route.
+ */
+- (void)collectMatchesFromNode:(UMKMockRouteTrieNode *)node
+                      segments:(NSArray<NSString *> *)segments
+                  segmentIndex:(NSUInteger)segmentIndex
+               parameterValues:(NSMutableArray<NSString *> *)parameterValues
+                         exact:(BOOL)exact
+                     intoTable:(NSMapTable<UMKMockRouteTrieRoute *, UMKMockRouteMatch *> *)matches
+{
+    NSUInteger segmentCount = segments.count;
+    if (segmentIndex == segmentCount) {
+        for (UMKMockRouteTrieRoute *route in node.routes) {
+            [self addMatchForRoute:route parameterValues:parameterValues exact:exact toTable:matches];
+        }
+
+        return;
+    }
+
+    NSString *segment = segments[segmentIndex];
+    UMKMockRouteTrieNode *literalChild = node.literalChildren[segment];
+    if (literalChild) {
+        [self collectMatchesFromNode:literalChild segments:segments segmentIndex:segmentIndex + 1
+                     parameterValues:parameterValues exact:exact intoTable:matches];
+    }
+
+    UMKMockRouteTrieNode *parameterChild = node.parameterChild;
+    if (!parameterChild) {
+        return;
+    }
+
+    // Trailing parameters match the rest of the URL string. Like everywhere else, SOCKit never matches them to an empty
+    // string.
+    if (parameterChild.routes.count > 0) {
+        NSArray<NSString *> *remainingSegments = [segments subarrayWithRange:NSMakeRange(segmentIndex, segmentCount - segmentIndex)];
+        NSString *value = [remainingSegments componentsJoinedByString:@"/"];
+        if (value.length > 0) {
+            [parameterValues addObject:value];
+            for (UMKMockRouteTrieRoute *route in parameterChild.routes) {
+                [self addMatchForRoute:route parameterValues:parameterValues exact:exact toTable:matches];
+            }
+
+            [parameterValues removeLastObject];
+        }
+    }
+
+    // Other parameters match one or more segments, leaving at least one segment for the rest of the pattern
+    if (parameterChild.literalChildren.count == 0 && !parameterChild.parameterChild) {
+        return;
+    }
+
+    NSMutableString *value = [segment mutableCopy];
+    for (NSUInteger nextSegmentIndex = segmentIndex + 1; nextSegmentIndex < segmentCount; ++nextSegmentIndex) {
+        if (value.length > 0) {
+            [parameterValues addObject:[value copy]];
+            [self collectMatchesFromNode:parameterChild segments:segments segmentIndex:nextSegmentIndex
+                         parameterValues:parameterValues exact:(exact && nextSegmentIndex == segmentIndex + 1) intoTable:matches];
+            [parameterValues removeLastObject];
+        }
+
+        [value appendFormat:@"/%@", segments[nextSegmentIndex]];
+    }
+}
+
+
+/*!
+ @abstract Adds a match for the specified route to the specified table.
+ @discussion If the route has already matched, an exact match replaces an inexact one.
+ @param route The route that matched.
+ @param parameterValues The values of the route's parameters.
+ @param exact Whether the parameter values are the ones SOCKit would produce.
+ @param matches The table to which the match should be added, keyed by route.
+ */
+- (void)addMatchForRoute:(UMKMockRouteTrieRoute *)route
+         parameterValues:(NSArray<NSString *> *)parameterValues
+                   exact:(BOOL)exact
+                 toTable:(NSMapTable<UMKMockRouteTrieRoute *, UMKMockRouteMatch *> *)matches
+{
+    UMKMockRouteMatch *match = [matches objectForKey:route];
+    if (!match) {
+        match = [[UMKMockRouteMatch alloc] initWithEntry:route.entry parameters:nil];
+        [matches setObject:match forKey:route];
+    }
+
+    if (exact && !match.parameters) {
+        match.parameters = [route parametersWithValues:parameterValues];
+    }
+}
+
+@end
@@ -28,14 +28,30 @@
 
 #import <URLMock/NSDictionary+UMKURLEncoding.h>
 #import <URLMock/UMKErrorUtilities.h>
+#import <URLMock/UMKLatencyHistogram.h>
+#import <URLMock/UMKMockRegistry.h>
+#import <URLMock/UMKMockRequestStatistics.h>
+#import <URLMock/UMKRequestJournal.h>
+
+#import "UMKCanonicalURLCache.h"
+#import "UMKMockRegistry+UMKMockURLProtocol.h"
+#import "UMKMockRequestIndex.h"
+
+#import <stdatomic.h>
+#import <time.h>
 
 
 #pragma mark Constants
 
 NSString *const kUMKErrorDomain = @"UMKErrorDomain";
 NSString *const kUMKUnexpectedRequestsKey = @"UMKUnexpectedRequests";
+NSString *const kUMKUnexpectedRequestCountKey = @"UMKUnexpectedRequestCount";
+NSString *const kUMKUnexpectedRequestRecordsKey = @"UMKUnexpectedRequestRecords";
 NSString *const kUMKUnservicedMockRequestsKey = @"UMKUnservicedMockRequests";
 
+/*! The default capacity of UMKMockURLProtocol's canonical URL cache. */
+static const NSUInteger kUMKDefaultCanonicalURLCacheCapacity = 512;
+
 
 #pragma mark - UMKMockUnexpectedRequest
 
@@ -65,59 +81,169 @@ NSString *const kUMKUnservicedMockRequestsKey = @"UMKUnservicedMockRequests";
 
 NS_ASSUME_NONNULL_BEGIN
 
-#pragma mark - UMKMockURLProtocolSettings
+#pragma mark - UMKMockURLProtocolClient
 
 /*!
- UMKMockURLProtocolSettings store settings for the UMKMockURLProtocol class.
+ UMKMockURLProtocolClients are passed to mock responders in place of a protocol's actual client. They forward every
+ message to the actual client and tell the protocol's mock registry when the response has finished. If the mock
+ request has statistics, they also record how long the response took to start and to finish.
  */
-@interface UMKMockURLProtocolSettings : NSObject
+@interface UMKMockURLProtocolClient : NSObject <NSURLProtocolClient>
 
-/*! Whether UMKMockURLProtocol is enabled. */
-@property (assign, getter = isEnabled) BOOL enabled;
+/*! The client to which messages are forwarded. */
+@property (nonatomic, strong, readonly) id<NSURLProtocolClient> client;
 
-/*! Whether verification is enabled for UMKMockURLProtocol. */
-@property (assign, getter = isVerificationEnabled) BOOL verificationEnabled;
+/*! The registry to notify when the response finishes. */
+@property (nonatomic, weak, readonly, nullable) UMKMockRegistry *registry;
 
-/*! The isolation queue for reading/writing expected mock requests. */
-@property (nonatomic, copy, readonly) dispatch_queue_t expectedMockRequestsIsolationQueue;
+/*! The request being responded to. */
+@property (nonatomic, strong, readonly) NSURLRequest *request;
 
-/*! 
- @abstract UMKMockURLProtocol's expected mock requests. 
- @discussion This variable should only be read and written on its isolation queue. Reads should be done using dispatch_sync;
-     writes should be done using dispatch_barrier_async. This allows for multiple simultaneous readers, but only one writer,
-     and prevents a read from occurring during a write.
- */
-@property (nonatomic, strong, readonly) NSMutableArray<id<UMKMockURLRequest>> *expectedMockRequests;
+/*! The mock request that is servicing the request, or nil if the request was unexpected. */
+@property (nonatomic, strong, readonly, nullable) id<UMKMockURLRequest> mockRequest;
 
-/*! The isolation queue for reading/writing unexpected requests. */
-@property (nonatomic, copy, readonly) dispatch_queue_t unexpectedRequestsIsolationQueue;
+/*! The statistics in which to record the response's timings, or nil if they should not be recorded. */
+@property (nonatomic, strong, readonly, nullable) UMKMockRequestStatistics *statistics;
 
-/*! 
- @abstract UMKMockURLProtocol's unexpected requests.
- @discussion This variable should only be read and written on its isolation queue. Reads should be done using dispatch_sync;
-     writes should be done using dispatch_barrier_async. This allows for multiple simultaneous readers, but only one writer,
-     and prevents a read from occurring during a write.
-*/
-@property (nonatomic, strong, readonly) NSMutableArray<NSURLRequest *> *unexpectedRequests;
+- (instancetype)initWithClient:(id<NSURLProtocolClient>)client
+                      registry:(nullable UMKMockRegistry *)registry
+                       request:(NSURLRequest *)request
+                   mockRequest:(nullable id<UMKMockURLRequest>)mockRequest
+                    statistics:(nullable UMKMockRequestStatistics *)statistics;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+
+#pragma mark -
+
+@implementation UMKMockURLProtocolClient {
+    /*! When the client was created, in nanoseconds on the uptime clock. Only meaningful if there are statistics. */
+    uint64_t _startTime;
+
+    /*! Whether the time to the first byte of the response has been recorded. */
+    _Atomic(bool) _recordedTimeToFirstByte;
+}
+
+- (instancetype)initWithClient:(id<NSURLProtocolClient>)client
+                      registry:(UMKMockRegistry *)registry
+                       request:(NSURLRequest *)request
+                   mockRequest:(id<UMKMockURLRequest>)mockRequest
+                    statistics:(UMKMockRequestStatistics *)statistics
+{
+    self = [super init];
+    if (self) {
+        _client = client;
+        _registry = registry;
+        _request = request;
+        _mockRequest = mockRequest;
+        _statistics = statistics;
+        _startTime = statistics ? clock_gettime_nsec_np(CLOCK_UPTIME_RAW) : 0;
+        atomic_init(&_recordedTimeToFirstByte, false);
+    }
+
+    return self;
+}
+
+
+/*!
+ @abstract Records the time since the client was created in the statistics' time-to-first-byte histogram, unless 
+     that has already been done.
+ */
+- (void)recordTimeToFirstByte
+{
+    if (self.statistics && !atomic_exchange_explicit(&_recordedTimeToFirstByte, true, memory_order_relaxed)) {
+        [self.statistics.timeToFirstByteHistogram recordDuration:clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - _startTime];
+    }
+}
 
-/*! The isolation queue for reading/writing serviced requests. */
-@property (nonatomic, copy, readonly) dispatch_queue_t servicedRequestsIsolationQueue;
 
 /*!
- @abstract UMKMockURLProtocol's serviced requests. Keys are NSURLRequests; values are UMKMockURLRequests.
- @discussion This variable should only be read and written on its isolation queue. Reads should be done using dispatch_sync;
-     writes should be done using dispatch_barrier_async. This allows for multiple simultaneous readers, but only one writer,
-     and prevents a read from occurring during a write.
+ @abstract Records the time since the client was created in the statistics' response duration histogram.
  */
-@property (nonatomic, strong, readonly) NSMutableDictionary<NSURLRequest *, id<UMKMockURLRequest>> *servicedRequests;
+- (void)recordResponseDuration
+{
+    if (self.statistics) {
+        [self recordTimeToFirstByte];
+        [self.statistics.responseDurationHistogram recordDuration:clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - _startTime];
+    }
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol wasRedirectedToRequest:(NSURLRequest *)request redirectResponse:(NSURLResponse *)redirectResponse
+{
+    [self.client URLProtocol:protocol wasRedirectedToRequest:request redirectResponse:redirectResponse];
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol cachedResponseIsValid:(NSCachedURLResponse *)cachedResponse
+{
+    [self.client URLProtocol:protocol cachedResponseIsValid:cachedResponse];
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol didReceiveResponse:(NSURLResponse *)response cacheStoragePolicy:(NSURLCacheStoragePolicy)policy
+{
+    [self recordTimeToFirstByte];
+    [self.client URLProtocol:protocol didReceiveResponse:response cacheStoragePolicy:policy];
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol didLoadData:(NSData *)data
+{
+    [self recordTimeToFirstByte];
+    [self.client URLProtocol:protocol didLoadData:data];
+}
 
 
+- (void)URLProtocolDidFinishLoading:(NSURLProtocol *)protocol
+{
+    [self recordResponseDuration];
+    [self.client URLProtocolDidFinishLoading:protocol];
+    [self.registry markResponseFinishedForRequest:self.request mockRequest:self.mockRequest error:nil];
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol didFailWithError:(NSError *)error
+{
+    [self recordResponseDuration];
+    [self.client URLProtocol:protocol didFailWithError:error];
+    [self.registry markResponseFinishedForRequest:self.request mockRequest:self.mockRequest error:error];
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol didReceiveAuthenticationChallenge:(NSURLAuthenticationChallenge *)challenge
+{
+    [self.client URLProtocol:protocol didReceiveAuthenticationChallenge:challenge];
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol didCancelAuthenticationChallenge:(NSURLAuthenticationChallenge *)challenge
+{
+    [self.client URLProtocol:protocol didCancelAuthenticationChallenge:challenge];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+#pragma mark - UMKMockURLProtocolSettings
+
 /*!
- @abstract Resets the receiver's accounting settings.
- @discussion Accounting settings include the whether the receiver has received any unexpected requests,
-     what requests are expected, and what requests have been serviced.
+ UMKMockURLProtocolSettings store settings for the UMKMockURLProtocol class that are shared by all mock registries.
+ */
+@interface UMKMockURLProtocolSettings : NSObject
+
+/*! Whether UMKMockURLProtocol is enabled. */
+@property (assign, getter = isEnabled) BOOL enabled;
+
+/*! 
+ @abstract The cache of canonical URLs, keyed by the absolute string of the URLs they were created from.
+ @discussion The cache is thread-safe and may be accessed from any thread. It is replaced when its capacity changes.
  */
-- (void)reset;
+@property (strong) UMKCanonicalURLCache *canonicalURLCache;
 
 @end
 
@@ -132,51 +258,99 @@ NS_ASSUME_NONNULL_END
 {
     self = [super init];
     if (self) {
-        _unexpectedRequests = [[NSMutableArray alloc] init];
-        NSString *label = [NSString stringWithFormat:@"%@.isolation.unexpectedRequests", self.class];
-        _unexpectedRequestsIsolationQueue = dispatch_queue_create([label UTF8String], 0);
-        
-        _expectedMockRequests = [[NSMutableArray alloc] init];
-        label = [NSString stringWithFormat:@"%@.isolation.expectedMockRequests", self.class];
-        _expectedMockRequestsIsolationQueue = dispatch_queue_create([label UTF8String], 0);
-        
-        _servicedRequests = [[NSMutableDictionary alloc] init];
-        label = [NSString stringWithFormat:@"%@.isolation.servicedRequests", self.class];
-        _servicedRequestsIsolationQueue = dispatch_queue_create([label UTF8String], 0);
+        _canonicalURLCache = [[UMKCanonicalURLCache alloc] initWithCapacity:kUMKDefaultCanonicalURLCacheCapacity];
     }
 
     return self;
 }
 
 
-- (void)reset
+- (NSString *)debugDescription
 {
-    dispatch_barrier_async(self.expectedMockRequestsIsolationQueue, ^{
-        [self.expectedMockRequests removeAllObjects];
-    });
-    
-    dispatch_barrier_async(self.unexpectedRequestsIsolationQueue, ^{
-        [self.unexpectedRequests removeAllObjects];
-    });
-    
-    dispatch_barrier_async(self.servicedRequestsIsolationQueue, ^{
-        [self.servicedRequests removeAllObjects];
-    });
+    return [NSString stringWithFormat:@"<%@: %p> enabled: %@; defaultRegistry: %@", self.class, self,
+                                                                                     self.enabled ? @"YES" : @"NO",
+                                                                                     [UMKMockRegistry defaultRegistry].debugDescription];
 }
 
+@end
+
 
-- (NSString *)debugDescription
+#pragma mark - Canonical Query Strings
+
+/*!
+ @abstract Returns whether the specified character can appear unencoded in a canonical query string.
+ @discussion These are the RFC 3986 unreserved characters, which are the only characters that 
+     -[UMKParameterPair URLEncodedStringValue] leaves unencoded in both keys and values.
+ */
+static inline BOOL UMKIsUnreservedCharacter(unichar character)
 {
-    return [NSString stringWithFormat:@"<%@: %p> enabled: %@; verificationEnabled: %@, receivedUnexpectedRequest: %@; "
-                                      @"expectedMockRequests: %@, servicedRequests: %@", self.class, self,
-                                                                                         self.enabled ? @"YES" : @"NO",
-                                                                                         self.verificationEnabled ? @"YES" : @"NO",
-                                                                                         self.unexpectedRequests.debugDescription,
-                                                                                         self.expectedMockRequests.debugDescription,
-                                                                                         self.servicedRequests.debugDescription];
+    return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z') ||
+        (character >= '0' && character <= '9') || character == '-' || character == '_' || character == '.' || character == '~';
 }
 
-@end
+
+/*!
+ @abstract Returns whether the specified query string is already in canonical form.
+ @discussion This is a conservative check that allows +[UMKMockURLProtocol canonicalURLForURL:] to skip parsing and 
+     re-encoding simple queries. A query is canonical if each of its parameters is either a key or a key-value pair 
+     consisting only of unreserved characters, no key is empty, and the keys are in strictly ascending case-insensitive 
+     order. Queries that contain percent-encoded characters, array or dictionary keys, or repeated keys are never 
+     considered canonical, even if canonicalizing them would leave them unchanged.
+ @param query The query string. May not be nil.
+ @result Whether the query string is canonical.
+ */
+static BOOL UMKQueryStringIsCanonical(NSString *query)
+{
+    NSUInteger length = query.length;
+    unichar stackCharacters[256];
+    unichar *characters = length <= 256 ? stackCharacters : malloc(length * sizeof(unichar));
+    [query getCharacters:characters range:NSMakeRange(0, length)];
+
+    BOOL isCanonical = YES;
+    NSRange previousKeyRange = NSMakeRange(NSNotFound, 0);
+    NSUInteger parameterStart = 0;
+    while (isCanonical && parameterStart <= length) {
+        // Find the end of the key and the end of the parameter
+        NSUInteger keyEnd = parameterStart;
+        while (keyEnd < length && UMKIsUnreservedCharacter(characters[keyEnd])) {
+            keyEnd++;
+        }
+
+        NSUInteger parameterEnd = keyEnd;
+        if (parameterEnd < length && characters[parameterEnd] == '=') {
+            parameterEnd++;
+            while (parameterEnd < length && UMKIsUnreservedCharacter(characters[parameterEnd])) {
+                parameterEnd++;
+            }
+        }
+
+        // Each parameter must have a non-empty key and end at an ampersand or the end of the string
+        if (keyEnd == parameterStart || (parameterEnd < length && characters[parameterEnd] != '&')) {
+            isCanonical = NO;
+            break;
+        }
+
+        NSRange keyRange = NSMakeRange(parameterStart, keyEnd - parameterStart);
+        if (previousKeyRange.location != NSNotFound) {
+            NSString *previousKey = [[NSString alloc] initWithCharactersNoCopy:characters + previousKeyRange.location
+                                                                        length:previousKeyRange.length
+                                                                  freeWhenDone:NO];
+            NSString *key = [[NSString alloc] initWithCharactersNoCopy:characters + keyRange.location
+                                                                length:keyRange.length
+                                                          freeWhenDone:NO];
+            isCanonical = [previousKey caseInsensitiveCompare:key] == NSOrderedAscending;
+        }
+
+        previousKeyRange = keyRange;
+        parameterStart = parameterEnd + 1;
+    }
+
+    if (characters != stackCharacters) {
+        free(characters);
+    }
+
+    return isCanonical;
+}
 
 
 #pragma mark - UMKMockURLProtocol
@@ -189,6 +363,12 @@ NS_ASSUME_NONNULL_END
 /*! The instance's mock responder. */
 @property (strong, nonatomic) id<UMKMockURLResponder> mockResponder;
 
+/*! The statistics of the instance's mock request, if any. */
+@property (strong, nonatomic) UMKMockRequestStatistics *mockRequestStatistics;
+
+/*! The instance's response session, if its responder creates them. This is released when the instance stops loading. */
+@property (strong, nonatomic) id<UMKMockURLResponseSession> responseSession;
+
 @end
 
 
@@ -200,16 +380,20 @@ NS_ASSUME_NONNULL_END
 {
     self = [super initWithRequest:request cachedResponse:cachedResponse client:client];
     if (self) {
-        _mockRequest = [self.class expectedMockRequestMatchingURLRequest:request];
+        UMKMockRegistry *registry = [self.class mockRegistry];
+        BOOL claimed = NO;
+        UMKMockRequestIndexEntry *entry = [registry expectedMockRequestEntryForProtocolWithURLRequest:request claimed:&claimed];
+        _mockRequest = entry.mockRequest;
+        _mockRequestStatistics = entry.statistics;
 
         // If there was a mock request, mark it as serviced. Otherwise, respond with an unexpected request responder
         if (_mockRequest) {
             _mockResponder = [_mockRequest responderForURLRequest:request];
             NSAssert(_mockResponder, @"No responder for mock request: %@", _mockRequest);
-            [self.class markRequest:request asServicedByMockRequest:_mockRequest];
+            [registry markRequest:request asServicedByEntry:entry claimed:claimed];
         } else {
             _mockResponder = [[UMKUnexpectedRequestResponder alloc] init];
-            [self.class addUnexpectedRequest:request];
+            [registry addUnexpectedRequest:request];
         }
     }
 
@@ -221,11 +405,13 @@ NS_ASSUME_NONNULL_END
 
 + (BOOL)canInitWithRequest:(NSURLRequest *)request
 {
-    if ([self isVerificationEnabled]) {
+    UMKMockRegistry *registry = [self mockRegistry];
+    if (registry.isVerificationEnabled) {
         return YES;
     }
     
-    return [self expectedMockRequestMatchingURLRequest:request] != nil;
+    // Save the match so that the protocol instance created for this request doesn’t have to repeat it
+    return [registry savePendingMatchForURLRequest:request];
 }
 
 
@@ -238,6 +424,7 @@ NS_ASSUME_NONNULL_END
     
     NSMutableURLRequest *canonicalRequest = [request mutableCopy];
     canonicalRequest.URL = canonicalURL;
+    [[self mockRegistry] movePendingMatchFromURLRequest:request toURLRequest:canonicalRequest];
     return canonicalRequest;
 }
 
@@ -250,13 +437,40 @@ NS_ASSUME_NONNULL_END
 
 - (void)startLoading
 {
-    [self.mockResponder respondToMockRequest:self.mockRequest client:self.client protocol:self];
+    // Responders talk to a client that tells our registry when the response finishes
+    UMKMockURLProtocolClient *client = [[UMKMockURLProtocolClient alloc] initWithClient:self.client
+                                                                               registry:[self.class mockRegistry]
+                                                                                request:self.request
+                                                                            mockRequest:self.mockRequest
+                                                                             statistics:self.mockRequestStatistics];
+
+    // Responders that create sessions can be shared between requests, because all of the response's state is ours
+    id<UMKMockURLResponder> mockResponder = self.mockResponder;
+    if ([mockResponder respondsToSelector:@selector(responseSessionForMockRequest:client:protocol:)]) {
+        self.responseSession = [mockResponder responseSessionForMockRequest:self.mockRequest client:client protocol:self];
+        [self.responseSession start];
+    } else {
+        [mockResponder respondToMockRequest:self.mockRequest client:client protocol:self];
+    }
 }
 
 
 - (void)stopLoading
 {
-    [self.mockResponder cancelResponse];
+    // Sessions retain us until they finish, so release ours to break the cycle
+    id<UMKMockURLResponseSession> responseSession = self.responseSession;
+    if (responseSession) {
+        self.responseSession = nil;
+        [responseSession cancel];
+        return;
+    }
+
+    id<UMKMockURLResponder> mockResponder = self.mockResponder;
+    if ([mockResponder respondsToSelector:@selector(cancelResponseToProtocol:)]) {
+        [mockResponder cancelResponseToProtocol:self];
+    } else {
+        [mockResponder cancelResponse];
+    }
 }
 
 
@@ -285,9 +499,15 @@ NS_ASSUME_NONNULL_END
 }
 
 
++ (UMKMockRegistry *)mockRegistry
+{
+    return [UMKMockRegistry defaultRegistry];
+}
+
+
 + (void)reset
 {
-    [self.settings reset];
+    [[self mockRegistry] reset];
 }
 
 
@@ -311,69 +531,45 @@ NS_ASSUME_NONNULL_END
  */
 + (id<UMKMockURLRequest>)expectedMockRequestMatchingURLRequest:(NSURLRequest *)request
 {
-    NSParameterAssert(request);
-
-    __block id<UMKMockURLRequest> mockRequest = nil;
-
-    dispatch_sync([[self.class settings] expectedMockRequestsIsolationQueue] , ^{
-        NSUInteger index = [self.settings.expectedMockRequests indexOfObjectPassingTest:^BOOL(id<UMKMockURLRequest> mockRequest, NSUInteger idx, BOOL *stop) {
-            return [mockRequest matchesURLRequest:request];
-        }];
-        
-        mockRequest = (index != NSNotFound) ? self.settings.expectedMockRequests[index] : nil;
-    });
-    
-    return mockRequest;
+    return [[self mockRegistry] expectedMockRequestMatchingURLRequest:request];
 }
 
 
 + (NSArray<id<UMKMockURLRequest>> *)expectedMockRequests
 {
-    __block NSArray<id<UMKMockURLRequest>> *expectedMockRequests = nil;
-    dispatch_sync(self.settings.expectedMockRequestsIsolationQueue, ^{
-        expectedMockRequests = [self.settings.expectedMockRequests copy];
-    });
-    
-    return expectedMockRequests;
+    return [self mockRegistry].expectedMockRequests;
 }
 
 
 + (void)expectMockRequest:(id<UMKMockURLRequest>)request
 {
-    NSParameterAssert(request);
+    [[self mockRegistry] expectMockRequest:request];
+}
 
-    dispatch_barrier_async(self.settings.expectedMockRequestsIsolationQueue, ^{
-        [self.settings.expectedMockRequests addObject:request];
-    });
+
++ (void)expectMockRequests:(NSArray<id<UMKMockURLRequest>> *)requests
+{
+    [[self mockRegistry] expectMockRequests:requests];
 }
 
 
 + (void)removeExpectedMockRequest:(id<UMKMockURLRequest>)request
 {
-    dispatch_barrier_async(self.settings.expectedMockRequestsIsolationQueue, ^{
-        [self.settings.expectedMockRequests removeObject:request];
-    });
+    [[self mockRegistry] removeExpectedMockRequest:request];
 }
 
 
-#pragma mark - Unexpected Requests
-
-+ (NSArray<NSURLRequest *> *)unexpectedRequests
++ (void)removeExpectedMockRequests:(NSArray<id<UMKMockURLRequest>> *)requests
 {
-    __block NSArray<NSURLRequest *> *unexpectedRequests = nil;
-    dispatch_sync(self.settings.unexpectedRequestsIsolationQueue, ^{
-        unexpectedRequests = [self.settings.unexpectedRequests copy];
-    });
-    
-    return unexpectedRequests;
+    [[self mockRegistry] removeExpectedMockRequests:requests];
 }
 
 
-+ (void)addUnexpectedRequest:(NSURLRequest *)request
+#pragma mark - Unexpected Requests
+
++ (NSArray<NSURLRequest *> *)unexpectedRequests
 {
-    dispatch_barrier_async(self.settings.unexpectedRequestsIsolationQueue, ^{
-        [self.settings.unexpectedRequests addObject:request];
-    });
+    return [self mockRegistry].unexpectedRequests;
 }
 
 
@@ -381,29 +577,19 @@ NS_ASSUME_NONNULL_END
 
 + (NSDictionary<NSURLRequest *, id<UMKMockURLRequest>> *)servicedRequests
 {
-    __block NSDictionary<NSURLRequest *, id<UMKMockURLRequest>> *servicedRequests = nil;
-    dispatch_sync(self.settings.servicedRequestsIsolationQueue, ^{
-        servicedRequests = [self.settings.servicedRequests copy];
-    });
-    
-    return servicedRequests;
+    return [self mockRegistry].servicedRequests;
 }
 
 
-+ (void)markRequest:(NSURLRequest * _Nonnull)request asServicedByMockRequest:(_Nonnull id<UMKMockURLRequest>)mockRequest
++ (id<UMKRequestJournalSink>)requestJournalSink
 {
-    if (![self isVerificationEnabled]) {
-        return;
-    }
+    return [self mockRegistry].journal.sink;
+}
 
-    dispatch_async(self.settings.servicedRequestsIsolationQueue, ^{
-        self.settings.servicedRequests[request] = mockRequest;
-    });
 
-    // If the mockRequest doesn't respond to shouldRemoveAfterServicingRequest: or it does and it responds YES, remove it
-    if (![mockRequest respondsToSelector:@selector(shouldRemoveAfterServicingRequest:)] || [mockRequest shouldRemoveAfterServicingRequest:request]) {
-        [self removeExpectedMockRequest:mockRequest];
-    }
++ (void)setRequestJournalSink:(id<UMKRequestJournalSink>)sink
+{
+    [self mockRegistry].journal.sink = sink;
 }
 
 
@@ -411,13 +597,13 @@ NS_ASSUME_NONNULL_END
 
 + (BOOL)isVerificationEnabled
 {
-    return self.settings.isVerificationEnabled;
+    return [self mockRegistry].isVerificationEnabled;
 }
 
 
 + (void)setVerificationEnabled:(BOOL)enabled
 {
-    self.settings.verificationEnabled = enabled;
+    [self mockRegistry].verificationEnabled = enabled;
 }
 
 
@@ -429,47 +615,47 @@ NS_ASSUME_NONNULL_END
                                      userInfo:nil];
     }
 
-    // We want to disallow any writes to either unexpectedRequests or expectedMockRequests until we're done copying both
-    __block NSArray<NSURLRequest *> *unexpectedRequests = nil;
-    __block NSArray<id<UMKMockURLRequest>> *expectedMockRequests = nil;
-    dispatch_sync(self.settings.unexpectedRequestsIsolationQueue, ^{
-        dispatch_sync(self.settings.expectedMockRequestsIsolationQueue, ^{
-            unexpectedRequests = [self.settings.unexpectedRequests copy];
-            expectedMockRequests = [self.settings.expectedMockRequests copy];
-        });
-    });
-    
-    BOOL receivedUnexpectedRequest = unexpectedRequests.count > 0;
+    return [[self mockRegistry] verifyWithError:outError];
+}
 
-    NSMutableSet<id<UMKMockURLRequest>> *unservicedMockRequests = [NSMutableSet setWithArray:expectedMockRequests];
-    [unservicedMockRequests minusSet:[NSSet setWithArray:self.servicedRequests.allValues]];
-    BOOL hasUnservicedMockRequests = unservicedMockRequests.count > 0;
 
-    BOOL passed = !(receivedUnexpectedRequest || hasUnservicedMockRequests);
-    if (passed || !outError) {
-        return passed;
-    }
-    
-    NSUInteger code = 0;
-    NSMutableDictionary *userInfo = [[NSMutableDictionary alloc] initWithCapacity:2];
-    
-    // We want to prioritize unexpected requests over unserviced requests.
-    // Unserviced requests will be returned whether that's the error code we use or not
-    if (receivedUnexpectedRequest) {
-        code = kUMKUnexpectedRequestErrorCode;
-        userInfo[NSLocalizedDescriptionKey] = NSLocalizedString(@"Received one or more unexpected requests", @"Unexpected request error description");
-        userInfo[kUMKUnexpectedRequestsKey] = unexpectedRequests;
-    } else {
-        code = kUMKUnservicedMockRequestErrorCode;
-        userInfo[NSLocalizedDescriptionKey] = NSLocalizedString(@"One or more mock requests were not serviced", @"Unserviced mock request error description");
-    }
-    
-    if (hasUnservicedMockRequests) {
-        userInfo[kUMKUnservicedMockRequestsKey] = [unservicedMockRequests allObjects];
-    }
-    
-    *outError = [NSError errorWithDomain:kUMKErrorDomain code:code userInfo:userInfo];
-    return NO;
+#pragma mark - Statistics
+
++ (BOOL)isStatisticsEnabled
+{
+    return [self mockRegistry].isStatisticsEnabled;
+}
+
+
++ (void)setStatisticsEnabled:(BOOL)enabled
+{
+    [self mockRegistry].statisticsEnabled = enabled;
+}
+
+
++ (UMKMockRequestStatistics *)statisticsForMockRequest:(id<UMKMockURLRequest>)mockRequest
+{
+    return [[self mockRegistry] statisticsForMockRequest:mockRequest];
+}
+
+
++ (NSArray<UMKMockRequestStatistics *> *)mockRequestStatistics
+{
+    return [self mockRegistry].mockRequestStatistics;
+}
+
+
+#pragma mark - Network Conditions
+
++ (UMKNetworkConditions *)networkConditions
+{
+    return [self mockRegistry].networkConditions;
+}
+
+
++ (void)setNetworkConditions:(UMKNetworkConditions *)networkConditions
+{
+    [self mockRegistry].networkConditions = networkConditions;
 }
 
 
@@ -480,16 +666,59 @@ NS_ASSUME_NONNULL_END
     // Always use the absolute URL
     NSURL *canonicalURL = URL.absoluteURL;
     NSString *query = canonicalURL.query;
+    if (query.length == 0) {
+        return canonicalURL;
+    }
+
+    UMKCanonicalURLCache *cache = self.settings.canonicalURLCache;
+    NSString *URLString = [canonicalURL absoluteString];
+    NSURL *cachedURL = [cache canonicalURLForURLString:URLString];
+    if (cachedURL) {
+        return cachedURL;
+    }
 
-    // If there's a query, make sure the order of the parameters is consistent
-    if (query.length > 0) {
+    // If the query isn't already canonical, make sure the order of the parameters is consistent
+    if (!UMKQueryStringIsCanonical(query)) {
         NSString *canonicalQueryString = [[NSDictionary umk_dictionaryWithURLEncodedParameterString:query] umk_URLEncodedParameterString];
-        NSString *URLString = [canonicalURL absoluteString];
         canonicalURL = [NSURL URLWithString:[URLString stringByReplacingCharactersInRange:[URLString rangeOfString:query]
                                                                                withString:canonicalQueryString]];
     }
 
+    if (canonicalURL) {
+        [cache setCanonicalURL:canonicalURL forURLString:URLString];
+    }
+
     return canonicalURL;
 }
 
+
++ (NSUInteger)canonicalURLCacheCapacity
+{
+    return self.settings.canonicalURLCache.capacity;
+}
+
+
++ (void)setCanonicalURLCacheCapacity:(NSUInteger)capacity
+{
+    self.settings.canonicalURLCache = [[UMKCanonicalURLCache alloc] initWithCapacity:capacity];
+}
+
+
++ (NSUInteger)canonicalURLCacheHitCount
+{
+    return self.settings.canonicalURLCache.hitCount;
+}
+
+
++ (NSUInteger)canonicalURLCacheMissCount
+{
+    return self.settings.canonicalURLCache.missCount;
+}
+
+
++ (void)removeAllCachedCanonicalURLs
+{
+    [self.settings.canonicalURLCache removeAllCanonicalURLs];
+}
+
 @end
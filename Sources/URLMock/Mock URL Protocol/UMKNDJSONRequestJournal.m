@@ -0,0 +1,380 @@
+//
+//  UMKNDJSONRequestJournal.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import <URLMock/UMKNDJSONRequestJournal.h>
+
+#import <fcntl.h>
+#import <os/lock.h>
+#import <unistd.h>
+
+
+/*! The number of bytes read from a journal file at a time. */
+static const NSUInteger kUMKNDJSONReadChunkSize = 64 * 1024;
+
+
+/*!
+ @abstract Returns an NSError in the POSIX domain for the specified error number and file URL.
+ @param errorNumber The error number.
+ @param fileURL The URL of the file that was being accessed.
+ @result An error that describes the problem.
+ */
+static NSError *UMKPOSIXErrorForFileURL(int errorNumber, NSURL *fileURL)
+{
+    return [NSError errorWithDomain:NSPOSIXErrorDomain code:errorNumber userInfo:@{ NSURLErrorKey : fileURL }];
+}
+
+
+#pragma mark - UMKNDJSONRequestJournalSink
+
+@implementation UMKNDJSONRequestJournalSink {
+    /*! Protects the instance variables below. */
+    os_unfair_lock _lock;
+
+    /*! The file descriptor of the sink's file, or -1 if it is closed. Only accessed on the write queue. */
+    int _fileDescriptor;
+
+    /*! The queue on which the file is written. */
+    dispatch_queue_t _writeQueue;
+
+    /*! Serialized records that have not been written to the file. */
+    NSMutableData *_pendingData;
+
+    /*! The number of records in _pendingData. */
+    NSUInteger _pendingRecordCount;
+
+    /*! Whether a write has been scheduled because the pending data reached the batch size. */
+    BOOL _immediateWriteScheduled;
+
+    /*! Whether a write has been scheduled to occur after the flush interval. */
+    BOOL _delayedWriteScheduled;
+
+    /*! Whether the sink has been closed. */
+    BOOL _closed;
+
+    /*! Backs the writtenRecordCount property. */
+    NSUInteger _writtenRecordCount;
+
+    /*! Backs the lastError property. */
+    NSError *_lastError;
+}
+
+- (instancetype)initWithFileURL:(NSURL *)fileURL error:(NSError **)outError
+{
+    return [self initWithFileURL:fileURL batchByteCount:64 * 1024 flushInterval:1.0 error:outError];
+}
+
+
+- (instancetype)initWithFileURL:(NSURL *)fileURL
+                 batchByteCount:(NSUInteger)batchByteCount
+                  flushInterval:(NSTimeInterval)flushInterval
+                          error:(NSError **)outError
+{
+    NSParameterAssert(fileURL);
+
+    self = [super init];
+    if (self) {
+        _fileDescriptor = open(fileURL.fileSystemRepresentation, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+        if (_fileDescriptor < 0) {
+            if (outError) {
+                *outError = UMKPOSIXErrorForFileURL(errno, fileURL);
+            }
+
+            return nil;
+        }
+
+        _fileURL = [fileURL copy];
+        _batchByteCount = batchByteCount;
+        _flushInterval = flushInterval;
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _pendingData = [[NSMutableData alloc] init];
+
+        NSString *label = [NSString stringWithFormat:@"%@.write", self.class];
+        _writeQueue = dispatch_queue_create(label.UTF8String, dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0));
+    }
+
+    return self;
+}
+
+
+- (void)dealloc
+{
+    // Scheduled writes retain the sink, so none can be pending when it is deallocated
+    [self writePendingData];
+    if (_fileDescriptor >= 0) {
+        close(_fileDescriptor);
+    }
+}
+
+
+- (NSUInteger)writtenRecordCount
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger writtenRecordCount = _writtenRecordCount;
+    os_unfair_lock_unlock(&_lock);
+    return writtenRecordCount;
+}
+
+
+- (NSError *)lastError
+{
+    os_unfair_lock_lock(&_lock);
+    NSError *lastError = _lastError;
+    os_unfair_lock_unlock(&_lock);
+    return lastError;
+}
+
+
+#pragma mark - Receiving Records
+
+- (void)requestJournal:(UMKRequestJournal *)journal didAddRecord:(UMKRequestJournalRecord *)record
+{
+    // Serialize the record before taking the lock so that threads adding records only contend on the append
+    NSData *line = [NSJSONSerialization dataWithJSONObject:record.JSONObject options:0 error:NULL];
+    if (!line) {
+        return;
+    }
+
+    BOOL scheduleImmediateWrite = NO;
+    BOOL scheduleDelayedWrite = NO;
+
+    os_unfair_lock_lock(&_lock);
+    if (_closed) {
+        os_unfair_lock_unlock(&_lock);
+        return;
+    }
+
+    [_pendingData appendData:line];
+    [_pendingData appendBytes:"\n" length:1];
+    _pendingRecordCount++;
+
+    if (_pendingData.length >= self.batchByteCount) {
+        scheduleImmediateWrite = !_immediateWriteScheduled;
+        _immediateWriteScheduled = YES;
+    } else if (!_delayedWriteScheduled) {
+        scheduleDelayedWrite = YES;
+        _delayedWriteScheduled = YES;
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    if (scheduleImmediateWrite) {
+        dispatch_async(_writeQueue, ^{
+            [self writePendingData];
+        });
+    } else if (scheduleDelayedWrite) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.flushInterval * NSEC_PER_SEC)), _writeQueue, ^{
+            [self writePendingData];
+        });
+    }
+}
+
+
+#pragma mark - Writing
+
+/*!
+ @abstract Writes the receiver's pending data to its file.
+ @discussion This method must be invoked on the receiver's write queue, or when no other thread can be using the 
+     receiver. Writes that are scheduled after the pending data has already been written do nothing.
+ */
+- (void)writePendingData
+{
+    os_unfair_lock_lock(&_lock);
+    NSData *data = _pendingData;
+    NSUInteger recordCount = _pendingRecordCount;
+    _pendingData = [[NSMutableData alloc] init];
+    _pendingRecordCount = 0;
+    _immediateWriteScheduled = NO;
+    _delayedWriteScheduled = NO;
+    os_unfair_lock_unlock(&_lock);
+
+    if (data.length == 0 || _fileDescriptor < 0) {
+        return;
+    }
+
+    const uint8_t *bytes = data.bytes;
+    NSUInteger remainingLength = data.length;
+    while (remainingLength > 0) {
+        ssize_t writtenLength = write(_fileDescriptor, bytes, remainingLength);
+        if (writtenLength < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            NSError *error = UMKPOSIXErrorForFileURL(errno, self.fileURL);
+            os_unfair_lock_lock(&_lock);
+            _lastError = error;
+            os_unfair_lock_unlock(&_lock);
+            return;
+        }
+
+        bytes += writtenLength;
+        remainingLength -= writtenLength;
+    }
+
+    os_unfair_lock_lock(&_lock);
+    _writtenRecordCount += recordCount;
+    os_unfair_lock_unlock(&_lock);
+}
+
+
+- (void)flush
+{
+    dispatch_sync(_writeQueue, ^{
+        [self writePendingData];
+    });
+}
+
+
+- (void)close
+{
+    os_unfair_lock_lock(&_lock);
+    _closed = YES;
+    os_unfair_lock_unlock(&_lock);
+
+    dispatch_sync(_writeQueue, ^{
+        [self writePendingData];
+        if (self->_fileDescriptor >= 0) {
+            close(self->_fileDescriptor);
+            self->_fileDescriptor = -1;
+        }
+    });
+}
+
+@end
+
+
+#pragma mark - UMKNDJSONRequestJournalReader
+
+@implementation UMKNDJSONRequestJournalReader
+
+- (instancetype)initWithFileURL:(NSURL *)fileURL
+{
+    NSParameterAssert(fileURL);
+
+    self = [super init];
+    if (self) {
+        _fileURL = [fileURL copy];
+    }
+
+    return self;
+}
+
+
+- (BOOL)enumerateRecordsUsingBlock:(void (^)(NSDictionary<NSString *, id> *record, BOOL *stop))block error:(NSError **)outError
+{
+    NSParameterAssert(block);
+
+    NSInputStream *stream = [NSInputStream inputStreamWithURL:self.fileURL];
+    [stream open];
+    if (!stream || stream.streamStatus == NSStreamStatusError) {
+        if (outError) {
+            *outError = stream.streamError ?: UMKPOSIXErrorForFileURL(ENOENT, self.fileURL);
+        }
+
+        return NO;
+    }
+
+    NSMutableData *buffer = [[NSMutableData alloc] init];
+    uint8_t *chunk = malloc(kUMKNDJSONReadChunkSize);
+    NSError *error = nil;
+    BOOL stop = NO;
+
+    while (!stop && !error) {
+        NSInteger readLength = [stream read:chunk maxLength:kUMKNDJSONReadChunkSize];
+        if (readLength < 0) {
+            error = stream.streamError;
+            break;
+        } else if (readLength == 0) {
+            break;
+        }
+
+        [buffer appendBytes:chunk length:readLength];
+
+        // Parse every complete line in the buffer, then discard them all at once
+        const char *bytes = buffer.bytes;
+        NSUInteger lineStart = 0;
+        const char *newline = NULL;
+        while (!stop && !error && (newline = memchr(bytes + lineStart, '\n', buffer.length - lineStart))) {
+            NSUInteger lineEnd = newline - bytes;
+            error = [self enumerateRecordInBytes:bytes + lineStart length:lineEnd - lineStart usingBlock:block stop:&stop];
+            lineStart = lineEnd + 1;
+        }
+
+        [buffer replaceBytesInRange:NSMakeRange(0, lineStart) withBytes:NULL length:0];
+    }
+
+    // Whatever is left over is a final line without a trailing newline
+    if (!stop && !error) {
+        error = [self enumerateRecordInBytes:buffer.bytes length:buffer.length usingBlock:block stop:&stop];
+    }
+
+    free(chunk);
+    [stream close];
+
+    if (error && outError) {
+        *outError = error;
+    }
+
+    return error == nil;
+}
+
+
+/*!
+ @abstract Parses a single line of the receiver's file and invokes the specified block with the resulting record.
+ @discussion Blank lines are skipped.
+ @param bytes The bytes of the line, excluding its newline.
+ @param length The number of bytes in the line.
+ @param block The block to invoke with the record.
+ @param stop The stop flag to pass to the block.
+ @result nil if the line was parsed or blank; otherwise, an NSError object that describes why the line is not a JSON
+     object.
+ */
+- (NSError *)enumerateRecordInBytes:(const char *)bytes
+                             length:(NSUInteger)length
+                         usingBlock:(void (^)(NSDictionary<NSString *, id> *record, BOOL *stop))block
+                               stop:(BOOL *)stop
+{
+    if (length == 0) {
+        return nil;
+    }
+
+    // The error is held strongly outside the pool so that it survives the pool being drained
+    NSError *error = nil;
+    @autoreleasepool {
+        NSError *parseError = nil;
+        NSData *line = [NSData dataWithBytesNoCopy:(void *)bytes length:length freeWhenDone:NO];
+        id record = [NSJSONSerialization JSONObjectWithData:line options:0 error:&parseError];
+        if ([record isKindOfClass:[NSDictionary class]]) {
+            block(record, stop);
+        } else {
+            error = parseError ?: [NSError errorWithDomain:NSCocoaErrorDomain code:NSPropertyListReadCorruptError
+                                                  userInfo:@{ NSURLErrorKey : self.fileURL }];
+        }
+    }
+
+    return error;
+}
+
+@end
@@ -0,0 +1,337 @@
+//
+//  UMKRequestJournal.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import <URLMock/UMKRequestJournal.h>
+
+#import <URLMock/UMKMockURLProtocol.h>
+
+#import <objc/runtime.h>
+#import <os/lock.h>
+
+
+/*! The FNV-1a 64-bit offset basis. */
+static const uint64_t kUMKFNV1aOffsetBasis = 0xcbf29ce484222325ULL;
+
+/*! The FNV-1a 64-bit prime. */
+static const uint64_t kUMKFNV1aPrime = 0x100000001b3ULL;
+
+
+/*!
+ @abstract Returns the specified FNV-1a hash updated with the specified bytes.
+ @param hash The hash to update.
+ @param bytes The bytes to hash.
+ @param length The number of bytes to hash.
+ @result The updated hash.
+ */
+static uint64_t UMKFNV1aHashUpdate(uint64_t hash, const void *bytes, NSUInteger length)
+{
+    const uint8_t *byte = bytes;
+    for (NSUInteger i = 0; i < length; ++i) {
+        hash ^= byte[i];
+        hash *= kUMKFNV1aPrime;
+    }
+
+    return hash;
+}
+
+
+/*!
+ @abstract Returns the specified FNV-1a hash updated with the UTF-8 representation of the specified string.
+ @param hash The hash to update.
+ @param string The string to hash.
+ @result The updated hash.
+ */
+static uint64_t UMKFNV1aHashUpdateWithString(uint64_t hash, NSString *string)
+{
+    const char *UTF8String = string.UTF8String;
+    return UTF8String ? UMKFNV1aHashUpdate(hash, UTF8String, strlen(UTF8String) + 1) : hash;
+}
+
+
+#pragma mark -
+
+@implementation UMKRequestJournalRecord
+
+- (instancetype)initWithURLRequest:(NSURLRequest *)request
+                              kind:(UMKRequestJournalRecordKind)kind
+                       mockRequest:(id<UMKMockURLRequest>)mockRequest
+{
+    NSParameterAssert(request);
+
+    self = [super init];
+    if (self) {
+        _kind = kind;
+        _HTTPMethod = [(request.HTTPMethod ?: @"GET") uppercaseString];
+        _canonicalURL = request.URL ? [UMKMockURLProtocol canonicalURLForURL:request.URL] : nil;
+        _mockRequest = mockRequest;
+        _timestamp = [NSDate timeIntervalSinceReferenceDate];
+
+        // Sort the header fields by lowercase name so that the digest doesn’t depend on their case or order
+        NSDictionary<NSString *, NSString *> *headers = request.allHTTPHeaderFields;
+        NSMutableDictionary<NSString *, NSString *> *lowercaseHeaders = [[NSMutableDictionary alloc] initWithCapacity:headers.count];
+        [headers enumerateKeysAndObjectsUsingBlock:^(NSString *field, NSString *value, BOOL *stop) {
+            lowercaseHeaders[field.lowercaseString] = value;
+        }];
+
+        uint64_t headerDigest = kUMKFNV1aOffsetBasis;
+        for (NSString *field in [lowercaseHeaders.allKeys sortedArrayUsingSelector:@selector(compare:)]) {
+            headerDigest = UMKFNV1aHashUpdateWithString(headerDigest, field);
+            headerDigest = UMKFNV1aHashUpdateWithString(headerDigest, lowercaseHeaders[field]);
+        }
+
+        _headerDigest = headerDigest;
+
+        NSData *body = request.HTTPBody;
+        if (!body && request.HTTPBodyStream) {
+            _bodyLength = NSNotFound;
+        } else {
+            _bodyLength = body.length;
+            _bodyHash = UMKFNV1aHashUpdate(kUMKFNV1aOffsetBasis, body.bytes, body.length);
+        }
+
+        _byteCount = class_getInstanceSize([self class]) + [_HTTPMethod lengthOfBytesUsingEncoding:NSUTF8StringEncoding] +
+                     [_canonicalURL.absoluteString lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    }
+
+    return self;
+}
+
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p> %@ %@", self.class, self, self.HTTPMethod, self.canonicalURL];
+}
+
+
+- (NSDictionary<NSString *, id> *)JSONObject
+{
+    id mockRequestIdentifier = [NSNull null];
+    if (self.mockRequest) {
+        // Use the runtime so that proxies and mock objects are never sent unexpected messages
+        mockRequestIdentifier = [NSString stringWithFormat:@"<%s: %p>", object_getClassName(self.mockRequest), self.mockRequest];
+    }
+
+    return @{ @"kind" : self.kind == UMKRequestJournalRecordKindUnexpected ? @"unexpected" : @"serviced",
+              @"method" : self.HTTPMethod,
+              @"url" : self.canonicalURL.absoluteString ?: [NSNull null],
+              @"headerDigest" : [NSString stringWithFormat:@"%016llx", (unsigned long long)self.headerDigest],
+              @"bodyLength" : self.bodyLength == NSNotFound ? [NSNull null] : @(self.bodyLength),
+              @"bodyHash" : [NSString stringWithFormat:@"%016llx", (unsigned long long)self.bodyHash],
+              @"mockRequest" : mockRequestIdentifier,
+              @"timestamp" : @(self.timestamp + NSTimeIntervalSince1970) };
+}
+
+@end
+
+
+#pragma mark -
+
+@implementation UMKRequestJournal {
+    os_unfair_lock _lock;
+
+    /*! 
+     The journal's ring buffer. It grows until it reaches the journal's capacity, after which new records replace the
+     oldest ones in place. Evicted slots contain NSNull.
+     */
+    NSMutableArray *_buffer;
+
+    /*! The index in the ring buffer of the oldest record. */
+    NSUInteger _head;
+
+    /*! The number of records in the ring buffer. */
+    NSUInteger _count;
+
+    /*! Backs the byteCount property. */
+    NSUInteger _byteCount;
+
+    /*! Backs the servicedRecordCount property. */
+    NSUInteger _servicedRecordCount;
+
+    /*! Backs the unexpectedRecordCount property. */
+    NSUInteger _unexpectedRecordCount;
+
+    /*! Backs the evictedRecordCount property. */
+    NSUInteger _evictedRecordCount;
+}
+
+- (instancetype)init
+{
+    return [self initWithCapacity:1024 byteBudget:1024 * 1024];
+}
+
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity byteBudget:(NSUInteger)byteBudget
+{
+    self = [super init];
+    if (self) {
+        _capacity = capacity;
+        _byteBudget = byteBudget;
+        _buffer = [[NSMutableArray alloc] init];
+        _lock = OS_UNFAIR_LOCK_INIT;
+    }
+
+    return self;
+}
+
+
+- (NSString *)debugDescription
+{
+    return [NSString stringWithFormat:@"<%@: %p> totalRecordCount: %lu, evictedRecordCount: %lu, records: %@",
+                                      self.class, self, (unsigned long)self.totalRecordCount,
+                                      (unsigned long)self.evictedRecordCount, self.records.debugDescription];
+}
+
+
+#pragma mark - Accessing Records
+
+- (NSArray<UMKRequestJournalRecord *> *)records
+{
+    os_unfair_lock_lock(&_lock);
+    NSMutableArray<UMKRequestJournalRecord *> *records = [[NSMutableArray alloc] initWithCapacity:_count];
+    for (NSUInteger i = 0; i < _count; ++i) {
+        [records addObject:_buffer[(_head + i) % _buffer.count]];
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    return records;
+}
+
+
+- (NSUInteger)byteCount
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger byteCount = _byteCount;
+    os_unfair_lock_unlock(&_lock);
+    return byteCount;
+}
+
+
+- (NSUInteger)totalRecordCount
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger totalRecordCount = _servicedRecordCount + _unexpectedRecordCount;
+    os_unfair_lock_unlock(&_lock);
+    return totalRecordCount;
+}
+
+
+- (NSUInteger)servicedRecordCount
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger servicedRecordCount = _servicedRecordCount;
+    os_unfair_lock_unlock(&_lock);
+    return servicedRecordCount;
+}
+
+
+- (NSUInteger)unexpectedRecordCount
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger unexpectedRecordCount = _unexpectedRecordCount;
+    os_unfair_lock_unlock(&_lock);
+    return unexpectedRecordCount;
+}
+
+
+- (NSUInteger)evictedRecordCount
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger evictedRecordCount = _evictedRecordCount;
+    os_unfair_lock_unlock(&_lock);
+    return evictedRecordCount;
+}
+
+
+#pragma mark - Adding and Removing Records
+
+- (void)addRecord:(UMKRequestJournalRecord *)record
+{
+    NSParameterAssert(record);
+
+    // Send the record to the sink first so that it is never blocked by the journal's lock
+    [self.sink requestJournal:self didAddRecord:record];
+
+    os_unfair_lock_lock(&_lock);
+    if (record.kind == UMKRequestJournalRecordKindUnexpected) {
+        _unexpectedRecordCount++;
+    } else {
+        _servicedRecordCount++;
+    }
+
+    if (self.capacity == 0) {
+        _evictedRecordCount++;
+        os_unfair_lock_unlock(&_lock);
+        return;
+    }
+
+    // Make room for the new record, keeping in mind that it will always be retained
+    while (_count > 0 && (_count >= self.capacity || _byteCount + record.byteCount > self.byteBudget)) {
+        [self evictOldestRecord];
+    }
+
+    // Until the buffer reaches capacity, it never wraps, so the next slot is always at its end
+    NSUInteger index = _head + _count;
+    if (index < _buffer.count || _buffer.count == self.capacity) {
+        _buffer[index % _buffer.count] = record;
+    } else {
+        [_buffer addObject:record];
+    }
+
+    _count++;
+    _byteCount += record.byteCount;
+    os_unfair_lock_unlock(&_lock);
+}
+
+
+/*!
+ @abstract Evicts the oldest record in the journal.
+ @discussion This method must be invoked while holding the journal's lock, and only if the journal has records.
+ */
+- (void)evictOldestRecord
+{
+    UMKRequestJournalRecord *record = _buffer[_head];
+    _buffer[_head] = [NSNull null];
+    _head = (_head + 1) % _buffer.count;
+    _count--;
+    _byteCount -= record.byteCount;
+    _evictedRecordCount++;
+}
+
+
+- (void)removeAllRecords
+{
+    os_unfair_lock_lock(&_lock);
+    [_buffer removeAllObjects];
+    _head = 0;
+    _count = 0;
+    _byteCount = 0;
+    _servicedRecordCount = 0;
+    _unexpectedRecordCount = 0;
+    _evictedRecordCount = 0;
+    os_unfair_lock_unlock(&_lock);
+}
+
+@end
@@ -0,0 +1,173 @@
+//
+//  UMKRequestMatchContext.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import <URLMock/UMKRequestMatchContext.h>
+
+#import <URLMock/NSDictionary+UMKURLEncoding.h>
+#import <URLMock/NSURLRequest+UMKHTTPConvenienceMethods.h>
+#import <URLMock/UMKMockURLProtocol.h>
+
+
+@implementation UMKRequestMatchContext {
+    NSDictionary<NSString *, NSString *> *_lowercaseHTTPHeaderFields;
+
+    BOOL _hasCanonicalURL;
+    BOOL _hasCanonicalURLStringExcludingQuery;
+    BOOL _hasHTTPHeaderFields;
+    BOOL _hasHTTPBodyData;
+    BOOL _hasJSONObjectFromHTTPBody;
+    BOOL _hasParametersFromURLEncodedHTTPBody;
+}
+
+@synthesize canonicalURL = _canonicalURL;
+@synthesize canonicalURLStringExcludingQuery = _canonicalURLStringExcludingQuery;
+@synthesize uppercaseHTTPMethod = _uppercaseHTTPMethod;
+@synthesize HTTPHeaderFields = _HTTPHeaderFields;
+@synthesize HTTPBodyData = _HTTPBodyData;
+@synthesize JSONObjectFromHTTPBody = _JSONObjectFromHTTPBody;
+@synthesize parametersFromURLEncodedHTTPBody = _parametersFromURLEncodedHTTPBody;
+
+
+- (instancetype)initWithURLRequest:(NSURLRequest *)request
+{
+    NSParameterAssert(request);
+
+    self = [super init];
+    if (self) {
+        _request = request;
+    }
+
+    return self;
+}
+
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p> request: %@", self.class, self, self.request];
+}
+
+
+#pragma mark - URL and Method
+
+- (NSURL *)canonicalURL
+{
+    if (!_hasCanonicalURL) {
+        _canonicalURL = [UMKMockURLProtocol canonicalURLForURL:self.request.URL];
+        _hasCanonicalURL = YES;
+    }
+
+    return _canonicalURL;
+}
+
+
+- (NSString *)canonicalURLStringExcludingQuery
+{
+    if (!_hasCanonicalURLStringExcludingQuery) {
+        _canonicalURLStringExcludingQuery = [[self.canonicalURL.absoluteString componentsSeparatedByString:@"?"] firstObject];
+        _hasCanonicalURLStringExcludingQuery = YES;
+    }
+
+    return _canonicalURLStringExcludingQuery;
+}
+
+
+- (NSString *)uppercaseHTTPMethod
+{
+    // A nil method is cheap to recompute, so there's no need to track whether it was computed
+    if (!_uppercaseHTTPMethod) {
+        _uppercaseHTTPMethod = self.request.HTTPMethod.uppercaseString;
+    }
+
+    return _uppercaseHTTPMethod;
+}
+
+
+#pragma mark - Headers
+
+- (NSDictionary<NSString *, NSString *> *)HTTPHeaderFields
+{
+    if (!_hasHTTPHeaderFields) {
+        _HTTPHeaderFields = self.request.allHTTPHeaderFields;
+
+        NSMutableDictionary<NSString *, NSString *> *lowercaseHTTPHeaderFields = [[NSMutableDictionary alloc] initWithCapacity:_HTTPHeaderFields.count];
+        [_HTTPHeaderFields enumerateKeysAndObjectsUsingBlock:^(NSString *field, NSString *value, BOOL *stop) {
+            lowercaseHTTPHeaderFields[field.lowercaseString] = value;
+        }];
+
+        _lowercaseHTTPHeaderFields = lowercaseHTTPHeaderFields;
+        _hasHTTPHeaderFields = YES;
+    }
+
+    return _HTTPHeaderFields;
+}
+
+
+- (NSString *)valueForHTTPHeaderField:(NSString *)field
+{
+    NSParameterAssert(field);
+    [self HTTPHeaderFields];
+    return _lowercaseHTTPHeaderFields[field.lowercaseString];
+}
+
+
+#pragma mark - Body
+
+- (NSData *)HTTPBodyData
+{
+    if (!_hasHTTPBodyData) {
+        _HTTPBodyData = [self.request umk_HTTPBodyData];
+        _hasHTTPBodyData = YES;
+    }
+
+    return _HTTPBodyData;
+}
+
+
+- (id)JSONObjectFromHTTPBody
+{
+    if (!_hasJSONObjectFromHTTPBody) {
+        NSData *body = self.HTTPBodyData;
+        _JSONObjectFromHTTPBody = body ? [NSJSONSerialization JSONObjectWithData:body options:0 error:NULL] : nil;
+        _hasJSONObjectFromHTTPBody = YES;
+    }
+
+    return _JSONObjectFromHTTPBody;
+}
+
+
+- (NSDictionary<NSString *, id> *)parametersFromURLEncodedHTTPBody
+{
+    if (!_hasParametersFromURLEncodedHTTPBody) {
+        NSData *body = self.HTTPBodyData;
+        NSString *bodyString = body ? [[NSString alloc] initWithData:body encoding:NSUTF8StringEncoding] : nil;
+        _parametersFromURLEncodedHTTPBody = bodyString ? [NSDictionary umk_dictionaryWithURLEncodedParameterString:bodyString] : nil;
+        _hasParametersFromURLEncodedHTTPBody = YES;
+    }
+
+    return _parametersFromURLEncodedHTTPBody;
+}
+
+@end
@@ -26,7 +26,10 @@
 
 #import <URLMock/UMKPatternMatchingMockRequest.h>
 
+#import <URLMock/UMKRequestMatchContext.h>
+
 #import "SOCKit.h"
+#import "UMKMockRouteTrie.h"
 
 
 @interface UMKPatternMatchingMockRequest ()
@@ -34,6 +37,14 @@
 /*! The SOCKit pattern associated with the instance’s URL pattern. */
 @property (nonatomic, strong, readonly) SOCPattern *pattern;
 
+/*!
+ @abstract Returns whether the receiver matches the URL request of the specified match context.
+ @discussion This is the implementation of both -matchesURLRequest: and -matchesURLRequest:context:.
+ @param context The match context.
+ @result Whether the receiver matches the context's URL request.
+ */
+- (BOOL)matchesURLRequestOfContext:(UMKRequestMatchContext *)context;
+
 @end
 
 
@@ -70,11 +81,29 @@
 
 - (BOOL)matchesURLRequest:(NSURLRequest *)request
 {
-    if (self.HTTPMethods && ![self.HTTPMethods containsObject:request.HTTPMethod.uppercaseString]) {
+    return [self matchesURLRequestOfContext:[[UMKRequestMatchContext alloc] initWithURLRequest:request]];
+}
+
+
+- (BOOL)matchesURLRequest:(NSURLRequest *)request context:(UMKRequestMatchContext *)context
+{
+    // If a subclass has its own idea of what matching means, respect it
+    if ([self methodForSelector:@selector(matchesURLRequest:)] != [UMKPatternMatchingMockRequest instanceMethodForSelector:@selector(matchesURLRequest:)]) {
+        return [self matchesURLRequest:request];
+    }
+
+    return [self matchesURLRequestOfContext:context];
+}
+
+
+- (BOOL)matchesURLRequestOfContext:(UMKRequestMatchContext *)context
+{
+    NSURLRequest *request = context.request;
+    if (self.HTTPMethods && ![self.HTTPMethods containsObject:context.uppercaseHTTPMethod]) {
         return NO;
     }
 
-    NSString *URLString = [self canonicalURLStringExcludingQueryForURL:request.URL];
+    NSString *URLString = context.canonicalURLStringExcludingQuery;
     if (![self.pattern stringMatches:URLString]) {
         return NO;
     } else if (!self.requestMatchingBlock) {
@@ -86,6 +115,16 @@
 }
 
 
+- (BOOL)matchesURLRequestOfContext:(UMKRequestMatchContext *)context patternParameters:(NSDictionary<NSString *, NSString *> *)parameters
+{
+    if (self.HTTPMethods && ![self.HTTPMethods containsObject:context.uppercaseHTTPMethod]) {
+        return NO;
+    }
+
+    return self.requestMatchingBlock ? self.requestMatchingBlock(context.request, parameters) : YES;
+}
+
+
 - (id<UMKMockURLResponder>)responderForURLRequest:(NSURLRequest *)request
 {
     if (!self.responderGenerationBlock) {
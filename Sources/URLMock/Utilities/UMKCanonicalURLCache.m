@@ -0,0 +1,270 @@
+//
+//  UMKCanonicalURLCache.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import "UMKCanonicalURLCache.h"
+
+#import <os/lock.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+#pragma mark UMKCanonicalURLCacheNode
+
+/*!
+ UMKCanonicalURLCacheNodes are the entries in a canonical URL cache. They form a doubly-linked list ordered from
+ most to least recently used.
+ */
+@interface UMKCanonicalURLCacheNode : NSObject
+
+/*! The node's URL string. */
+@property (nonatomic, copy, readonly) NSString *URLString;
+
+/*! The node's canonical URL. */
+@property (nonatomic, strong) NSURL *canonicalURL;
+
+/*! The next more recently used node. This is not retained; nodes are owned by their cache's dictionary. */
+@property (nonatomic, unsafe_unretained, nullable) UMKCanonicalURLCacheNode *previous;
+
+/*! The next less recently used node. */
+@property (nonatomic, strong, nullable) UMKCanonicalURLCacheNode *next;
+
+- (instancetype)initWithURLString:(NSString *)URLString canonicalURL:(NSURL *)canonicalURL;
+
+@end
+
+
+@interface UMKCanonicalURLCache ()
+
+/*! The cache's nodes, keyed by URL string. */
+@property (nonatomic, strong, readonly) NSMutableDictionary<NSString *, UMKCanonicalURLCacheNode *> *nodes;
+
+/*! The most recently used node. */
+@property (nonatomic, strong, nullable) UMKCanonicalURLCacheNode *head;
+
+/*! The least recently used node. */
+@property (nonatomic, strong, nullable) UMKCanonicalURLCacheNode *tail;
+
+/*! Redeclared as readwrite. */
+@property (nonatomic, assign, readwrite) NSUInteger hitCount;
+
+/*! Redeclared as readwrite. */
+@property (nonatomic, assign, readwrite) NSUInteger missCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+
+#pragma mark -
+
+@implementation UMKCanonicalURLCacheNode
+
+- (instancetype)initWithURLString:(NSString *)URLString canonicalURL:(NSURL *)canonicalURL
+{
+    self = [super init];
+    if (self) {
+        _URLString = [URLString copy];
+        _canonicalURL = canonicalURL;
+    }
+
+    return self;
+}
+
+@end
+
+
+#pragma mark -
+
+@implementation UMKCanonicalURLCache {
+    os_unfair_lock _lock;
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+{
+    self = [super init];
+    if (self) {
+        _capacity = capacity;
+        _nodes = [[NSMutableDictionary alloc] initWithCapacity:capacity];
+        _lock = OS_UNFAIR_LOCK_INIT;
+    }
+
+    return self;
+}
+
+
+- (NSUInteger)count
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger count = self.nodes.count;
+    os_unfair_lock_unlock(&_lock);
+    return count;
+}
+
+
+- (NSUInteger)hitCount
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger hitCount = _hitCount;
+    os_unfair_lock_unlock(&_lock);
+    return hitCount;
+}
+
+
+- (NSUInteger)missCount
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger missCount = _missCount;
+    os_unfair_lock_unlock(&_lock);
+    return missCount;
+}
+
+
+- (NSURL *)canonicalURLForURLString:(NSString *)URLString
+{
+    NSParameterAssert(URLString);
+
+    os_unfair_lock_lock(&_lock);
+    UMKCanonicalURLCacheNode *node = self.nodes[URLString];
+    if (node) {
+        _hitCount++;
+        [self moveNodeToHead:node];
+    } else {
+        _missCount++;
+    }
+
+    NSURL *canonicalURL = node.canonicalURL;
+    os_unfair_lock_unlock(&_lock);
+
+    return canonicalURL;
+}
+
+
+- (void)setCanonicalURL:(NSURL *)canonicalURL forURLString:(NSString *)URLString
+{
+    NSParameterAssert(canonicalURL);
+    NSParameterAssert(URLString);
+
+    if (self.capacity == 0) {
+        return;
+    }
+
+    os_unfair_lock_lock(&_lock);
+    UMKCanonicalURLCacheNode *node = self.nodes[URLString];
+    if (node) {
+        node.canonicalURL = canonicalURL;
+        [self moveNodeToHead:node];
+    } else {
+        if (self.nodes.count >= self.capacity) {
+            UMKCanonicalURLCacheNode *leastRecentlyUsedNode = self.tail;
+            [self removeNode:leastRecentlyUsedNode];
+            [self.nodes removeObjectForKey:leastRecentlyUsedNode.URLString];
+        }
+
+        node = [[UMKCanonicalURLCacheNode alloc] initWithURLString:URLString canonicalURL:canonicalURL];
+        self.nodes[node.URLString] = node;
+        [self insertNodeAtHead:node];
+    }
+    os_unfair_lock_unlock(&_lock);
+}
+
+
+- (void)removeAllCanonicalURLs
+{
+    os_unfair_lock_lock(&_lock);
+    [self.nodes removeAllObjects];
+
+    // Break the links between nodes so that long lists are not released recursively
+    UMKCanonicalURLCacheNode *node = self.head;
+    while (node) {
+        UMKCanonicalURLCacheNode *next = node.next;
+        node.next = nil;
+        node = next;
+    }
+
+    self.head = nil;
+    self.tail = nil;
+    _hitCount = 0;
+    _missCount = 0;
+    os_unfair_lock_unlock(&_lock);
+}
+
+
+- (void)dealloc
+{
+    [self removeAllCanonicalURLs];
+}
+
+
+#pragma mark - Linked List
+
+/*! Must be called with the lock held. */
+- (void)insertNodeAtHead:(UMKCanonicalURLCacheNode *)node
+{
+    node.previous = nil;
+    node.next = self.head;
+    self.head.previous = node;
+    self.head = node;
+
+    if (!self.tail) {
+        self.tail = node;
+    }
+}
+
+
+/*! Must be called with the lock held. */
+- (void)removeNode:(UMKCanonicalURLCacheNode *)node
+{
+    UMKCanonicalURLCacheNode *previous = node.previous;
+    UMKCanonicalURLCacheNode *next = node.next;
+
+    previous.next = next;
+    next.previous = previous;
+
+    if (self.head == node) {
+        self.head = next;
+    }
+
+    if (self.tail == node) {
+        self.tail = previous;
+    }
+
+    node.previous = nil;
+    node.next = nil;
+}
+
+
+/*! Must be called with the lock held. */
+- (void)moveNodeToHead:(UMKCanonicalURLCacheNode *)node
+{
+    if (self.head == node) {
+        return;
+    }
+
+    [self removeNode:node];
+    [self insertNodeAtHead:node];
+}
+
+@end
@@ -0,0 +1,278 @@
+//
+//  UMKLatencyHistogram.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import <URLMock/UMKLatencyHistogram.h>
+
+#import <stdatomic.h>
+#import <stdlib.h>
+
+
+#pragma mark Constants
+
+// These are enumerators rather than const variables so that they can be used in each other's definitions
+enum {
+    /*! The number of sub-buckets in each bucket after the first, expressed as a power of 2. */
+    kUMKLatencyHistogramSubBucketBits = 4,
+
+    /*! The number of sub-buckets in each bucket after the first. */
+    kUMKLatencyHistogramSubBucketCount = 1 << kUMKLatencyHistogramSubBucketBits,
+
+    /*! The number of durations that are recorded exactly. These make up the first bucket. */
+    kUMKLatencyHistogramExactCount = 2 * kUMKLatencyHistogramSubBucketCount,
+
+    /*! The number of bits in the largest duration with its own bucket. Longer durations share its bucket. */
+    kUMKLatencyHistogramMaximumTrackedDurationBits = 40,
+
+    /*! The number of buckets in a histogram. */
+    kUMKLatencyHistogramBucketCount = kUMKLatencyHistogramExactCount +
+        (kUMKLatencyHistogramMaximumTrackedDurationBits - 1 - kUMKLatencyHistogramSubBucketBits) * kUMKLatencyHistogramSubBucketCount
+};
+
+/*! The largest duration with its own bucket. */
+#define kUMKLatencyHistogramMaximumTrackedDuration ((1ULL << kUMKLatencyHistogramMaximumTrackedDurationBits) - 1)
+
+
+#pragma mark - Bucket Indexes
+
+/*!
+ @abstract Returns the index of the bucket that contains the specified duration.
+ @discussion Durations below kUMKLatencyHistogramExactCount have their own buckets. Longer durations are shifted right
+     until only their top five bits remain, the first of which is always set, so the shift selects a bucket and the 
+     remaining four bits select one of its sub-buckets.
+ @param duration The duration.
+ @result The index of the duration's bucket.
+ */
+static inline NSUInteger UMKLatencyHistogramIndexForDuration(uint64_t duration)
+{
+    if (duration < kUMKLatencyHistogramExactCount) {
+        return (NSUInteger)duration;
+    }
+
+    duration = MIN(duration, kUMKLatencyHistogramMaximumTrackedDuration);
+    uint64_t shift = (uint64_t)(63 - __builtin_clzll(duration)) - kUMKLatencyHistogramSubBucketBits;
+    uint64_t subBucket = (duration >> shift) - kUMKLatencyHistogramSubBucketCount;
+    return (NSUInteger)(kUMKLatencyHistogramExactCount + (shift - 1) * kUMKLatencyHistogramSubBucketCount + subBucket);
+}
+
+
+/*!
+ @abstract Returns the largest duration that is recorded in the bucket with the specified index.
+ @param index The bucket index.
+ @result The largest duration in the bucket.
+ */
+static inline uint64_t UMKLatencyHistogramHighestDurationForIndex(NSUInteger index)
+{
+    if (index < kUMKLatencyHistogramExactCount) {
+        return index;
+    }
+
+    uint64_t offset = index - kUMKLatencyHistogramExactCount;
+    uint64_t shift = offset / kUMKLatencyHistogramSubBucketCount + 1;
+    uint64_t subBucket = offset % kUMKLatencyHistogramSubBucketCount + kUMKLatencyHistogramSubBucketCount;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+
+#pragma mark -
+
+@implementation UMKLatencyHistogram {
+    /*! The histogram's bucket counts, or NULL if no durations have been recorded. Allocated using calloc. */
+    _Atomic(_Atomic(uint64_t) *) _buckets;
+
+    /*! Backs the count property. */
+    _Atomic(uint64_t) _count;
+
+    /*! Backs the totalDuration property. */
+    _Atomic(uint64_t) _totalDuration;
+
+    /*! Backs the minimumDuration property. UINT64_MAX if no durations have been recorded. */
+    _Atomic(uint64_t) _minimumDuration;
+
+    /*! Backs the maximumDuration property. */
+    _Atomic(uint64_t) _maximumDuration;
+}
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        atomic_init(&_buckets, NULL);
+        atomic_init(&_count, 0);
+        atomic_init(&_totalDuration, 0);
+        atomic_init(&_minimumDuration, UINT64_MAX);
+        atomic_init(&_maximumDuration, 0);
+    }
+
+    return self;
+}
+
+
+- (void)dealloc
+{
+    free((void *)atomic_load(&_buckets));
+}
+
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p> count=%llu, min=%lluns, p50=%lluns, p99=%lluns, max=%lluns",
+            self.class, self, self.count, self.minimumDuration, [self durationAtPercentile:50],
+            [self durationAtPercentile:99], self.maximumDuration];
+}
+
+
+#pragma mark - Recording
+
+/*!
+ @abstract Returns the receiver's buckets, allocating them if needed.
+ @discussion If several threads allocate buckets at once, only one allocation is kept.
+ @result The receiver's buckets.
+ */
+- (_Atomic(uint64_t) *)allocatedBuckets
+{
+    _Atomic(uint64_t) *buckets = atomic_load_explicit(&_buckets, memory_order_acquire);
+    if (buckets) {
+        return buckets;
+    }
+
+    _Atomic(uint64_t) *newBuckets = calloc(kUMKLatencyHistogramBucketCount, sizeof(_Atomic(uint64_t)));
+    if (atomic_compare_exchange_strong_explicit(&_buckets, &buckets, newBuckets, memory_order_acq_rel, memory_order_acquire)) {
+        return newBuckets;
+    }
+
+    free((void *)newBuckets);
+    return buckets;
+}
+
+
+- (void)recordDuration:(uint64_t)duration
+{
+    _Atomic(uint64_t) *buckets = [self allocatedBuckets];
+    atomic_fetch_add_explicit(&buckets[UMKLatencyHistogramIndexForDuration(duration)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&_totalDuration, duration, memory_order_relaxed);
+
+    uint64_t minimumDuration = atomic_load_explicit(&_minimumDuration, memory_order_relaxed);
+    while (duration < minimumDuration &&
+           !atomic_compare_exchange_weak_explicit(&_minimumDuration, &minimumDuration, duration, memory_order_relaxed, memory_order_relaxed));
+
+    uint64_t maximumDuration = atomic_load_explicit(&_maximumDuration, memory_order_relaxed);
+    while (duration > maximumDuration &&
+           !atomic_compare_exchange_weak_explicit(&_maximumDuration, &maximumDuration, duration, memory_order_relaxed, memory_order_relaxed));
+
+    // The count is updated last so that readers that see it have a good chance of seeing everything else
+    atomic_fetch_add_explicit(&_count, 1, memory_order_release);
+}
+
+
+- (void)reset
+{
+    _Atomic(uint64_t) *buckets = atomic_load_explicit(&_buckets, memory_order_acquire);
+    if (buckets) {
+        for (NSUInteger i = 0; i < kUMKLatencyHistogramBucketCount; ++i) {
+            atomic_store_explicit(&buckets[i], 0, memory_order_relaxed);
+        }
+    }
+
+    atomic_store(&_count, 0);
+    atomic_store(&_totalDuration, 0);
+    atomic_store(&_minimumDuration, UINT64_MAX);
+    atomic_store(&_maximumDuration, 0);
+}
+
+
+#pragma mark - Querying
+
+- (uint64_t)count
+{
+    return atomic_load_explicit(&_count, memory_order_acquire);
+}
+
+
+- (uint64_t)totalDuration
+{
+    return atomic_load_explicit(&_totalDuration, memory_order_relaxed);
+}
+
+
+- (uint64_t)minimumDuration
+{
+    uint64_t minimumDuration = atomic_load_explicit(&_minimumDuration, memory_order_relaxed);
+    return minimumDuration == UINT64_MAX ? 0 : minimumDuration;
+}
+
+
+- (uint64_t)maximumDuration
+{
+    return atomic_load_explicit(&_maximumDuration, memory_order_relaxed);
+}
+
+
+- (double)meanDuration
+{
+    uint64_t count = self.count;
+    return count > 0 ? (double)self.totalDuration / count : 0;
+}
+
+
+- (uint64_t)durationAtPercentile:(double)percentile
+{
+    _Atomic(uint64_t) *buckets = atomic_load_explicit(&_buckets, memory_order_acquire);
+    if (!buckets) {
+        return 0;
+    }
+
+    // Take a snapshot of the counts so that the rank we look for is consistent with the buckets we search
+    uint64_t *counts = malloc(kUMKLatencyHistogramBucketCount * sizeof(uint64_t));
+    uint64_t count = 0;
+    for (NSUInteger i = 0; i < kUMKLatencyHistogramBucketCount; ++i) {
+        counts[i] = atomic_load_explicit(&buckets[i], memory_order_relaxed);
+        count += counts[i];
+    }
+
+    uint64_t duration = 0;
+    if (count > 0) {
+        percentile = MIN(MAX(percentile, 0), 100);
+        uint64_t rank = MAX((uint64_t)ceil(percentile / 100 * count), 1);
+
+        uint64_t cumulativeCount = 0;
+        for (NSUInteger i = 0; i < kUMKLatencyHistogramBucketCount; ++i) {
+            cumulativeCount += counts[i];
+            if (cumulativeCount >= rank) {
+                // The last bucket holds every duration that is too long to track, so only the maximum is meaningful
+                duration = i < kUMKLatencyHistogramBucketCount - 1 ? UMKLatencyHistogramHighestDurationForIndex(i) : UINT64_MAX;
+                break;
+            }
+        }
+
+        duration = percentile > 0 ? MIN(MAX(duration, self.minimumDuration), self.maximumDuration) : self.minimumDuration;
+    }
+
+    free(counts);
+    return duration;
+}
+
+@end
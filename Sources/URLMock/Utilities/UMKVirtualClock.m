@@ -0,0 +1,472 @@
+//
+//  UMKVirtualClock.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import <URLMock/UMKVirtualClock.h>
+
+#import "UMKVirtualClock+UMKMockHTTPResponder.h"
+
+#import <os/lock.h>
+#import <time.h>
+
+
+#pragma mark Constants
+
+/*! How long -advanceByTimeInterval: waits for handed-off work to finish before giving up. */
+static const NSTimeInterval kUMKVirtualClockActivityTimeout = 10.0;
+
+
+#pragma mark - Timer Queue
+
+/*!
+ @abstract Returns the queue on which clocks run their scheduled blocks.
+ @discussion A single serial queue is shared by every clock, so any number of outstanding delays only ever occupies
+     one thread, and only briefly each time a block comes due.
+ @result The timer queue.
+ */
+static dispatch_queue_t UMKVirtualClockTimerQueue(void)
+{
+    static dispatch_queue_t queue = NULL;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("UMKVirtualClock.timers",
+                                      dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0));
+    });
+
+    return queue;
+}
+
+
+#pragma mark - UMKVirtualClockScheduledBlock
+
+/*!
+ UMKVirtualClockScheduledBlocks are the tokens that clocks return when a block is scheduled.
+ */
+@interface UMKVirtualClockScheduledBlock : NSObject
+
+/*! The block to run. */
+@property (nonatomic, copy, readonly) dispatch_block_t block;
+
+/*! For virtual clocks, the time at which the block is due, in nanoseconds since the clock was created. */
+@property (nonatomic, assign, readonly) uint64_t time;
+
+/*! For real-time clocks, the timer that runs the block. */
+@property (nonatomic, strong) dispatch_source_t timer;
+
+/*! Whether the block has run or been canceled. Only accessed with the clock's lock held. */
+@property (nonatomic, assign, getter = isDone) BOOL done;
+
+- (instancetype)initWithBlock:(dispatch_block_t)block time:(uint64_t)time;
+
+@end
+
+
+@implementation UMKVirtualClockScheduledBlock
+
+- (instancetype)initWithBlock:(dispatch_block_t)block time:(uint64_t)time
+{
+    self = [super init];
+    if (self) {
+        _block = [block copy];
+        _time = time;
+    }
+
+    return self;
+}
+
+@end
+
+
+#pragma mark - UMKVirtualClock
+
+@interface UMKVirtualClock ()
+
+/*!
+ @abstract Records that a scheduled block or outstanding activity is done.
+ @discussion Idle as-fast-as-possible clocks advance to their next scheduled block.
+ */
+- (void)endActivity;
+
+/*!
+ @abstract Returns whether any outstanding activity was handed off to the specified run loop.
+ @param runLoop The run loop.
+ @result Whether any outstanding activity was handed off to the run loop.
+ */
+- (BOOL)hasActivityOnRunLoop:(CFRunLoopRef)runLoop;
+
+@end
+
+
+@implementation UMKVirtualClock {
+    /*! Protects the instance variables below. */
+    os_unfair_lock _lock;
+
+    /*! For real-time clocks, the system uptime at which the clock was created, in nanoseconds of CLOCK_UPTIME_RAW. */
+    uint64_t _originTime;
+
+    /*! For virtual clocks, the current time in nanoseconds since the clock was created. */
+    uint64_t _currentTime;
+
+    /*! For virtual clocks, the blocks that haven't run, sorted by when they are due. Blocks due at the same time are
+        in the order they were scheduled. */
+    NSMutableArray<UMKVirtualClockScheduledBlock *> *_scheduledBlocks;
+
+    /*! For real-time clocks, the number of blocks that haven't run. */
+    NSUInteger _realTimeScheduledBlockCount;
+
+    /*! The number of scheduled blocks that are running plus the number of outstanding activities. */
+    NSUInteger _activityCount;
+
+    /*! The run loops to which outstanding activities were handed off, counted once per activity. */
+    NSCountedSet *_activityRunLoops;
+
+    /*! Signaled whenever an outstanding activity ends. */
+    dispatch_semaphore_t _activitySemaphore;
+}
+
+/*! Protects sDefaultClock. */
+static os_unfair_lock sDefaultClockLock = OS_UNFAIR_LOCK_INIT;
+
+/*! The default clock, or nil if a real-time clock hasn't been created yet. */
+static UMKVirtualClock *sDefaultClock = nil;
+
++ (UMKVirtualClock *)defaultClock
+{
+    os_unfair_lock_lock(&sDefaultClockLock);
+    if (!sDefaultClock) {
+        sDefaultClock = [[UMKVirtualClock alloc] init];
+    }
+
+    UMKVirtualClock *clock = sDefaultClock;
+    os_unfair_lock_unlock(&sDefaultClockLock);
+    return clock;
+}
+
+
++ (void)setDefaultClock:(UMKVirtualClock *)clock
+{
+    os_unfair_lock_lock(&sDefaultClockLock);
+    sDefaultClock = clock;
+    os_unfair_lock_unlock(&sDefaultClockLock);
+}
+
+
+- (instancetype)init
+{
+    return [self initWithMode:UMKVirtualClockModeRealTime];
+}
+
+
+- (instancetype)initWithMode:(UMKVirtualClockMode)mode
+{
+    self = [super init];
+    if (self) {
+        _mode = mode;
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _originTime = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+        _scheduledBlocks = [[NSMutableArray alloc] init];
+        _activityRunLoops = [[NSCountedSet alloc] init];
+        _activitySemaphore = dispatch_semaphore_create(0);
+    }
+
+    return self;
+}
+
+
+- (NSTimeInterval)currentTime
+{
+    if (self.mode == UMKVirtualClockModeRealTime) {
+        return (clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - _originTime) / (double)NSEC_PER_SEC;
+    }
+
+    os_unfair_lock_lock(&_lock);
+    uint64_t currentTime = _currentTime;
+    os_unfair_lock_unlock(&_lock);
+    return currentTime / (double)NSEC_PER_SEC;
+}
+
+
+- (NSUInteger)scheduledBlockCount
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger count = self.mode == UMKVirtualClockModeRealTime ? _realTimeScheduledBlockCount : _scheduledBlocks.count;
+    os_unfair_lock_unlock(&_lock);
+    return count;
+}
+
+
+#pragma mark - Scheduling Blocks
+
+- (id)scheduleBlock:(dispatch_block_t)block afterDelay:(NSTimeInterval)delay
+{
+    NSParameterAssert(block);
+    NSParameterAssert(delay >= 0.0);
+
+    uint64_t interval = (uint64_t)(delay * NSEC_PER_SEC);
+    if (self.mode == UMKVirtualClockModeRealTime) {
+        return [self scheduleRealTimeBlock:block afterInterval:interval];
+    }
+
+    os_unfair_lock_lock(&_lock);
+    UMKVirtualClockScheduledBlock *scheduledBlock = [[UMKVirtualClockScheduledBlock alloc] initWithBlock:block time:_currentTime + interval];
+    NSUInteger index = [_scheduledBlocks indexOfObject:scheduledBlock
+                                         inSortedRange:NSMakeRange(0, _scheduledBlocks.count)
+                                               options:NSBinarySearchingInsertionIndex | NSBinarySearchingLastEqual
+                                       usingComparator:^NSComparisonResult(UMKVirtualClockScheduledBlock *block1, UMKVirtualClockScheduledBlock *block2) {
+                                           return block1.time < block2.time ? NSOrderedAscending
+                                                                            : block1.time > block2.time ? NSOrderedDescending : NSOrderedSame;
+                                       }];
+    [_scheduledBlocks insertObject:scheduledBlock atIndex:index];
+    os_unfair_lock_unlock(&_lock);
+
+    if (self.mode == UMKVirtualClockModeAsFastAsPossible) {
+        [self advanceAsFastAsPossible];
+    }
+
+    return scheduledBlock;
+}
+
+
+/*!
+ @abstract Schedules the specified block to run on a timer after the specified number of nanoseconds.
+ @param block The block to run.
+ @param interval The number of nanoseconds after which to run the block.
+ @result The scheduled block.
+ */
+- (UMKVirtualClockScheduledBlock *)scheduleRealTimeBlock:(dispatch_block_t)block afterInterval:(uint64_t)interval
+{
+    UMKVirtualClockScheduledBlock *scheduledBlock = [[UMKVirtualClockScheduledBlock alloc] initWithBlock:block time:0];
+
+    // The timer's handler retains the scheduled block, which retains the timer, until the timer is canceled
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, UMKVirtualClockTimerQueue());
+    dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)interval), DISPATCH_TIME_FOREVER, interval / 10);
+    dispatch_source_set_event_handler(timer, ^{
+        if ([self finishScheduledBlock:scheduledBlock]) {
+            scheduledBlock.block();
+        }
+    });
+
+    scheduledBlock.timer = timer;
+
+    os_unfair_lock_lock(&_lock);
+    ++_realTimeScheduledBlockCount;
+    os_unfair_lock_unlock(&_lock);
+
+    dispatch_resume(timer);
+    return scheduledBlock;
+}
+
+
+- (void)cancelScheduledBlock:(id)token
+{
+    NSParameterAssert([token isKindOfClass:[UMKVirtualClockScheduledBlock class]]);
+    [self finishScheduledBlock:token];
+}
+
+
+/*!
+ @abstract Marks the specified scheduled block as done, removing it from the receiver's schedule and canceling its
+     timer.
+ @param scheduledBlock The scheduled block.
+ @result Whether the block was not already done.
+ */
+- (BOOL)finishScheduledBlock:(UMKVirtualClockScheduledBlock *)scheduledBlock
+{
+    os_unfair_lock_lock(&_lock);
+    BOOL wasDone = scheduledBlock.isDone;
+    if (!wasDone) {
+        scheduledBlock.done = YES;
+        if (scheduledBlock.timer) {
+            --_realTimeScheduledBlockCount;
+        } else {
+            [_scheduledBlocks removeObjectIdenticalTo:scheduledBlock];
+        }
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    if (scheduledBlock.timer) {
+        dispatch_source_cancel(scheduledBlock.timer);
+    }
+
+    return !wasDone;
+}
+
+
+#pragma mark - Advancing Virtual Clocks
+
+/*!
+ @abstract Removes the receiver's next scheduled block if it is due by the specified time and no activity is
+     outstanding, and advances the receiver's current time to when it was due.
+ @discussion Running the returned block counts as an activity, so the caller must invoke -endActivity once it has run.
+ @param limit The time by which the block must be due, in nanoseconds since the receiver was created.
+ @param outBusy On return, whether no block was returned because activity is outstanding. May be NULL.
+ @result The next scheduled block, or nil if there is none due or activity is outstanding.
+ */
+- (UMKVirtualClockScheduledBlock *)dequeueScheduledBlockDueBy:(uint64_t)limit busy:(BOOL *)outBusy
+{
+    os_unfair_lock_lock(&_lock);
+    BOOL busy = _activityCount > 0;
+    UMKVirtualClockScheduledBlock *scheduledBlock = busy ? nil : _scheduledBlocks.firstObject;
+    if (scheduledBlock && scheduledBlock.time <= limit) {
+        [_scheduledBlocks removeObjectAtIndex:0];
+        scheduledBlock.done = YES;
+        _currentTime = MAX(_currentTime, scheduledBlock.time);
+        ++_activityCount;
+    } else {
+        scheduledBlock = nil;
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    if (outBusy) {
+        *outBusy = busy;
+    }
+
+    return scheduledBlock;
+}
+
+
+/*!
+ @abstract Runs the receiver's next scheduled block on the timer queue if no activity is outstanding.
+ @discussion This is invoked whenever an as-fast-as-possible clock might be able to advance. Once the block has run,
+     this is invoked again, so the clock keeps advancing until it runs out of blocks.
+ */
+- (void)advanceAsFastAsPossible
+{
+    dispatch_async(UMKVirtualClockTimerQueue(), ^{
+        UMKVirtualClockScheduledBlock *scheduledBlock = [self dequeueScheduledBlockDueBy:UINT64_MAX busy:NULL];
+        if (scheduledBlock) {
+            scheduledBlock.block();
+            [self endActivity];
+        }
+    });
+}
+
+
+- (void)advanceByTimeInterval:(NSTimeInterval)interval
+{
+    NSParameterAssert(self.mode == UMKVirtualClockModeManual);
+    NSParameterAssert(interval >= 0.0);
+
+    os_unfair_lock_lock(&_lock);
+    uint64_t targetTime = _currentTime + (uint64_t)(interval * NSEC_PER_SEC);
+    os_unfair_lock_unlock(&_lock);
+
+    CFRunLoopRef currentRunLoop = CFRunLoopGetCurrent();
+    dispatch_time_t deadline = DISPATCH_TIME_FOREVER;
+    while (YES) {
+        BOOL busy = NO;
+        UMKVirtualClockScheduledBlock *scheduledBlock = [self dequeueScheduledBlockDueBy:targetTime busy:&busy];
+        if (scheduledBlock) {
+            scheduledBlock.block();
+            [self endActivity];
+            deadline = DISPATCH_TIME_FOREVER;
+            continue;
+        } else if (!busy) {
+            break;
+        }
+
+        if (deadline == DISPATCH_TIME_FOREVER) {
+            deadline = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kUMKVirtualClockActivityTimeout * NSEC_PER_SEC));
+        } else if (dispatch_time(DISPATCH_TIME_NOW, 0) >= deadline) {
+            NSAssert(NO, @"Timed out waiting for handed-off work to finish: %@", self);
+            return;
+        }
+
+        // Work handed off to this thread's run loop only finishes if we run it. Other threads finish theirs on their own.
+        if ([self hasActivityOnRunLoop:currentRunLoop]) {
+            CFRunLoopRunInMode(kCFRunLoopDefaultMode, 0.001, true);
+        } else {
+            dispatch_semaphore_wait(_activitySemaphore, deadline);
+        }
+    }
+
+    os_unfair_lock_lock(&_lock);
+    _currentTime = MAX(_currentTime, targetTime);
+    os_unfair_lock_unlock(&_lock);
+}
+
+
+#pragma mark - Activity
+
+- (void)endActivity
+{
+    os_unfair_lock_lock(&_lock);
+    BOOL idle = --_activityCount == 0;
+    os_unfair_lock_unlock(&_lock);
+
+    dispatch_semaphore_signal(_activitySemaphore);
+    if (idle && self.mode == UMKVirtualClockModeAsFastAsPossible) {
+        [self advanceAsFastAsPossible];
+    }
+}
+
+
+- (BOOL)hasActivityOnRunLoop:(CFRunLoopRef)runLoop
+{
+    os_unfair_lock_lock(&_lock);
+    BOOL hasActivity = [_activityRunLoops countForObject:(__bridge id)runLoop] > 0;
+    os_unfair_lock_unlock(&_lock);
+    return hasActivity;
+}
+
+
+- (NSString *)description
+{
+    static NSString *const modeNames[] = { @"real time", @"manual", @"as fast as possible" };
+    return [NSString stringWithFormat:@"<%@: %p> mode: %@; currentTime: %.4f; scheduledBlockCount: %lu", self.class, self,
+                modeNames[self.mode], self.currentTime, (unsigned long)self.scheduledBlockCount];
+}
+
+@end
+
+
+#pragma mark - Responder Activity
+
+@implementation UMKVirtualClock (UMKMockHTTPResponder)
+
+- (void)beginActivityOnRunLoop:(CFRunLoopRef)runLoop
+{
+    NSParameterAssert(runLoop);
+
+    os_unfair_lock_lock(&self->_lock);
+    ++self->_activityCount;
+    [self->_activityRunLoops addObject:(__bridge id)runLoop];
+    os_unfair_lock_unlock(&self->_lock);
+}
+
+
+- (void)endActivityOnRunLoop:(CFRunLoopRef)runLoop
+{
+    NSParameterAssert(runLoop);
+
+    os_unfair_lock_lock(&self->_lock);
+    [self->_activityRunLoops removeObject:(__bridge id)runLoop];
+    os_unfair_lock_unlock(&self->_lock);
+
+    [self endActivity];
+}
+
+@end
@@ -0,0 +1,433 @@
+//
+//  UMKMockURLProtocolPerformanceTests.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import "UMKRandomizedTestCase.h"
+
+
+/*! The number of mock requests registered by the registry benchmarks. */
+static const NSUInteger kUMKPerformanceTestMockRequestCount = 10000;
+
+/*! The number of data tasks run at once by the contention benchmark. */
+static const NSUInteger kUMKPerformanceTestConcurrentTaskCount = 64;
+
+/*! The length of the body used by the chunked response memory benchmark. */
+static const NSUInteger kUMKPerformanceTestLargeBodyLength = 256 * 1024 * 1024;
+
+/*! The number of chunks the chunked response memory benchmark breaks its body into. */
+static const NSUInteger kUMKPerformanceTestLargeBodyChunkCount = 1000;
+
+/*! The number of responses sent by the response template benchmarks. */
+static const NSUInteger kUMKPerformanceTestResponseCount = 10000;
+
+
+#pragma mark - UMKByteCountingURLProtocolClient
+
+/*!
+ UMKByteCountingURLProtocolClients count the bytes they are sent and discard them, so that the only memory used
+ by a response is the memory used to produce it. Their finished expectations are fulfilled when loading finishes.
+ */
+@interface UMKByteCountingURLProtocolClient : NSObject <NSURLProtocolClient>
+
+@property (nonatomic, assign, readonly) NSUInteger byteCount;
+@property (nonatomic, assign, readonly, getter = isFinished) BOOL finished;
+@property (nonatomic, strong, readonly) XCTestExpectation *finishedExpectation;
+
+@end
+
+
+@implementation UMKByteCountingURLProtocolClient
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        _finishedExpectation = [[XCTestExpectation alloc] initWithDescription:@"Loading finished"];
+    }
+
+    return self;
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol wasRedirectedToRequest:(NSURLRequest *)request redirectResponse:(NSURLResponse *)redirectResponse
+{
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol cachedResponseIsValid:(NSCachedURLResponse *)cachedResponse
+{
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol didReceiveResponse:(NSURLResponse *)response cacheStoragePolicy:(NSURLCacheStoragePolicy)policy
+{
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol didLoadData:(NSData *)data
+{
+    _byteCount += data.length;
+}
+
+
+- (void)URLProtocolDidFinishLoading:(NSURLProtocol *)protocol
+{
+    _finished = YES;
+    [self.finishedExpectation fulfill];
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol didFailWithError:(NSError *)error
+{
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol didReceiveAuthenticationChallenge:(NSURLAuthenticationChallenge *)challenge
+{
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol didCancelAuthenticationChallenge:(NSURLAuthenticationChallenge *)challenge
+{
+}
+
+@end
+
+
+#pragma mark -
+
+@interface UMKMockHTTPResponder (UMKPrivateMethods)
+
+- (void)invalidateResponseTemplate;
+
+@end
+
+
+@interface UMKMockURLProtocolPerformanceTests : UMKRandomizedTestCase
+
+- (void)testLookupPerformanceWith10kMockRequests;
+- (void)testPatternLookupPerformanceWith1kURLPatterns;
+- (void)testContentionPerformanceWith64ConcurrentDataTasks;
+- (void)testCanonicalURLPerformanceWithRepeatedURLs;
+- (void)testPeakMemoryOfLargeChunkedResponse;
+- (void)testResponsePerformanceWithCompiledTemplate;
+- (void)testResponsePerformanceWithRecompiledTemplate;
+- (void)testPerItemRegistrationPerformanceWith1kMockRequests;
+- (void)testBulkRegistrationPerformanceWith1kMockRequests;
+- (void)testPerItemRegistrationPerformanceWith10kMockRequests;
+- (void)testBulkRegistrationPerformanceWith10kMockRequests;
+- (void)testPerItemRegistrationPerformanceWith100kMockRequests;
+- (void)testBulkRegistrationPerformanceWith100kMockRequests;
+
+@end
+
+
+@implementation UMKMockURLProtocolPerformanceTests
+
+- (void)setUp
+{
+    [super setUp];
+    [UMKMockURLProtocol reset];
+    [UMKMockURLProtocol setVerificationEnabled:NO];
+}
+
+
+- (void)tearDown
+{
+    [UMKMockURLProtocol reset];
+    [super tearDown];
+}
+
+
+- (void)testLookupPerformanceWith10kMockRequests
+{
+    NSMutableArray<NSURLRequest *> *requests = [[NSMutableArray alloc] initWithCapacity:kUMKPerformanceTestMockRequestCount];
+    for (NSUInteger i = 0; i < kUMKPerformanceTestMockRequestCount; ++i) {
+        NSURL *URL = [NSURL URLWithString:[NSString stringWithFormat:@"http://host%lu.example.com/resource?id=%lu", (unsigned long)i, (unsigned long)i]];
+        UMKMockHTTPRequest *mockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:URL];
+        mockRequest.responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200];
+        [UMKMockURLProtocol expectMockRequest:mockRequest];
+        [requests addObject:[NSURLRequest requestWithURL:URL]];
+    }
+
+    XCTAssertEqual([UMKMockURLProtocol expectedMockRequests].count, kUMKPerformanceTestMockRequestCount);
+
+    // Look up the most recently registered mock requests, which a linear scan would find last
+    NSArray<NSURLRequest *> *lookupRequests = [requests subarrayWithRange:NSMakeRange(kUMKPerformanceTestMockRequestCount - 1000, 1000)];
+    [self measureBlock:^{
+        for (NSURLRequest *request in lookupRequests) {
+            XCTAssertTrue([UMKMockURLProtocol canInitWithRequest:request]);
+        }
+    }];
+}
+
+
+- (void)testPatternLookupPerformanceWith1kURLPatterns
+{
+    // A REST-style API with a thousand resources, each with a collection, an item, and a nested item route
+    const NSUInteger resourceCount = 1000 / 3;
+    NSMutableArray<NSURLRequest *> *requests = [[NSMutableArray alloc] initWithCapacity:resourceCount];
+    for (NSUInteger i = 0; i < resourceCount; ++i) {
+        NSString *collectionPattern = [NSString stringWithFormat:@"http://api.example.com/resource%lu", (unsigned long)i];
+        for (NSString *URLPattern in @[ collectionPattern,
+                                        [collectionPattern stringByAppendingString:@"/:id"],
+                                        [collectionPattern stringByAppendingString:@"/:id/children/:childID"] ]) {
+            UMKPatternMatchingMockRequest *mockRequest = [[UMKPatternMatchingMockRequest alloc] initWithURLPattern:URLPattern];
+            mockRequest.responderGenerationBlock = ^id<UMKMockURLResponder>(NSURLRequest *request, NSDictionary *parameters) {
+                return [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200];
+            };
+
+            [UMKMockURLProtocol expectMockRequest:mockRequest];
+        }
+
+        NSString *URLString = [collectionPattern stringByAppendingFormat:@"/%lu/children/%lu", (unsigned long)i, (unsigned long)i];
+        [requests addObject:[NSURLRequest requestWithURL:[NSURL URLWithString:URLString]]];
+    }
+
+    [self measureBlock:^{
+        for (NSURLRequest *request in requests) {
+            XCTAssertTrue([UMKMockURLProtocol canInitWithRequest:request]);
+        }
+    }];
+}
+
+
+- (void)testContentionPerformanceWith64ConcurrentDataTasks
+{
+    NSMutableArray<NSURLRequest *> *requests = [[NSMutableArray alloc] initWithCapacity:kUMKPerformanceTestConcurrentTaskCount];
+    for (NSUInteger i = 0; i < kUMKPerformanceTestMockRequestCount; ++i) {
+        NSURL *URL = [NSURL URLWithString:[NSString stringWithFormat:@"http://api.example.com/resource/%lu", (unsigned long)i]];
+        UMKMockHTTPRequest *mockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:URL];
+        mockRequest.responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200];
+        [UMKMockURLProtocol expectMockRequest:mockRequest];
+
+        if (i % (kUMKPerformanceTestMockRequestCount / kUMKPerformanceTestConcurrentTaskCount) == 0 &&
+            requests.count < kUMKPerformanceTestConcurrentTaskCount) {
+            [requests addObject:[NSURLRequest requestWithURL:URL]];
+        }
+    }
+
+    NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+    configuration.protocolClasses = @[ [UMKMockURLProtocol class] ];
+    configuration.HTTPMaximumConnectionsPerHost = kUMKPerformanceTestConcurrentTaskCount;
+    NSURLSession *session = [NSURLSession sessionWithConfiguration:configuration];
+
+    // Every task looks up its mock request while the others are doing the same
+    [self measureBlock:^{
+        dispatch_group_t group = dispatch_group_create();
+        for (NSURLRequest *request in requests) {
+            dispatch_group_enter(group);
+            NSURLSessionDataTask *task = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+                XCTAssertNil(error);
+                XCTAssertEqual([(NSHTTPURLResponse *)response statusCode], 200);
+                dispatch_group_leave(group);
+            }];
+
+            [task resume];
+        }
+
+        XCTAssertEqual(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(10 * NSEC_PER_SEC))), 0, @"Tasks timed out");
+    }];
+
+    [session invalidateAndCancel];
+}
+
+
+- (void)testCanonicalURLPerformanceWithRepeatedURLs
+{
+    // A handful of endpoints hit over and over, as in a typical test suite
+    NSArray<NSURL *> *URLs = @[ [NSURL URLWithString:@"http://api.example.com/users?page=2&sort=name&limit=50"],
+                                [NSURL URLWithString:@"http://api.example.com/search?q=caf%C3%A9&lang=fr&page=1"],
+                                [NSURL URLWithString:@"http://api.example.com/items?ids[]=3&ids[]=1&ids[]=2"],
+                                [NSURL URLWithString:@"http://api.example.com/items?filter[color]=red&filter[size]=large"],
+                                [NSURL URLWithString:@"http://api.example.com/status?a=1&b=2&c=3"] ];
+
+    [UMKMockURLProtocol removeAllCachedCanonicalURLs];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10000; ++i) {
+            XCTAssertNotNil([UMKMockURLProtocol canonicalURLForURL:URLs[i % URLs.count]]);
+        }
+    }];
+
+    XCTAssertGreaterThan([UMKMockURLProtocol canonicalURLCacheHitCount], [UMKMockURLProtocol canonicalURLCacheMissCount]);
+}
+
+
+- (void)testPeakMemoryOfLargeChunkedResponse
+{
+    if (@available(macOS 10.15, iOS 13.0, tvOS 13.0, *)) {
+        // Touch every page up front so that the body is resident before measuring starts
+        void *bytes = malloc(kUMKPerformanceTestLargeBodyLength);
+        memset(bytes, 0x5A, kUMKPerformanceTestLargeBodyLength);
+        NSData *body = [NSData dataWithBytesNoCopy:bytes length:kUMKPerformanceTestLargeBodyLength freeWhenDone:YES];
+
+        UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200
+                                                                                        headers:nil
+                                                                                           body:body
+                                                                                 chunkCountHint:kUMKPerformanceTestLargeBodyChunkCount
+                                                                             delayBetweenChunks:0.0];
+        UMKMockHTTPRequest *mockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:UMKRandomHTTPURL()];
+        id protocol = [[NSURLProtocol alloc] initWithRequest:[NSURLRequest requestWithURL:mockRequest.URL] cachedResponse:nil client:nil];
+
+        // Peak physical memory should stay near the size of the body, since chunks share its bytes
+        XCTMeasureOptions *options = [XCTMeasureOptions defaultOptions];
+        options.iterationCount = 3;
+        [self measureWithMetrics:@[ [[XCTMemoryMetric alloc] init], [[XCTClockMetric alloc] init] ] options:options block:^{
+            UMKByteCountingURLProtocolClient *client = [[UMKByteCountingURLProtocolClient alloc] init];
+            [responder respondToMockRequest:mockRequest client:client protocol:protocol];
+            XCTAssertEqual([XCTWaiter waitForExpectations:@[ client.finishedExpectation ] timeout:30.0], XCTWaiterResultCompleted,
+                           @"Response did not finish");
+            XCTAssertEqual(client.byteCount, kUMKPerformanceTestLargeBodyLength);
+        }];
+    }
+}
+
+
+- (void)testResponsePerformanceWithCompiledTemplate
+{
+    [self measureResponsesRecompilingTemplate:NO];
+}
+
+
+- (void)testResponsePerformanceWithRecompiledTemplate
+{
+    [self measureResponsesRecompilingTemplate:YES];
+}
+
+
+/*!
+ @abstract Measures sending many responses from a responder with a body and headers.
+ @discussion Recompiling the template for every response costs what building the response from scratch used to, so 
+     comparing the baselines of the compiled and recompiled benchmarks shows what the compiled template saves. CPU and
+     memory are reported as metrics rather than asserted on, since they also reflect whatever else the process is doing.
+ @param recompilesTemplate Whether to invalidate the responder's template before each response.
+ */
+- (void)measureResponsesRecompilingTemplate:(BOOL)recompilesTemplate
+{
+    NSDictionary<NSString *, NSString *> *headers = @{ kUMKMockHTTPMessageContentTypeHeaderField : kUMKMockHTTPMessageUTF8JSONContentTypeHeaderValue,
+                                                       @"Cache-Control" : @"no-cache",
+                                                       @"X-Request-Id" : UMKRandomAlphanumericString() };
+    NSData *body = [@"{\"id\":1,\"name\":\"URLMock\",\"tags\":[\"mock\",\"http\"]}" dataUsingEncoding:NSUTF8StringEncoding];
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200 headers:headers body:body];
+
+    UMKMockHTTPRequest *mockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:UMKRandomHTTPURL()];
+    id protocol = [[NSURLProtocol alloc] initWithRequest:[NSURLRequest requestWithURL:mockRequest.URL] cachedResponse:nil client:nil];
+    UMKByteCountingURLProtocolClient *client = [[UMKByteCountingURLProtocolClient alloc] init];
+
+    __block NSUInteger responseCount = 0;
+    NSArray<id<XCTMetric>> *metrics = @[ [[XCTClockMetric alloc] init], [[XCTCPUMetric alloc] init], [[XCTMemoryMetric alloc] init] ];
+    [self measureWithMetrics:metrics block:^{
+        for (NSUInteger i = 0; i < kUMKPerformanceTestResponseCount; ++i) {
+            @autoreleasepool {
+                if (recompilesTemplate) {
+                    [responder invalidateResponseTemplate];
+                }
+
+                [[responder responseSessionForMockRequest:mockRequest client:client protocol:protocol] start];
+                ++responseCount;
+            }
+        }
+    }];
+
+    XCTAssertEqual(client.byteCount, responseCount * body.length, @"Responses not delivered");
+}
+
+
+#pragma mark - Registration
+
+- (void)testPerItemRegistrationPerformanceWith1kMockRequests
+{
+    [self measureRegistrationOfMockRequestCount:1000 bulk:NO];
+}
+
+
+- (void)testBulkRegistrationPerformanceWith1kMockRequests
+{
+    [self measureRegistrationOfMockRequestCount:1000 bulk:YES];
+}
+
+
+- (void)testPerItemRegistrationPerformanceWith10kMockRequests
+{
+    [self measureRegistrationOfMockRequestCount:10000 bulk:NO];
+}
+
+
+- (void)testBulkRegistrationPerformanceWith10kMockRequests
+{
+    [self measureRegistrationOfMockRequestCount:10000 bulk:YES];
+}
+
+
+- (void)testPerItemRegistrationPerformanceWith100kMockRequests
+{
+    [self measureRegistrationOfMockRequestCount:100000 bulk:NO];
+}
+
+
+- (void)testBulkRegistrationPerformanceWith100kMockRequests
+{
+    [self measureRegistrationOfMockRequestCount:100000 bulk:YES];
+}
+
+
+/*!
+ @abstract Measures how long it takes to register the specified number of mock requests.
+ @discussion The mock requests are created before measuring so that only their registration is measured. A
+     tenth of the mock requests share their URLs with others so that exact-match buckets with several entries are 
+     exercised as well.
+ @param count The number of mock requests to register.
+ @param bulk Whether to use the bulk registration methods or register the mock requests one at a time.
+ */
+- (void)measureRegistrationOfMockRequestCount:(NSUInteger)count bulk:(BOOL)bulk
+{
+    NSMutableArray<id<UMKMockURLRequest>> *mockRequests = [[NSMutableArray alloc] initWithCapacity:count];
+    for (NSUInteger i = 0; i < count; ++i) {
+        NSUInteger resourceID = i % 10 == 0 ? i / 10 : i;
+        NSURL *URL = [NSURL URLWithString:[NSString stringWithFormat:@"http://api.example.com/resource/%lu", (unsigned long)resourceID]];
+        UMKMockHTTPRequest *mockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:URL];
+        mockRequest.responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200];
+        [mockRequests addObject:mockRequest];
+    }
+
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [UMKMockURLProtocol reset];
+
+        [self startMeasuring];
+        if (bulk) {
+            [UMKMockURLProtocol expectMockRequests:mockRequests];
+        } else {
+            for (id<UMKMockURLRequest> mockRequest in mockRequests) {
+                [UMKMockURLProtocol expectMockRequest:mockRequest];
+            }
+        }
+
+        // The first reader takes a snapshot of the expected mock requests, so include it in the setup time
+        XCTAssertEqual([UMKMockURLProtocol expectedMockRequests].count, count);
+        [self stopMeasuring];
+    }];
+}
+
+@end
@@ -0,0 +1,185 @@
+//
+//  UMKLatencyModelTests.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import "UMKRandomizedTestCase.h"
+
+
+@interface UMKLatencyModelTests : UMKRandomizedTestCase
+
+- (void)testFixedLatencyModel;
+- (void)testUniformLatencyModel;
+- (void)testLognormalLatencyModel;
+- (void)testEmpiricalLatencyModel;
+- (void)testEmpiricalLatencyModelWithContentsOfURL;
+- (void)testSamplingIsDeterministic;
+
+@end
+
+
+@implementation UMKLatencyModelTests
+
+- (void)testFixedLatencyModel
+{
+    NSTimeInterval latency = random() % 1000 / 1000.0;
+    UMKLatencyModel *model = [UMKLatencyModel fixedLatencyModelWithLatency:latency];
+
+    for (NSUInteger i = 0; i < 10; ++i) {
+        XCTAssertEqual([model sampleLatency], latency, @"Fixed latency varies");
+    }
+
+    XCTAssertThrows([UMKLatencyModel fixedLatencyModelWithLatency:-1.0], @"Negative latency allowed");
+}
+
+
+- (void)testUniformLatencyModel
+{
+    NSTimeInterval minimumLatency = random() % 100 / 1000.0;
+    NSTimeInterval maximumLatency = minimumLatency + 0.1;
+    UMKLatencyModel *model = [UMKLatencyModel uniformLatencyModelWithMinimumLatency:minimumLatency maximumLatency:maximumLatency seed:random()];
+
+    XCTAssertEqualWithAccuracy([model latencyAtQuantile:0.0], minimumLatency, 1e-9, @"Minimum latency is wrong");
+    XCTAssertEqualWithAccuracy([model latencyAtQuantile:0.5], minimumLatency + 0.05, 1e-9, @"Median latency is wrong");
+
+    double sum = 0.0;
+    for (NSUInteger i = 0; i < 10000; ++i) {
+        NSTimeInterval latency = [model sampleLatency];
+        XCTAssertGreaterThanOrEqual(latency, minimumLatency, @"Latency below the minimum");
+        XCTAssertLessThanOrEqual(latency, maximumLatency, @"Latency above the maximum");
+        sum += latency;
+    }
+
+    XCTAssertEqualWithAccuracy(sum / 10000, minimumLatency + 0.05, 0.005, @"Latencies are not uniformly distributed");
+    XCTAssertThrows([UMKLatencyModel uniformLatencyModelWithMinimumLatency:1.0 maximumLatency:0.5 seed:0], @"Empty range allowed");
+}
+
+
+- (void)testLognormalLatencyModel
+{
+    UMKLatencyModel *model = [UMKLatencyModel lognormalLatencyModelWithMedianLatency:0.1 sigma:1.0 seed:random()];
+
+    // The 84.13th percentile is one standard deviation above the mean of the logarithm
+    XCTAssertEqualWithAccuracy([model latencyAtQuantile:0.5], 0.1, 1e-9, @"Median latency is wrong");
+    XCTAssertEqualWithAccuracy([model latencyAtQuantile:0.841344746], 0.1 * M_E, 1e-6, @"Latency one sigma above the median is wrong");
+    XCTAssertEqualWithAccuracy([model latencyAtQuantile:0.001], 0.1 * exp(-3.090232306), 1e-6, @"Tail latency is wrong");
+    XCTAssertEqual([model latencyAtQuantile:0.0], 0.0, @"Minimum latency is not 0");
+
+    NSUInteger belowMedianCount = 0;
+    for (NSUInteger i = 0; i < 10000; ++i) {
+        NSTimeInterval latency = [model sampleLatency];
+        XCTAssertGreaterThanOrEqual(latency, 0.0, @"Negative latency sampled");
+        belowMedianCount += latency < 0.1;
+    }
+
+    XCTAssertEqualWithAccuracy(belowMedianCount / 10000.0, 0.5, 0.02, @"Half of latencies are not below the median");
+    XCTAssertThrows([UMKLatencyModel lognormalLatencyModelWithMedianLatency:0.0 sigma:1.0 seed:0], @"Zero median allowed");
+}
+
+
+- (void)testEmpiricalLatencyModel
+{
+    UMKLatencyModel *model = [UMKLatencyModel empiricalLatencyModelWithPercentileLatencies:@{ @10 : @0.02, @50 : @0.05, @90 : @0.2, @99 : @1.0 }
+                                                                                      seed:random()];
+
+    XCTAssertEqualWithAccuracy([model latencyAtQuantile:0.0], 0.02, 1e-9, @"Latency below the lowest percentile is wrong");
+    XCTAssertEqualWithAccuracy([model latencyAtQuantile:0.5], 0.05, 1e-9, @"Latency at a percentile is wrong");
+    XCTAssertEqualWithAccuracy([model latencyAtQuantile:0.7], 0.125, 1e-9, @"Latency between percentiles is not interpolated");
+    XCTAssertEqualWithAccuracy([model latencyAtQuantile:0.999], 1.0, 1e-9, @"Latency above the highest percentile is wrong");
+
+    NSUInteger tailCount = 0;
+    for (NSUInteger i = 0; i < 10000; ++i) {
+        NSTimeInterval latency = [model sampleLatency];
+        XCTAssertGreaterThanOrEqual(latency, 0.02, @"Latency below the lowest percentile");
+        XCTAssertLessThanOrEqual(latency, 1.0, @"Latency above the highest percentile");
+        tailCount += latency > 0.2;
+    }
+
+    XCTAssertEqualWithAccuracy(tailCount / 10000.0, 0.1, 0.02, @"Latencies don't follow the percentile table");
+
+    XCTAssertThrows([UMKLatencyModel empiricalLatencyModelWithPercentileLatencies:@{ } seed:0], @"Empty table allowed");
+    XCTAssertThrows(([UMKLatencyModel empiricalLatencyModelWithPercentileLatencies:@{ @50 : @1.0, @90 : @0.5 } seed:0]), @"Decreasing table allowed");
+    XCTAssertThrows([UMKLatencyModel empiricalLatencyModelWithPercentileLatencies:@{ @101 : @1.0 } seed:0], @"Percentile above 100 allowed");
+}
+
+
+- (void)testEmpiricalLatencyModelWithContentsOfURL
+{
+    NSURL *fileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]]];
+
+    NSData *table = [@"{ \"p0\" : 0.01, \"p50\" : 0.08, \"P99.9\" : 2.5, \"100\" : 4 }" dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertTrue([table writeToURL:fileURL atomically:YES], @"Could not write percentile table");
+
+    NSError *error = nil;
+    UMKLatencyModel *model = [UMKLatencyModel empiricalLatencyModelWithContentsOfURL:fileURL seed:1 error:&error];
+    XCTAssertNotNil(model, @"Model not loaded: %@", error);
+    XCTAssertEqual(model.seed, 1, @"Seed is not set correctly");
+    XCTAssertEqualWithAccuracy([model latencyAtQuantile:0.5], 0.08, 1e-9, @"Latency at p50 is wrong");
+    XCTAssertEqualWithAccuracy([model latencyAtQuantile:0.999], 2.5, 1e-9, @"Latency at p99.9 is wrong");
+    XCTAssertEqualWithAccuracy([model latencyAtQuantile:1.0], 4.0, 1e-9, @"Latency at p100 is wrong");
+
+    for (NSString *malformedTable in @[ @"[ 0.1 ]", @"{ }", @"{ \"median\" : 0.1 }", @"{ \"p50\" : \"fast\" }", @"{ \"p50\" : 0.5, \"p90\" : 0.1 }" ]) {
+        XCTAssertTrue([[malformedTable dataUsingEncoding:NSUTF8StringEncoding] writeToURL:fileURL atomically:YES], @"Could not write percentile table");
+
+        error = nil;
+        XCTAssertNil([UMKLatencyModel empiricalLatencyModelWithContentsOfURL:fileURL seed:0 error:&error], @"Malformed table loaded: %@", malformedTable);
+        XCTAssertEqualObjects(error.domain, NSCocoaErrorDomain, @"Incorrect error domain");
+        XCTAssertEqual(error.code, NSPropertyListReadCorruptError, @"Incorrect error code");
+        XCTAssertEqualObjects(error.userInfo[NSURLErrorKey], fileURL, @"Error does not include the file URL");
+    }
+
+    [[NSFileManager defaultManager] removeItemAtURL:fileURL error:NULL];
+
+    error = nil;
+    XCTAssertNil([UMKLatencyModel empiricalLatencyModelWithContentsOfURL:fileURL seed:0 error:&error], @"Missing file loaded");
+    XCTAssertNotNil(error, @"No error for missing file");
+}
+
+
+- (void)testSamplingIsDeterministic
+{
+    uint64_t seed = random();
+    UMKLatencyModel *model = [UMKLatencyModel lognormalLatencyModelWithMedianLatency:0.1 sigma:0.5 seed:seed];
+    UMKLatencyModel *sameSeedModel = [UMKLatencyModel lognormalLatencyModelWithMedianLatency:0.1 sigma:0.5 seed:seed];
+    UMKLatencyModel *otherSeedModel = [UMKLatencyModel lognormalLatencyModelWithMedianLatency:0.1 sigma:0.5 seed:seed + 1];
+
+    NSMutableArray<NSNumber *> *latencies = [[NSMutableArray alloc] init];
+    BOOL differsFromOtherSeed = NO;
+    for (NSUInteger i = 0; i < 100; ++i) {
+        NSTimeInterval latency = [model sampleLatency];
+        [latencies addObject:@(latency)];
+        XCTAssertEqual([sameSeedModel sampleLatency], latency, @"Models with the same seed produce different latencies");
+        differsFromOtherSeed = differsFromOtherSeed || [otherSeedModel sampleLatency] != latency;
+    }
+
+    XCTAssertTrue(differsFromOtherSeed, @"Models with different seeds produce the same latencies");
+
+    [model reset];
+    for (NSNumber *latency in latencies) {
+        XCTAssertEqual([model sampleLatency], latency.doubleValue, @"Reset model does not repeat its latencies");
+    }
+}
+
+@end
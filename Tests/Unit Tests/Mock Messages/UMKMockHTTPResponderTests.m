@@ -29,6 +29,90 @@
 #import <OCMock/OCMock.h>
 
 
+#pragma mark - UMKChunkRecordingURLProtocolClient
+
+/*!
+ UMKChunkRecordingURLProtocolClients record the data they are sent and whether loading finished. Unlike a mock,
+ they can be used to observe responses that are delivered asynchronously. Their loading completed expectations are
+ fulfilled when loading finishes or fails, so tests can wait for responses without polling.
+ */
+@interface UMKChunkRecordingURLProtocolClient : NSObject <NSURLProtocolClient>
+
+@property (nonatomic, strong, readonly) NSURLResponse *response;
+@property (nonatomic, strong, readonly) NSMutableArray<NSData *> *chunks;
+@property (nonatomic, assign, readonly, getter = isFinished) BOOL finished;
+@property (nonatomic, strong, readonly) NSError *error;
+@property (nonatomic, strong, readonly) XCTestExpectation *loadingCompletedExpectation;
+
+@end
+
+
+@implementation UMKChunkRecordingURLProtocolClient
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        _chunks = [[NSMutableArray alloc] init];
+        _loadingCompletedExpectation = [[XCTestExpectation alloc] initWithDescription:@"Loading completed"];
+    }
+
+    return self;
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol wasRedirectedToRequest:(NSURLRequest *)request redirectResponse:(NSURLResponse *)redirectResponse
+{
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol cachedResponseIsValid:(NSCachedURLResponse *)cachedResponse
+{
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol didReceiveResponse:(NSURLResponse *)response cacheStoragePolicy:(NSURLCacheStoragePolicy)policy
+{
+    _response = response;
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol didLoadData:(NSData *)data
+{
+    NSAssert([NSThread isMainThread], @"Data delivered off the loading thread");
+    [self.chunks addObject:data];
+}
+
+
+- (void)URLProtocolDidFinishLoading:(NSURLProtocol *)protocol
+{
+    _finished = YES;
+    [self.loadingCompletedExpectation fulfill];
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol didFailWithError:(NSError *)error
+{
+    _error = error;
+    [self.loadingCompletedExpectation fulfill];
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol didReceiveAuthenticationChallenge:(NSURLAuthenticationChallenge *)challenge
+{
+}
+
+
+- (void)URLProtocol:(NSURLProtocol *)protocol didCancelAuthenticationChallenge:(NSURLAuthenticationChallenge *)challenge
+{
+}
+
+@end
+
+
+#pragma mark -
+
+
 @interface UMKMockHTTPResponderTests : UMKRandomizedTestCase
 
 @property (nonatomic, strong) UMKMockHTTPRequest *mockRequest;
@@ -41,6 +125,22 @@
 - (void)testMockHTTPResponderWithStatusCodeBody;
 - (void)testMockHTTPResponderWithStatusCodeHeadersBody;
 - (void)testMockHTTPResponderWithStatusCodeHeadersBodyChunkCountHintDelayBetweenChunks;
+- (void)testMockHTTPResponderChunksAreDeliveredWithoutBlocking;
+- (void)testMockHTTPResponderCancelResponseToProtocol;
+- (void)testMockHTTPResponderResponseSessions;
+- (void)testMockHTTPResponderReusesResponseTemplate;
+- (void)testMockHTTPResponderWithContentEncoding;
+- (void)testMockHTTPResponderWithEncodedBodyFileURL;
+- (void)testMockHTTPResponderWithStatusCodeHeadersBodyFileURL;
+- (void)testMockHTTPResponderWithMissingBodyFile;
+- (void)testMockHTTPResponderWithStatusCodeHeadersChunkProducer;
+- (void)testMockHTTPResponderWithStatusCodeHeadersBodyStream;
+- (void)testMockHTTPResponderWithStatusCodeHeadersBodyStreamFactory;
+- (void)testMockHTTPResponderWithNetworkConditions;
+- (void)testMockHTTPResponderWithNetworkConditionsJitter;
+- (void)testMockHTTPResponderWithLatencyModel;
+- (void)testMockHTTPErrorResponderWithLatencyModel;
+- (void)testMockHTTPResponderWithVirtualClock;
 
 @end
 
@@ -63,6 +163,21 @@
 }
 
 
+/*!
+ @abstract Runs the current run loop until the specified clients have finished or failed loading.
+ @discussion Responses are delivered on the run loop of the thread that started them, so this is used instead of a 
+     blocking wait.
+ @param clients The clients whose loading to wait for.
+ @param timeout The maximum amount of time to wait.
+ @result Whether every client finished or failed loading before the timeout elapsed.
+ */
+- (BOOL)waitForLoadingToCompleteForClients:(NSArray<UMKChunkRecordingURLProtocolClient *> *)clients timeout:(NSTimeInterval)timeout
+{
+    NSArray<XCTestExpectation *> *expectations = [clients valueForKey:@"loadingCompletedExpectation"];
+    return [XCTWaiter waitForExpectations:expectations timeout:timeout] == XCTWaiterResultCompleted;
+}
+
+
 - (void)testMockHTTPResponderWithError
 {
     NSError *error = UMKRandomError();
@@ -201,5 +316,589 @@
 }
 
 
+- (void)testMockHTTPResponderChunksAreDeliveredWithoutBlocking
+{
+    NSMutableData *body = [[NSMutableData alloc] initWithLength:4096 + random() % 4096];
+    arc4random_buf(body.mutableBytes, body.length);
+
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200
+                                                                                    headers:nil
+                                                                                       body:body
+                                                                             chunkCountHint:4
+                                                                         delayBetweenChunks:0.05];
+    UMKChunkRecordingURLProtocolClient *client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+
+    // Responding should return as soon as the first chunk is sent rather than sleeping through the delays
+    NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+    [responder respondToMockRequest:self.mockRequest client:client protocol:self.URLProtocol];
+    XCTAssertLessThan([NSDate timeIntervalSinceReferenceDate] - start, 0.05, @"Responding blocked between chunks");
+    XCTAssertEqual(client.chunks.count, 1, @"First chunk not delivered synchronously");
+    XCTAssertFalse(client.isFinished, @"Finished before all chunks were delivered");
+
+    XCTAssertTrue(([self waitForLoadingToCompleteForClients:@[ client ] timeout:2.0] && client.isFinished), @"Response did not finish");
+    XCTAssertEqual(client.chunks.count, 4, @"Incorrect number of chunks delivered");
+
+    NSMutableData *deliveredBody = [[NSMutableData alloc] init];
+    for (NSData *chunk in client.chunks) {
+        [deliveredBody appendData:chunk];
+    }
+
+    XCTAssertEqualObjects(deliveredBody, body, @"Chunks were not delivered in order");
+}
+
+
+- (void)testMockHTTPResponderCancelResponseToProtocol
+{
+    NSMutableData *body = [[NSMutableData alloc] initWithLength:4096];
+    arc4random_buf(body.mutableBytes, body.length);
+
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200
+                                                                                    headers:nil
+                                                                                       body:body
+                                                                             chunkCountHint:4
+                                                                         delayBetweenChunks:0.05];
+    UMKChunkRecordingURLProtocolClient *canceledClient = [[UMKChunkRecordingURLProtocolClient alloc] init];
+    UMKChunkRecordingURLProtocolClient *client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+    id otherProtocol = [OCMockObject mockForClass:[NSURLProtocol class]];
+
+    [responder respondToMockRequest:self.mockRequest client:canceledClient protocol:self.URLProtocol];
+    [responder respondToMockRequest:self.mockRequest client:client protocol:otherProtocol];
+    [responder cancelResponseToProtocol:self.URLProtocol];
+
+    // Canceling one response should leave the other alone
+    XCTAssertTrue(([self waitForLoadingToCompleteForClients:@[ client ] timeout:2.0] && client.isFinished), @"Uncanceled response did not finish");
+    XCTAssertEqual(client.chunks.count, 4, @"Incorrect number of chunks delivered");
+    XCTAssertEqual(canceledClient.chunks.count, 1, @"Chunks delivered after cancellation");
+    XCTAssertFalse(canceledClient.isFinished, @"Canceled response finished");
+}
+
+
+- (void)testMockHTTPResponderResponseSessions
+{
+    NSData *body = [UMKRandomAlphanumericString() dataUsingEncoding:NSUTF8StringEncoding];
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200 body:body];
+
+    // Sessions for unshaped responses with no latency deliver everything when started
+    UMKChunkRecordingURLProtocolClient *client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+    id<UMKMockURLResponseSession> session = [responder responseSessionForMockRequest:self.mockRequest client:client protocol:self.URLProtocol];
+    XCTAssertNotNil(session, @"Returned nil session");
+    XCTAssertNil(client.response, @"Response sent before the session started");
+
+    [session start];
+    XCTAssertNotNil(client.response, @"Response not sent");
+    XCTAssertEqualObjects(client.chunks.firstObject, body, @"Body not delivered");
+    XCTAssertTrue(client.isFinished, @"Response did not finish");
+
+    // Sessions are independent, so canceling one leaves the others alone, and they're unaffected by the responder
+    responder.latencyModel = [UMKLatencyModel fixedLatencyModelWithLatency:0.05];
+    UMKChunkRecordingURLProtocolClient *canceledClient = [[UMKChunkRecordingURLProtocolClient alloc] init];
+    id<UMKMockURLResponseSession> canceledSession = [responder responseSessionForMockRequest:self.mockRequest
+                                                                                      client:canceledClient
+                                                                                    protocol:self.URLProtocol];
+    client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+    session = [responder responseSessionForMockRequest:self.mockRequest client:client protocol:self.URLProtocol];
+
+    [canceledSession start];
+    [session start];
+    [canceledSession cancel];
+    [responder cancelResponse];
+
+    XCTAssertTrue(([self waitForLoadingToCompleteForClients:@[ client ] timeout:2.0] && client.isFinished), @"Uncanceled session did not finish");
+    XCTAssertEqualObjects(client.chunks.firstObject, body, @"Body not delivered");
+    XCTAssertNil(canceledClient.response, @"Response sent after cancellation");
+    XCTAssertFalse(canceledClient.isFinished, @"Canceled session finished");
+}
+
+
+- (void)testMockHTTPResponderReusesResponseTemplate
+{
+    // NSHTTPURLResponse may canonicalize header field names, so use ones that are already canonical
+    NSString *contentType = UMKRandomAlphanumericString();
+    NSDictionary<NSString *, NSString *> *headers = @{ kUMKMockHTTPMessageContentTypeHeaderField : contentType };
+    NSData *body = [UMKRandomAlphanumericString() dataUsingEncoding:NSUTF8StringEncoding];
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200 headers:headers body:body];
+
+    NSHTTPURLResponse *(^respond)(id protocol) = ^NSHTTPURLResponse *(id protocol) {
+        UMKChunkRecordingURLProtocolClient *client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+        [[responder responseSessionForMockRequest:self.mockRequest client:client protocol:protocol] start];
+        XCTAssertEqualObjects(client.chunks.firstObject, body, @"Body not delivered");
+        XCTAssertTrue(client.isFinished, @"Response did not finish");
+        return (NSHTTPURLResponse *)client.response;
+    };
+
+    // Responses to the same URL are stamped from the template once and then reused
+    NSHTTPURLResponse *response = respond(self.URLProtocol);
+    XCTAssertEqual(response.statusCode, 200, @"Incorrect status code");
+    XCTAssertEqualObjects(response.URL, [self.URLProtocol request].URL, @"Incorrect URL");
+    XCTAssertEqualObjects(response.allHeaderFields[kUMKMockHTTPMessageContentTypeHeaderField], contentType, @"Incorrect headers");
+    XCTAssertEqual(respond(self.URLProtocol), response, @"Response not reused");
+
+    // Other URLs get their own responses
+    NSURL *otherURL = UMKRandomHTTPURL();
+    id otherProtocol = [OCMockObject mockForClass:[NSURLProtocol class]];
+    [[[otherProtocol stub] andReturn:[[NSURLRequest alloc] initWithURL:otherURL]] request];
+    NSHTTPURLResponse *otherResponse = respond(otherProtocol);
+    XCTAssertEqualObjects(otherResponse.URL, otherURL, @"Incorrect URL");
+    XCTAssertEqualObjects(otherResponse.allHeaderFields[kUMKMockHTTPMessageContentTypeHeaderField], contentType, @"Incorrect headers");
+
+    // Changing the headers recompiles the template
+    NSString *value = UMKRandomAlphanumericString();
+    [responder setValue:value forHeaderField:@"Cache-Control"];
+    response = respond(otherProtocol);
+    XCTAssertNotEqual(response, otherResponse, @"Stale response reused after headers changed");
+    XCTAssertEqualObjects(response.allHeaderFields[@"Cache-Control"], value, @"Header change not reflected in response");
+}
+
+
+- (void)testMockHTTPResponderWithContentEncoding
+{
+    NSMutableString *bodyString = [[NSMutableString alloc] init];
+    while (bodyString.length < 16384) {
+        [bodyString appendString:UMKRandomAlphanumericString()];
+    }
+
+    NSData *body = [bodyString dataUsingEncoding:NSUTF8StringEncoding];
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200
+                                                                                    headers:nil
+                                                                                       body:body
+                                                                             chunkCountHint:4
+                                                                         delayBetweenChunks:0.01];
+    XCTAssertEqual(responder.contentEncoding, UMKMockHTTPContentEncodingIdentity, @"Content encoding is not identity by default");
+    [responder setValue:[NSString stringWithFormat:@"%lu", (unsigned long)body.length] forHeaderField:kUMKMockHTTPMessageContentLengthHeaderField];
+    responder.contentEncoding = UMKMockHTTPContentEncodingGzip;
+
+    // Chunks are cut from the compressed bytes
+    UMKChunkRecordingURLProtocolClient *client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+    [[responder responseSessionForMockRequest:self.mockRequest client:client protocol:self.URLProtocol] start];
+    XCTAssertTrue(([self waitForLoadingToCompleteForClients:@[ client ] timeout:2.0] && client.isFinished), @"Response did not finish");
+
+    NSMutableData *encodedBody = [[NSMutableData alloc] init];
+    for (NSData *chunk in client.chunks) {
+        [encodedBody appendData:chunk];
+    }
+
+    NSDictionary *headerFields = [(NSHTTPURLResponse *)client.response allHeaderFields];
+    XCTAssertEqualObjects(headerFields[kUMKMockHTTPMessageContentEncodingHeaderField], @"gzip", @"Content-Encoding is not set correctly");
+    XCTAssertEqualObjects(headerFields[kUMKMockHTTPMessageContentLengthHeaderField],
+                          ([NSString stringWithFormat:@"%lu", (unsigned long)encodedBody.length]), @"Content-Length is not the encoded length");
+    XCTAssertLessThan(encodedBody.length, body.length, @"Body is not compressed");
+    XCTAssertGreaterThan(client.chunks.count, 1, @"Compressed body is not chunked");
+
+    // gzip bodies start with a magic number and end with the uncompressed length, modulo 2^32
+    const uint8_t *bytes = encodedBody.bytes;
+    XCTAssertTrue(bytes[0] == 0x1F && bytes[1] == 0x8B, @"Body is not in the gzip format");
+    uint32_t trailerLength = 0;
+    [encodedBody getBytes:&trailerLength range:NSMakeRange(encodedBody.length - sizeof(trailerLength), sizeof(trailerLength))];
+    XCTAssertEqual(CFSwapInt32LittleToHost(trailerLength), body.length, @"gzip trailer has the wrong length");
+
+    if (@available(macOS 10.15, iOS 13.0, tvOS 13.0, *)) {
+        // zlib writes a 10-byte gzip header and an 8-byte trailer around the raw deflate stream
+        NSData *deflateStream = [encodedBody subdataWithRange:NSMakeRange(10, encodedBody.length - 18)];
+        XCTAssertEqualObjects([deflateStream decompressedDataUsingAlgorithm:NSDataCompressionAlgorithmZlib error:NULL], body,
+                              @"Body does not decompress correctly");
+    }
+
+    // The body is compressed once and reused by subsequent responses, even when other things change
+    responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200 body:body];
+    responder.contentEncoding = UMKMockHTTPContentEncodingDeflate;
+
+    NSData *(^respond)(void) = ^NSData *{
+        UMKChunkRecordingURLProtocolClient *responseClient = [[UMKChunkRecordingURLProtocolClient alloc] init];
+        [[responder responseSessionForMockRequest:self.mockRequest client:responseClient protocol:self.URLProtocol] start];
+        XCTAssertTrue(responseClient.isFinished, @"Response did not finish");
+        XCTAssertEqual(responseClient.chunks.count, 1, @"Incorrect number of chunks delivered");
+        return responseClient.chunks.firstObject;
+    };
+
+    NSData *deflatedBody = respond();
+    XCTAssertEqual(((const uint8_t *)deflatedBody.bytes)[0], 0x78, @"Body is not in the zlib format");
+    XCTAssertEqual(respond(), deflatedBody, @"Compressed body not reused");
+
+    [responder setValue:UMKRandomAlphanumericString() forHeaderField:@"Cache-Control"];
+    XCTAssertEqual(respond(), deflatedBody, @"Compressed body not reused after headers changed");
+
+    // Turning encoding off sends the body as it is
+    responder.contentEncoding = UMKMockHTTPContentEncodingIdentity;
+    XCTAssertEqualObjects(respond(), body, @"Body not sent unencoded");
+}
+
+
+- (void)testMockHTTPResponderWithEncodedBodyFileURL
+{
+    // The file's contents are sent as they are, so they don't actually need to be compressed
+    NSMutableData *encodedBody = [[NSMutableData alloc] initWithLength:4096 + random() % 4096];
+    arc4random_buf(encodedBody.mutableBytes, encodedBody.length);
+
+    NSURL *encodedBodyFileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString]];
+    XCTAssertTrue([encodedBody writeToURL:encodedBodyFileURL atomically:YES], @"Could not write body file");
+
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200
+                                                                                    headers:nil
+                                                                         encodedBodyFileURL:encodedBodyFileURL
+                                                                            contentEncoding:UMKMockHTTPContentEncodingGzip
+                                                                             chunkCountHint:4
+                                                                         delayBetweenChunks:0.01];
+    XCTAssertEqual(responder.contentEncoding, UMKMockHTTPContentEncodingGzip, @"Content encoding is not set correctly");
+
+    UMKChunkRecordingURLProtocolClient *client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+    [[responder responseSessionForMockRequest:self.mockRequest client:client protocol:self.URLProtocol] start];
+    XCTAssertTrue(([self waitForLoadingToCompleteForClients:@[ client ] timeout:2.0] && client.isFinished), @"Response did not finish");
+    XCTAssertEqual(client.chunks.count, 4, @"Incorrect number of chunks delivered");
+
+    NSMutableData *deliveredBody = [[NSMutableData alloc] init];
+    for (NSData *chunk in client.chunks) {
+        [deliveredBody appendData:chunk];
+    }
+
+    NSDictionary *headerFields = [(NSHTTPURLResponse *)client.response allHeaderFields];
+    XCTAssertEqualObjects(deliveredBody, encodedBody, @"Encoded body file contents not delivered as they are");
+    XCTAssertEqualObjects(headerFields[kUMKMockHTTPMessageContentEncodingHeaderField], @"gzip", @"Content-Encoding is not set correctly");
+    XCTAssertEqualObjects(headerFields[kUMKMockHTTPMessageContentLengthHeaderField],
+                          ([NSString stringWithFormat:@"%lu", (unsigned long)encodedBody.length]), @"Content-Length is not set correctly");
+
+    [[NSFileManager defaultManager] removeItemAtURL:encodedBodyFileURL error:NULL];
+}
+
+
+- (void)testMockHTTPResponderWithStatusCodeHeadersBodyFileURL
+{
+    NSMutableData *body = [[NSMutableData alloc] initWithLength:4096 + random() % 4096];
+    arc4random_buf(body.mutableBytes, body.length);
+
+    NSURL *bodyFileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString]];
+    XCTAssertTrue([body writeToURL:bodyFileURL atomically:YES], @"Could not write body file");
+
+    NSDictionary<NSString *, NSString *> *headers = UMKRandomDictionaryOfStringsWithElementCount(5);
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200
+                                                                                    headers:headers
+                                                                                bodyFileURL:bodyFileURL
+                                                                             chunkCountHint:4
+                                                                         delayBetweenChunks:0.01];
+
+    XCTAssertEqualObjects([responder valueForHeaderField:kUMKMockHTTPMessageContentLengthHeaderField],
+                          ([NSString stringWithFormat:@"%lu", (unsigned long)body.length]), @"Content-Length is not set correctly");
+    XCTAssertEqual(responder.headers.count, headers.count + 1, @"Headers are not set correctly");
+
+    UMKChunkRecordingURLProtocolClient *client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+    [responder respondToMockRequest:self.mockRequest client:client protocol:self.URLProtocol];
+    XCTAssertTrue(([self waitForLoadingToCompleteForClients:@[ client ] timeout:2.0] && client.isFinished), @"Response did not finish");
+    XCTAssertEqual(client.chunks.count, 4, @"Incorrect number of chunks delivered");
+
+    NSMutableData *deliveredBody = [[NSMutableData alloc] init];
+    for (NSData *chunk in client.chunks) {
+        [deliveredBody appendData:chunk];
+    }
+
+    XCTAssertEqualObjects(deliveredBody, body, @"Body file contents not delivered");
+    XCTAssertEqualObjects(responder.body, body, @"Body is not set correctly");
+
+    // Setting the body replaces the file's contents
+    NSData *replacementBody = [UMKRandomUnicodeString() dataUsingEncoding:NSUTF8StringEncoding];
+    responder.body = replacementBody;
+    XCTAssertEqualObjects(responder.body, replacementBody, @"Body is not replaced");
+
+    [[NSFileManager defaultManager] removeItemAtURL:bodyFileURL error:NULL];
+}
+
+
+- (void)testMockHTTPResponderWithMissingBodyFile
+{
+    NSURL *bodyFileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString]];
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200 headers:nil bodyFileURL:bodyFileURL];
+    XCTAssertNil([responder valueForHeaderField:kUMKMockHTTPMessageContentLengthHeaderField], @"Content-Length set for missing file");
+
+    UMKChunkRecordingURLProtocolClient *client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+    [responder respondToMockRequest:self.mockRequest client:client protocol:self.URLProtocol];
+    XCTAssertNotNil(client.error, @"Missing body file did not produce an error");
+    XCTAssertEqual(client.chunks.count, 0, @"Data delivered for missing body file");
+    XCTAssertFalse(client.isFinished, @"Response with missing body file finished");
+}
+
+
+- (void)testMockHTTPResponderWithStatusCodeHeadersChunkProducer
+{
+    const NSUInteger chunkLength = 1024;
+    const NSUInteger chunkCount = random() % 10 + 5;
+    __block NSUInteger producedChunkCount = 0;
+    UMKMockHTTPResponderChunkProducer chunkProducer = ^NSData *(NSUInteger maximumLength, NSError **error) {
+        XCTAssertEqual(maximumLength, chunkLength, @"Incorrect maximum length requested");
+        return producedChunkCount++ < chunkCount ? [[NSMutableData alloc] initWithLength:maximumLength] : nil;
+    };
+
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200
+                                                                                    headers:nil
+                                                                              chunkProducer:chunkProducer
+                                                                                chunkLength:chunkLength
+                                                                         delayBetweenChunks:0.001];
+    XCTAssertNil(responder.body, @"Streaming responder has a body");
+
+    UMKChunkRecordingURLProtocolClient *client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+    [responder respondToMockRequest:self.mockRequest client:client protocol:self.URLProtocol];
+    XCTAssertTrue(([self waitForLoadingToCompleteForClients:@[ client ] timeout:2.0] && client.isFinished), @"Response did not finish");
+    XCTAssertEqual(client.chunks.count, chunkCount, @"Incorrect number of chunks delivered");
+
+    // Chunks should be pulled as they're delivered, and pulling should stop as soon as the response is canceled
+    producedChunkCount = 0;
+    client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+    responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200
+                                                              headers:nil
+                                                        chunkProducer:chunkProducer
+                                                          chunkLength:chunkLength
+                                                   delayBetweenChunks:0.05];
+    [responder respondToMockRequest:self.mockRequest client:client protocol:self.URLProtocol];
+    XCTAssertEqual(client.chunks.count, 1, @"First chunk not delivered synchronously");
+    XCTAssertEqual(producedChunkCount, 2, @"Chunks not pulled on demand");
+
+    [responder cancelResponse];
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.2]];
+    XCTAssertEqual(producedChunkCount, 2, @"Chunks pulled after cancellation");
+    XCTAssertEqual(client.chunks.count, 1, @"Chunks delivered after cancellation");
+    XCTAssertFalse(client.isFinished, @"Canceled response finished");
+}
+
+
+- (void)testMockHTTPResponderWithStatusCodeHeadersBodyStream
+{
+    NSMutableData *body = [[NSMutableData alloc] initWithLength:4096 + random() % 4096];
+    arc4random_buf(body.mutableBytes, body.length);
+
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200
+                                                                                    headers:nil
+                                                                                 bodyStream:[NSInputStream inputStreamWithData:body]
+                                                                                chunkLength:1000
+                                                                         delayBetweenChunks:0.001];
+
+    UMKChunkRecordingURLProtocolClient *client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+    [responder respondToMockRequest:self.mockRequest client:client protocol:self.URLProtocol];
+    XCTAssertTrue(([self waitForLoadingToCompleteForClients:@[ client ] timeout:2.0] && client.isFinished), @"Response did not finish");
+    XCTAssertNil(client.error, @"Stream response failed");
+    XCTAssertEqual(client.chunks.count, (body.length + 999) / 1000, @"Incorrect number of chunks delivered");
+
+    NSMutableData *deliveredBody = [[NSMutableData alloc] init];
+    for (NSData *chunk in client.chunks) {
+        XCTAssertLessThanOrEqual(chunk.length, 1000, @"Chunk is too long");
+        [deliveredBody appendData:chunk];
+    }
+
+    XCTAssertEqualObjects(deliveredBody, body, @"Stream contents not delivered");
+
+    // A stream can only be read once, so every later response fails rather than sending a truncated body
+    client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+    [responder respondToMockRequest:self.mockRequest client:client protocol:self.URLProtocol];
+    XCTAssertTrue(([self waitForLoadingToCompleteForClients:@[ client ] timeout:2.0] && client.error != nil), @"Second response did not fail");
+    XCTAssertEqualObjects(client.error.domain, kUMKErrorDomain, @"Incorrect error domain");
+    XCTAssertEqual(client.error.code, kUMKSingleUseResponderReusedErrorCode, @"Incorrect error code");
+    XCTAssertEqual(client.chunks.count, 0, @"Data delivered for reused stream");
+}
+
+
+- (void)testMockHTTPResponderWithStatusCodeHeadersBodyStreamFactory
+{
+    NSMutableData *body = [[NSMutableData alloc] initWithLength:4096 + random() % 4096];
+    arc4random_buf(body.mutableBytes, body.length);
+
+    __block NSUInteger streamCount = 0;
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200
+                                                                                    headers:nil
+                                                                          bodyStreamFactory:^NSInputStream *{
+                                                                              ++streamCount;
+                                                                              return [NSInputStream inputStreamWithData:body];
+                                                                          }
+                                                                                chunkLength:1000
+                                                                         delayBetweenChunks:0.001];
+
+    // Overlapping responses each read their own stream, so every one gets the whole body
+    NSMutableArray<UMKChunkRecordingURLProtocolClient *> *clients = [[NSMutableArray alloc] init];
+    for (NSUInteger i = 0; i < 3; ++i) {
+        UMKChunkRecordingURLProtocolClient *client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+        [responder respondToMockRequest:self.mockRequest client:client protocol:self.URLProtocol];
+        [clients addObject:client];
+    }
+
+    XCTAssertEqual(streamCount, 3, @"Streams not created once per response");
+    XCTAssertTrue(([self waitForLoadingToCompleteForClients:clients timeout:2.0] && ![[clients valueForKey:@"finished"] containsObject:@NO]), @"Responses did not finish");
+
+    for (UMKChunkRecordingURLProtocolClient *client in clients) {
+        XCTAssertNil(client.error, @"Stream response failed");
+
+        NSMutableData *deliveredBody = [[NSMutableData alloc] init];
+        for (NSData *chunk in client.chunks) {
+            [deliveredBody appendData:chunk];
+        }
+
+        XCTAssertEqualObjects(deliveredBody, body, @"Stream contents not delivered");
+    }
+}
+
+
+- (void)testMockHTTPResponderWithNetworkConditions
+{
+    NSMutableData *body = [[NSMutableData alloc] initWithLength:20000];
+    arc4random_buf(body.mutableBytes, body.length);
+
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200 body:body];
+    XCTAssertNil(responder.networkConditions, @"Network conditions are set by default");
+
+    // At 100 KB/s, chunks are 2000 bytes and the token bucket starts with one chunk's worth of tokens
+    responder.networkConditions = [[UMKNetworkConditions alloc] initWithDownstreamBytesPerSecond:100000 roundTripTime:0.05 jitter:0.0];
+
+    UMKChunkRecordingURLProtocolClient *client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+    NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+    [responder respondToMockRequest:self.mockRequest client:client protocol:self.URLProtocol];
+    XCTAssertNil(client.response, @"Response sent before the round-trip time elapsed");
+
+    XCTAssertTrue(([self waitForLoadingToCompleteForClients:@[ client ] timeout:5.0] && client.isFinished), @"Response did not finish");
+    NSTimeInterval elapsed = [NSDate timeIntervalSinceReferenceDate] - start;
+
+    // 50 ms of latency, then 20 ms for each chunk once the bucket has been drained
+    XCTAssertGreaterThanOrEqual(elapsed, 0.2, @"Body delivered faster than the downstream rate");
+    XCTAssertNotNil(client.response, @"Response not sent");
+    XCTAssertEqual(client.chunks.count, 10, @"Body not broken into the preferred chunk length");
+
+    NSMutableData *deliveredBody = [[NSMutableData alloc] init];
+    for (NSData *chunk in client.chunks) {
+        [deliveredBody appendData:chunk];
+    }
+
+    XCTAssertEqualObjects(deliveredBody, body, @"Body not delivered");
+}
+
+
+- (void)testMockHTTPResponderWithNetworkConditionsJitter
+{
+    // Pick a seed whose first two jitter samples are far enough apart to tell which response arrives first
+    const NSTimeInterval jitter = 10.0;
+    uint64_t jitterSeed;
+    NSTimeInterval latencies[2];
+    do {
+        jitterSeed = random();
+        UMKNetworkConditions *twinConditions = [[UMKNetworkConditions alloc] initWithDownstreamBytesPerSecond:0
+                                                                                                roundTripTime:0.0
+                                                                                                       jitter:jitter
+                                                                                                   jitterSeed:jitterSeed];
+        latencies[0] = [twinConditions sampleJitter];
+        latencies[1] = [twinConditions sampleJitter];
+    } while (fabs(latencies[0] - latencies[1]) < 1.0);
+
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200];
+    responder.networkConditions = [[UMKNetworkConditions alloc] initWithDownstreamBytesPerSecond:0
+                                                                                   roundTripTime:0.0
+                                                                                          jitter:jitter
+                                                                                      jitterSeed:jitterSeed];
+
+    UMKVirtualClock *clock = [[UMKVirtualClock alloc] initWithMode:UMKVirtualClockModeManual];
+    [UMKVirtualClock setDefaultClock:clock];
+
+    UMKChunkRecordingURLProtocolClient *clients[2];
+    for (NSUInteger i = 0; i < 2; ++i) {
+        clients[i] = [[UMKChunkRecordingURLProtocolClient alloc] init];
+        [responder respondToMockRequest:self.mockRequest client:clients[i] protocol:self.URLProtocol];
+    }
+
+    [UMKVirtualClock setDefaultClock:nil];
+
+    // Each response takes the next sample from the seeded sequence rather than reusing the first
+    NSUInteger first = latencies[0] < latencies[1] ? 0 : 1;
+    NSUInteger second = 1 - first;
+
+    [clock advanceByTimeInterval:latencies[first] - 0.1];
+    XCTAssertNil(clients[first].response, @"Response sent before its jitter elapsed");
+
+    [clock advanceByTimeInterval:0.2];
+    XCTAssertNotNil(clients[first].response, @"Response not sent after its jitter elapsed");
+    XCTAssertNil(clients[second].response, @"Responses sampled the same jitter");
+
+    [clock advanceByTimeInterval:latencies[second] - latencies[first]];
+    XCTAssertNotNil(clients[second].response, @"Response not sent after its jitter elapsed");
+}
+
+
+- (void)testMockHTTPResponderWithLatencyModel
+{
+    NSData *body = [UMKRandomAlphanumericString() dataUsingEncoding:NSUTF8StringEncoding];
+
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200 body:body];
+    XCTAssertNil(responder.latencyModel, @"Latency model is set by default");
+
+    // The latency model overrides the network conditions' round-trip time
+    responder.networkConditions = [[UMKNetworkConditions alloc] initWithDownstreamBytesPerSecond:0 roundTripTime:5.0 jitter:0.0];
+    responder.latencyModel = [UMKLatencyModel fixedLatencyModelWithLatency:0.1];
+
+    NSMutableArray<UMKChunkRecordingURLProtocolClient *> *clients = [[NSMutableArray alloc] init];
+    NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+    for (NSUInteger i = 0; i < 100; ++i) {
+        UMKChunkRecordingURLProtocolClient *client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+        [responder respondToMockRequest:self.mockRequest client:client protocol:self.URLProtocol];
+        XCTAssertNil(client.response, @"Response sent before the latency elapsed");
+        [clients addObject:client];
+    }
+
+    // Responses are scheduled rather than slept, so many concurrent responses take no longer than one
+    XCTAssertLessThan([NSDate timeIntervalSinceReferenceDate] - start, 0.1, @"Responding blocked during the latency");
+
+    XCTAssertTrue(([self waitForLoadingToCompleteForClients:clients timeout:2.0] && ![[clients valueForKey:@"finished"] containsObject:@NO]), @"Responses did not finish");
+    XCTAssertGreaterThanOrEqual([NSDate timeIntervalSinceReferenceDate] - start, 0.1, @"Responses sent before the latency elapsed");
+
+    for (UMKChunkRecordingURLProtocolClient *client in clients) {
+        XCTAssertNotNil(client.response, @"Response not sent");
+        XCTAssertEqualObjects(client.chunks.firstObject, body, @"Body not delivered");
+    }
+}
+
+
+- (void)testMockHTTPErrorResponderWithLatencyModel
+{
+    NSError *error = UMKRandomError();
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithError:error];
+    responder.latencyModel = [UMKLatencyModel fixedLatencyModelWithLatency:0.05];
+
+    UMKChunkRecordingURLProtocolClient *client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+    [responder respondToMockRequest:self.mockRequest client:client protocol:self.URLProtocol];
+    XCTAssertNil(client.error, @"Error sent before the latency elapsed");
+
+    XCTAssertTrue(([self waitForLoadingToCompleteForClients:@[ client ] timeout:2.0] && client.error != nil), @"Error not sent");
+    XCTAssertEqualObjects(client.error, error, @"Incorrect error sent");
+    XCTAssertNil(client.response, @"Response sent with error");
+    XCTAssertFalse(client.isFinished, @"Finished loading with error");
+}
+
+
+- (void)testMockHTTPResponderWithVirtualClock
+{
+    NSMutableData *body = [[NSMutableData alloc] initWithLength:4096];
+    arc4random_buf(body.mutableBytes, body.length);
+
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200
+                                                                                    headers:nil
+                                                                                       body:body
+                                                                             chunkCountHint:4
+                                                                         delayBetweenChunks:10.0];
+    responder.latencyModel = [UMKLatencyModel fixedLatencyModelWithLatency:30.0];
+
+    UMKVirtualClock *clock = [[UMKVirtualClock alloc] initWithMode:UMKVirtualClockModeManual];
+    [UMKVirtualClock setDefaultClock:clock];
+
+    UMKChunkRecordingURLProtocolClient *client = [[UMKChunkRecordingURLProtocolClient alloc] init];
+    NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+    [responder respondToMockRequest:self.mockRequest client:client protocol:self.URLProtocol];
+    [UMKVirtualClock setDefaultClock:nil];
+
+    [clock advanceByTimeInterval:29.0];
+    XCTAssertNil(client.response, @"Response sent before the latency elapsed");
+
+    // The response and first chunk arrive at 30 seconds, and the others every 10 seconds after that
+    [clock advanceByTimeInterval:1.0];
+    XCTAssertNotNil(client.response, @"Response not sent after the latency elapsed");
+    XCTAssertEqual(client.chunks.count, 1, @"Incorrect number of chunks delivered with the response");
+
+    [clock advanceByTimeInterval:15.0];
+    XCTAssertEqual(client.chunks.count, 2, @"Incorrect number of chunks delivered after one delay");
+    XCTAssertFalse(client.isFinished, @"Finished before all chunks were delivered");
+
+    [clock advanceByTimeInterval:15.0];
+    XCTAssertEqual(client.chunks.count, 4, @"Incorrect number of chunks delivered after three delays");
+    XCTAssertTrue(client.isFinished, @"Response did not finish");
+    XCTAssertLessThan([NSDate timeIntervalSinceReferenceDate] - start, 1.0, @"Delays took real time");
+}
 
 @end
@@ -0,0 +1,301 @@
+//
+//  UMKMockSequenceResponderTests.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import "UMKRandomizedTestCase.h"
+
+#import <OCMock/OCMock.h>
+#import <stdatomic.h>
+
+
+#pragma mark UMKCountingMockURLResponder
+
+/*!
+ UMKCountingMockURLResponders count the requests they respond to and the cancellation messages they receive. They
+ don't create response sessions, so sequence responders must adapt them.
+ */
+@interface UMKCountingMockURLResponder : NSObject <UMKMockURLResponder>
+
+@property (nonatomic, assign, readonly) NSUInteger responseCount;
+@property (nonatomic, assign, readonly) NSUInteger cancelCount;
+
+@end
+
+
+@implementation UMKCountingMockURLResponder {
+    _Atomic(NSUInteger) _responseCount;
+    _Atomic(NSUInteger) _cancelCount;
+}
+
+- (NSUInteger)responseCount
+{
+    return atomic_load(&_responseCount);
+}
+
+
+- (NSUInteger)cancelCount
+{
+    return atomic_load(&_cancelCount);
+}
+
+
+- (void)respondToMockRequest:(id<UMKMockURLRequest>)request client:(id<NSURLProtocolClient>)client protocol:(NSURLProtocol *)protocol
+{
+    atomic_fetch_add(&_responseCount, 1);
+}
+
+
+- (void)cancelResponse
+{
+    atomic_fetch_add(&_cancelCount, 1);
+}
+
+@end
+
+
+#pragma mark -
+
+@interface UMKMockSequenceResponderTests : UMKRandomizedTestCase
+
+@property (nonatomic, strong) UMKMockHTTPRequest *mockRequest;
+@property (nonatomic, strong) id URLProtocolClient;
+@property (nonatomic, strong) id URLProtocol;
+
+- (void)testInit;
+- (void)testResponderForResponseAtIndex;
+- (void)testSequenceStopsWhenExhausted;
+- (void)testSequenceRepeatsLastResponseWhenExhausted;
+- (void)testSequenceWrapsAroundWhenExhausted;
+- (void)testReset;
+- (void)testCancelResponseToProtocol;
+- (void)testConcurrentRequestsClaimDistinctPositions;
+
+@end
+
+
+@implementation UMKMockSequenceResponderTests
+
+- (void)setUp
+{
+    [super setUp];
+
+    NSURL *URL = UMKRandomHTTPURL();
+
+    self.mockRequest = [[UMKMockHTTPRequest alloc] initWithHTTPMethod:kUMKMockHTTPRequestGetMethod URL:URL];
+    self.URLProtocolClient = [OCMockObject mockForProtocol:@protocol(NSURLProtocolClient)];
+    self.URLProtocol = [OCMockObject mockForClass:[NSURLProtocol class]];
+
+    [[[self.URLProtocol stub] andReturn:[[NSURLRequest alloc] initWithURL:URL]] request];
+}
+
+
+- (NSArray<UMKCountingMockURLResponder *> *)randomCountingResponders
+{
+    return UMKGeneratedArrayWithElementCount(random() % 5 + 2, ^id(NSUInteger index) {
+        return [[UMKCountingMockURLResponder alloc] init];
+    });
+}
+
+
+- (void)respondWithSequenceResponder:(UMKMockSequenceResponder *)sequenceResponder
+{
+    [[sequenceResponder responseSessionForMockRequest:self.mockRequest client:self.URLProtocolClient protocol:self.URLProtocol] start];
+}
+
+
+- (void)testInit
+{
+    XCTAssertThrows([[UMKMockSequenceResponder alloc] initWithResponders:@[ ]
+                                                      exhaustionBehavior:UMKMockSequenceResponderExhaustionBehaviorStop],
+                    @"Does not throw an exception when the sequence is empty");
+
+    NSArray *responders = [self randomCountingResponders];
+    UMKMockSequenceResponder *sequenceResponder = [UMKMockSequenceResponder sequenceResponderWithResponders:responders];
+    XCTAssertNotNil(sequenceResponder, @"Returns nil");
+    XCTAssertEqualObjects(sequenceResponder.responders, responders, @"Responders not set correctly");
+    XCTAssertEqual(sequenceResponder.exhaustionBehavior, UMKMockSequenceResponderExhaustionBehaviorStop, @"Exhaustion behavior not set correctly");
+    XCTAssertEqual(sequenceResponder.responseCount, (NSUInteger)0, @"Response count is non-zero");
+
+    sequenceResponder = [[UMKMockSequenceResponder alloc] initWithResponders:responders
+                                                          exhaustionBehavior:UMKMockSequenceResponderExhaustionBehaviorWrapAround];
+    XCTAssertEqual(sequenceResponder.exhaustionBehavior, UMKMockSequenceResponderExhaustionBehaviorWrapAround, @"Exhaustion behavior not set correctly");
+}
+
+
+- (void)testResponderForResponseAtIndex
+{
+    NSArray *responders = [self randomCountingResponders];
+    NSUInteger count = responders.count;
+
+    UMKMockSequenceResponder *stop = [[UMKMockSequenceResponder alloc] initWithResponders:responders
+                                                                       exhaustionBehavior:UMKMockSequenceResponderExhaustionBehaviorStop];
+    UMKMockSequenceResponder *repeatLast = [[UMKMockSequenceResponder alloc] initWithResponders:responders
+                                                                             exhaustionBehavior:UMKMockSequenceResponderExhaustionBehaviorRepeatLast];
+    UMKMockSequenceResponder *wrapAround = [[UMKMockSequenceResponder alloc] initWithResponders:responders
+                                                                             exhaustionBehavior:UMKMockSequenceResponderExhaustionBehaviorWrapAround];
+
+    for (NSUInteger i = 0; i < count * 3; ++i) {
+        if (i < count) {
+            XCTAssertEqual([stop responderForResponseAtIndex:i], responders[i], @"Incorrect responder at index %lu", (unsigned long)i);
+            XCTAssertEqual([repeatLast responderForResponseAtIndex:i], responders[i], @"Incorrect responder at index %lu", (unsigned long)i);
+        } else {
+            XCTAssertNil([stop responderForResponseAtIndex:i], @"Returns responder after exhaustion");
+            XCTAssertEqual([repeatLast responderForResponseAtIndex:i], responders.lastObject, @"Does not repeat last responder");
+        }
+
+        XCTAssertEqual([wrapAround responderForResponseAtIndex:i], responders[i % count], @"Does not wrap around");
+    }
+}
+
+
+- (void)testSequenceStopsWhenExhausted
+{
+    // 503, 503, then 200, like a service that recovers on the third attempt
+    UMKMockHTTPResponder *unavailableResponder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:503];
+    UMKMockHTTPResponder *OKResponder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200];
+    UMKMockSequenceResponder *sequenceResponder =
+        [UMKMockSequenceResponder sequenceResponderWithResponders:@[ unavailableResponder, unavailableResponder, OKResponder ]];
+
+    for (NSNumber *statusCode in @[ @503, @503, @200 ]) {
+        [[self.URLProtocolClient expect] URLProtocol:self.URLProtocol
+                                  didReceiveResponse:[OCMArg checkWithBlock:^BOOL(NSHTTPURLResponse *response) {
+                                      return response.statusCode == statusCode.integerValue;
+                                  }]
+                                  cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+        [[self.URLProtocolClient expect] URLProtocolDidFinishLoading:self.URLProtocol];
+
+        [self respondWithSequenceResponder:sequenceResponder];
+        XCTAssertNoThrow([self.URLProtocolClient verify], @"Incorrect response for status code %@", statusCode);
+    }
+
+    [[self.URLProtocolClient expect] URLProtocol:self.URLProtocol didFailWithError:[OCMArg checkWithBlock:^BOOL(NSError *error) {
+        return [error.domain isEqualToString:kUMKErrorDomain] && error.code == kUMKMockSequenceExhaustedErrorCode;
+    }]];
+
+    [self respondWithSequenceResponder:sequenceResponder];
+    XCTAssertNoThrow([self.URLProtocolClient verify], @"Does not fail after the sequence is exhausted");
+    XCTAssertEqual(sequenceResponder.responseCount, (NSUInteger)4, @"Incorrect response count");
+}
+
+
+- (void)testSequenceRepeatsLastResponseWhenExhausted
+{
+    NSArray<UMKCountingMockURLResponder *> *responders = [self randomCountingResponders];
+    UMKMockSequenceResponder *sequenceResponder = [[UMKMockSequenceResponder alloc] initWithResponders:responders
+                                                                                    exhaustionBehavior:UMKMockSequenceResponderExhaustionBehaviorRepeatLast];
+
+    NSUInteger extraCount = random() % 5 + 1;
+    for (NSUInteger i = 0; i < responders.count + extraCount; ++i) {
+        [self respondWithSequenceResponder:sequenceResponder];
+    }
+
+    for (NSUInteger i = 0; i < responders.count - 1; ++i) {
+        XCTAssertEqual(responders[i].responseCount, (NSUInteger)1, @"Responder %lu responded incorrect number of times", (unsigned long)i);
+    }
+
+    XCTAssertEqual(responders.lastObject.responseCount, 1 + extraCount, @"Last responder was not repeated");
+    XCTAssertEqual(sequenceResponder.responseCount, responders.count + extraCount, @"Incorrect response count");
+}
+
+
+- (void)testSequenceWrapsAroundWhenExhausted
+{
+    NSArray<UMKCountingMockURLResponder *> *responders = [self randomCountingResponders];
+    UMKMockSequenceResponder *sequenceResponder = [[UMKMockSequenceResponder alloc] initWithResponders:responders
+                                                                                    exhaustionBehavior:UMKMockSequenceResponderExhaustionBehaviorWrapAround];
+
+    NSUInteger cycleCount = random() % 5 + 2;
+    for (NSUInteger i = 0; i < responders.count * cycleCount; ++i) {
+        [sequenceResponder respondToMockRequest:self.mockRequest client:self.URLProtocolClient protocol:self.URLProtocol];
+    }
+
+    for (UMKCountingMockURLResponder *responder in responders) {
+        XCTAssertEqual(responder.responseCount, cycleCount, @"Sequence did not wrap around");
+    }
+}
+
+
+- (void)testReset
+{
+    NSArray<UMKCountingMockURLResponder *> *responders = [self randomCountingResponders];
+    UMKMockSequenceResponder *sequenceResponder = [UMKMockSequenceResponder sequenceResponderWithResponders:responders];
+
+    for (NSUInteger i = 0; i < responders.count; ++i) {
+        [self respondWithSequenceResponder:sequenceResponder];
+    }
+
+    [sequenceResponder reset];
+    XCTAssertEqual(sequenceResponder.responseCount, (NSUInteger)0, @"Response count not reset");
+
+    [self respondWithSequenceResponder:sequenceResponder];
+    XCTAssertEqual(responders.firstObject.responseCount, (NSUInteger)2, @"Sequence did not restart from the first responder");
+}
+
+
+- (void)testCancelResponseToProtocol
+{
+    UMKCountingMockURLResponder *repeatedResponder = [[UMKCountingMockURLResponder alloc] init];
+    UMKCountingMockURLResponder *otherResponder = [[UMKCountingMockURLResponder alloc] init];
+    UMKMockSequenceResponder *sequenceResponder =
+        [UMKMockSequenceResponder sequenceResponderWithResponders:@[ repeatedResponder, otherResponder, repeatedResponder ]];
+
+    // Responders that can't cancel individual responses should have all their responses canceled, but only once
+    [sequenceResponder cancelResponseToProtocol:self.URLProtocol];
+    XCTAssertEqual(repeatedResponder.cancelCount, (NSUInteger)1, @"Repeated responder not canceled exactly once");
+    XCTAssertEqual(otherResponder.cancelCount, (NSUInteger)1, @"Responder not canceled exactly once");
+
+    id<UMKMockURLResponseSession> session = [sequenceResponder responseSessionForMockRequest:self.mockRequest
+                                                                                      client:self.URLProtocolClient
+                                                                                    protocol:self.URLProtocol];
+    [session cancel];
+    XCTAssertEqual(repeatedResponder.cancelCount, (NSUInteger)2, @"Session did not cancel its responder");
+    XCTAssertEqual(otherResponder.cancelCount, (NSUInteger)1, @"Session canceled another responder");
+}
+
+
+- (void)testConcurrentRequestsClaimDistinctPositions
+{
+    const NSUInteger count = 10000;
+    NSArray<UMKCountingMockURLResponder *> *responders = UMKGeneratedArrayWithElementCount(count, ^id(NSUInteger index) {
+        return [[UMKCountingMockURLResponder alloc] init];
+    });
+
+    UMKMockSequenceResponder *sequenceResponder = [UMKMockSequenceResponder sequenceResponderWithResponders:responders];
+    id<UMKMockURLRequest> mockRequest = self.mockRequest;
+    id client = self.URLProtocolClient;
+    id protocol = self.URLProtocol;
+
+    dispatch_apply(count, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+        [sequenceResponder respondToMockRequest:mockRequest client:client protocol:protocol];
+    });
+
+    XCTAssertEqual(sequenceResponder.responseCount, count, @"Incorrect response count");
+    for (UMKCountingMockURLResponder *responder in responders) {
+        XCTAssertEqual(responder.responseCount, (NSUInteger)1, @"Position claimed more or less than once");
+    }
+}
+
+@end
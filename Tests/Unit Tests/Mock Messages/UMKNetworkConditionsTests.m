@@ -0,0 +1,143 @@
+//
+//  UMKNetworkConditionsTests.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import "UMKRandomizedTestCase.h"
+
+
+@interface UMKNetworkConditionsTests : UMKRandomizedTestCase
+
+- (void)testInit;
+- (void)testPreferredChunkLength;
+- (void)testProfiles;
+- (void)testEquality;
+- (void)testSampleJitter;
+
+@end
+
+
+@implementation UMKNetworkConditionsTests
+
+- (void)testInit
+{
+    NSUInteger bytesPerSecond = random() % 1000000;
+    NSTimeInterval roundTripTime = random() % 1000 / 1000.0;
+    NSTimeInterval jitter = random() % 100 / 1000.0;
+    uint64_t jitterSeed = random();
+
+    UMKNetworkConditions *conditions = [[UMKNetworkConditions alloc] initWithDownstreamBytesPerSecond:bytesPerSecond
+                                                                                        roundTripTime:roundTripTime
+                                                                                               jitter:jitter
+                                                                                           jitterSeed:jitterSeed];
+    XCTAssertEqual(conditions.downstreamBytesPerSecond, bytesPerSecond, @"Downstream rate is not set correctly");
+    XCTAssertEqual(conditions.roundTripTime, roundTripTime, @"Round-trip time is not set correctly");
+    XCTAssertEqual(conditions.jitter, jitter, @"Jitter is not set correctly");
+    XCTAssertEqual(conditions.jitterSeed, jitterSeed, @"Jitter seed is not set correctly");
+
+    conditions = [[UMKNetworkConditions alloc] initWithDownstreamBytesPerSecond:bytesPerSecond roundTripTime:roundTripTime jitter:jitter];
+    XCTAssertEqual(conditions.jitterSeed, 0, @"Jitter seed is not 0 by default");
+    XCTAssertThrows([[UMKNetworkConditions alloc] initWithDownstreamBytesPerSecond:0 roundTripTime:-1.0 jitter:0.0], @"Negative round-trip time allowed");
+    XCTAssertThrows([[UMKNetworkConditions alloc] initWithDownstreamBytesPerSecond:0 roundTripTime:0.0 jitter:-1.0], @"Negative jitter allowed");
+}
+
+
+- (void)testPreferredChunkLength
+{
+    UMKNetworkConditions *conditions = [[UMKNetworkConditions alloc] initWithDownstreamBytesPerSecond:0 roundTripTime:0.0 jitter:0.0];
+    XCTAssertEqual(conditions.preferredChunkLength, NSUIntegerMax, @"Unlimited bandwidth has a limited chunk length");
+
+    conditions = [[UMKNetworkConditions alloc] initWithDownstreamBytesPerSecond:100000 roundTripTime:0.0 jitter:0.0];
+    XCTAssertEqual(conditions.preferredChunkLength, 2000, @"Chunk length is not 20 ms of data");
+
+    conditions = [[UMKNetworkConditions alloc] initWithDownstreamBytesPerSecond:1000 roundTripTime:0.0 jitter:0.0];
+    XCTAssertEqual(conditions.preferredChunkLength, 1024, @"Chunk length is below the minimum");
+
+    conditions = [[UMKNetworkConditions alloc] initWithDownstreamBytesPerSecond:1000000000 roundTripTime:0.0 jitter:0.0];
+    XCTAssertEqual(conditions.preferredChunkLength, 64 * 1024, @"Chunk length is above the maximum");
+}
+
+
+- (void)testProfiles
+{
+    UMKNetworkConditions *conditions3G = [UMKNetworkConditions networkConditions3G];
+    UMKNetworkConditions *conditionsLTE = [UMKNetworkConditions networkConditionsLTE];
+    UMKNetworkConditions *conditionsWiFi = [UMKNetworkConditions networkConditionsWiFi];
+
+    XCTAssertLessThan(conditions3G.downstreamBytesPerSecond, conditionsLTE.downstreamBytesPerSecond, @"3G is faster than LTE");
+    XCTAssertLessThan(conditionsLTE.downstreamBytesPerSecond, conditionsWiFi.downstreamBytesPerSecond, @"LTE is faster than Wi-Fi");
+    XCTAssertGreaterThan(conditions3G.roundTripTime, conditionsLTE.roundTripTime, @"3G has less latency than LTE");
+    XCTAssertGreaterThan(conditionsLTE.roundTripTime, conditionsWiFi.roundTripTime, @"LTE has less latency than Wi-Fi");
+}
+
+
+- (void)testEquality
+{
+    UMKNetworkConditions *conditions = [UMKNetworkConditions networkConditionsLTE];
+    XCTAssertEqualObjects(conditions, [UMKNetworkConditions networkConditionsLTE], @"Equal conditions are not equal");
+    XCTAssertEqual(conditions.hash, [UMKNetworkConditions networkConditionsLTE].hash, @"Equal conditions have different hashes");
+    XCTAssertEqual([conditions copy], conditions, @"Copy is not the same instance");
+    XCTAssertNotEqualObjects(conditions, [UMKNetworkConditions networkConditions3G], @"Unequal conditions are equal");
+
+    UMKNetworkConditions *reseededConditions = [[UMKNetworkConditions alloc] initWithDownstreamBytesPerSecond:conditions.downstreamBytesPerSecond
+                                                                                                roundTripTime:conditions.roundTripTime
+                                                                                                       jitter:conditions.jitter
+                                                                                                   jitterSeed:conditions.jitterSeed + 1];
+    XCTAssertNotEqualObjects(conditions, reseededConditions, @"Conditions with different seeds are equal");
+}
+
+
+- (void)testSampleJitter
+{
+    NSTimeInterval jitter = random() % 100 / 1000.0 + 0.01;
+    uint64_t jitterSeed = random();
+    UMKNetworkConditions *conditions = [[UMKNetworkConditions alloc] initWithDownstreamBytesPerSecond:0
+                                                                                        roundTripTime:0.0
+                                                                                               jitter:jitter
+                                                                                           jitterSeed:jitterSeed];
+
+    NSMutableArray<NSNumber *> *samples = [[NSMutableArray alloc] init];
+    for (NSUInteger i = 0; i < 100; ++i) {
+        NSTimeInterval sample = [conditions sampleJitter];
+        XCTAssertGreaterThanOrEqual(sample, 0.0, @"Jitter sample is negative");
+        XCTAssertLessThan(sample, jitter, @"Jitter sample exceeds jitter");
+        [samples addObject:@(sample)];
+    }
+
+    XCTAssertGreaterThan([NSSet setWithArray:samples].count, 1, @"Every jitter sample is the same");
+
+    // The same seed produces the same sequence, whether in other conditions or after a reset
+    UMKNetworkConditions *twinConditions = [[UMKNetworkConditions alloc] initWithDownstreamBytesPerSecond:0
+                                                                                            roundTripTime:0.0
+                                                                                                   jitter:jitter
+                                                                                               jitterSeed:jitterSeed];
+    [conditions resetJitter];
+    for (NSNumber *sample in samples) {
+        XCTAssertEqual([twinConditions sampleJitter], sample.doubleValue, @"Jitter not reproducible from seed");
+        XCTAssertEqual([conditions sampleJitter], sample.doubleValue, @"Jitter not reproducible after reset");
+    }
+}
+
+@end
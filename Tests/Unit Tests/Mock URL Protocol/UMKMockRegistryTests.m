@@ -0,0 +1,431 @@
+//
+//  UMKMockRegistryTests.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import "UMKRandomizedTestCase.h"
+
+#import <stdatomic.h>
+
+
+@interface UMKMockRegistry (UMKPrivateMethods)
+
+- (NSUInteger)retiredExpectedMockRequestsSnapshotCount;
+
+@end
+
+
+@interface UMKMockRegistryTests : UMKRandomizedTestCase
+
+- (void)testDefaultRegistry;
+- (void)testProtocolClass;
+- (void)testRegisterWithSessionConfiguration;
+- (void)testRegistriesAreIndependent;
+- (void)testSessionsUseTheirRegistries;
+- (void)testVerificationCounts;
+- (void)testEventObservers;
+- (void)testEventDrivenWaits;
+- (void)testStatistics;
+- (void)testRetiredSnapshotsAreReleasedDuringConcurrentReads;
+
+@end
+
+
+@implementation UMKMockRegistryTests
+
+- (void)setUp
+{
+    [super setUp];
+    [UMKMockURLProtocol reset];
+}
+
+
+- (void)testDefaultRegistry
+{
+    UMKMockRegistry *defaultRegistry = [UMKMockRegistry defaultRegistry];
+    XCTAssertNotNil(defaultRegistry, @"Returns nil");
+    XCTAssertEqual([UMKMockRegistry defaultRegistry], defaultRegistry, @"Returns different registries");
+    XCTAssertEqual([UMKMockURLProtocol mockRegistry], defaultRegistry, @"Protocol does not use default registry");
+    XCTAssertEqual(defaultRegistry.protocolClass, [UMKMockURLProtocol class], @"Protocol class is incorrect");
+}
+
+
+- (void)testProtocolClass
+{
+    UMKMockRegistry *registry = [[UMKMockRegistry alloc] init];
+    Class protocolClass = registry.protocolClass;
+    XCTAssertNotNil(protocolClass, @"Returns nil");
+    XCTAssertEqual(registry.protocolClass, protocolClass, @"Returns different classes");
+    XCTAssertTrue([protocolClass isSubclassOfClass:[UMKMockURLProtocol class]], @"Not a subclass of UMKMockURLProtocol");
+    XCTAssertNotEqual(protocolClass, [UMKMockURLProtocol class], @"Uses UMKMockURLProtocol");
+    XCTAssertEqual([protocolClass mockRegistry], registry, @"Protocol class is not bound to registry");
+
+    UMKMockRegistry *otherRegistry = [[UMKMockRegistry alloc] init];
+    XCTAssertNotEqual(otherRegistry.protocolClass, protocolClass, @"Registries share a protocol class");
+}
+
+
+- (void)testRegisterWithSessionConfiguration
+{
+    UMKMockRegistry *registry = [[UMKMockRegistry alloc] init];
+    NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+    NSUInteger protocolClassCount = configuration.protocolClasses.count;
+
+    [registry registerWithSessionConfiguration:configuration];
+    XCTAssertEqual(configuration.protocolClasses.firstObject, registry.protocolClass, @"Protocol class not registered first");
+    XCTAssertEqual(configuration.protocolClasses.count, protocolClassCount + 1, @"Other protocol classes not preserved");
+
+    [registry registerWithSessionConfiguration:configuration];
+    XCTAssertEqual(configuration.protocolClasses.count, protocolClassCount + 1, @"Protocol class registered twice");
+}
+
+
+- (void)testRegistriesAreIndependent
+{
+    UMKMockRegistry *registry1 = [[UMKMockRegistry alloc] init];
+    UMKMockRegistry *registry2 = [[UMKMockRegistry alloc] init];
+
+    NSURL *URL = UMKRandomHTTPURL();
+    NSURLRequest *request = [NSURLRequest requestWithURL:URL];
+    UMKMockHTTPRequest *mockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:URL];
+    mockRequest.responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200];
+
+    [registry1 expectMockRequest:mockRequest];
+    XCTAssertEqualObjects(registry1.expectedMockRequests, @[ mockRequest ], @"Mock request not added");
+    XCTAssertEqualObjects(registry2.expectedMockRequests, @[], @"Mock request added to other registry");
+    XCTAssertEqualObjects([UMKMockURLProtocol expectedMockRequests], @[], @"Mock request added to default registry");
+
+    XCTAssertTrue([registry1.protocolClass canInitWithRequest:request], @"Registry's protocol cannot init with its mock request");
+    XCTAssertFalse([registry2.protocolClass canInitWithRequest:request], @"Protocol can init with another registry's mock request");
+    XCTAssertFalse([UMKMockURLProtocol canInitWithRequest:request], @"Default protocol can init with another registry's mock request");
+
+    // Verification is independent too
+    registry1.verificationEnabled = YES;
+    XCTAssertFalse(registry2.isVerificationEnabled, @"Verification enabled on other registry");
+    XCTAssertFalse([UMKMockURLProtocol isVerificationEnabled], @"Verification enabled on default registry");
+    XCTAssertThrows([registry2 verifyWithError:NULL], @"Verification not disabled");
+
+    NSError *error = nil;
+    XCTAssertFalse([registry1 verifyWithError:&error], @"Verified with unserviced mock request");
+    XCTAssertEqualObjects(error.userInfo[kUMKUnservicedMockRequestsKey], @[ mockRequest ], @"Unserviced mock requests are incorrect");
+
+    XCTAssertNotNil([[registry1.protocolClass alloc] initWithRequest:request cachedResponse:nil client:nil], @"Protocol not initialized");
+    XCTAssertEqualObjects(registry1.servicedRequests, @{ request : mockRequest }, @"Request not serviced");
+    XCTAssertEqualObjects(registry1.expectedMockRequests, @[], @"Mock request not removed");
+    XCTAssertTrue([registry1 verifyWithError:NULL], @"Did not verify");
+
+    XCTAssertNotNil([[registry1.protocolClass alloc] initWithRequest:request cachedResponse:nil client:nil], @"Protocol not initialized");
+    XCTAssertEqualObjects(registry1.unexpectedRequests, @[ request ], @"Unexpected request not recorded");
+    XCTAssertEqualObjects(registry2.unexpectedRequests, @[], @"Unexpected request recorded in other registry");
+    XCTAssertEqualObjects([UMKMockURLProtocol unexpectedRequests], @[], @"Unexpected request recorded in default registry");
+
+    [registry1 reset];
+    XCTAssertEqualObjects(registry1.unexpectedRequests, @[], @"Unexpected requests not reset");
+    XCTAssertEqualObjects(registry1.servicedRequests, @{ }, @"Serviced requests not reset");
+}
+
+
+- (void)testSessionsUseTheirRegistries
+{
+    NSURL *URL = UMKRandomHTTPURL();
+    NSArray<NSNumber *> *statusCodes = @[ @201, @202 ];
+
+    NSMutableArray<UMKMockRegistry *> *registries = [[NSMutableArray alloc] init];
+    NSMutableArray<NSURLSession *> *sessions = [[NSMutableArray alloc] init];
+    for (NSNumber *statusCode in statusCodes) {
+        UMKMockRegistry *registry = [[UMKMockRegistry alloc] init];
+        UMKMockHTTPRequest *mockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:URL];
+        mockRequest.responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:statusCode.integerValue];
+        [registry expectMockRequest:mockRequest];
+        [registries addObject:registry];
+
+        NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+        [registry registerWithSessionConfiguration:configuration];
+        [sessions addObject:[NSURLSession sessionWithConfiguration:configuration]];
+    }
+
+    // The same URL gets a different response in each session
+    [sessions enumerateObjectsUsingBlock:^(NSURLSession *session, NSUInteger i, BOOL *stop) {
+        XCTestExpectation *expectation = [self expectationWithDescription:@"Task completed"];
+        [[session dataTaskWithURL:URL completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+            XCTAssertNil(error, @"Task failed");
+            XCTAssertEqual([(NSHTTPURLResponse *)response statusCode], statusCodes[i].integerValue, @"Response from wrong registry");
+            [expectation fulfill];
+        }] resume];
+    }];
+
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+
+    for (NSURLSession *session in sessions) {
+        [session invalidateAndCancel];
+    }
+}
+
+
+- (void)testVerificationCounts
+{
+    UMKMockRegistry *registry = [[UMKMockRegistry alloc] init];
+    registry.verificationEnabled = YES;
+    XCTAssertEqual(registry.unexpectedRequestCount, 0, @"Initial unexpected request count is non-zero");
+    XCTAssertEqual(registry.unservicedMockRequestCount, 0, @"Initial unserviced mock request count is non-zero");
+
+    NSURL *URL = UMKRandomHTTPURL();
+    NSURLRequest *request = [NSURLRequest requestWithURL:URL];
+    UMKMockHTTPRequest *mockRequest1 = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:URL];
+    mockRequest1.responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200];
+    UMKMockHTTPRequest *mockRequest2 = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:UMKRandomHTTPURL()];
+
+    // Mock requests expected more than once are only counted once
+    [registry expectMockRequests:@[ mockRequest1, mockRequest2, mockRequest1 ]];
+    XCTAssertEqual(registry.unservicedMockRequestCount, 2, @"Unserviced mock request count is incorrect");
+
+    [registry removeExpectedMockRequest:mockRequest2];
+    XCTAssertEqual(registry.unservicedMockRequestCount, 1, @"Removed mock request still counted");
+
+    XCTAssertNotNil([[registry.protocolClass alloc] initWithRequest:request cachedResponse:nil client:nil], @"Protocol not initialized");
+    XCTAssertEqual(registry.unservicedMockRequestCount, 0, @"Serviced mock request still counted");
+    XCTAssertTrue([registry verifyWithError:NULL], @"Did not verify");
+
+    // Serviced mock requests stay serviced if they are expected again
+    [registry expectMockRequest:mockRequest1];
+    XCTAssertEqual(registry.unservicedMockRequestCount, 0, @"Serviced mock request counted");
+
+    XCTAssertNotNil([[registry.protocolClass alloc] initWithRequest:request cachedResponse:nil client:nil], @"Protocol not initialized");
+    XCTAssertNotNil([[registry.protocolClass alloc] initWithRequest:request cachedResponse:nil client:nil], @"Protocol not initialized");
+    XCTAssertEqual(registry.unexpectedRequestCount, 1, @"Unexpected request count is incorrect");
+
+    NSError *error = nil;
+    XCTAssertFalse([registry verifyWithError:&error], @"Verified with unexpected request");
+    XCTAssertEqualObjects(error.userInfo[kUMKUnexpectedRequestsKey], @[ request ], @"Unexpected requests are incorrect");
+    XCTAssertEqualObjects(error.userInfo[kUMKUnexpectedRequestCountKey], @1, @"Unexpected request count is incorrect");
+    XCTAssertNil(error.userInfo[kUMKUnexpectedRequestRecordsKey], @"Returned records for retained requests");
+    XCTAssertNil(error.userInfo[kUMKUnservicedMockRequestsKey], @"Returned unserviced mock requests");
+
+    // Without retained requests, errors still report the exact count and fall back on the journal
+    registry.retainsRequests = NO;
+    XCTAssertNotNil([[registry.protocolClass alloc] initWithRequest:request cachedResponse:nil client:nil], @"Protocol not initialized");
+    XCTAssertFalse([registry verifyWithError:&error], @"Verified with unexpected request");
+    XCTAssertEqualObjects(error.userInfo[kUMKUnexpectedRequestsKey], @[ request ], @"Unexpected requests are incorrect");
+    XCTAssertEqualObjects(error.userInfo[kUMKUnexpectedRequestCountKey], @2, @"Unexpected request count is incorrect");
+    XCTAssertEqual([error.userInfo[kUMKUnexpectedRequestRecordsKey] count], 2, @"Unexpected request records are incorrect");
+    registry.retainsRequests = YES;
+
+    [registry reset];
+    XCTAssertEqual(registry.unexpectedRequestCount, 0, @"Unexpected request count not reset");
+    XCTAssertEqual(registry.unservicedMockRequestCount, 0, @"Unserviced mock request count not reset");
+
+    [registry expectMockRequest:mockRequest1];
+    XCTAssertEqual(registry.unservicedMockRequestCount, 1, @"Serviced mock requests not reset");
+}
+
+
+- (void)testEventObservers
+{
+    UMKMockRegistry *registry = [[UMKMockRegistry alloc] init];
+
+    NSURLRequest *request = [NSURLRequest requestWithURL:UMKRandomHTTPURL()];
+    NSURLRequest *unexpectedRequest = [NSURLRequest requestWithURL:UMKRandomHTTPURL()];
+    UMKMockHTTPRequest *mockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:request.URL];
+    mockRequest.responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200];
+    [registry expectMockRequest:mockRequest];
+
+    NSMutableArray<UMKMockRegistryEvent *> *events = [[NSMutableArray alloc] init];
+    id<NSObject> observer = [registry addEventObserverUsingBlock:^(UMKMockRegistryEvent *event) {
+        [events addObject:event];
+    }];
+
+    XCTAssertNotNil([[registry.protocolClass alloc] initWithRequest:request cachedResponse:nil client:nil], @"Protocol not initialized");
+    XCTAssertNotNil([[registry.protocolClass alloc] initWithRequest:unexpectedRequest cachedResponse:nil client:nil], @"Protocol not initialized");
+
+    XCTAssertEqual(events.count, 2, @"Incorrect number of events");
+    XCTAssertEqual(events.firstObject.kind, UMKMockRegistryEventKindServiced, @"Incorrect event kind");
+    XCTAssertEqualObjects(events.firstObject.request, request, @"Incorrect event request");
+    XCTAssertEqual(events.firstObject.mockRequest, mockRequest, @"Incorrect event mock request");
+    XCTAssertEqual(events.lastObject.kind, UMKMockRegistryEventKindUnexpected, @"Incorrect event kind");
+    XCTAssertEqualObjects(events.lastObject.request, unexpectedRequest, @"Incorrect event request");
+    XCTAssertNil(events.lastObject.mockRequest, @"Unexpected event has mock request");
+    XCTAssertEqual([registry serviceCountForMockRequest:mockRequest], 1, @"Incorrect service count");
+
+    [registry removeEventObserver:observer];
+    XCTAssertNotNil([[registry.protocolClass alloc] initWithRequest:unexpectedRequest cachedResponse:nil client:nil], @"Protocol not initialized");
+    XCTAssertEqual(events.count, 2, @"Removed observer received event");
+
+    [registry reset];
+    XCTAssertEqual([registry serviceCountForMockRequest:mockRequest], 0, @"Service count not reset");
+}
+
+
+- (void)testEventDrivenWaits
+{
+    UMKMockRegistry *registry = [[UMKMockRegistry alloc] init];
+    NSURL *URL = UMKRandomHTTPURL();
+    UMKMockHTTPRequest *mockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:URL];
+    mockRequest.responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200];
+    [registry expectMockRequest:mockRequest];
+
+    // Nothing happens, so waits time out
+    XCTAssertFalse([registry waitForMockRequest:mockRequest serviceCount:1 timeout:0.05], @"Wait did not time out");
+    XCTAssertFalse([registry waitForExpectedMockRequestsToBeServicedWithTimeout:0.05], @"Wait did not time out");
+
+    XCTestExpectation *servicedExpectation = [self expectationWithDescription:@"Expected mock requests serviced"];
+    [registry waitForExpectedMockRequestsToBeServicedWithTimeout:5.0 completionHandler:^(BOOL serviced) {
+        XCTAssertTrue(serviced, @"Wait timed out");
+        [servicedExpectation fulfill];
+    }];
+
+    NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+    [registry registerWithSessionConfiguration:configuration];
+    NSURLSession *session = [NSURLSession sessionWithConfiguration:configuration];
+    [[session dataTaskWithURL:URL] resume];
+
+    XCTAssertTrue([registry waitForMockRequest:mockRequest serviceCount:1 timeout:5.0], @"Wait timed out");
+    XCTAssertTrue([registry waitForFinishedResponseCount:1 timeout:5.0], @"Wait timed out");
+    XCTAssertEqual(registry.finishedResponseCount, 1, @"Incorrect finished response count");
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+
+    [session invalidateAndCancel];
+}
+
+
+- (void)testStatistics
+{
+    UMKMockRegistry *registry = [[UMKMockRegistry alloc] init];
+    XCTAssertFalse(registry.isStatisticsEnabled, @"Statistics enabled by default");
+
+    NSURL *URL = UMKRandomHTTPURL();
+    UMKMockHTTPRequest *untrackedMockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:UMKRandomHTTPURL()];
+    [registry expectMockRequest:untrackedMockRequest];
+
+    registry.statisticsEnabled = YES;
+    UMKMockHTTPRequest *mockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:URL];
+    mockRequest.responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200 body:[UMKRandomUnicodeString() dataUsingEncoding:NSUTF8StringEncoding]];
+    UMKPatternMatchingMockRequest *patternMockRequest = [[UMKPatternMatchingMockRequest alloc] initWithURLPattern:@"http://example.com/:id"];
+    patternMockRequest.responderGenerationBlock = ^id<UMKMockURLResponder>(NSURLRequest *request, NSDictionary *parameters) {
+        return [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200];
+    };
+
+    [registry expectMockRequests:@[ mockRequest, patternMockRequest ]];
+    XCTAssertNil([registry statisticsForMockRequest:untrackedMockRequest], @"Statistics collected while disabled");
+
+    UMKMockRequestStatistics *statistics = [registry statisticsForMockRequest:mockRequest];
+    UMKMockRequestStatistics *patternStatistics = [registry statisticsForMockRequest:patternMockRequest];
+    XCTAssertNotNil(statistics, @"Statistics not collected");
+    XCTAssertEqual(statistics.mockRequest, mockRequest, @"Statistics for wrong mock request");
+    XCTAssertEqualObjects(registry.mockRequestStatistics, (@[ statistics, patternStatistics ]), @"Statistics are incorrect");
+
+    NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+    [registry registerWithSessionConfiguration:configuration];
+    NSURLSession *session = [NSURLSession sessionWithConfiguration:configuration];
+
+    // Probing whether a request can be handled doesn't service it, so it isn't recorded
+    for (NSUInteger i = 0; i < 3; ++i) {
+        XCTAssertTrue([registry.protocolClass canInitWithRequest:[NSURLRequest requestWithURL:URL]], @"Cannot init with expected request");
+    }
+
+    XCTAssertEqual(statistics.matchCount, 0, @"Probes recorded as matches");
+    XCTAssertEqual(statistics.evaluationCount, 0, @"Probes recorded as evaluations");
+
+    NSUInteger requestCount = 2 + random() % 5;
+    for (NSUInteger i = 0; i < requestCount; ++i) {
+        [[session dataTaskWithURL:URL] resume];
+    }
+
+    [[session dataTaskWithURL:[NSURL URLWithString:@"http://example.com/123"]] resume];
+    XCTAssertTrue([registry waitForFinishedResponseCount:requestCount + 1 timeout:5.0], @"Responses did not finish");
+
+    // However many times the URL loading system probes the protocol class, each serviced request is recorded once
+    XCTAssertEqual(statistics.matchCount, requestCount, @"Match count is incorrect");
+    XCTAssertEqual(statistics.evaluationCount, requestCount, @"Evaluation count is incorrect");
+    XCTAssertEqual(statistics.matchingTimeHistogram.count, statistics.evaluationCount, @"Matching times not recorded");
+    XCTAssertEqual(statistics.timeToFirstByteHistogram.count, requestCount, @"Times to first byte not recorded");
+    XCTAssertEqual(statistics.responseDurationHistogram.count, requestCount, @"Response durations not recorded");
+    XCTAssertLessThanOrEqual(statistics.timeToFirstByteHistogram.minimumDuration, statistics.responseDurationHistogram.maximumDuration,
+                             @"Time to first byte is longer than response duration");
+
+    XCTAssertEqual(patternStatistics.matchCount, 1, @"Match count is incorrect");
+    XCTAssertEqual(patternStatistics.evaluationCount, 1, @"Evaluation count is incorrect");
+    XCTAssertEqual(patternStatistics.responseDurationHistogram.count, 1, @"Response duration not recorded");
+
+    [session invalidateAndCancel];
+
+    [registry reset];
+    XCTAssertNil([registry statisticsForMockRequest:mockRequest], @"Statistics not reset");
+    XCTAssertEqualObjects(registry.mockRequestStatistics, @[], @"Statistics not reset");
+}
+
+
+- (void)testRetiredSnapshotsAreReleasedDuringConcurrentReads
+{
+    UMKMockRegistry *registry = [[UMKMockRegistry alloc] init];
+    [registry expectMockRequests:UMKGeneratedArrayWithElementCount(64, ^id(NSUInteger index) {
+        return [UMKMockHTTPRequest mockHTTPGetRequestWithURL:UMKRandomHTTPURL()];
+    })];
+
+    // Several readers run continuously and overlap one another, so there is rarely a moment without a reader
+    _Atomic(bool) readersShouldStop;
+    atomic_init(&readersShouldStop, false);
+    _Atomic(bool) *readersShouldStopPointer = &readersShouldStop;
+
+    // Readers release retired snapshots, so they report when the last one is gone once the mutations are done
+    _Atomic(bool) mutationsFinished;
+    atomic_init(&mutationsFinished, false);
+    _Atomic(bool) *mutationsFinishedPointer = &mutationsFinished;
+
+    _Atomic(bool) snapshotsReleased;
+    atomic_init(&snapshotsReleased, false);
+    _Atomic(bool) *snapshotsReleasedPointer = &snapshotsReleased;
+    XCTestExpectation *releasedExpectation = [self expectationWithDescription:@"Retired snapshots released"];
+
+    Class protocolClass = registry.protocolClass;
+    NSURLRequest *request = [NSURLRequest requestWithURL:UMKRandomHTTPURL()];
+    dispatch_group_t readerGroup = dispatch_group_create();
+    for (NSUInteger i = 0; i < 4; ++i) {
+        dispatch_group_async(readerGroup, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+            while (!atomic_load(readersShouldStopPointer)) {
+                [protocolClass canInitWithRequest:request];
+                if (atomic_load(mutationsFinishedPointer) && registry.retiredExpectedMockRequestsSnapshotCount == 0 &&
+                    !atomic_exchange(snapshotsReleasedPointer, true)) {
+                    [releasedExpectation fulfill];
+                }
+            }
+        });
+    }
+
+    // Every mutation retires the snapshot the readers were using
+    NSUInteger mutationCount = 1000 + random() % 1000;
+    for (NSUInteger i = 0; i < mutationCount; ++i) {
+        UMKMockHTTPRequest *mockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:UMKRandomHTTPURL()];
+        [registry expectMockRequest:mockRequest];
+        [registry removeExpectedMockRequest:mockRequest];
+    }
+
+    atomic_store(&mutationsFinished, true);
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+
+    atomic_store(&readersShouldStop, true);
+    dispatch_group_wait(readerGroup, DISPATCH_TIME_FOREVER);
+    XCTAssertEqual(registry.expectedMockRequests.count, 64, @"Expected mock requests are incorrect");
+}
+
+@end
@@ -29,11 +29,50 @@
 #import <OCMock/OCMock.h>
 
 
+@interface UMKMockURLProtocol (UMKPrivateMethods)
+
++ (id<UMKMockURLRequest>)expectedMockRequestMatchingURLRequest:(NSURLRequest *)request;
+
+@end
+
+
+#pragma mark - UMKRejectingMockHTTPRequest
+
+/*!
+ UMKRejectingMockHTTPRequests override -matchesURLRequest: to never match, but not -matchesURLRequest:context:.
+ */
+@interface UMKRejectingMockHTTPRequest : UMKMockHTTPRequest
+
+@end
+
+
+@implementation UMKRejectingMockHTTPRequest
+
+- (BOOL)matchesURLRequest:(NSURLRequest *)request
+{
+    return NO;
+}
+
+@end
+
+
+#pragma mark -
+
 @interface UMKMockURLProtocolTests : UMKRandomizedTestCase
 
 - (void)testReset;
 - (void)testVerificationEnabledAccessors;
 - (void)testExpectedMockRequestsAccessors;
+- (void)testExpectedMockRequestsBulkAccessors;
+- (void)testExpectedMockRequestsConcurrentAccess;
+- (void)testExpectedMockRequestMatchingURLRequest;
+- (void)testExpectedMockRequestMatchingURLPatterns;
+- (void)testExpectedMockRequestMatchingOverriddenMatchesURLRequest;
+- (void)testInitReusesMatchFromCanInit;
+- (void)testInitClaimsOneShotMockRequestsOnce;
+- (void)testStopLoadingCancelsOnlyItsResponse;
+- (void)testCanonicalURL;
+- (void)testCanonicalURLCache;
 
 @end
 
@@ -96,6 +135,274 @@
 }
 
 
+- (void)testExpectedMockRequestsBulkAccessors
+{
+    NSURL *URL = UMKRandomHTTPURL();
+    NSURLRequest *request = [NSURLRequest requestWithURL:URL];
+
+    UMKMockHTTPRequest *mockRequest1 = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:URL];
+    UMKMockHTTPRequest *mockRequest2 = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:URL];
+    UMKPatternMatchingMockRequest *patternRequest = [[UMKPatternMatchingMockRequest alloc] initWithURLPattern:@"http://example.com/:id"];
+    id<UMKMockURLRequest> opaqueMockRequest = [OCMockObject niceMockForProtocol:@protocol(UMKMockURLRequest)];
+
+    [UMKMockURLProtocol expectMockRequests:@[]];
+    XCTAssertEqualObjects([UMKMockURLProtocol expectedMockRequests], @[], @"Mock requests added");
+
+    // Bulk additions preserve order, both among themselves and with individual additions
+    [UMKMockURLProtocol expectMockRequest:mockRequest1];
+    [UMKMockURLProtocol expectMockRequests:@[ patternRequest, opaqueMockRequest, mockRequest2 ]];
+    XCTAssertEqualObjects([UMKMockURLProtocol expectedMockRequests], (@[ mockRequest1, patternRequest, opaqueMockRequest, mockRequest2 ]),
+                          @"Mock requests not added in order");
+    XCTAssertEqual([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:request], mockRequest1, @"Did not return first match");
+
+    [UMKMockURLProtocol removeExpectedMockRequests:@[ mockRequest1, opaqueMockRequest ]];
+    XCTAssertEqualObjects([UMKMockURLProtocol expectedMockRequests], (@[ patternRequest, mockRequest2 ]), @"Mock requests not removed");
+    XCTAssertEqual([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:request], mockRequest2, @"Did not return remaining match");
+
+    // Removing mock requests that aren't expected has no effect
+    [UMKMockURLProtocol removeExpectedMockRequests:@[ mockRequest1 ]];
+    XCTAssertEqualObjects([UMKMockURLProtocol expectedMockRequests], (@[ patternRequest, mockRequest2 ]), @"Mock requests removed");
+
+    [UMKMockURLProtocol removeExpectedMockRequests:@[ mockRequest2, patternRequest ]];
+    XCTAssertEqualObjects([UMKMockURLProtocol expectedMockRequests], @[], @"Mock requests not removed");
+    XCTAssertNil([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:request], @"Matched removed mock request");
+}
+
+
+- (void)testExpectedMockRequestsConcurrentAccess
+{
+    NSURL *URL = UMKRandomHTTPURL();
+    NSURLRequest *request = [NSURLRequest requestWithURL:URL];
+    UMKMockHTTPRequest *mockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:URL];
+    [UMKMockURLProtocol expectMockRequest:mockRequest];
+
+    // Readers always see a consistent snapshot, no matter how many writers are adding and removing mock requests
+    const size_t iterationCount = 1000;
+    dispatch_apply(iterationCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        if (i % 2 == 0) {
+            UMKMockHTTPRequest *otherMockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:UMKRandomHTTPURL()];
+            [UMKMockURLProtocol expectMockRequest:otherMockRequest];
+            [UMKMockURLProtocol removeExpectedMockRequest:otherMockRequest];
+        } else {
+            XCTAssertEqual([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:request], mockRequest, @"Did not return match");
+            XCTAssertEqual([UMKMockURLProtocol expectedMockRequests].firstObject, mockRequest, @"Incorrect expected mock requests");
+        }
+    });
+
+    XCTAssertEqualObjects([UMKMockURLProtocol expectedMockRequests], @[ mockRequest ], @"Mock requests not removed");
+}
+
+
+- (void)testExpectedMockRequestMatchingURLRequest
+{
+    NSURL *URL = UMKRandomHTTPURL();
+    NSURLRequest *request = [NSURLRequest requestWithURL:URL];
+
+    UMKMockHTTPRequest *mockRequest1 = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:URL];
+    UMKMockHTTPRequest *mockRequest2 = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:URL];
+    UMKMockHTTPRequest *postRequest = [UMKMockHTTPRequest mockHTTPPostRequestWithURL:URL];
+
+    id opaqueMockRequest = [OCMockObject niceMockForProtocol:@protocol(UMKMockURLRequest)];
+    [[[opaqueMockRequest stub] andReturnValue:@YES] matchesURLRequest:OCMOCK_ANY];
+
+    XCTAssertNil([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:request], @"Matched with no expected mock requests");
+
+    [UMKMockURLProtocol expectMockRequest:postRequest];
+    XCTAssertNil([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:request], @"Matched mock request with wrong method");
+
+    // The first registered mock request wins, whether it is indexed or opaque
+    [UMKMockURLProtocol expectMockRequest:mockRequest1];
+    [UMKMockURLProtocol expectMockRequest:opaqueMockRequest];
+    [UMKMockURLProtocol expectMockRequest:mockRequest2];
+    XCTAssertEqual([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:request], mockRequest1, @"Did not return first match");
+
+    [UMKMockURLProtocol removeExpectedMockRequest:mockRequest1];
+    XCTAssertEqual([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:request], opaqueMockRequest, @"Did not return first match");
+
+    [UMKMockURLProtocol removeExpectedMockRequest:opaqueMockRequest];
+    XCTAssertEqual([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:request], mockRequest2, @"Did not return first match");
+
+    // Matching the index key alone is not enough; the mock request still has to match the body
+    [UMKMockURLProtocol removeExpectedMockRequest:mockRequest2];
+    [mockRequest1 setBodyWithString:UMKRandomUnicodeString()];
+    [UMKMockURLProtocol expectMockRequest:mockRequest1];
+    XCTAssertNil([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:request], @"Matched mock request with wrong body");
+}
+
+
+- (void)testExpectedMockRequestMatchingOverriddenMatchesURLRequest
+{
+    NSURL *URL = UMKRandomHTTPURL();
+    NSURLRequest *request = [NSURLRequest requestWithURL:URL];
+
+    // Subclasses that only override -matchesURLRequest: must not be matched using the superclass's context variant
+    [UMKMockURLProtocol expectMockRequest:[UMKRejectingMockHTTPRequest mockHTTPGetRequestWithURL:URL]];
+    XCTAssertNil([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:request], @"Override of -matchesURLRequest: ignored");
+
+    // Strict mocks that only stub -matchesURLRequest: raise an exception if they are sent the context variant
+    id mockRequest = [OCMockObject mockForProtocol:@protocol(UMKMockURLRequest)];
+    [[[mockRequest stub] andReturnValue:@YES] matchesURLRequest:request];
+
+    [UMKMockURLProtocol expectMockRequest:mockRequest];
+    XCTAssertEqual([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:request], mockRequest, @"Did not match mock");
+}
+
+
+- (void)testExpectedMockRequestMatchingURLPatterns
+{
+    NSURLRequest *(^requestWithURLString)(NSString *) = ^NSURLRequest *(NSString *URLString) {
+        return [NSURLRequest requestWithURL:[NSURL URLWithString:URLString]];
+    };
+
+    UMKPatternMatchingMockRequest *userRequest = [[UMKPatternMatchingMockRequest alloc] initWithURLPattern:@"http://example.com/users/:id"];
+    UMKPatternMatchingMockRequest *meRequest = [[UMKPatternMatchingMockRequest alloc] initWithURLPattern:@"http://example.com/users/me"];
+    UMKPatternMatchingMockRequest *postRequest = [[UMKPatternMatchingMockRequest alloc] initWithURLPattern:@"http://example.com/users/:id/posts/:post"];
+    UMKPatternMatchingMockRequest *fileRequest = [[UMKPatternMatchingMockRequest alloc] initWithURLPattern:@"http://example.com/files/:path"];
+    UMKPatternMatchingMockRequest *rawRequest = [[UMKPatternMatchingMockRequest alloc] initWithURLPattern:@"http://example.com/raw/:path/raw"];
+    UMKPatternMatchingMockRequest *escapedRequest = [[UMKPatternMatchingMockRequest alloc] initWithURLPattern:@"http://example\\.com/escaped/:id"];
+
+    __block NSDictionary *postParameters = nil;
+    postRequest.requestMatchingBlock = ^BOOL(NSURLRequest *request, NSDictionary *parameters) {
+        postParameters = parameters;
+        return ![parameters[@"post"] isEqualToString:@"0"];
+    };
+
+    [UMKMockURLProtocol expectMockRequest:userRequest];
+    [UMKMockURLProtocol expectMockRequest:meRequest];
+    [UMKMockURLProtocol expectMockRequest:postRequest];
+    [UMKMockURLProtocol expectMockRequest:fileRequest];
+    [UMKMockURLProtocol expectMockRequest:rawRequest];
+    [UMKMockURLProtocol expectMockRequest:escapedRequest];
+
+    // Registration order decides ties between parameters and literals
+    XCTAssertEqual([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:requestWithURLString(@"http://example.com/users/me")], userRequest,
+                   @"Did not return first match");
+    [UMKMockURLProtocol removeExpectedMockRequest:userRequest];
+    XCTAssertEqual([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:requestWithURLString(@"http://example.com/users/me")], meRequest,
+                   @"Did not return first match");
+    XCTAssertNil([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:requestWithURLString(@"http://example.com/users/1")],
+                 @"Matched removed mock request");
+
+    // Parameters are passed to the request matching block
+    XCTAssertEqual([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:requestWithURLString(@"http://example.com/users/1/posts/2")], postRequest,
+                   @"Did not match nested pattern");
+    XCTAssertEqualObjects(postParameters, (@{ @"id" : @"1", @"post" : @"2" }), @"Incorrect parameters");
+    XCTAssertNil([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:requestWithURLString(@"http://example.com/users/1/posts/0")],
+                 @"Matched mock request whose matching block failed");
+
+    // Trailing parameters match several segments; other parameters can too
+    XCTAssertEqual([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:requestWithURLString(@"http://example.com/files/a/b/c")], fileRequest,
+                   @"Did not match trailing parameter");
+    XCTAssertEqual([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:requestWithURLString(@"http://example.com/raw/a/b/raw")], rawRequest,
+                   @"Did not match parameter spanning segments");
+    XCTAssertNil([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:requestWithURLString(@"http://example.com/raw/raw")],
+                 @"Matched empty parameter");
+
+    // Patterns that cannot be compiled are still matched
+    XCTAssertEqual([UMKMockURLProtocol expectedMockRequestMatchingURLRequest:requestWithURLString(@"http://example.com/escaped/1")], escapedRequest,
+                   @"Did not match escaped pattern");
+}
+
+
+- (void)testInitReusesMatchFromCanInit
+{
+    NSURLRequest *request = [NSURLRequest requestWithURL:UMKRandomHTTPURL()];
+    id responder = [OCMockObject niceMockForProtocol:@protocol(UMKMockURLResponder)];
+
+    // The mock request is strict, so matching it a second time will raise an exception
+    id mockRequest = [OCMockObject mockForProtocol:@protocol(UMKMockURLRequest)];
+    [[[mockRequest expect] andReturnValue:@YES] matchesURLRequest:request];
+    [[[mockRequest stub] andReturn:responder] responderForURLRequest:request];
+
+    [UMKMockURLProtocol expectMockRequest:mockRequest];
+    XCTAssertTrue([UMKMockURLProtocol canInitWithRequest:request], @"Could not init with matching request");
+
+    UMKMockURLProtocol *protocol = [[UMKMockURLProtocol alloc] initWithRequest:request cachedResponse:nil client:nil];
+    XCTAssertNotNil(protocol, @"Protocol not initialized");
+    XCTAssertEqual([UMKMockURLProtocol unexpectedRequests].count, 0, @"Request treated as unexpected");
+    XCTAssertNoThrow([mockRequest verify], @"Mock request not matched");
+
+    // If the expected mock requests change after canInitWithRequest:, the match is not reused
+    mockRequest = [OCMockObject niceMockForProtocol:@protocol(UMKMockURLRequest)];
+    [[[mockRequest stub] andReturnValue:@YES] matchesURLRequest:request];
+    [[[mockRequest stub] andReturn:responder] responderForURLRequest:request];
+
+    [UMKMockURLProtocol expectMockRequest:mockRequest];
+    XCTAssertTrue([UMKMockURLProtocol canInitWithRequest:request], @"Could not init with matching request");
+    [UMKMockURLProtocol removeExpectedMockRequest:mockRequest];
+
+    protocol = [[UMKMockURLProtocol alloc] initWithRequest:request cachedResponse:nil client:nil];
+    XCTAssertNotNil(protocol, @"Protocol not initialized");
+    XCTAssertEqualObjects([UMKMockURLProtocol unexpectedRequests], @[ request ], @"Request not treated as unexpected");
+}
+
+
+- (void)testInitClaimsOneShotMockRequestsOnce
+{
+    NSURL *URL = UMKRandomHTTPURL();
+    UMKMockHTTPRequest *mockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:URL];
+    mockRequest.responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200];
+
+    [UMKMockURLProtocol setVerificationEnabled:YES];
+    [UMKMockURLProtocol expectMockRequest:mockRequest];
+
+    // However many protocol instances race to match the mock request, only one of them gets it
+    const size_t protocolCount = 64;
+    dispatch_apply(protocolCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        NSURLRequest *request = [NSURLRequest requestWithURL:URL];
+        XCTAssertNotNil([[UMKMockURLProtocol alloc] initWithRequest:request cachedResponse:nil client:nil], @"Protocol not initialized");
+    });
+
+    XCTAssertEqual([UMKMockURLProtocol unexpectedRequests].count, protocolCount - 1, @"One-shot mock request used more than once");
+    XCTAssertEqualObjects([UMKMockURLProtocol expectedMockRequests], @[], @"Mock request not removed");
+    [UMKMockURLProtocol setVerificationEnabled:NO];
+}
+
+
+- (void)testStopLoadingCancelsOnlyItsResponse
+{
+    NSURLRequest *request = [NSURLRequest requestWithURL:UMKRandomHTTPURL()];
+    UMKMockHTTPResponder *responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200];
+    responder.latencyModel = [UMKLatencyModel fixedLatencyModelWithLatency:1.0];
+
+    id mockRequest = [OCMockObject niceMockForProtocol:@protocol(UMKMockURLRequest)];
+    [[[mockRequest stub] andReturnValue:@YES] matchesURLRequest:request];
+    [[[mockRequest stub] andReturn:responder] responderForURLRequest:request];
+    [UMKMockURLProtocol expectMockRequest:mockRequest];
+
+    UMKVirtualClock *clock = [[UMKVirtualClock alloc] initWithMode:UMKVirtualClockModeManual];
+    [UMKVirtualClock setDefaultClock:clock];
+
+    // Every protocol instance shares the same responder, but each owns its own response
+    const NSUInteger protocolCount = 16;
+    NSMutableArray<UMKMockURLProtocol *> *protocols = [[NSMutableArray alloc] initWithCapacity:protocolCount];
+    NSMutableArray *clients = [[NSMutableArray alloc] initWithCapacity:protocolCount];
+    for (NSUInteger i = 0; i < protocolCount; ++i) {
+        id client = [OCMockObject niceMockForProtocol:@protocol(NSURLProtocolClient)];
+        UMKMockURLProtocol *protocol = [[UMKMockURLProtocol alloc] initWithRequest:request cachedResponse:nil client:client];
+        if (i == 0) {
+            [[client reject] URLProtocolDidFinishLoading:OCMOCK_ANY];
+        } else {
+            [[client expect] URLProtocolDidFinishLoading:protocol];
+        }
+
+        [protocol startLoading];
+        [protocols addObject:protocol];
+        [clients addObject:client];
+    }
+
+    [protocols.firstObject stopLoading];
+    [clock advanceByTimeInterval:1.0];
+    [UMKVirtualClock setDefaultClock:nil];
+
+    for (id client in clients) {
+        XCTAssertNoThrow([client verify], @"Stopping one request affected another");
+    }
+
+    [protocols makeObjectsPerformSelector:@selector(stopLoading)];
+}
+
+
 - (void)testCanonicalURL
 {
     XCTAssertNil([UMKMockURLProtocol canonicalURLForURL:nil], @"returns non-nil for nil URL");
@@ -119,6 +426,60 @@
     XCTAssertEqualObjects(canonicalURL5.absoluteString,
                           @"http://domain?arg=bar&arg=baz&arg=foo&arg=quux&arg=quuz&arg=qux",
                           @"canonical URL should have consistent order of set parameters");
+
+    // Queries that are already canonical are returned unchanged
+    NSURL *testURL6 = [NSURL URLWithString:@"http://domain?a=foo&B=bar&c&d="];
+    XCTAssertEqualObjects([UMKMockURLProtocol canonicalURLForURL:testURL6], testURL6, @"canonical query should not be changed");
+
+    // Queries that look almost canonical are still canonicalized
+    NSURL *testURL7 = [NSURL URLWithString:@"http://domain?a=1&a=2&b=3&"];
+    XCTAssertEqualObjects([UMKMockURLProtocol canonicalURLForURL:testURL7].absoluteString, @"http://domain?a=1&a=2&b=3",
+                          @"repeated keys and trailing ampersand should be canonicalized");
+
+    NSURL *testURL8 = [NSURL URLWithString:@"http://domain?a=%7E&b=c+d"];
+    XCTAssertEqualObjects([UMKMockURLProtocol canonicalURLForURL:testURL8].absoluteString, @"http://domain?a=~&b=c%2Bd",
+                          @"encoded characters should be canonicalized");
+}
+
+
+- (void)testCanonicalURLCache
+{
+    NSUInteger originalCapacity = [UMKMockURLProtocol canonicalURLCacheCapacity];
+    [UMKMockURLProtocol setCanonicalURLCacheCapacity:2];
+    XCTAssertEqual([UMKMockURLProtocol canonicalURLCacheCapacity], 2, @"Capacity not set");
+    XCTAssertEqual([UMKMockURLProtocol canonicalURLCacheHitCount], 0, @"Hit count not reset");
+    XCTAssertEqual([UMKMockURLProtocol canonicalURLCacheMissCount], 0, @"Miss count not reset");
+
+    // URLs without queries are not cached
+    [UMKMockURLProtocol canonicalURLForURL:[NSURL URLWithString:@"http://domain/path"]];
+    XCTAssertEqual([UMKMockURLProtocol canonicalURLCacheMissCount], 0, @"URL without query counted");
+
+    NSURL *URL1 = [NSURL URLWithString:@"http://domain?b=2&a=1"];
+    NSURL *URL2 = [NSURL URLWithString:@"http://domain?d=4&c=3"];
+    NSURL *URL3 = [NSURL URLWithString:@"http://domain?f=6&e=5"];
+
+    NSURL *canonicalURL1 = [UMKMockURLProtocol canonicalURLForURL:URL1];
+    XCTAssertEqualObjects([UMKMockURLProtocol canonicalURLForURL:URL1], canonicalURL1, @"Cached URL is incorrect");
+    XCTAssertEqual([UMKMockURLProtocol canonicalURLCacheHitCount], 1, @"Hit not counted");
+    XCTAssertEqual([UMKMockURLProtocol canonicalURLCacheMissCount], 1, @"Miss not counted");
+
+    // Adding a third URL evicts the least recently used one
+    [UMKMockURLProtocol canonicalURLForURL:URL2];
+    [UMKMockURLProtocol canonicalURLForURL:URL1];
+    [UMKMockURLProtocol canonicalURLForURL:URL3];
+    XCTAssertEqual([UMKMockURLProtocol canonicalURLCacheHitCount], 2, @"Hit not counted");
+    XCTAssertEqual([UMKMockURLProtocol canonicalURLCacheMissCount], 3, @"Miss not counted");
+
+    [UMKMockURLProtocol canonicalURLForURL:URL1];
+    XCTAssertEqual([UMKMockURLProtocol canonicalURLCacheHitCount], 3, @"Recently used URL was evicted");
+    [UMKMockURLProtocol canonicalURLForURL:URL2];
+    XCTAssertEqual([UMKMockURLProtocol canonicalURLCacheMissCount], 4, @"Least recently used URL was not evicted");
+
+    [UMKMockURLProtocol removeAllCachedCanonicalURLs];
+    XCTAssertEqual([UMKMockURLProtocol canonicalURLCacheHitCount], 0, @"Hit count not reset");
+    XCTAssertEqual([UMKMockURLProtocol canonicalURLCacheMissCount], 0, @"Miss count not reset");
+
+    [UMKMockURLProtocol setCanonicalURLCacheCapacity:originalCapacity];
 }
 
 @end
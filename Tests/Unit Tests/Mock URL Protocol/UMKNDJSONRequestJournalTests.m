@@ -0,0 +1,260 @@
+//
+//  UMKNDJSONRequestJournalTests.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import "UMKRandomizedTestCase.h"
+
+
+@interface UMKNDJSONRequestJournalTests : UMKRandomizedTestCase
+
+@property (nonatomic, copy) NSURL *fileURL;
+
+- (void)testJournalSendsRecordsToSink;
+- (void)testSinkInitFailsForInvalidFile;
+- (void)testSinkWritesRecordsThatReaderReads;
+- (void)testSinkWritesFullBatchesWithoutWaitingForFlushInterval;
+- (void)testSinkDiscardsRecordsAfterClose;
+- (void)testReaderStops;
+- (void)testReaderReadsUnterminatedLastLine;
+- (void)testReaderFailsForMalformedRecord;
+
+@end
+
+
+@implementation UMKNDJSONRequestJournalTests
+
+- (void)setUp
+{
+    [super setUp];
+    NSString *fileName = [NSString stringWithFormat:@"%@.ndjson", [NSUUID UUID].UUIDString];
+    self.fileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:fileName]];
+}
+
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtURL:self.fileURL error:NULL];
+    [super tearDown];
+}
+
+
+- (UMKRequestJournalRecord *)randomRecord
+{
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:UMKRandomHTTPURL()];
+    request.HTTPBody = [UMKRandomUnicodeString() dataUsingEncoding:NSUTF8StringEncoding];
+    UMKRequestJournalRecordKind kind = random() % 2 ? UMKRequestJournalRecordKindServiced : UMKRequestJournalRecordKindUnexpected;
+    id<UMKMockURLRequest> mockRequest = kind == UMKRequestJournalRecordKindServiced ? [UMKMockHTTPRequest mockHTTPGetRequestWithURL:request.URL] : nil;
+    return [[UMKRequestJournalRecord alloc] initWithURLRequest:request kind:kind mockRequest:mockRequest];
+}
+
+
+- (NSArray<NSDictionary *> *)readRecords
+{
+    NSMutableArray<NSDictionary *> *records = [[NSMutableArray alloc] init];
+    UMKNDJSONRequestJournalReader *reader = [[UMKNDJSONRequestJournalReader alloc] initWithFileURL:self.fileURL];
+    NSError *error = nil;
+    XCTAssertTrue([reader enumerateRecordsUsingBlock:^(NSDictionary *record, BOOL *stop) {
+        [records addObject:record];
+    } error:&error], @"Could not read records: %@", error);
+
+    return records;
+}
+
+
+/*! Timestamps may not survive the round trip through JSON exactly, so records are compared without them. */
+- (NSArray<NSDictionary *> *)recordsWithoutTimestamps:(NSArray<NSDictionary *> *)records
+{
+    NSMutableArray<NSDictionary *> *recordsWithoutTimestamps = [[NSMutableArray alloc] initWithCapacity:records.count];
+    for (NSDictionary *record in records) {
+        NSMutableDictionary *recordWithoutTimestamp = [record mutableCopy];
+        [recordWithoutTimestamp removeObjectForKey:@"timestamp"];
+        [recordsWithoutTimestamps addObject:recordWithoutTimestamp];
+    }
+
+    return recordsWithoutTimestamps;
+}
+
+
+- (void)writeString:(NSString *)string
+{
+    XCTAssertTrue([string writeToURL:self.fileURL atomically:YES encoding:NSUTF8StringEncoding error:NULL], @"Could not write file");
+}
+
+
+- (void)testJournalSendsRecordsToSink
+{
+    UMKRequestJournal *journal = [[UMKRequestJournal alloc] initWithCapacity:0 byteBudget:0];
+    id sink = [OCMockObject mockForProtocol:@protocol(UMKRequestJournalSink)];
+    journal.sink = sink;
+
+    // Records are sent to the sink even if the journal doesn't retain them
+    UMKRequestJournalRecord *record = [self randomRecord];
+    [[sink expect] requestJournal:journal didAddRecord:record];
+    [journal addRecord:record];
+    XCTAssertNoThrow([sink verify], @"Record not sent to sink");
+
+    [UMKMockURLProtocol setRequestJournalSink:sink];
+    XCTAssertEqual([UMKMockURLProtocol requestJournalSink], sink, @"Sink not set on default registry's journal");
+    XCTAssertEqual([UMKMockRegistry defaultRegistry].journal.sink, sink, @"Sink not set on default registry's journal");
+    [UMKMockURLProtocol setRequestJournalSink:nil];
+}
+
+
+- (void)testSinkInitFailsForInvalidFile
+{
+    NSURL *fileURL = [self.fileURL URLByAppendingPathComponent:@"missing-directory/journal.ndjson"];
+    NSError *error = nil;
+    XCTAssertNil([[UMKNDJSONRequestJournalSink alloc] initWithFileURL:fileURL error:&error], @"Returned non-nil for invalid file");
+    XCTAssertEqualObjects(error.domain, NSPOSIXErrorDomain, @"Error domain is incorrect");
+}
+
+
+- (void)testSinkWritesRecordsThatReaderReads
+{
+    NSError *error = nil;
+    UMKNDJSONRequestJournalSink *sink = [[UMKNDJSONRequestJournalSink alloc] initWithFileURL:self.fileURL error:&error];
+    XCTAssertNotNil(sink, @"Could not create sink: %@", error);
+    XCTAssertEqualObjects(sink.fileURL, self.fileURL, @"File URL is set incorrectly");
+    XCTAssertEqual(sink.batchByteCount, 64 * 1024, @"Default batch byte count is incorrect");
+    XCTAssertEqual(sink.flushInterval, 1.0, @"Default flush interval is incorrect");
+
+    UMKRequestJournal *journal = [[UMKRequestJournal alloc] initWithCapacity:1 byteBudget:NSUIntegerMax];
+    journal.sink = sink;
+
+    NSUInteger recordCount = 100 + random() % 100;
+    NSMutableArray<NSDictionary *> *JSONObjects = [[NSMutableArray alloc] initWithCapacity:recordCount];
+    for (NSUInteger i = 0; i < recordCount; ++i) {
+        UMKRequestJournalRecord *record = [self randomRecord];
+        [JSONObjects addObject:record.JSONObject];
+        [journal addRecord:record];
+    }
+
+    [sink flush];
+    XCTAssertEqual(sink.writtenRecordCount, recordCount, @"Written record count is incorrect");
+    XCTAssertNil(sink.lastError, @"Write failed");
+    NSArray<NSDictionary *> *records = [self readRecords];
+    XCTAssertEqualObjects([self recordsWithoutTimestamps:records], [self recordsWithoutTimestamps:JSONObjects], @"Read records differ from written records");
+    XCTAssertEqualWithAccuracy([records.lastObject[@"timestamp"] doubleValue], [JSONObjects.lastObject[@"timestamp"] doubleValue], 0.001,
+                               @"Timestamp read incorrectly");
+
+    // New sinks append to the file
+    sink = [[UMKNDJSONRequestJournalSink alloc] initWithFileURL:self.fileURL error:NULL];
+    UMKRequestJournalRecord *record = [self randomRecord];
+    [sink requestJournal:journal didAddRecord:record];
+    [sink close];
+    XCTAssertEqualObjects([self recordsWithoutTimestamps:[self readRecords]].lastObject, [self recordsWithoutTimestamps:@[ record.JSONObject ]].lastObject,
+                          @"Record not appended");
+    XCTAssertEqual([self readRecords].count, recordCount + 1, @"Existing records not preserved");
+}
+
+
+- (void)testSinkWritesFullBatchesWithoutWaitingForFlushInterval
+{
+    UMKNDJSONRequestJournalSink *sink = [[UMKNDJSONRequestJournalSink alloc] initWithFileURL:self.fileURL
+                                                                               batchByteCount:1
+                                                                                flushInterval:3600
+                                                                                        error:NULL];
+    UMKRequestJournal *journal = [[UMKRequestJournal alloc] init];
+    journal.sink = sink;
+    [journal addRecord:[self randomRecord]];
+
+    UMKAssertTrueBeforeTimeout(5, sink.writtenRecordCount == 1, @"Full batch not written");
+    XCTAssertEqual([self readRecords].count, 1, @"Full batch not written to the file");
+}
+
+
+- (void)testSinkDiscardsRecordsAfterClose
+{
+    UMKNDJSONRequestJournalSink *sink = [[UMKNDJSONRequestJournalSink alloc] initWithFileURL:self.fileURL error:NULL];
+    UMKRequestJournal *journal = [[UMKRequestJournal alloc] init];
+    journal.sink = sink;
+
+    [journal addRecord:[self randomRecord]];
+    [sink close];
+    [journal addRecord:[self randomRecord]];
+    [sink flush];
+
+    XCTAssertEqual(sink.writtenRecordCount, 1, @"Record written after close");
+    XCTAssertEqual([self readRecords].count, 1, @"Record written after close");
+}
+
+
+- (void)testReaderStops
+{
+    [self writeString:@"{\"kind\":\"serviced\"}\n{\"kind\":\"unexpected\"}\n{\"kind\":\"serviced\"}\n"];
+
+    __block NSUInteger count = 0;
+    UMKNDJSONRequestJournalReader *reader = [[UMKNDJSONRequestJournalReader alloc] initWithFileURL:self.fileURL];
+    XCTAssertEqualObjects(reader.fileURL, self.fileURL, @"File URL is set incorrectly");
+    XCTAssertTrue([reader enumerateRecordsUsingBlock:^(NSDictionary *record, BOOL *stop) {
+        count++;
+        *stop = [record[@"kind"] isEqualToString:@"unexpected"];
+    } error:NULL], @"Returned NO");
+
+    XCTAssertEqual(count, 2, @"Did not stop");
+}
+
+
+- (void)testReaderReadsUnterminatedLastLine
+{
+    [self writeString:@"{\"kind\":\"serviced\"}\n\n{\"kind\":\"unexpected\"}"];
+    XCTAssertEqualObjects([self readRecords], (@[ @{ @"kind" : @"serviced" }, @{ @"kind" : @"unexpected" } ]), @"Records read incorrectly");
+
+    // A partially written last record is reported rather than dropped
+    [self writeString:@"{\"kind\":\"serviced\"}\n{\"kind\":\"serv"];
+
+    __block NSUInteger count = 0;
+    NSError *error = nil;
+    UMKNDJSONRequestJournalReader *reader = [[UMKNDJSONRequestJournalReader alloc] initWithFileURL:self.fileURL];
+    XCTAssertFalse([reader enumerateRecordsUsingBlock:^(NSDictionary *record, BOOL *stop) {
+        count++;
+    } error:&error], @"Returned YES for partially written record");
+
+    XCTAssertNotNil(error, @"Error not returned");
+    XCTAssertEqual(count, 1, @"Incorrect number of records enumerated");
+}
+
+
+- (void)testReaderFailsForMalformedRecord
+{
+    [self writeString:@"{\"kind\":\"serviced\"}\n[1, 2]\n{\"kind\":\"unexpected\"}\n"];
+
+    __block NSUInteger count = 0;
+    NSError *error = nil;
+    UMKNDJSONRequestJournalReader *reader = [[UMKNDJSONRequestJournalReader alloc] initWithFileURL:self.fileURL];
+    XCTAssertFalse([reader enumerateRecordsUsingBlock:^(NSDictionary *record, BOOL *stop) {
+        count++;
+    } error:&error], @"Returned YES for malformed record");
+
+    XCTAssertNotNil(error, @"Error not returned");
+    XCTAssertEqual(count, 1, @"Records after malformed record were enumerated");
+
+    reader = [[UMKNDJSONRequestJournalReader alloc] initWithFileURL:[self.fileURL URLByAppendingPathExtension:@"missing"]];
+    error = nil;
+    XCTAssertFalse([reader enumerateRecordsUsingBlock:^(NSDictionary *record, BOOL *stop) { } error:&error], @"Returned YES for missing file");
+    XCTAssertNotNil(error, @"Error not returned");
+}
+
+@end
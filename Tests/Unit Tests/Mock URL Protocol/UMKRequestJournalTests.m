@@ -0,0 +1,276 @@
+//
+//  UMKRequestJournalTests.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import "UMKRandomizedTestCase.h"
+
+
+@interface UMKRequestJournalTests : UMKRandomizedTestCase
+
+- (void)testRecordInit;
+- (void)testRecordHeaderDigestIgnoresFieldNameCaseAndOrder;
+- (void)testAddRecordEvictsOldestRecordsAtCapacity;
+- (void)testAddRecordEvictsOldestRecordsOverByteBudget;
+- (void)testZeroCapacity;
+- (void)testRemoveAllRecords;
+- (void)testRegistryJournalsRequests;
+- (void)testRegistryRetainedRequestLimit;
+
+@end
+
+
+@implementation UMKRequestJournalTests
+
+- (UMKRequestJournalRecord *)randomRecordWithKind:(UMKRequestJournalRecordKind)kind
+{
+    NSURLRequest *request = [NSURLRequest requestWithURL:UMKRandomHTTPURL()];
+    return [[UMKRequestJournalRecord alloc] initWithURLRequest:request kind:kind mockRequest:nil];
+}
+
+
+- (void)testRecordInit
+{
+    NSURL *URL = UMKRandomHTTPURL();
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:URL];
+    request.HTTPMethod = @"post";
+    request.HTTPBody = [UMKRandomUnicodeString() dataUsingEncoding:NSUTF8StringEncoding];
+    id<UMKMockURLRequest> mockRequest = [UMKMockHTTPRequest mockHTTPPostRequestWithURL:URL];
+
+    NSTimeInterval startTime = [NSDate timeIntervalSinceReferenceDate];
+    UMKRequestJournalRecord *record = [[UMKRequestJournalRecord alloc] initWithURLRequest:request
+                                                                                     kind:UMKRequestJournalRecordKindServiced
+                                                                              mockRequest:mockRequest];
+    XCTAssertNotNil(record, @"Returned nil");
+    XCTAssertEqual(record.kind, UMKRequestJournalRecordKindServiced, @"Kind is set incorrectly");
+    XCTAssertEqualObjects(record.HTTPMethod, @"POST", @"HTTP method is set incorrectly");
+    XCTAssertEqualObjects(record.canonicalURL, [UMKMockURLProtocol canonicalURLForURL:URL], @"Canonical URL is set incorrectly");
+    XCTAssertEqual(record.bodyLength, request.HTTPBody.length, @"Body length is set incorrectly");
+    XCTAssertEqual(record.mockRequest, mockRequest, @"Mock request is set incorrectly");
+    XCTAssertGreaterThanOrEqual(record.timestamp, startTime, @"Timestamp is set incorrectly");
+    XCTAssertGreaterThan(record.byteCount, 0, @"Byte count is zero");
+
+    // Equal bodies have equal hashes
+    NSMutableURLRequest *otherRequest = [request mutableCopy];
+    otherRequest.HTTPBody = [request.HTTPBody copy];
+    UMKRequestJournalRecord *otherRecord = [[UMKRequestJournalRecord alloc] initWithURLRequest:otherRequest
+                                                                                          kind:UMKRequestJournalRecordKindUnexpected
+                                                                                   mockRequest:nil];
+    XCTAssertEqual(otherRecord.bodyHash, record.bodyHash, @"Body hash differs for equal bodies");
+    XCTAssertNil(otherRecord.mockRequest, @"Mock request is set incorrectly");
+
+    // Body streams are not read
+    otherRequest.HTTPBodyStream = [NSInputStream inputStreamWithData:request.HTTPBody];
+    otherRecord = [[UMKRequestJournalRecord alloc] initWithURLRequest:otherRequest kind:UMKRequestJournalRecordKindServiced mockRequest:nil];
+    XCTAssertEqual(otherRecord.bodyLength, NSNotFound, @"Body stream length is set incorrectly");
+    XCTAssertEqual(otherRecord.bodyHash, 0, @"Body stream hash is set incorrectly");
+}
+
+
+- (void)testRecordHeaderDigestIgnoresFieldNameCaseAndOrder
+{
+    NSURL *URL = UMKRandomHTTPURL();
+    NSMutableURLRequest *request1 = [NSMutableURLRequest requestWithURL:URL];
+    [request1 setValue:@"application/json" forHTTPHeaderField:@"Accept"];
+    [request1 setValue:@"abc" forHTTPHeaderField:@"X-Token"];
+
+    NSMutableURLRequest *request2 = [NSMutableURLRequest requestWithURL:URL];
+    [request2 setValue:@"abc" forHTTPHeaderField:@"x-token"];
+    [request2 setValue:@"application/json" forHTTPHeaderField:@"ACCEPT"];
+
+    NSMutableURLRequest *request3 = [request2 mutableCopy];
+    [request3 setValue:@"def" forHTTPHeaderField:@"x-token"];
+
+    UMKRequestJournalRecordKind kind = UMKRequestJournalRecordKindServiced;
+    uint64_t digest1 = [[UMKRequestJournalRecord alloc] initWithURLRequest:request1 kind:kind mockRequest:nil].headerDigest;
+    uint64_t digest2 = [[UMKRequestJournalRecord alloc] initWithURLRequest:request2 kind:kind mockRequest:nil].headerDigest;
+    uint64_t digest3 = [[UMKRequestJournalRecord alloc] initWithURLRequest:request3 kind:kind mockRequest:nil].headerDigest;
+
+    XCTAssertEqual(digest1, digest2, @"Digests differ for equivalent headers");
+    XCTAssertNotEqual(digest2, digest3, @"Digests equal for different headers");
+}
+
+
+- (void)testAddRecordEvictsOldestRecordsAtCapacity
+{
+    NSUInteger capacity = 2 + random() % 10;
+    UMKRequestJournal *journal = [[UMKRequestJournal alloc] initWithCapacity:capacity byteBudget:NSUIntegerMax];
+    XCTAssertEqual(journal.capacity, capacity, @"Capacity is set incorrectly");
+    XCTAssertEqual(journal.byteBudget, NSUIntegerMax, @"Byte budget is set incorrectly");
+    XCTAssertEqualObjects(journal.records, @[], @"Initial records are non-empty");
+
+    // Wrap around the ring buffer a few times
+    NSUInteger recordCount = capacity * 3 + random() % capacity;
+    NSMutableArray<UMKRequestJournalRecord *> *records = [[NSMutableArray alloc] initWithCapacity:recordCount];
+    for (NSUInteger i = 0; i < recordCount; ++i) {
+        UMKRequestJournalRecord *record = [self randomRecordWithKind:(i % 3 == 0 ? UMKRequestJournalRecordKindUnexpected
+                                                                                 : UMKRequestJournalRecordKindServiced)];
+        [records addObject:record];
+        [journal addRecord:record];
+
+        NSUInteger retainedCount = MIN(i + 1, capacity);
+        XCTAssertEqualObjects(journal.records, [records subarrayWithRange:NSMakeRange(i + 1 - retainedCount, retainedCount)],
+                              @"Records are incorrect after adding record %lu", (unsigned long)i);
+    }
+
+    XCTAssertEqual(journal.totalRecordCount, recordCount, @"Total record count is incorrect");
+    XCTAssertEqual(journal.unexpectedRecordCount, (recordCount + 2) / 3, @"Unexpected record count is incorrect");
+    XCTAssertEqual(journal.servicedRecordCount, recordCount - (recordCount + 2) / 3, @"Serviced record count is incorrect");
+    XCTAssertEqual(journal.evictedRecordCount, recordCount - capacity, @"Evicted record count is incorrect");
+
+    NSUInteger byteCount = 0;
+    for (UMKRequestJournalRecord *record in journal.records) {
+        byteCount += record.byteCount;
+    }
+
+    XCTAssertEqual(journal.byteCount, byteCount, @"Byte count is incorrect");
+}
+
+
+- (void)testAddRecordEvictsOldestRecordsOverByteBudget
+{
+    UMKRequestJournalRecord *record1 = [self randomRecordWithKind:UMKRequestJournalRecordKindServiced];
+    UMKRequestJournalRecord *record2 = [self randomRecordWithKind:UMKRequestJournalRecordKindServiced];
+    UMKRequestJournalRecord *record3 = [self randomRecordWithKind:UMKRequestJournalRecordKindServiced];
+
+    UMKRequestJournal *journal = [[UMKRequestJournal alloc] initWithCapacity:10 byteBudget:record2.byteCount + record3.byteCount];
+    [journal addRecord:record1];
+    [journal addRecord:record2];
+    [journal addRecord:record3];
+    XCTAssertLessThanOrEqual(journal.byteCount, journal.byteBudget, @"Byte budget exceeded");
+    XCTAssertEqualObjects(journal.records.lastObject, record3, @"Newest record not retained");
+    XCTAssertFalse([journal.records containsObject:record1], @"Oldest record not evicted");
+    XCTAssertEqual(journal.totalRecordCount, 3, @"Total record count is incorrect");
+    XCTAssertEqual(journal.evictedRecordCount + journal.records.count, 3, @"Evicted record count is incorrect");
+
+    // The newest record is retained even if it exceeds the budget on its own
+    journal = [[UMKRequestJournal alloc] initWithCapacity:10 byteBudget:1];
+    [journal addRecord:record1];
+    [journal addRecord:record2];
+    XCTAssertEqualObjects(journal.records, @[ record2 ], @"Newest record not retained");
+    XCTAssertEqual(journal.evictedRecordCount, 1, @"Evicted record count is incorrect");
+}
+
+
+- (void)testZeroCapacity
+{
+    UMKRequestJournal *journal = [[UMKRequestJournal alloc] initWithCapacity:0 byteBudget:NSUIntegerMax];
+    [journal addRecord:[self randomRecordWithKind:UMKRequestJournalRecordKindServiced]];
+    [journal addRecord:[self randomRecordWithKind:UMKRequestJournalRecordKindUnexpected]];
+
+    XCTAssertEqualObjects(journal.records, @[], @"Records retained");
+    XCTAssertEqual(journal.byteCount, 0, @"Byte count is non-zero");
+    XCTAssertEqual(journal.servicedRecordCount, 1, @"Serviced record count is incorrect");
+    XCTAssertEqual(journal.unexpectedRecordCount, 1, @"Unexpected record count is incorrect");
+}
+
+
+- (void)testRemoveAllRecords
+{
+    UMKRequestJournal *journal = [[UMKRequestJournal alloc] initWithCapacity:2 byteBudget:NSUIntegerMax];
+    for (NSUInteger i = 0; i < 5; ++i) {
+        [journal addRecord:[self randomRecordWithKind:UMKRequestJournalRecordKindServiced]];
+    }
+
+    [journal removeAllRecords];
+    XCTAssertEqualObjects(journal.records, @[], @"Records not removed");
+    XCTAssertEqual(journal.byteCount, 0, @"Byte count not reset");
+    XCTAssertEqual(journal.totalRecordCount, 0, @"Total record count not reset");
+    XCTAssertEqual(journal.evictedRecordCount, 0, @"Evicted record count not reset");
+
+    UMKRequestJournalRecord *record = [self randomRecordWithKind:UMKRequestJournalRecordKindServiced];
+    [journal addRecord:record];
+    XCTAssertEqualObjects(journal.records, @[ record ], @"Record not added after removing all records");
+}
+
+
+- (void)testRegistryJournalsRequests
+{
+    UMKMockRegistry *registry = [[UMKMockRegistry alloc] init];
+    registry.verificationEnabled = YES;
+    registry.retainsRequests = NO;
+    XCTAssertNotNil(registry.journal, @"Default journal is nil");
+
+    NSURL *URL = UMKRandomHTTPURL();
+    NSURLRequest *request = [NSURLRequest requestWithURL:URL];
+    UMKMockHTTPRequest *mockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:URL];
+    mockRequest.responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200];
+    [registry expectMockRequest:mockRequest];
+
+    XCTAssertNotNil([[registry.protocolClass alloc] initWithRequest:request cachedResponse:nil client:nil], @"Protocol not initialized");
+    XCTAssertNotNil([[registry.protocolClass alloc] initWithRequest:request cachedResponse:nil client:nil], @"Protocol not initialized");
+
+    // Requests are journaled, but not retained
+    XCTAssertEqualObjects(registry.servicedRequests, @{ }, @"Serviced request retained");
+    XCTAssertEqualObjects(registry.unexpectedRequests, @[], @"Unexpected request retained");
+    XCTAssertEqual(registry.unexpectedRequestCount, 1, @"Unexpected request not counted");
+
+    NSArray<UMKRequestJournalRecord *> *records = registry.journal.records;
+    XCTAssertEqual(records.count, 2, @"Incorrect number of records");
+    XCTAssertEqual(records[0].kind, UMKRequestJournalRecordKindServiced, @"Serviced request not journaled");
+    XCTAssertEqual(records[0].mockRequest, mockRequest, @"Serviced request journaled with wrong mock request");
+    XCTAssertEqual(records[1].kind, UMKRequestJournalRecordKindUnexpected, @"Unexpected request not journaled");
+    XCTAssertEqualObjects(records[1].canonicalURL, [UMKMockURLProtocol canonicalURLForURL:URL], @"Unexpected request journaled incorrectly");
+
+    [registry reset];
+    XCTAssertEqual(registry.journal.totalRecordCount, 0, @"Journal not reset");
+}
+
+
+- (void)testRegistryRetainedRequestLimit
+{
+    UMKMockRegistry *registry = [[UMKMockRegistry alloc] init];
+    XCTAssertTrue(registry.retainsRequests, @"Requests not retained by default");
+    XCTAssertEqual(registry.retainedRequestLimit, NSUIntegerMax, @"Requests are limited by default");
+
+    registry.verificationEnabled = YES;
+    registry.retainedRequestLimit = 2;
+
+    NSArray<NSURLRequest *> *requests = UMKGeneratedArrayWithElementCount(3 + random() % 5, ^id(NSUInteger index) {
+        return [NSURLRequest requestWithURL:UMKRandomHTTPURL()];
+    });
+
+    NSMutableDictionary<NSURLRequest *, id<UMKMockURLRequest>> *servicedRequests = [[NSMutableDictionary alloc] init];
+    for (NSURLRequest *request in requests) {
+        UMKMockHTTPRequest *mockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:request.URL];
+        mockRequest.responder = [UMKMockHTTPResponder mockHTTPResponderWithStatusCode:200];
+        [registry expectMockRequest:mockRequest];
+        XCTAssertNotNil([[registry.protocolClass alloc] initWithRequest:request cachedResponse:nil client:nil], @"Protocol not initialized");
+        servicedRequests[request] = mockRequest;
+    }
+
+    for (NSURLRequest *request in requests) {
+        XCTAssertNotNil([[registry.protocolClass alloc] initWithRequest:request cachedResponse:nil client:nil], @"Protocol not initialized");
+    }
+
+    // Only the most recent requests of each kind are retained, but every request is still counted and journaled
+    [servicedRequests removeObjectsForKeys:[requests subarrayWithRange:NSMakeRange(0, requests.count - 2)]];
+    XCTAssertEqualObjects(registry.unexpectedRequests, [requests subarrayWithRange:NSMakeRange(requests.count - 2, 2)],
+                          @"Unexpected requests not limited");
+    XCTAssertEqualObjects(registry.servicedRequests, servicedRequests, @"Serviced requests not limited");
+    XCTAssertEqual(registry.unexpectedRequestCount, requests.count, @"Unexpected requests not counted");
+    XCTAssertEqual(registry.journal.totalRecordCount, 2 * requests.count, @"Requests not journaled");
+}
+
+@end
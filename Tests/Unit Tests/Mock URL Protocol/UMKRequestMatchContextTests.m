@@ -0,0 +1,158 @@
+//
+//  UMKRequestMatchContextTests.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+#import "UMKRandomizedTestCase.h"
+
+
+/*! A mock HTTP request subclass that never matches any request. */
+@interface UMKNeverMatchingMockHTTPRequest : UMKMockHTTPRequest
+@end
+
+
+@implementation UMKNeverMatchingMockHTTPRequest
+
+- (BOOL)matchesURLRequest:(NSURLRequest *)request
+{
+    return NO;
+}
+
+@end
+
+
+#pragma mark -
+
+@interface UMKRequestMatchContextTests : UMKRandomizedTestCase
+
+- (void)testInit;
+- (void)testURLAndMethod;
+- (void)testHeaders;
+- (void)testBodyIsReadOnce;
+- (void)testParsedBodies;
+- (void)testMockRequestsMatchUsingContext;
+
+@end
+
+
+@implementation UMKRequestMatchContextTests
+
+- (void)testInit
+{
+    NSURLRequest *request = [NSURLRequest requestWithURL:UMKRandomHTTPURL()];
+    UMKRequestMatchContext *context = [[UMKRequestMatchContext alloc] initWithURLRequest:request];
+    XCTAssertNotNil(context, @"Returns nil");
+    XCTAssertEqual(context.request, request, @"Request not set correctly");
+}
+
+
+- (void)testURLAndMethod
+{
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:@"http://domain.com/path?b=2&a=1"]];
+    request.HTTPMethod = @"post";
+
+    UMKRequestMatchContext *context = [[UMKRequestMatchContext alloc] initWithURLRequest:request];
+    XCTAssertEqualObjects(context.canonicalURL, [UMKMockURLProtocol canonicalURLForURL:request.URL], @"Canonical URL is incorrect");
+    XCTAssertEqual(context.canonicalURL, context.canonicalURL, @"Canonical URL is not memoized");
+    XCTAssertEqualObjects(context.canonicalURLStringExcludingQuery, @"http://domain.com/path", @"URL string excluding query is incorrect");
+    XCTAssertEqualObjects(context.uppercaseHTTPMethod, @"POST", @"Method is not uppercase");
+}
+
+
+- (void)testHeaders
+{
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:UMKRandomHTTPURL()];
+    NSDictionary<NSString *, NSString *> *headers = UMKRandomDictionaryOfStringsWithElementCount(random() % 10 + 1);
+    for (NSString *field in headers) {
+        [request setValue:headers[field] forHTTPHeaderField:field];
+    }
+
+    UMKRequestMatchContext *context = [[UMKRequestMatchContext alloc] initWithURLRequest:request];
+    XCTAssertEqualObjects(context.HTTPHeaderFields, request.allHTTPHeaderFields, @"Headers are incorrect");
+
+    for (NSString *field in headers) {
+        XCTAssertEqualObjects([context valueForHTTPHeaderField:field.uppercaseString], headers[field], @"Header lookup is case-sensitive");
+    }
+
+    XCTAssertNil([context valueForHTTPHeaderField:UMKRandomUnicodeString()], @"Returns value for missing header");
+}
+
+
+- (void)testBodyIsReadOnce
+{
+    NSData *body = [UMKRandomUnicodeStringWithLength(1024) dataUsingEncoding:NSUTF8StringEncoding];
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:UMKRandomHTTPURL()];
+    request.HTTPBodyStream = [NSInputStream inputStreamWithData:body];
+
+    UMKRequestMatchContext *context = [[UMKRequestMatchContext alloc] initWithURLRequest:request];
+    NSData *contextBody = context.HTTPBodyData;
+    XCTAssertEqualObjects(contextBody, body, @"Body is incorrect");
+    XCTAssertEqual(context.HTTPBodyData, contextBody, @"Body is not memoized");
+
+    context = [[UMKRequestMatchContext alloc] initWithURLRequest:[NSURLRequest requestWithURL:UMKRandomHTTPURL()]];
+    XCTAssertNil(context.HTTPBodyData, @"Body is non-nil for request without body");
+    XCTAssertNil(context.JSONObjectFromHTTPBody, @"JSON is non-nil for request without body");
+    XCTAssertNil(context.parametersFromURLEncodedHTTPBody, @"Parameters are non-nil for request without body");
+}
+
+
+- (void)testParsedBodies
+{
+    id JSONObject = UMKRandomJSONObject(3, 3);
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:UMKRandomHTTPURL()];
+    request.HTTPBody = [NSJSONSerialization dataWithJSONObject:JSONObject options:0 error:NULL];
+
+    UMKRequestMatchContext *context = [[UMKRequestMatchContext alloc] initWithURLRequest:request];
+    XCTAssertEqualObjects(context.JSONObjectFromHTTPBody, JSONObject, @"JSON is incorrect");
+    XCTAssertEqual(context.JSONObjectFromHTTPBody, context.JSONObjectFromHTTPBody, @"JSON is not memoized");
+
+    NSDictionary<NSString *, id> *parameters = UMKRandomURLEncodedParameterDictionary(3, 3);
+    request.HTTPBody = [[parameters umk_URLEncodedParameterString] dataUsingEncoding:NSUTF8StringEncoding];
+
+    context = [[UMKRequestMatchContext alloc] initWithURLRequest:request];
+    XCTAssertEqualObjects(context.parametersFromURLEncodedHTTPBody, parameters, @"Parameters are incorrect");
+    XCTAssertEqual(context.parametersFromURLEncodedHTTPBody, context.parametersFromURLEncodedHTTPBody, @"Parameters are not memoized");
+}
+
+
+- (void)testMockRequestsMatchUsingContext
+{
+    NSURL *URL = UMKRandomHTTPURL();
+    NSURLRequest *request = [NSURLRequest requestWithURL:URL];
+    UMKRequestMatchContext *context = [[UMKRequestMatchContext alloc] initWithURLRequest:request];
+
+    UMKMockHTTPRequest *mockRequest = [UMKMockHTTPRequest mockHTTPGetRequestWithURL:URL];
+    XCTAssertTrue([mockRequest matchesURLRequest:request context:context], @"Does not match equivalent request");
+
+    NSString *URLPattern = [[URL.absoluteString componentsSeparatedByString:@"?"] firstObject];
+    UMKPatternMatchingMockRequest *patternRequest = [[UMKPatternMatchingMockRequest alloc] initWithURLPattern:URLPattern];
+    patternRequest.HTTPMethods = [NSSet setWithObject:@"get"];
+    XCTAssertTrue([patternRequest matchesURLRequest:request context:context], @"Does not match equivalent request");
+
+    // Subclasses that override -matchesURLRequest: are respected
+    UMKNeverMatchingMockHTTPRequest *neverMatchingRequest = [UMKNeverMatchingMockHTTPRequest mockHTTPGetRequestWithURL:URL];
+    XCTAssertFalse([neverMatchingRequest matchesURLRequest:request context:context], @"Subclass override not respected");
+}
+
+@end
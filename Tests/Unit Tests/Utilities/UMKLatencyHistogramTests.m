@@ -0,0 +1,150 @@
+//
+//  UMKLatencyHistogramTests.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import "UMKRandomizedTestCase.h"
+
+
+@interface UMKLatencyHistogramTests : UMKRandomizedTestCase
+
+- (void)testInit;
+- (void)testRecordDuration;
+- (void)testDurationAtPercentile;
+- (void)testConcurrentRecording;
+- (void)testReset;
+
+@end
+
+
+@implementation UMKLatencyHistogramTests
+
+- (void)testInit
+{
+    UMKLatencyHistogram *histogram = [[UMKLatencyHistogram alloc] init];
+    XCTAssertNotNil(histogram, @"Returns nil");
+    XCTAssertEqual(histogram.count, 0, @"Count is non-zero");
+    XCTAssertEqual(histogram.totalDuration, 0, @"Total duration is non-zero");
+    XCTAssertEqual(histogram.minimumDuration, 0, @"Minimum duration is non-zero");
+    XCTAssertEqual(histogram.maximumDuration, 0, @"Maximum duration is non-zero");
+    XCTAssertEqual(histogram.meanDuration, 0, @"Mean duration is non-zero");
+    XCTAssertEqual([histogram durationAtPercentile:50], 0, @"Median is non-zero");
+}
+
+
+- (void)testRecordDuration
+{
+    UMKLatencyHistogram *histogram = [[UMKLatencyHistogram alloc] init];
+    uint64_t minimumDuration = UINT64_MAX;
+    uint64_t maximumDuration = 0;
+    uint64_t totalDuration = 0;
+
+    NSUInteger count = 100 + random() % 100;
+    for (NSUInteger i = 0; i < count; ++i) {
+        uint64_t duration = random() % 10000000;
+        [histogram recordDuration:duration];
+        minimumDuration = MIN(minimumDuration, duration);
+        maximumDuration = MAX(maximumDuration, duration);
+        totalDuration += duration;
+    }
+
+    XCTAssertEqual(histogram.count, count, @"Count is incorrect");
+    XCTAssertEqual(histogram.totalDuration, totalDuration, @"Total duration is incorrect");
+    XCTAssertEqual(histogram.minimumDuration, minimumDuration, @"Minimum duration is incorrect");
+    XCTAssertEqual(histogram.maximumDuration, maximumDuration, @"Maximum duration is incorrect");
+    XCTAssertEqualWithAccuracy(histogram.meanDuration, (double)totalDuration / count, 0.001, @"Mean duration is incorrect");
+    XCTAssertEqual([histogram durationAtPercentile:0], minimumDuration, @"Minimum percentile is incorrect");
+    XCTAssertEqual([histogram durationAtPercentile:100], maximumDuration, @"Maximum percentile is incorrect");
+
+    // Durations far beyond the tracked range are still recorded
+    [histogram recordDuration:UINT64_MAX / 2];
+    XCTAssertEqual(histogram.maximumDuration, UINT64_MAX / 2, @"Maximum duration is incorrect");
+    XCTAssertEqual([histogram durationAtPercentile:100], UINT64_MAX / 2, @"Maximum percentile is incorrect");
+}
+
+
+- (void)testDurationAtPercentile
+{
+    UMKLatencyHistogram *histogram = [[UMKLatencyHistogram alloc] init];
+
+    // Small durations are recorded exactly
+    for (uint64_t duration = 1; duration <= 20; ++duration) {
+        [histogram recordDuration:duration];
+    }
+
+    XCTAssertEqual([histogram durationAtPercentile:50], 10, @"Median is incorrect");
+    XCTAssertEqual([histogram durationAtPercentile:95], 19, @"95th percentile is incorrect");
+
+    // Larger durations are recorded to within 1/16th of their value
+    [histogram reset];
+    for (uint64_t duration = 1; duration <= 10000; ++duration) {
+        [histogram recordDuration:duration * 1000];
+    }
+
+    uint64_t percentiles[] = { 10, 50, 90, 99 };
+    for (size_t i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); ++i) {
+        double expectedDuration = percentiles[i] * 100 * 1000;
+        XCTAssertEqualWithAccuracy((double)[histogram durationAtPercentile:percentiles[i]], expectedDuration, expectedDuration / 16,
+                                   @"Percentile %llu is incorrect", percentiles[i]);
+    }
+}
+
+
+- (void)testConcurrentRecording
+{
+    UMKLatencyHistogram *histogram = [[UMKLatencyHistogram alloc] init];
+    NSUInteger iterations = 8;
+    NSUInteger durationsPerIteration = 10000;
+
+    dispatch_apply(iterations, dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^(size_t iteration) {
+        for (NSUInteger i = 1; i <= durationsPerIteration; ++i) {
+            [histogram recordDuration:i];
+        }
+    });
+
+    XCTAssertEqual(histogram.count, iterations * durationsPerIteration, @"Count is incorrect");
+    XCTAssertEqual(histogram.totalDuration, iterations * durationsPerIteration * (durationsPerIteration + 1) / 2, @"Total duration is incorrect");
+    XCTAssertEqual(histogram.minimumDuration, 1, @"Minimum duration is incorrect");
+    XCTAssertEqual(histogram.maximumDuration, durationsPerIteration, @"Maximum duration is incorrect");
+}
+
+
+- (void)testReset
+{
+    UMKLatencyHistogram *histogram = [[UMKLatencyHistogram alloc] init];
+    [histogram recordDuration:random()];
+    [histogram reset];
+
+    XCTAssertEqual(histogram.count, 0, @"Count not reset");
+    XCTAssertEqual(histogram.totalDuration, 0, @"Total duration not reset");
+    XCTAssertEqual(histogram.minimumDuration, 0, @"Minimum duration not reset");
+    XCTAssertEqual(histogram.maximumDuration, 0, @"Maximum duration not reset");
+    XCTAssertEqual([histogram durationAtPercentile:50], 0, @"Median not reset");
+
+    [histogram recordDuration:42];
+    XCTAssertEqual([histogram durationAtPercentile:50], 42, @"Median is incorrect after reset");
+}
+
+@end
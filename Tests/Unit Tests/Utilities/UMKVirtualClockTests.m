@@ -0,0 +1,204 @@
+//
+//  UMKVirtualClockTests.m
+//  URLMock
+//
+//  Created by agent on 10/17/2026.
+//  Copyright (c) 2015 Prachi Gauriar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+
+
+#import "UMKRandomizedTestCase.h"
+
+
+@interface UMKVirtualClockTests : UMKRandomizedTestCase
+
+- (void)testInit;
+- (void)testDefaultClock;
+- (void)testRealTimeClock;
+- (void)testManualClock;
+- (void)testManualClockRunsBlocksScheduledWhileAdvancing;
+- (void)testAsFastAsPossibleClock;
+- (void)testCancelScheduledBlock;
+
+@end
+
+
+@implementation UMKVirtualClockTests
+
+- (void)testInit
+{
+    UMKVirtualClock *clock = [[UMKVirtualClock alloc] init];
+    XCTAssertEqual(clock.mode, UMKVirtualClockModeRealTime, @"Default mode is not real time");
+    XCTAssertEqual(clock.scheduledBlockCount, 0, @"Scheduled block count is non-zero");
+
+    clock = [[UMKVirtualClock alloc] initWithMode:UMKVirtualClockModeManual];
+    XCTAssertEqual(clock.mode, UMKVirtualClockModeManual, @"Mode is not set correctly");
+    XCTAssertEqual(clock.currentTime, 0.0, @"Current time is non-zero");
+
+    XCTAssertThrows([clock scheduleBlock:^{ } afterDelay:-1.0], @"Negative delay allowed");
+    XCTAssertThrows([[[UMKVirtualClock alloc] init] advanceByTimeInterval:1.0], @"Real-time clock advanced manually");
+}
+
+
+- (void)testDefaultClock
+{
+    UMKVirtualClock *defaultClock = [UMKVirtualClock defaultClock];
+    XCTAssertEqual(defaultClock.mode, UMKVirtualClockModeRealTime, @"Default clock is not real time");
+    XCTAssertEqual([UMKVirtualClock defaultClock], defaultClock, @"Default clock changes");
+
+    UMKVirtualClock *clock = [[UMKVirtualClock alloc] initWithMode:UMKVirtualClockModeManual];
+    [UMKVirtualClock setDefaultClock:clock];
+    XCTAssertEqual([UMKVirtualClock defaultClock], clock, @"Default clock is not set");
+
+    [UMKVirtualClock setDefaultClock:nil];
+    XCTAssertEqual([UMKVirtualClock defaultClock].mode, UMKVirtualClockModeRealTime, @"Default clock is not reset to real time");
+}
+
+
+- (void)testRealTimeClock
+{
+    UMKVirtualClock *clock = [[UMKVirtualClock alloc] init];
+
+    __block NSTimeInterval runTime = 0.0;
+    XCTestExpectation *ranExpectation = [self expectationWithDescription:@"Block ran"];
+    [clock scheduleBlock:^{
+        runTime = clock.currentTime;
+        [ranExpectation fulfill];
+    } afterDelay:0.05];
+
+    XCTAssertEqual(clock.scheduledBlockCount, 1, @"Block not scheduled");
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    XCTAssertGreaterThanOrEqual(runTime, 0.05, @"Block ran before its delay");
+    XCTAssertEqual(clock.scheduledBlockCount, 0, @"Scheduled block count is non-zero after block ran");
+}
+
+
+- (void)testManualClock
+{
+    UMKVirtualClock *clock = [[UMKVirtualClock alloc] initWithMode:UMKVirtualClockModeManual];
+
+    NSMutableArray<NSNumber *> *order = [[NSMutableArray alloc] init];
+    NSMutableArray<NSNumber *> *runTimes = [[NSMutableArray alloc] init];
+    NSArray<NSNumber *> *delays = @[ @3.0, @1.0, @2.0, @1.0, @10.0 ];
+    for (NSUInteger i = 0; i < delays.count; ++i) {
+        [clock scheduleBlock:^{
+            [order addObject:@(i)];
+            [runTimes addObject:@(clock.currentTime)];
+        } afterDelay:delays[i].doubleValue];
+    }
+
+    [clock advanceByTimeInterval:0.5];
+    XCTAssertEqual(order.count, 0, @"Blocks ran before they were due");
+    XCTAssertEqual(clock.currentTime, 0.5, @"Current time not advanced");
+
+    [clock advanceByTimeInterval:2.5];
+    XCTAssertEqualObjects(order, (@[ @1, @3, @2, @0 ]), @"Blocks did not run in order of their delays");
+    XCTAssertEqualObjects(runTimes, (@[ @1.0, @1.0, @2.0, @3.0 ]), @"Blocks did not run at their scheduled times");
+    XCTAssertEqual(clock.currentTime, 3.0, @"Current time not advanced");
+    XCTAssertEqual(clock.scheduledBlockCount, 1, @"Scheduled block count is incorrect");
+}
+
+
+- (void)testManualClockRunsBlocksScheduledWhileAdvancing
+{
+    UMKVirtualClock *clock = [[UMKVirtualClock alloc] initWithMode:UMKVirtualClockModeManual];
+
+    // Each block reschedules itself, like a chunked response
+    NSMutableArray<NSNumber *> *runTimes = [[NSMutableArray alloc] init];
+    __block __weak dispatch_block_t weakTick = nil;
+    dispatch_block_t tick = ^{
+        [runTimes addObject:@(clock.currentTime)];
+        if (runTimes.count < 5) {
+            [clock scheduleBlock:weakTick afterDelay:10.0];
+        }
+    };
+
+    weakTick = tick;
+    [clock scheduleBlock:tick afterDelay:10.0];
+
+    NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+    [clock advanceByTimeInterval:45.0];
+    XCTAssertLessThan([NSDate timeIntervalSinceReferenceDate] - start, 1.0, @"Advancing took real time");
+    XCTAssertEqualObjects(runTimes, (@[ @10.0, @20.0, @30.0, @40.0 ]), @"Rescheduled blocks did not run at the right times");
+
+    [clock advanceByTimeInterval:100.0];
+    XCTAssertEqual(runTimes.count, 5, @"Last rescheduled block did not run");
+}
+
+
+- (void)testAsFastAsPossibleClock
+{
+    UMKVirtualClock *clock = [[UMKVirtualClock alloc] initWithMode:UMKVirtualClockModeAsFastAsPossible];
+
+    NSMutableArray<NSNumber *> *order = [[NSMutableArray alloc] init];
+    __block NSTimeInterval finalTime = 0.0;
+    NSArray<NSNumber *> *delays = @[ @60.0, @20.0, @40.0 ];
+    XCTestExpectation *ranExpectation = [self expectationWithDescription:@"Blocks ran"];
+    ranExpectation.expectedFulfillmentCount = delays.count;
+
+    // Schedule the blocks from a block so that the clock can't advance until they're all scheduled
+    [clock scheduleBlock:^{
+        for (NSUInteger i = 0; i < delays.count; ++i) {
+            [clock scheduleBlock:^{
+                @synchronized (order) {
+                    [order addObject:@(i)];
+                    finalTime = clock.currentTime;
+                }
+
+                [ranExpectation fulfill];
+            } afterDelay:delays[i].doubleValue];
+        }
+    } afterDelay:0.0];
+
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    XCTAssertEqualObjects(order, (@[ @1, @2, @0 ]), @"Blocks did not run in order of their delays");
+    XCTAssertEqual(finalTime, 60.0, @"Clock did not advance to the last block's time");
+}
+
+
+- (void)testCancelScheduledBlock
+{
+    for (NSNumber *mode in @[ @(UMKVirtualClockModeRealTime), @(UMKVirtualClockModeManual) ]) {
+        UMKVirtualClock *clock = [[UMKVirtualClock alloc] initWithMode:mode.integerValue];
+
+        __block BOOL ran = NO;
+        XCTestExpectation *ranExpectation = [[XCTestExpectation alloc] initWithDescription:@"Canceled block ran"];
+        ranExpectation.inverted = YES;
+        id token = [clock scheduleBlock:^{
+            ran = YES;
+            [ranExpectation fulfill];
+        } afterDelay:0.01];
+
+        [clock cancelScheduledBlock:token];
+        XCTAssertEqual(clock.scheduledBlockCount, 0, @"Canceled block is still scheduled");
+        XCTAssertNoThrow([clock cancelScheduledBlock:token], @"Canceling twice throws");
+
+        if (clock.mode == UMKVirtualClockModeManual) {
+            [clock advanceByTimeInterval:1.0];
+        } else {
+            [XCTWaiter waitForExpectations:@[ ranExpectation ] timeout:0.05];
+        }
+
+        XCTAssertFalse(ran, @"Canceled block ran");
+    }
+}
+
+@end